@@ -10,12 +10,11 @@
  */
 
 #include <I2S.h>
-#include <EEPROM.h>
 #include "arduino_tr808_config.h"
 #include "tr808_drums.h"
+#include "tr808_pattern_store.h"
 
 // 고급 기능 설정
-#define EEPROM_SIZE 4096
 #define MAX_PATTERN_LENGTH 32
 #define MAX_SEQUENCES 8
 
@@ -31,6 +30,8 @@ struct DrumPattern {
 // 전역 변수
 TR808DrumMachine drumMachine;
 DrumPattern sequences[MAX_SEQUENCES];
+TR808PartitionBackend storageBackend;
+TR808PatternStore patternStore(&storageBackend);
 uint8_t currentSequence = 0;
 uint8_t currentStep = 0;
 unsigned long lastStepTime = 0;
@@ -48,8 +49,12 @@ void setup() {
     Serial.println("  ESP32C3 TR-808 고급 기능 데모");
     Serial.println("===========================================");
     
-    // EEPROM 초기화
-    EEPROM.begin(EEPROM_SIZE);
+    // 패턴 저장소 마운트 (플래시 쓰기는 백그라운드 태스크에서 처리)
+    if (patternStore.begin()) {
+        patternStore.startWriterTask();
+    } else {
+        Serial.println("⚠️ 저장소 파티션 없음 - 저장 기능 비활성화");
+    }
     
     // I2S 초기화
     if (!I2S.begin(I2S_STANDARD, DEFAULT_SAMPLE_RATE, 16, 1)) {
@@ -386,7 +391,7 @@ void loadLatinPattern() {
 }
 
 // ============================================
-// EEPROM 저장/불러오기
+// 패턴 저장/불러오기
 // ============================================
 
 void saveAllSettings() {
@@ -399,8 +404,12 @@ void saveAllSettings() {
 }
 
 void saveSequence(uint8_t seqIndex) {
-    int addr = seqIndex * sizeof(DrumPattern);
-    EEPROM.put(addr, sequences[seqIndex]);
+    // 변경된 시퀀스 하나만 레코드로 추가 (전체 블록 재기록 없음)
+    if (!patternStore.queueWrite(TR808_RECORD_PATTERN, seqIndex,
+                                 &sequences[seqIndex], sizeof(DrumPattern))) {
+        Serial.println("❌ 시퀀스 " + String(seqIndex + 1) + " 저장 실패");
+        return;
+    }
     
     Serial.println("💾 시퀀스 " + String(seqIndex + 1) + " 저장됨");
 }
@@ -415,8 +424,11 @@ void loadAllSettings() {
 }
 
 void loadSequence(uint8_t seqIndex) {
-    int addr = seqIndex * sizeof(DrumPattern);
-    EEPROM.get(addr, sequences[seqIndex]);
+    if (patternStore.read(TR808_RECORD_PATTERN, seqIndex,
+                          &sequences[seqIndex], sizeof(DrumPattern)) != sizeof(DrumPattern)) {
+        Serial.println("📂 시퀀스 " + String(seqIndex + 1) + " 저장된 데이터 없음");
+        return;
+    }
     
     Serial.println("📂 시퀀스 " + String(seqIndex + 1) + " 로드됨: " + String(sequences[seqIndex].name));
 }
@@ -486,7 +498,8 @@ void printAdvancedStatus() {
     Serial.println("  실행시간: " + String(millis() / 1000) + "초");
     Serial.println("");
     Serial.println("💾 저장:");
-    Serial.println("  EEPROM: " + String(EEPROM_SIZE) + " bytes");
+    Serial.println("  플래시 저장소: " + String(patternStore.isMounted() ? "마운트됨" : "없음"));
+    Serial.println("  최대 소거 횟수: " + String(patternStore.getStats().maxEraseCount));
     Serial.println("  시퀀스: " + String(MAX_SEQUENCES) + "개");
     Serial.println("  패턴 길이: 최대 " + String(MAX_PATTERN_LENGTH) + "스텝");
     Serial.println("");
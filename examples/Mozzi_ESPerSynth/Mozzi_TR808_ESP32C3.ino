@@ -17,6 +17,7 @@
  * - pattern_demo - 데모 패턴 재생
  * - pattern_stop - 패턴 중지
  * - status - 시스템 상태 및 성능 통계
+ * - benchmark - 보이스 처리량 측정
  * - list - 지원되는 드럼 목록
  * - help - 도움말 표시
  */
@@ -88,6 +89,7 @@ const char* HELP_TEXT = R"(
 
 🔧 시스템:
 - test           : 오디오 출력 테스트
+- benchmark      : 보이스 처리량 측정 (32768Hz / 64000Hz)
 - reset          : 시스템 리셋
 
 )" ;
@@ -224,20 +226,33 @@ extern "C" {
  * Serial 입력 처리
  */
 void processSerialInput() {
-    String input = Serial.readStringUntil('\n');
-    input.trim();
-    input.toLowerCase();
+    static char line[COMMAND_BUFFER_SIZE];
+    static uint8_t length = 0;
     
-    if (input.length() == 0) return;
-    
-    Serial.print(F("🔹 수신된 명령어: "));
-    Serial.println(input);
-    
-    // TR-808 드럼 머신에서 명령어 처리
-    bool handled = tr808Mozzi.processSerialCommand(input);
-    
-    if (!handled) {
-        Serial.println(F("❓ 알 수 없는 명령어입니다. 'help'를 입력하여 도움말을 확인하세요."));
+    // 수신된 바이트만 처리 (readStringUntil 타임아웃 대기 없음)
+    while (Serial.available()) {
+        char c = (char)Serial.read();
+        
+        if (c != '\n' && c != '\r') {
+            if (length < sizeof(line) - 1) {
+                line[length++] = c;
+            }
+            continue;
+        }
+        
+        if (length == 0) continue;
+        line[length] = '\0';
+        length = 0;
+        
+        Serial.print(F("🔹 수신된 명령어: "));
+        Serial.println(line);
+        
+        // TR-808 드럼 머신에서 명령어 처리 (버퍼 제자리 토큰화)
+        bool handled = tr808Mozzi.processSerialCommand(line);
+        
+        if (!handled) {
+            Serial.println(F("❓ 알 수 없는 명령어입니다. 'help'를 입력하여 도움말을 확인하세요."));
+        }
     }
 }
 
@@ -3,12 +3,26 @@
  * 
  * ESP32C3의 GPIO 18 (I2S 또는 PWM)을 통한 오디오 출력
  * PWM 기반의 외부 오디오 출력 모드 구현
+ *
+ * PWM 블록 출력 (AUDIO_OUTPUT_PWM):
+ * - LEDC에는 DMA가 없으므로 렌더 태스크가 블록 단위로 16 -> 8비트 재양자화(노이즈 셰이핑)해 링에 넣고
+ *   샘플 타이머 ISR은 링에서 듀티 값 하나를 읽어 레지스터에 쓰기만 함 (렌더/변환 없음)
+ * - 블록 장부는 I2S DMA 출력과 같은 TR808DmaRing, 제출 안 된 블록은 ISR이 중앙값(무음)으로 재생
  */
 
 #include "mozzi_config.h"
 #include "driver/ledc.h"
 #include "driver/gpio.h"
+#include "hal/ledc_ll.h"
+#include "soc/ledc_struct.h"
 #include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "../src/tr808_dma_ring.h"
+#include "../src/tr808_noise_shaper.h"
+#include "../src/tr808_log.h"
+
+void* getArenaSlot(uint8_t slot);   // buffer_manager_esp32c3.cpp
 
 // =============================================================================
 // 전역 변수 및 상수 정의
@@ -16,9 +30,14 @@
 
 static const char* TAG = "ESP32C3_AudioOutput";
 
-// PWM 채널 설정
-#define PWM_TIMER_SPEED_HZ 8000      // 8kHz PWM 주파수
-#define PWM_TIMER_RESOLUTION 8       // 8-bit 분해능 (0-255)
+// PWM 채널 설정 (mozzi_config.h)
+#define PWM_TIMER_SPEED_HZ PWM_FREQUENCY
+#define PWM_TIMER_RESOLUTION PWM_RESOLUTION
+#define PWM_MIDSCALE (1 << (PWM_RESOLUTION - 1))
+
+// 샘플 타이머 (하드웨어 타이머 0, APB 80MHz 분주)
+#define PWM_SAMPLE_TIMER_NUM 0
+#define PWM_SAMPLE_TIMER_TICKS (80000000UL / PWM_SAMPLE_TIMER_DIVIDER / MOZZI_AUDIO_RATE)
 
 // GPIO 설정
 #define AUDIO_OUTPUT_PIN GPIO_NUM_18
@@ -31,6 +50,24 @@ static volatile uint8_t currentBuffer = 0;
 static volatile uint8_t writeBuffer = 0;
 static volatile size_t bufferIndex = 0;
 
+// PWM 블록 링 (렌더 태스크 -> 샘플 ISR)
+static uint8_t (*pwmBlocks)[DMA_MAX_BLOCK_SAMPLES] = NULL;     // [PWM_OUTPUT_BLOCKS] (시작 아레나)
+static volatile uint16_t pwmBlockSamples = DMA_INITIAL_BLOCK_SAMPLES;  // 현재 블록 크기 (적응형 지연)
+static TR808DmaRing pwmRing;
+static TR808NoiseShaper pwmShaper;
+static hw_timer_t* pwmSampleTimer = NULL;
+static TaskHandle_t pwmWaiter = NULL;           // 블록 완료 알림을 받을 렌더 태스크
+static volatile bool pwmRunning = false;
+
+// 샘플 ISR 상태
+static volatile uint16_t pwmReadIndex = 0;
+static volatile uint8_t pwmReadSlot = 0;
+static volatile bool pwmBlockReady = false;     // 재생 중인 블록이 제출됐는지 (아니면 무음)
+
+// 성능 측정 변수
+static volatile uint32_t pwmWakeups = 0;
+static volatile uint32_t pwmSilentBlocks = 0;   // ISR이 무음으로 대체한 블록 수
+
 // =============================================================================
 // 오디오 출력 초기화
 // =============================================================================
@@ -74,14 +111,142 @@ void initializeAudioOutput() {
     
     // PWM 채널 시작
     ledc_fade_func_install(0);
-    ledc_set_duty(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_0, 0);
+    ledc_set_duty(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_0, PWM_MIDSCALE);  // 중앙값 = 무음
     ledc_update_duty(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_0);
     
     DEBUG_PRINTLN("Audio output initialized successfully");
 }
 
 // =============================================================================
-// 오디오 출력 함수 (Mozzi에서 호출)
+// PWM 블록 출력 (AUDIO_OUTPUT_PWM)
+// =============================================================================
+
+/**
+ * 샘플 타이머 ISR: 링에서 듀티 값 하나를 읽어 LEDC 레지스터에 기록
+ * 드라이버 함수(ledc_set_duty 등)는 스핀락/검사가 있어 레지스터 헬퍼만 사용
+ */
+static void IRAM_ATTR pwmSampleISR() {
+    uint8_t level = pwmBlockReady ? pwmBlocks[pwmReadSlot][pwmReadIndex] : PWM_MIDSCALE;
+    ledc_ll_set_duty_int_part(&LEDC, LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_0, level);
+    ledc_ll_set_duty_start(&LEDC, LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_0, true);
+    ledc_ll_ls_channel_update(&LEDC, LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_0);
+
+    if (++pwmReadIndex < pwmBlockSamples) return;
+
+    // 블록 끝: 장부 갱신 -> 다음 블록 제출 여부 확인 -> 렌더 태스크 깨움
+    pwmReadIndex = 0;
+    pwmRing.onBlockComplete();
+    uint32_t playing = pwmRing.getCompleted();
+    pwmReadSlot = playing % PWM_OUTPUT_BLOCKS;
+    pwmBlockReady = pwmRing.isSubmitted(playing);
+    if (!pwmBlockReady) pwmSilentBlocks++;
+
+    BaseType_t woken = pdFALSE;
+    if (pwmWaiter != NULL) vTaskNotifyGiveFromISR(pwmWaiter, &woken);
+    if (woken) portYIELD_FROM_ISR();
+}
+
+bool initializePwmOutput() {
+    // 듀티 링은 시작 아레나에서 (AUDIO_OUTPUT_PWM 빌드에서만 예산에 포함)
+    pwmBlocks = (uint8_t (*)[DMA_MAX_BLOCK_SAMPLES])getArenaSlot(MOZZI_ARENA_PWM_BLOCKS);
+    if (pwmBlocks == NULL) return false;
+    initializeAudioOutput();
+    tr808Log.log(TR808_LOG_PWM_READY, PWM_FREQUENCY, PWM_RESOLUTION, PWM_NOISE_SHAPING_ORDER);
+    return true;
+}
+
+void startPwmOutput() {
+    if (pwmRunning || pwmBlocks == NULL) return;
+
+    // 모든 블록을 무음으로 채운 상태에서 시작 (프리필 = 블록 수)
+    memset(pwmBlocks, PWM_MIDSCALE, PWM_OUTPUT_BLOCKS * DMA_MAX_BLOCK_SAMPLES);
+    pwmRing.begin(PWM_OUTPUT_BLOCKS, PWM_OUTPUT_BLOCKS);
+    pwmShaper.begin(PWM_NOISE_SHAPING_ORDER);
+    pwmReadIndex = 0;
+    pwmReadSlot = 0;
+    pwmBlockReady = true;
+
+    pwmSampleTimer = timerBegin(PWM_SAMPLE_TIMER_NUM, PWM_SAMPLE_TIMER_DIVIDER, true);
+    if (pwmSampleTimer == NULL) {
+        tr808Log.log(TR808_LOG_PWM_TIMER_FAILED);
+        return;
+    }
+    timerAttachInterrupt(pwmSampleTimer, &pwmSampleISR, true);
+    timerAlarmWrite(pwmSampleTimer, PWM_SAMPLE_TIMER_TICKS, true);
+    timerAlarmEnable(pwmSampleTimer);
+    pwmRunning = true;
+}
+
+void stopPwmOutput() {
+    if (!pwmRunning) return;
+
+    pwmRunning = false;
+    timerAlarmDisable(pwmSampleTimer);
+    timerDetachInterrupt(pwmSampleTimer);
+    timerEnd(pwmSampleTimer);
+    pwmSampleTimer = NULL;
+
+    ledc_set_duty(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_0, PWM_MIDSCALE);
+    ledc_update_duty(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_0);
+}
+
+bool isPwmOutputRunning() {
+    return pwmRunning;
+}
+
+/**
+ * 빈 블록이 생길 때까지 대기 (렌더 태스크 전용)
+ * ISR이 블록 끝마다 태스크 알림을 보냄
+ */
+bool waitPwmBlock(uint32_t timeoutMs) {
+    if (!pwmRunning) {
+        vTaskDelay(pdMS_TO_TICKS(timeoutMs));
+        return false;
+    }
+
+    pwmWaiter = xTaskGetCurrentTaskHandle();
+    if (pwmRing.freeBlocks() == 0) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeoutMs));
+        pwmWakeups++;
+    }
+    return pwmRing.freeBlocks() > 0;
+}
+
+/**
+ * 렌더한 16비트 블록을 8비트로 재양자화해 제출
+ * 반환: 제때 제출했으면 true (늦었으면 ISR이 그 블록을 무음으로 재생)
+ */
+bool writePwmBlock(const int16_t* block) {
+    pwmShaper.processBlock(block, pwmBlocks[pwmRing.writeIndex()], pwmBlockSamples);
+
+    bool onTime = pwmRing.commit();
+    if (!onTime) {
+        tr808Log.log(TR808_LOG_PWM_UNDERRUN, pwmRing.getUnderruns());
+    }
+    return onTime;
+}
+
+uint32_t getPwmUnderruns() {
+    return pwmRing.getUnderruns();
+}
+
+/**
+ * 블록 크기 변경 (렌더 태스크 전용, 안전 지점에서만)
+ * 샘플 타이머를 멈춘 상태에서 바꾸고 무음 프리필로 재시작
+ */
+bool resizePwmOutput(uint16_t blockSamples) {
+    if (blockSamples == 0 || blockSamples > DMA_MAX_BLOCK_SAMPLES) return false;
+    if (blockSamples == pwmBlockSamples) return true;
+
+    bool wasRunning = pwmRunning;
+    stopPwmOutput();
+    pwmBlockSamples = blockSamples;
+    if (wasRunning) startPwmOutput();
+    return !wasRunning || pwmRunning;
+}
+
+// =============================================================================
+// 오디오 출력 함수 (즉시 출력, 테스트용)
 // =============================================================================
 
 void audioOutput(int16_t output) {
@@ -295,4 +460,12 @@ void printAudioOutputStatus() {
 #else
     DEBUG_PRINTLN("PWM Mode: Enabled");
 #endif
+    DEBUG_PRINTF("PWM Block Output: %s (%d blocks x %d samples, carrier %lu Hz, noise shaping order %d)\n",
+                 pwmRunning ? "Running" : "Stopped", PWM_OUTPUT_BLOCKS, pwmBlockSamples,
+                 (unsigned long)PWM_FREQUENCY, pwmShaper.getOrder());
+    DEBUG_PRINTF("PWM Blocks Completed: %lu, Wakeups: %lu\n",
+                 (unsigned long)pwmRing.getCompleted(), (unsigned long)pwmWakeups);
+    DEBUG_PRINTF("PWM Underrun Blocks: %lu (late commits %lu, silent %lu)\n",
+                 (unsigned long)pwmRing.getUnderruns(), (unsigned long)pwmRing.getLateCommits(),
+                 (unsigned long)pwmSilentBlocks);
 }
\ No newline at end of file
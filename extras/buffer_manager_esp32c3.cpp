@@ -3,11 +3,18 @@
  * 
  * 최적화된 원형 버퍼, 더블 버퍼링, 메모리 풀 관리
  * ESP32C3의 제한된 RAM을 효율적으로 활용
+ * 출력 블록 크기(지연)는 TR808LatencyController가 언더런/서비스 시간으로 조정
  */
 
 #include "mozzi_config.h"
 #include "esp_log.h"
 #include <string.h>
+#include "../src/tr808_latency_controller.h"
+#include "../src/tr808_log.h"
+#include "../src/tr808_arena.h"
+#include "../src/tr808_trace.h"
+
+void recordBufferOverflow();        // performance_monitor_esp32c3.cpp
 
 // =============================================================================
 // 버퍼 관리 전역 변수
@@ -34,11 +41,39 @@ static volatile size_t circularWriteIndex = 0;
 static volatile size_t circularReadIndex = 0;
 static volatile size_t circularCount = 0;
 
-// 메모리 풀 관리
-#define MEMORY_POOL_SIZE 4
+// 메모리 풀 관리 (블록은 시작 아레나에서)
+#define MEMORY_POOL_SIZE MOZZI_MEMORY_POOL_BLOCKS
 static int16_t* memoryPool[MEMORY_POOL_SIZE];
 static bool poolUsed[MEMORY_POOL_SIZE];
 
+// 시작 메모리 아레나 (MozziArenaSlot 순서, 이 빌드에서 쓰지 않는 항목은 0바이트)
+static constexpr TR808ArenaBudget mozziArenaBudget[MOZZI_ARENA_SLOT_COUNT] = {
+    {"render block", DMA_MAX_BLOCK_SAMPLES * sizeof(int16_t), 4},
+#ifdef AUDIO_OUTPUT_PWM
+    {"pwm blocks", PWM_OUTPUT_BLOCKS * DMA_MAX_BLOCK_SAMPLES, 4},
+#else
+    {"pwm blocks", 0, 4},
+#endif
+    {"memory pool", MEMORY_POOL_SIZE * MOZZI_OUTPUT_BUFFER_SIZE * sizeof(int16_t), 4},
+#ifdef TR808_TRACE
+    {"trace ring", TR808_TRACE_RECORDS * sizeof(TR808TraceRecord), 8},
+#else
+    {"trace ring", 0, 8},
+#endif
+};
+
+#define MOZZI_ARENA_BYTES tr808ArenaTotal(mozziArenaBudget, MOZZI_ARENA_SLOT_COUNT)
+static_assert(MOZZI_ARENA_BYTES <= TR808_ARENA_LIMIT_BYTES,
+              "Mozzi 아레나가 메모리 예산 초과 (TR808_ARENA_LIMIT_BYTES)");
+
+alignas(TR808_ARENA_STORAGE_ALIGN) static uint8_t mozziArenaStorage[MOZZI_ARENA_BYTES];
+static TR808Arena mozziArena;
+static void* arenaSlots[MOZZI_ARENA_SLOT_COUNT];
+static uint32_t sealedFreeHeap = 0;
+
+// 적응형 출력 지연 (렌더 태스크 전용)
+static TR808LatencyController latencyController;
+
 // =============================================================================
 // 템플릿 기반 최적화된 원형 버퍼
 // =============================================================================
@@ -142,6 +177,10 @@ void initializeBufferManager() {
     // 메모리 풀 초기화
     initializeMemoryPool();
     
+    // 출력 지연: 최소 블록에서 시작 (고정 모드면 최소=최대)
+    latencyController.begin(MOZZI_AUDIO_RATE, DMA_OUTPUT_BLOCKS,
+                            DMA_INITIAL_BLOCK_SAMPLES, DMA_MAX_BLOCK_SAMPLES);
+    
     DEBUG_PRINTLN("Buffer manager initialized successfully");
 }
 
@@ -312,6 +351,53 @@ void clearAudioCircularBuffer() {
     audioCircularBuffer.clear();
 }
 
+// =============================================================================
+// 시작 메모리 아레나
+// =============================================================================
+
+/**
+ * 예산 표 순서대로 모든 슬롯 할당 (ESP32C3Mozzi::initialize() 첫 단계, 한 번만)
+ * 각 모듈은 초기화 때 getArenaSlot()으로 자기 영역을 받음
+ */
+bool initializeMemoryArena() {
+    if (mozziArena.getCapacity() != 0) return true;
+    
+    mozziArena.begin(mozziArenaStorage, sizeof(mozziArenaStorage));
+    for (uint8_t slot = 0; slot < MOZZI_ARENA_SLOT_COUNT; slot++) {
+        arenaSlots[slot] = mozziArena.allocate(mozziArenaBudget[slot]);
+    }
+#ifdef TR808_TRACE
+    tr808Trace.begin((TR808TraceRecord*)arenaSlots[MOZZI_ARENA_TRACE_RING]);
+#endif
+    return mozziArena.getFailures() == 0;
+}
+
+void* getArenaSlot(uint8_t slot) {
+    return slot < MOZZI_ARENA_SLOT_COUNT ? arenaSlots[slot] : nullptr;
+}
+
+// 초기화 끝: 이후 할당 금지, 힙 기준점 기록
+void sealMemoryArena() {
+    mozziArena.seal();
+    sealedFreeHeap = ESP.getFreeHeap();
+}
+
+void printArenaReport() {
+    DEBUG_PRINTF("Startup Arena: %lu/%lu bytes (limit %lu), %s, %u failed allocations\n",
+                 (unsigned long)mozziArena.getUsed(), (unsigned long)mozziArena.getCapacity(),
+                 (unsigned long)TR808_ARENA_LIMIT_BYTES, mozziArena.isSealed() ? "sealed" : "open",
+                 (unsigned)mozziArena.getFailures());
+    for (uint8_t i = 0; i < mozziArena.getConsumerCount(); i++) {
+        const TR808ArenaConsumer& consumer = mozziArena.getConsumer(i);
+        DEBUG_PRINTF("  %-14s @%5lu %6lu bytes\n", consumer.name,
+                     (unsigned long)consumer.offset, (unsigned long)consumer.bytes);
+    }
+    if (mozziArena.isSealed()) {
+        DEBUG_PRINTF("Free Heap: %lu at seal -> %lu now\n",
+                     (unsigned long)sealedFreeHeap, (unsigned long)ESP.getFreeHeap());
+    }
+}
+
 // =============================================================================
 // 메모리 풀 관리
 // =============================================================================
@@ -319,8 +405,9 @@ void clearAudioCircularBuffer() {
 void initializeMemoryPool() {
     DEBUG_PRINTLN("Initializing audio memory pool...");
     
+    int16_t* poolStorage = (int16_t*)getArenaSlot(MOZZI_ARENA_MEMORY_POOL);
     for (int i = 0; i < MEMORY_POOL_SIZE; i++) {
-        memoryPool[i] = new int16_t[MOZZI_OUTPUT_BUFFER_SIZE];
+        memoryPool[i] = poolStorage != nullptr ? poolStorage + i * MOZZI_OUTPUT_BUFFER_SIZE : nullptr;
         poolUsed[i] = false;
         
         if (memoryPool[i] == nullptr) {
@@ -452,38 +539,86 @@ void analyzeBufferUsage() {
 // 버퍼 크기 동적 조정
 // =============================================================================
 
+/**
+ * 출력 블록 크기 요청 (수동)
+ * 2의 거듭제곱으로 올려 지연 컨트롤러에 넘기고, 렌더 태스크가 다음 무음 블록에서 적용
+ * 요청 후 일정 시간(TR808_LATENCY_HOLD_MS)은 자동으로 줄이지 않음
+ */
 void resizeAudioBuffer(size_t newSize) {
     if (newSize < 16 || newSize > 2048) {
         DEBUG_PRINTLN("ERROR: Invalid buffer size");
         return;
     }
     
-    DEBUG_PRINT("Resizing audio buffer to ");
+    DEBUG_PRINT("Requesting output block size ");
     DEBUG_PRINT(newSize);
     DEBUG_PRINTLN(" samples");
     
-    // 기존 버퍼 내용 보존
-    int16_t tempBuffer[MOZZI_OUTPUT_BUFFER_SIZE];
-    size_t currentSize = writeIndex;
-    
-    memcpy(tempBuffer, audioBuffer0, currentSize * sizeof(int16_t));
-    
-    // 새 크기로 버퍼 재할당 (필요시)
-    // 현재는 정적 할당 사용
-    
-    // 버퍼 내용 복원
-    writeIndex = min(currentSize, newSize);
-    memcpy(audioBuffer0, tempBuffer, writeIndex * sizeof(int16_t));
-    
-    DEBUG_PRINTLN("Audio buffer resized");
+    latencyController.requestSize((uint16_t)newSize);
+}
+
+// =============================================================================
+// 적응형 출력 지연
+// =============================================================================
+
+/**
+ * 블록 하나 제출 후 호출 (렌더 태스크)
+ * 반환: true면 getPendingBlockSamples()로 출력을 재설정한 뒤 confirmBlockResize() 호출
+ */
+bool updateAdaptiveLatency(uint32_t serviceUs, bool silent) {
+    return latencyController.onBlock(serviceUs, silent);
+}
+
+uint16_t getPendingBlockSamples() {
+    return latencyController.getPendingSamples();
+}
+
+void confirmBlockResize(bool resized) {
+    uint16_t previous = latencyController.getBlockSamples();
+    uint16_t target = latencyController.getPendingSamples();
+    if (!resized) {
+        // 재설정 실패: 요청을 버리고 현재 크기 유지 (다음 언더런이 다시 요청)
+        tr808Log.log(TR808_LOG_LATENCY_RESIZE_FAILED, target);
+        latencyController.requestSize(previous);
+        return;
+    }
+    latencyController.applyResize();
+    tr808Log.log(target > previous ? TR808_LOG_LATENCY_GROW : TR808_LOG_LATENCY_SHRINK,
+                 previous, target, latencyController.getLatencySamples());
+}
+
+uint16_t getAudioBlockSamples() {
+    return latencyController.getBlockSamples();
+}
+
+uint32_t getAudioLatencySamples() {
+    return latencyController.getLatencySamples();
+}
+
+uint32_t getAudioBlockPeriodUs() {
+    return latencyController.getBlockPeriodUs();
+}
+
+// 지연 범위 설정: 라이브 연주는 낮은 최소, 설치물은 최소=최대로 고정 (다음 안전 지점에 맞춤)
+void setAdaptiveLatencyLimits(uint16_t minSamples, uint16_t maxSamples) {
+    if (minSamples == 0 || maxSamples > DMA_MAX_BLOCK_SAMPLES) {
+        DEBUG_PRINTLN("ERROR: Invalid latency limits");
+        return;
+    }
+    latencyController.setLimits(minSamples, maxSamples);
 }
 
 // =============================================================================
 // 버퍼 오버플로우 처리
 // =============================================================================
 
+/**
+ * 출력 블록이 마감을 넘김 (렌더 태스크, 언더런 1회)
+ * 로그는 출력 백엔드가 남기므로 여기서는 집계 + 지연 키움 요청만
+ */
 void handleBufferOverflow() {
-    DEBUG_PRINTLN("WARNING: Buffer overflow detected");
+    recordBufferOverflow();
+    latencyController.onMiss();
     
     // 가장 오래된 샘플 버림
     if (circularCount > 0) {
@@ -539,6 +674,16 @@ void printBufferStatistics() {
     DEBUG_PRINT(audioCircularBuffer.full() ? "Yes" : "No");
     DEBUG_PRINT(" Empty: ");
     DEBUG_PRINTLN(audioCircularBuffer.empty() ? "Yes" : "No");
+    
+    DEBUG_PRINTF("Output Latency: %d samples/block x %d blocks = %lu samples (range %d-%d)\n",
+                 latencyController.getBlockSamples(), DMA_OUTPUT_BLOCKS,
+                 (unsigned long)latencyController.getLatencySamples(),
+                 latencyController.getMinSamples(), latencyController.getMaxSamples());
+    DEBUG_PRINTF("Latency Changes: %lu grows, %lu shrinks, %lu deadline misses\n",
+                 (unsigned long)latencyController.getGrows(), (unsigned long)latencyController.getShrinks(),
+                 (unsigned long)latencyController.getMisses());
+    
+    printArenaReport();
 }
 
 // =============================================================================
@@ -548,12 +693,9 @@ void printBufferStatistics() {
 void cleanupBufferManager() {
     DEBUG_PRINTLN("Cleaning up buffer manager...");
     
-    // 메모리 풀 정리
+    // 메모리 풀 정리 (아레나 영역이므로 해제 없이 사용 표시만 초기화)
     for (int i = 0; i < MEMORY_POOL_SIZE; i++) {
-        if (memoryPool[i] != nullptr) {
-            delete[] memoryPool[i];
-            memoryPool[i] = nullptr;
-        }
+        poolUsed[i] = false;
     }
     
     DEBUG_PRINTLN("Buffer manager cleanup completed");
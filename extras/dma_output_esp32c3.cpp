@@ -0,0 +1,309 @@
+/*
+ * ESP32C3 Mozzi Library DMA 블록 오디오 출력 구현
+ *
+ * 샘플마다 타이머 ISR에서 audioHook()을 부르던 구조를 I2S GDMA 블록 출력으로 대체
+ * - I2S 드라이버의 DMA 디스크립터 링(DMA_OUTPUT_BLOCKS개, 핑퐁)이 블록 단위로 출력
+ * - 디스크립터 EOF 인터럽트 = 블록 1개 완료 (2블록 링이면 링 절반 완료)
+ *   -> 드라이버 이벤트 큐(I2S_EVENT_TX_DONE)로 렌더 태스크를 깨워 빈 블록을 채움
+ * - 블록 장부(완료/제출/언더런)는 TR808DmaRing 공유 (호스트 모델: extras/host/dma_model.cpp)
+ * - 인터럽트: 64000회/초 -> 500회/초 (128샘플 블록), 컨트롤 갱신도 렌더 루프에서 샘플 수로 호출
+ * - 블록 크기는 런타임 값 (적응형 지연): 레거시 드라이버는 dma_buf_len을 설치 때만 받으므로
+ *   resizeDmaOutput()이 드라이버를 다시 설치 (무음 블록에서만 호출, buffer_manager_esp32c3.cpp)
+ *
+ * esp32c3_optimizations.h의 initialize_gdma()는 ESP-IDF에 없는 API(gdma_new_algorithm_group 등)를
+ * 사용하므로, I2S 주변장치에 연결된 GDMA 채널은 I2S 드라이버가 할당/연결하도록 둠
+ */
+
+#include "mozzi_config.h"
+#include "driver/i2s.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "../src/tr808_dma_ring.h"
+#include "../src/tr808_log.h"
+
+// =============================================================================
+// DMA 출력 전역 변수
+// =============================================================================
+
+static const char* TAG = "ESP32C3_DmaOutput";
+
+#define DMA_I2S_PORT I2S_NUM_0
+#define DMA_EVENT_QUEUE_SIZE (DMA_OUTPUT_BLOCKS * 2)
+
+static TR808DmaRing dmaRing;
+static QueueHandle_t dmaEvents = NULL;
+static TaskHandle_t renderTask = NULL;
+static volatile bool dmaInstalled = false;
+static volatile bool dmaRunning = false;
+static uint16_t dmaBlockSamples = DMA_INITIAL_BLOCK_SAMPLES;  // 현재 디스크립터 크기
+
+void startDmaOutput();
+
+// 성능 측정 변수
+static volatile uint32_t dmaWakeups = 0;          // 블록 완료 이벤트로 깨어난 횟수
+static volatile uint32_t dmaShortWrites = 0;      // 블록 전체를 쓰지 못한 횟수
+static volatile uint32_t dmaQueueOverflows = 0;   // 드라이버가 보고한 송신 큐 비움 (재생할 데이터 없음)
+
+// =============================================================================
+// DMA 출력 초기화
+// =============================================================================
+
+// 드라이버 설치 + 핀 연결, 출력은 정지 상태로 둠
+static bool installDmaDriver(uint16_t blockSamples) {
+    // 설정 경로는 필드 단위로 채움 (IDF 버전마다 구조체 필드 순서가 다름)
+    i2s_config_t i2s_config;
+    memset(&i2s_config, 0, sizeof(i2s_config));
+    i2s_config.mode = (i2s_mode_t)(I2S_MODE_MASTER | I2S_MODE_TX);
+    i2s_config.sample_rate = MOZZI_AUDIO_RATE;
+    i2s_config.bits_per_sample = I2S_BITS_PER_SAMPLE_16BIT;
+    i2s_config.channel_format = I2S_CHANNEL_FMT_ONLY_LEFT;
+    i2s_config.communication_format = I2S_COMM_FORMAT_STAND_I2S;
+    i2s_config.intr_alloc_flags = ESP_INTR_FLAG_LEVEL3;
+    i2s_config.dma_buf_count = DMA_OUTPUT_BLOCKS;
+    i2s_config.dma_buf_len = blockSamples;
+    i2s_config.use_apll = false;
+    i2s_config.tx_desc_auto_clear = true;               // 렌더가 늦으면 이전 블록 반복 대신 무음
+
+    i2s_pin_config_t pin_config;
+    memset(&pin_config, 0, sizeof(pin_config));
+    pin_config.mck_io_num = I2S_PIN_NO_CHANGE;
+    pin_config.bck_io_num = DMA_I2S_BCK_PIN;
+    pin_config.ws_io_num = DMA_I2S_WS_PIN;
+    pin_config.data_out_num = DMA_I2S_DATA_PIN;
+    pin_config.data_in_num = I2S_PIN_NO_CHANGE;
+
+    if (i2s_driver_install(DMA_I2S_PORT, &i2s_config, DMA_EVENT_QUEUE_SIZE, &dmaEvents) != ESP_OK) {
+        return false;
+    }
+    if (i2s_set_pin(DMA_I2S_PORT, &pin_config) != ESP_OK) {
+        i2s_driver_uninstall(DMA_I2S_PORT);
+        return false;
+    }
+
+    // 설치 직후 드라이버가 출력을 시작하므로 startDmaOutput()까지 정지
+    i2s_stop(DMA_I2S_PORT);
+    dmaBlockSamples = blockSamples;
+    return true;
+}
+
+static uint32_t dmaBlockPeriodUs() {
+    return (uint32_t)((uint64_t)dmaBlockSamples * 1000000ULL / MOZZI_AUDIO_RATE);
+}
+
+bool initializeDmaOutput() {
+    if (dmaInstalled) return true;
+    tr808Log.log(TR808_LOG_DMA_INIT);
+
+    if (!installDmaDriver(dmaBlockSamples)) {
+        tr808Log.log(TR808_LOG_DMA_INIT_FAILED);
+        return false;
+    }
+
+    dmaInstalled = true;
+    tr808Log.log(TR808_LOG_DMA_READY, DMA_OUTPUT_BLOCKS, dmaBlockSamples, dmaBlockPeriodUs());
+    return true;
+}
+
+/**
+ * 블록 크기 변경 (렌더 태스크 전용, 안전 지점에서만)
+ * 정지 -> 드라이버 재설치 -> 무음 프리필로 재시작, 재생 중이던 블록 꼬리만 잘림
+ * 실패하면 이전 크기로 되돌려 출력 유지
+ */
+bool resizeDmaOutput(uint16_t blockSamples) {
+    if (!dmaInstalled || blockSamples == 0 || blockSamples > DMA_MAX_BLOCK_SAMPLES) return false;
+    if (blockSamples == dmaBlockSamples) return true;
+
+    bool wasRunning = dmaRunning;
+    uint16_t previous = dmaBlockSamples;
+    dmaRunning = false;
+    i2s_stop(DMA_I2S_PORT);
+    i2s_driver_uninstall(DMA_I2S_PORT);
+
+    bool resized = installDmaDriver(blockSamples);
+    if (!resized && !installDmaDriver(previous)) {
+        dmaInstalled = false;
+        tr808Log.log(TR808_LOG_DMA_INIT_FAILED);
+        return false;
+    }
+    if (wasRunning) startDmaOutput();
+    return resized;
+}
+
+uint16_t getDmaBlockSamples() {
+    return dmaBlockSamples;
+}
+
+// =============================================================================
+// DMA 출력 시작/정지
+// =============================================================================
+
+void startDmaOutput() {
+    if (!dmaInstalled || dmaRunning) return;
+    tr808Log.log(TR808_LOG_DMA_START);
+
+    // 모든 디스크립터를 무음으로 채운 상태에서 시작 (프리필 = 블록 수)
+    i2s_zero_dma_buffer(DMA_I2S_PORT);
+    xQueueReset(dmaEvents);
+    dmaRing.begin(DMA_OUTPUT_BLOCKS, DMA_OUTPUT_BLOCKS);
+
+    i2s_start(DMA_I2S_PORT);
+    dmaRunning = true;
+}
+
+void stopDmaOutput() {
+    if (!dmaRunning) return;
+    tr808Log.log(TR808_LOG_DMA_STOP);
+
+    dmaRunning = false;
+    i2s_stop(DMA_I2S_PORT);
+}
+
+bool isDmaOutputRunning() {
+    return dmaRunning;
+}
+
+// =============================================================================
+// 블록 대기/제출 (렌더 태스크 전용)
+// =============================================================================
+
+/**
+ * 빈 블록이 생길 때까지 대기
+ * 밀린 완료 이벤트를 모두 반영한 뒤 판단: 늦게 깨어났으면 장부가 언더런으로 집계하고 재동기화
+ */
+bool waitDmaBlock(uint32_t timeoutMs) {
+    if (!dmaRunning) {
+        vTaskDelay(pdMS_TO_TICKS(timeoutMs));
+        return false;
+    }
+
+    TickType_t wait = dmaRing.freeBlocks() > 0 ? 0 : pdMS_TO_TICKS(timeoutMs);
+    i2s_event_t event;
+    while (xQueueReceive(dmaEvents, &event, wait) == pdTRUE) {
+        if (event.type == I2S_EVENT_TX_DONE) {
+            dmaRing.onBlockComplete();
+        } else if (event.type == I2S_EVENT_TX_Q_OVF) {
+            dmaQueueOverflows++;
+        }
+        if (wait != 0) {
+            dmaWakeups++;
+            wait = 0;  // 이후로는 큐에 남은 이벤트만 비움
+        }
+    }
+    return dmaRing.freeBlocks() > 0;
+}
+
+/**
+ * 렌더한 블록 제출 (빈 디스크립터로 복사, 대기 없음)
+ * 반환: 제때 블록 전체를 제출했으면 true
+ */
+bool writeDmaBlock(const int16_t* block) {
+    size_t bytesWritten = 0;
+    i2s_write(DMA_I2S_PORT, block, dmaBlockSamples * sizeof(int16_t), &bytesWritten, 0);
+
+    bool onTime = dmaRing.commit();
+    if (bytesWritten != dmaBlockSamples * sizeof(int16_t)) {
+        dmaShortWrites++;
+        onTime = false;
+    }
+    if (!onTime) {
+        tr808Log.log(TR808_LOG_DMA_UNDERRUN, dmaRing.getUnderruns(), (int32_t)bytesWritten);
+    }
+    return onTime;
+}
+
+// =============================================================================
+// 렌더 태스크
+// =============================================================================
+
+static void audioRenderTask(void* parameters) {
+    while (true) {
+        // 블록 완료 이벤트까지 대기 후 블록 하나 렌더/제출
+        audioHook();
+    }
+}
+
+bool startAudioRenderTask() {
+    if (renderTask != NULL) return true;
+
+    if (xTaskCreate(audioRenderTask, "mozzi_render", DMA_RENDER_TASK_STACK, NULL,
+                    DMA_RENDER_TASK_PRIORITY, &renderTask) != pdPASS) {
+        renderTask = NULL;
+        tr808Log.log(TR808_LOG_DMA_TASK_FAILED);
+        return false;
+    }
+    return true;
+}
+
+// =============================================================================
+// DMA 출력 상태
+// =============================================================================
+
+uint32_t getDmaUnderruns() {
+    return dmaRing.getUnderruns();
+}
+
+uint32_t getDmaBlocksCompleted() {
+    return dmaRing.getCompleted();
+}
+
+void printDmaOutputStatus() {
+    DEBUG_PRINTLN("=== ESP32C3 DMA Output Status ===");
+    DEBUG_PRINTF("DMA Output: %s\n", dmaRunning ? "Running" : "Stopped");
+    DEBUG_PRINTF("Render Task: %s\n", renderTask != NULL ? "Running" : "Not started");
+    DEBUG_PRINTF("Blocks: %d x %d samples (%lu us/block)\n",
+                 DMA_OUTPUT_BLOCKS, dmaBlockSamples, (unsigned long)dmaBlockPeriodUs());
+    DEBUG_PRINTF("Blocks Completed: %lu, Submitted: %lu\n",
+                 (unsigned long)dmaRing.getCompleted(), (unsigned long)dmaRing.getSubmitted());
+    DEBUG_PRINTF("Render Wakeups: %lu\n", (unsigned long)dmaWakeups);
+    DEBUG_PRINTF("Underrun Blocks: %lu (late commits %lu, short writes %lu, driver queue empty %lu)\n",
+                 (unsigned long)dmaRing.getUnderruns(), (unsigned long)dmaRing.getLateCommits(),
+                 (unsigned long)dmaShortWrites, (unsigned long)dmaQueueOverflows);
+}
+
+void resetDmaOutputCounters() {
+    dmaWakeups = 0;
+    dmaShortWrites = 0;
+    dmaQueueOverflows = 0;
+}
+
+// =============================================================================
+// 출력 주파수 검증
+// =============================================================================
+
+void validateAudioFrequency() {
+    DEBUG_PRINTLN("Validating audio frequency...");
+
+    // 블록 완료 수 x 블록 크기 = 실제 출력 샘플 수
+    const uint32_t testDurationMs = 1000;
+    uint32_t startTime = micros();
+    uint32_t startBlocks = dmaRing.getCompleted();
+
+    delay(testDurationMs);
+
+    uint32_t actualDuration = micros() - startTime;
+    uint32_t actualSamples = (dmaRing.getCompleted() - startBlocks) * dmaBlockSamples;
+    float actualRate = (float)actualSamples / (actualDuration / 1000000.0f);
+    float errorPercent = fabsf(actualRate - MOZZI_AUDIO_RATE) / MOZZI_AUDIO_RATE * 100.0f;
+
+    // 블록 단위 측정이라 1초 창에서 ±1블록(0.2%) 오차는 정상
+    DEBUG_PRINTF("Expected Rate: %d Hz, Actual Rate: %.1f Hz, Error: %.3f%%\n",
+                 MOZZI_AUDIO_RATE, actualRate, errorPercent);
+    if (errorPercent > 1.0f) {
+        DEBUG_PRINTLN("WARNING: Frequency error exceeds 1%");
+    } else {
+        DEBUG_PRINTLN("Frequency validation passed");
+    }
+}
+
+void debugDmaConfiguration() {
+    DEBUG_PRINTLN("=== DMA Output Configuration ===");
+    DEBUG_PRINTF("I2S Port: %d, Pins BCK %d / WS %d / DATA %d\n",
+                 DMA_I2S_PORT, DMA_I2S_BCK_PIN, DMA_I2S_WS_PIN, DMA_I2S_DATA_PIN);
+    DEBUG_PRINTF("Descriptor Ring: %d blocks x %d samples (max %d)\n",
+                 DMA_OUTPUT_BLOCKS, dmaBlockSamples, DMA_MAX_BLOCK_SAMPLES);
+    DEBUG_PRINTF("Render Deadline: %lu us (blocks - 1)\n",
+                 (unsigned long)(dmaBlockPeriodUs() * (DMA_OUTPUT_BLOCKS - 1)));
+    DEBUG_PRINTF("Control Update: every %d samples\n", CONTROL_UPDATE_SAMPLES);
+}
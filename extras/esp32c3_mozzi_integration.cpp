@@ -7,6 +7,8 @@
 
 #include "esp32c3_mozzi_integration.h"
 #include "esp_log.h"
+#include "../src/tr808_trace.h"
+#include "../src/tr808_placement.h"
 
 // =============================================================================
 // 전역 변수 및 상수
@@ -17,6 +19,30 @@ static const char* TAG = "ESP32C3_Mozzi";
 // 전역 시스템 인스턴스
 ESP32C3Mozzi mozziSystem;
 
+// 렌더 블록 (시작 아레나, initialize()에서 연결)
+static int16_t* renderBlock = nullptr;
+
+// 출력 백엔드 (I2S DMA 또는 LEDC PWM 블록 출력, 렌더 루프는 동일)
+#ifdef AUDIO_OUTPUT_PWM
+    #define initializeBlockOutput() initializePwmOutput()
+    #define startBlockOutput() startPwmOutput()
+    #define stopBlockOutput() stopPwmOutput()
+    #define isBlockOutputRunning() isPwmOutputRunning()
+    #define waitOutputBlock(timeoutMs) waitPwmBlock(timeoutMs)
+    #define writeOutputBlock(block) writePwmBlock(block)
+    #define resizeOutputBlock(samples) resizePwmOutput(samples)
+    #define getOutputUnderruns() getPwmUnderruns()
+#else
+    #define initializeBlockOutput() initializeDmaOutput()
+    #define startBlockOutput() startDmaOutput()
+    #define stopBlockOutput() stopDmaOutput()
+    #define isBlockOutputRunning() isDmaOutputRunning()
+    #define waitOutputBlock(timeoutMs) waitDmaBlock(timeoutMs)
+    #define writeOutputBlock(block) writeDmaBlock(block)
+    #define resizeOutputBlock(samples) resizeDmaOutput(samples)
+    #define getOutputUnderruns() getDmaUnderruns()
+#endif
+
 // =============================================================================
 // ESP32C3Mozzi 클래스 구현
 // =============================================================================
@@ -29,14 +55,21 @@ ESP32C3Mozzi::ESP32C3Mozzi()
 bool ESP32C3Mozzi::initialize() {
     DEBUG_PRINTLN("Initializing ESP32C3 Mozzi System...");
     
+    // 출력 블록/메모리 풀/트레이스 링을 시작 아레나에서 먼저 할당
+    if (!initializeMemoryArena()) {
+        DEBUG_PRINTLN("Failed to allocate startup arena");
+        return false;
+    }
+    renderBlock = (int16_t*)getArenaSlot(MOZZI_ARENA_RENDER_BLOCK);
+    
     // 각子系统 순차 초기화
     if (!initializeAudio()) {
         DEBUG_PRINTLN("Failed to initialize audio system");
         return false;
     }
     
-    if (!initializeTimers()) {
-        DEBUG_PRINTLN("Failed to initialize timer system");
+    if (!initializeOutput()) {
+        DEBUG_PRINTLN("Failed to initialize output system");
         return false;
     }
     
@@ -50,6 +83,9 @@ bool ESP32C3Mozzi::initialize() {
         // 성능 모니터링 실패는 치명적이지 않음
     }
     
+    // 이후 아레나 할당 금지 (오디오 경로는 힙을 쓰지 않음)
+    sealMemoryArena();
+    
     initialized = true;
     DEBUG_PRINTLN("ESP32C3 Mozzi System initialized successfully");
     
@@ -63,8 +99,11 @@ bool ESP32C3Mozzi::initializeAudio() {
     DEBUG_PRINTLN("Initializing audio system...");
     
     try {
-        // 오디오 출력 초기화
-        initializeAudioOutput();
+        // 오디오 출력 초기화 (I2S DMA 또는 PWM 블록 출력)
+        if (!initializeBlockOutput()) {
+            DEBUG_PRINTLN("Block output initialization failed");
+            return false;
+        }
         initializeAudioBuffers();
         
         DEBUG_PRINTLN("Audio system initialized");
@@ -76,23 +115,20 @@ bool ESP32C3Mozzi::initializeAudio() {
     }
 }
 
-bool ESP32C3Mozzi::initializeTimers() {
-    DEBUG_PRINTLN("Initializing timer system...");
+bool ESP32C3Mozzi::initializeOutput() {
+    DEBUG_PRINTLN("Initializing output system...");
     
-    try {
-        // 타이머 인터럽트 초기화
-        initializeTimerInterrupts();
-        
-        // 타이머 설정 검증
-        debugTimerConfiguration();
-        
-        DEBUG_PRINTLN("Timer system initialized");
-        return true;
-    }
-    catch (...) {
-        DEBUG_PRINTLN("Timer system initialization failed");
+    // 블록 완료 이벤트로 깨어나는 렌더 태스크 (출력 시작 전에는 대기만 함)
+    if (!startAudioRenderTask()) {
+        DEBUG_PRINTLN("Output system initialization failed");
         return false;
     }
+    
+    // DMA 설정 검증
+    debugDmaConfiguration();
+    
+    DEBUG_PRINTLN("Output system initialized");
+    return true;
 }
 
 bool ESP32C3Mozzi::initializeBuffers() {
@@ -144,16 +180,15 @@ bool ESP32C3Mozzi::startAudio() {
     DEBUG_PRINTLN("Starting audio system...");
     
     try {
-        // 타이머 시작
-        startAudioTimer();
-        startControlTimer();
+        // DMA 출력 시작 (무음 프리필 후 렌더 태스크가 블록 단위로 채움)
+        startBlockOutput();
         
         audioActive = true;
         DEBUG_PRINTLN("Audio system started");
         
         // 시작 상태 확인
-        if (!isAudioTimerRunning()) {
-            DEBUG_PRINTLN("WARNING: Audio timer not running");
+        if (!isBlockOutputRunning()) {
+            DEBUG_PRINTLN("WARNING: DMA output not running");
             audioActive = false;
             return false;
         }
@@ -171,9 +206,8 @@ bool ESP32C3Mozzi::stopAudio() {
     DEBUG_PRINTLN("Stopping audio system...");
     
     try {
-        // 타이머 정지
-        stopAudioTimer();
-        stopControlTimer();
+        // DMA 출력 정지 (렌더 태스크는 다음 시작까지 대기)
+        stopBlockOutput();
         
         audioActive = false;
         DEBUG_PRINTLN("Audio system stopped");
@@ -207,10 +241,10 @@ void ESP32C3Mozzi::printSystemStatus() {
     DEBUG_PRINTLN(performanceMonitoring ? "Active" : "Inactive");
     
     // 오디오 상태
-    DEBUG_PRINT("Audio Timer: ");
-    DEBUG_PRINTLN(isAudioTimerRunning() ? "Running" : "Stopped");
-    DEBUG_PRINT("Control Timer: ");
-    DEBUG_PRINTLN(isControlTimerRunning() ? "Running" : "Stopped");
+    DEBUG_PRINT("Block Output: ");
+    DEBUG_PRINTLN(isBlockOutputRunning() ? "Running" : "Stopped");
+    DEBUG_PRINT("Output Underruns: ");
+    DEBUG_PRINTLN(getOutputUnderruns());
     
     // 버퍼 상태
     DEBUG_PRINT("Audio Buffer: ");
@@ -239,11 +273,15 @@ void ESP32C3Mozzi::printBufferStatus() {
     analyzeBufferUsage();
 }
 
-void ESP32C3Mozzi::printTimerStatus() {
-    DEBUG_PRINTLN("=== Timer Status ===");
+void ESP32C3Mozzi::printOutputStatus() {
+    DEBUG_PRINTLN("=== Output Status ===");
     
-    printTimerPerformanceReport();
+#ifdef AUDIO_OUTPUT_PWM
+    printAudioOutputStatus();
+#else
+    printDmaOutputStatus();
     validateAudioFrequency();
+#endif
 }
 
 void ESP32C3Mozzi::printConfiguration() {
@@ -261,10 +299,16 @@ void ESP32C3Mozzi::printConfiguration() {
     DEBUG_PRINT(MOZZI_OUTPUT_BUFFER_SIZE);
     DEBUG_PRINTLN(" samples");
     
-    DEBUG_PRINT("Timer Interval: ");
-    DEBUG_PRINT(TIMER_INTERVAL_US);
+    DEBUG_PRINT("DMA Blocks: ");
+    DEBUG_PRINT(DMA_OUTPUT_BLOCKS);
+    DEBUG_PRINT(" x ");
+    DEBUG_PRINT(getAudioBlockPeriodUs());
     DEBUG_PRINTLN(" μs");
     
+    DEBUG_PRINT("Output Latency: ");
+    DEBUG_PRINT(getAudioLatencySamples());
+    DEBUG_PRINTLN(" samples");
+    
     DEBUG_PRINT("Platform: ");
 #ifdef PLATFORM_ESP32C3
     DEBUG_PRINTLN("ESP32C3");
@@ -272,11 +316,11 @@ void ESP32C3Mozzi::printConfiguration() {
     DEBUG_PRINTLN("Unknown");
 #endif
     
-    DEBUG_PRINT("Timer Interrupt: ");
-#ifdef ESP32C3_TIMER_INTERRUPT
-    DEBUG_PRINTLN("Enabled");
+    DEBUG_PRINT("Output: ");
+#ifdef AUDIO_OUTPUT_PWM
+    DEBUG_PRINTLN("LEDC PWM blocks (noise-shaped 8-bit, sample ISR reads ring)");
 #else
-    DEBUG_PRINTLN("Disabled");
+    DEBUG_PRINTLN("I2S DMA blocks (no per-sample ISR)");
 #endif
     
     DEBUG_PRINT("Performance Monitoring: ");
@@ -298,8 +342,8 @@ void ESP32C3Mozzi::runSelfTest() {
     DEBUG_PRINTLN("2. Audio System Test");
     runAudioTest();
     
-    // 3. 타이머 시스템 테스트
-    DEBUG_PRINTLN("3. Timer System Test");
+    // 3. 출력 시스템 테스트
+    DEBUG_PRINTLN("3. Output System Test");
     validateAudioFrequency();
     
     // 4. 버퍼 시스템 테스트
@@ -354,9 +398,9 @@ void ESP32C3Mozzi::validateConfiguration() {
         valid = false;
     }
     
-    // 타이머 설정 검증
-    if (TIMER_INTERVAL_US < 10) {
-        DEBUG_PRINTLN("ERROR: Timer interval too small");
+    // DMA 블록 설정 검증 (블록 주기 = 렌더 태스크의 최대 서비스 시간)
+    if (DMA_OUTPUT_BLOCKS < 2 || DMA_BLOCK_PERIOD_US < 500) {
+        DEBUG_PRINTLN("ERROR: DMA block period too small");
         valid = false;
     }
     
@@ -371,6 +415,7 @@ void ESP32C3Mozzi::resetAllCounters() {
     DEBUG_PRINTLN("Resetting all performance counters...");
     
     resetPerformanceCounters();
+    resetDmaOutputCounters();
     resetAudioBuffer();
     clearCircularBuffer();
     
@@ -384,8 +429,7 @@ void ESP32C3Mozzi::emergencyStop() {
     audioActive = false;
     performanceMonitoring = false;
     
-    stopAudioTimer();
-    stopControlTimer();
+    stopBlockOutput();
     
     DEBUG_PRINTLN("Emergency stop completed");
 }
@@ -393,7 +437,7 @@ void ESP32C3Mozzi::emergencyStop() {
 bool ESP32C3Mozzi::isSystemHealthy() {
     // 시스템 건강 상태 점검
     if (!initialized) return false;
-    if (!isAudioTimerRunning()) return false;
+    if (!isBlockOutputRunning()) return false;
     if (ESP.getFreeHeap() < 5000) return false; // 메모리 부족
     
     return true;
@@ -403,22 +447,53 @@ bool ESP32C3Mozzi::isSystemHealthy() {
 // 기본 콜백 함수 구현
 // =============================================================================
 
-void audioHook() {
+// 렌더 진입점: IRAM 배치 (updateAudio/updateControl 구현도 TR808_HOT 권장)
+void TR808_HOT audioHook() {
+    static uint16_t controlCountdown = 0;
+    
+    // 블록 완료(EOF) 이벤트까지 대기, 정지 중이면 타임아웃 후 복귀
+    if (!waitOutputBlock(DMA_WAIT_TIMEOUT_MS) || renderBlock == nullptr) return;
+    
+    // 현재 블록 크기 (적응형 지연: 안전 지점에서만 바뀜)
+    const uint16_t blockSamples = getAudioBlockSamples();
+    uint32_t serviceStart = micros();
+    int16_t blockPeak = 0;
+    
     // 성능 모니터링 시작
+    startBlockServiceTimer();
+    TR808_TRACE_EVENT(TR808_TRACE_RENDER_BEGIN, blockSamples);
     startAudioProcessingTimer();
     
-    // Mozzi 오디오 처리 로직이 여기에 들어감
-    // 예: Oscil, WaveShaper 등의 Mozzi 오브젝트들
+    // 블록 렌더: 컨트롤 갱신은 샘플 수로 분주 (별도 컨트롤 타이머 없음)
+    for (uint16_t i = 0; i < blockSamples; i++) {
+        if (controlCountdown == 0) {
+            updateControl();
+            controlCountdown = CONTROL_UPDATE_SAMPLES;
+        }
+        controlCountdown--;
+        int16_t sample = VALIDATE_AUDIO_SAMPLE(updateAudio());
+        renderBlock[i] = sample;
+        if (i == 0) markFirstOutputSample();
+        int16_t level = sample < 0 ? -(sample + 1) : sample;
+        if (level > blockPeak) blockPeak = level;
+    }
     
     // 성능 모니터링 끝
     endAudioProcessingTimer();
-    incrementAudioSampleCount();
+    TR808_TRACE_EVENT(TR808_TRACE_RENDER_END, blockSamples);
+    
+    bool onTime = writeOutputBlock(renderBlock);
+    endBlockServiceTimer();
+    incrementAudioSampleCount(blockSamples);
+    
+    // 언더런/서비스 시간을 지연 컨트롤러에 반영, 무음 블록이면 대기 중인 크기 변경 적용
+    if (!onTime) handleBufferOverflow();
+    if (updateAdaptiveLatency(micros() - serviceStart, blockPeak <= ADAPTIVE_SILENCE_THRESHOLD)) {
+        confirmBlockResize(resizeOutputBlock(getPendingBlockSamples()));
+    }
 }
 
-void updateControl() {
-    // Mozzi 제어 업데이트 로직
-    // 예: ControlChange, Random, ControlDelay 등
-}
+// updateControl() / updateAudio()는 스케치가 정의 (esp32c3_mozzi_integration.h, Mozzi 규약)
 
 // =============================================================================
 // Arduino 호환성 함수
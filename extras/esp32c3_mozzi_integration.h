@@ -34,19 +34,32 @@ void switchBuffer();
 void testAudioOutput();
 void printAudioOutputStatus();
 
-// TimerInterrupt.cpp 함수들
-void initializeTimerInterrupts();
-void startAudioTimer();
-void stopAudioTimer();
-void startControlTimer();
-void stopControlTimer();
-bool isAudioTimerRunning();
-bool isControlTimerRunning();
-void restartAudioTimer();
-void restartControlTimer();
+// DmaOutput.cpp 함수들
+bool initializeDmaOutput();
+void startDmaOutput();
+void stopDmaOutput();
+bool isDmaOutputRunning();
+bool waitDmaBlock(uint32_t timeoutMs);      // 빈 블록이 생길 때까지 대기 (렌더 태스크 전용)
+bool writeDmaBlock(const int16_t* block);   // 렌더한 블록 제출, 늦었으면 false
+bool startAudioRenderTask();
+uint32_t getDmaUnderruns();
+uint32_t getDmaBlocksCompleted();
 void validateAudioFrequency();
-void debugTimerConfiguration();
-void printTimerPerformanceReport();
+void debugDmaConfiguration();
+void printDmaOutputStatus();
+void resetDmaOutputCounters();
+bool resizeDmaOutput(uint16_t blockSamples);  // 드라이버 재설치 (안전 지점, 렌더 태스크 전용)
+uint16_t getDmaBlockSamples();
+
+// AudioOutput.cpp PWM 블록 출력 (AUDIO_OUTPUT_PWM)
+bool initializePwmOutput();
+void startPwmOutput();
+void stopPwmOutput();
+bool isPwmOutputRunning();
+bool waitPwmBlock(uint32_t timeoutMs);
+bool writePwmBlock(const int16_t* block);  // 16 -> 8비트 노이즈 셰이핑 후 제출
+uint32_t getPwmUnderruns();
+bool resizePwmOutput(uint16_t blockSamples);
 
 // BufferManager.cpp 함수들
 void initializeBufferManager();
@@ -61,16 +74,38 @@ bool isCircularBufferFull();
 bool isCircularBufferEmpty();
 void clearCircularBuffer();
 void printBufferStatistics();
+void handleBufferOverflow();
+void resizeAudioBuffer(size_t newSize);     // 블록 크기 요청 (2의 거듭제곱, 다음 안전 지점에 적용)
+// 적응형 지연 (렌더 태스크가 블록마다 호출)
+bool updateAdaptiveLatency(uint32_t serviceUs, bool silent);  // true면 지금 크기 변경
+uint16_t getPendingBlockSamples();
+void confirmBlockResize(bool resized);
+uint16_t getAudioBlockSamples();
+uint32_t getAudioLatencySamples();
+uint32_t getAudioBlockPeriodUs();
+void setAdaptiveLatencyLimits(uint16_t minSamples, uint16_t maxSamples);  // 최소=최대면 고정 지연
+
+// BufferManager.cpp 시작 메모리 아레나 (MozziArenaSlot, mozzi_config.h)
+bool initializeMemoryArena();
+void* getArenaSlot(uint8_t slot);
+void sealMemoryArena();
+void printArenaReport();
 
 // PerformanceMonitor.cpp 함수들
 void initializePerformanceMonitoring();
 void startAudioProcessingTimer();
 void endAudioProcessingTimer();
-void incrementAudioSampleCount();
-void startInterruptTimer();
-void endInterruptTimer();
+void incrementAudioSampleCount(uint32_t samples);
+void startBlockServiceTimer();
+void endBlockServiceTimer();
 void printPerformanceReport();
 void analyzeLatency();
+void markTriggerTime();             // 트리거 시각 기록 (드럼 트리거 경로에서 호출)
+void markFirstOutputSample();       // 블록 첫 샘플 렌더 직후 호출: 트리거 -> 첫 출력 샘플 지연 기록
+void printLatencyHistograms();
+// 세션 누적 지연 분포 (0: 블록 서비스, 1: 렌더, 2: 트리거->출력), 다른 구간/보드 스냅샷과 merge() 가능
+struct TR808HistogramSnapshot;
+const TR808HistogramSnapshot* getLatencyHistogram(uint8_t id);
 void runPerformanceBenchmark();
 void resetPerformanceCounters();
 void startPerformanceMonitoring();
@@ -92,7 +127,7 @@ public:
     // 초기화 함수들
     bool initialize();
     bool initializeAudio();
-    bool initializeTimers();
+    bool initializeOutput();
     bool initializeBuffers();
     bool initializePerformanceMonitoring();
     
@@ -110,7 +145,7 @@ public:
     void printSystemStatus();
     void printPerformanceReport();
     void printBufferStatus();
-    void printTimerStatus();
+    void printOutputStatus();
     void printConfiguration();
     
     // 테스트 함수들
@@ -138,7 +173,7 @@ extern ESP32C3Mozzi mozziSystem;
 // 시스템 초기화
 #define MOZZI_SYSTEM_INIT() mozziSystem.initialize()
 #define MOZZI_AUDIO_INIT() mozziSystem.initializeAudio()
-#define MOZZI_TIMER_INIT() mozziSystem.initializeTimers()
+#define MOZZI_OUTPUT_INIT() mozziSystem.initializeOutput()
 #define MOZZI_BUFFER_INIT() mozziSystem.initializeBuffers()
 #define MOZZI_PERF_INIT() mozziSystem.initializePerformanceMonitoring()
 
@@ -156,7 +191,7 @@ extern ESP32C3Mozzi mozziSystem;
 #define MOZZI_PRINT_STATUS() mozziSystem.printSystemStatus()
 #define MOZZI_PRINT_PERF() mozziSystem.printPerformanceReport()
 #define MOZZI_PRINT_BUFFERS() mozziSystem.printBufferStatus()
-#define MOZZI_PRINT_TIMERS() mozziSystem.printTimerStatus()
+#define MOZZI_PRINT_OUTPUT() mozziSystem.printOutputStatus()
 
 // 테스트
 #define MOZZI_SELF_TEST() mozziSystem.runSelfTest()
@@ -167,12 +202,15 @@ extern ESP32C3Mozzi mozziSystem;
 // 기본 제공 콜백 함수
 // =============================================================================
 
-// Mozzi에서 호출되는 오디오 훅 (기본 구현)
+// 렌더 태스크가 호출하는 오디오 훅: 블록 완료 대기 -> 블록 렌더 -> 제출 (기본 구현)
 void audioHook();
 
-// Mozzi에서 호출되는 제어 업데이트 (빈 구현)
+// Mozzi에서 호출되는 제어 업데이트 (스케치가 정의, CONTROL_UPDATE_SAMPLES마다)
 void updateControl();
 
+// Mozzi에서 호출되는 샘플 생성 (스케치가 정의, 샘플마다)
+int updateAudio();
+
 // =============================================================================
 // 예외 처리 및 디버깅
 // =============================================================================
@@ -180,7 +218,7 @@ void updateControl();
 // 오류 코드 정의
 #define MOZZI_ERROR_NONE 0
 #define MOZZI_ERROR_INIT_FAILED 1
-#define MOZZI_ERROR_TIMER_FAILED 2
+#define MOZZI_ERROR_OUTPUT_FAILED 2
 #define MOZZI_ERROR_BUFFER_FAILED 3
 #define MOZZI_ERROR_AUDIO_FAILED 4
 #define MOZZI_ERROR_MEMORY_FAILED 5
@@ -242,8 +280,7 @@ void setup() {
 }
 
 void loop() {
-    // Mozzi 오디오 처리
-    audioHook();
+    // 오디오는 렌더 태스크가 DMA 블록 완료마다 처리 (loop()에서 audioHook() 호출 불필요)
     
     // 주기적으로 상태 확인
     static uint32_t lastStatus = 0;
@@ -3,6 +3,7 @@
 #include <freertos/task.h>
 #include <freertos/semphr.h>
 #include <esp32/rom/ets_sys.h>
+#include "../src/tr808_arena.h"
 
 //==============================================================================
 // 전역 변수
@@ -13,6 +14,18 @@ static audio_buffer_t g_audio_output_buffer = {0};
 static volatile bool g_audio_processing_enabled = false;
 static TaskHandle_t g_audio_processing_task_handle = NULL;
 
+// 오디오 버퍼 시작 아레나 (예산 초과 시 빌드 실패)
+static constexpr TR808ArenaBudget g_audio_arena_budget[] = {
+    {"audio input", AUDIO_BLOCK_SIZE, DMA_ALIGNMENT},
+    {"audio output", AUDIO_BLOCK_SIZE, DMA_ALIGNMENT},
+};
+#define AUDIO_ARENA_SLOTS (sizeof(g_audio_arena_budget) / sizeof(g_audio_arena_budget[0]))
+#define AUDIO_ARENA_BYTES tr808ArenaTotal(g_audio_arena_budget, AUDIO_ARENA_SLOTS)
+static_assert(AUDIO_ARENA_BYTES <= TR808_ARENA_LIMIT_BYTES, "오디오 버퍼 아레나가 메모리 예산 초과");
+
+alignas(TR808_ARENA_STORAGE_ALIGN) static uint8_t g_audio_arena_storage[AUDIO_ARENA_BYTES];
+static TR808Arena g_audio_arena;
+
 //==============================================================================
 // 최적화된 오디오 처리 루프
 //==============================================================================
@@ -74,13 +87,14 @@ bool initialize_audio_processor() {
         return false;
     }
     
-    // 오디오 버퍼 초기화
-    if (!initialize_audio_buffer(&g_audio_input_buffer, AUDIO_BLOCK_SIZE)) {
+    // 오디오 버퍼 초기화 (아레나에서 표 순서대로, 재초기화 시 같은 자리 재사용)
+    g_audio_arena.begin(g_audio_arena_storage, sizeof(g_audio_arena_storage));
+    if (!initialize_audio_buffer(&g_audio_input_buffer, g_audio_arena.allocate(g_audio_arena_budget[0]), AUDIO_BLOCK_SIZE)) {
         Serial.println("입력 버퍼 초기화 실패");
         return false;
     }
     
-    if (!initialize_audio_buffer(&g_audio_output_buffer, AUDIO_BLOCK_SIZE)) {
+    if (!initialize_audio_buffer(&g_audio_output_buffer, g_audio_arena.allocate(g_audio_arena_budget[1]), AUDIO_BLOCK_SIZE)) {
         Serial.println("출력 버퍼 초기화 실패");
         return false;
     }
@@ -54,6 +54,7 @@ typedef struct {
     volatile uint32_t write_pos;
     volatile uint32_t read_pos;
     SemaphoreHandle_t mutex;
+    StaticSemaphore_t mutex_storage;    // 정적 뮤텍스 (힙 사용 없음)
     bool is_filled;
 } audio_buffer_t;
 
@@ -217,26 +218,24 @@ static inline bool initialize_timer_interrupt(timer_interrupt_config_t* config,
 /**
  * @brief 오디오 버퍼 초기화
  * @param buffer 오디오 버퍼 구조체 포인터
+ * @param storage 버퍼 저장소 (시작 아레나에서 DMA_ALIGNMENT 정렬로 할당, 힙 사용 없음)
  * @param size 버퍼 크기
  * @return bool 초기화 성공 여부
  */
-static inline bool initialize_audio_buffer(audio_buffer_t* buffer, size_t size) {
+static inline bool initialize_audio_buffer(audio_buffer_t* buffer, void* storage, size_t size) {
     buffer->buffer_size = size;
     buffer->write_pos = 0;
     buffer->read_pos = 0;
     buffer->is_filled = false;
     
-    // DMA 정렬된 버퍼 할당
-    buffer->audio_buffer = heap_caps_malloc_aligned(DMA_ALIGNMENT, size, MALLOC_CAP_8BIT | MALLOC_CAP_INTERNAL);
-    
-    if (buffer->audio_buffer == NULL) {
+    if (storage == NULL) {
         return false;
     }
+    buffer->audio_buffer = storage;
     
-    buffer->mutex = xSemaphoreCreateMutex();
+    buffer->mutex = xSemaphoreCreateMutexStatic(&buffer->mutex_storage);
     
     if (buffer->mutex == NULL) {
-        free(buffer->audio_buffer);
         return false;
     }
     
@@ -0,0 +1,171 @@
+/*
+ * 호스트 빌드용 ADSR 대체 헤더
+ *
+ * Mozzi ADSR과 같은 구조: update()가 컨트롤 틱 수로 단계를 넘기고,
+ * next()는 단계 목표 레벨까지 오디오 레이트로 선형 보간 (Line)
+ * - 시간 -> 컨트롤 스텝 변환은 Mozzi와 같은 (ms * rate) >> 10 근사
+ * - 레벨 타입 T = unsigned int면 16비트 레벨 (0-65535)
+ *
+ * 작성일: 2025-10-30
+ * 호환성: 호스트 (Mozzi 1.x/2.x API 부분 집합)
+ */
+
+#ifndef TR808_HOST_ADSR_H
+#define TR808_HOST_ADSR_H
+
+#include <stdint.h>
+
+/**
+ * 고정 소수점 선형 보간기 (Mozzi Line<unsigned int>와 같은 16비트 소수부)
+ */
+template <typename T>
+class Line {
+private:
+    int64_t current;    // 값 << 16
+    int64_t step;
+
+public:
+    Line() : current(0), step(0) {}
+
+    inline T next() {
+        current += step;
+        return (T)(current >> 16);
+    }
+
+    inline void set(T value) {
+        current = (int64_t)value << 16;
+        step = 0;
+    }
+
+    inline void set(T targetvalue, uint32_t num_steps) {
+        if (num_steps == 0) {
+            set(targetvalue);
+            return;
+        }
+        step = (((int64_t)targetvalue << 16) - current) / (int64_t)num_steps;
+    }
+};
+
+template <unsigned int CONTROL_UPDATE_RATE, unsigned int LERP_RATE, typename T = unsigned char>
+class ADSR {
+private:
+    enum { ATTACK, DECAY, SUSTAIN, RELEASE, IDLE };
+
+    struct phase {
+        uint8_t phase_type;
+        uint32_t update_steps;
+        uint32_t lerp_steps;
+        T level;
+    } attack, decay, sustain, release, idle;
+
+    const uint32_t LERPS_PER_CONTROL;
+    uint32_t update_step_counter;
+    uint32_t num_update_steps;
+    phase* current_phase;
+    Line<T> transition;
+    bool adsr_playing;
+
+    static inline uint32_t convertMsecToControlUpdateSteps(unsigned int msec) {
+        return (uint32_t)(((uint32_t)msec * CONTROL_UPDATE_RATE) >> 10);
+    }
+
+    inline void setPhase(phase* next_phase) {
+        update_step_counter = 0;
+        num_update_steps = next_phase->update_steps;
+        transition.set(next_phase->level, next_phase->lerp_steps);
+        current_phase = next_phase;
+    }
+
+    inline void checkForAndSetNextPhase(phase* next_phase) {
+        if (++update_step_counter >= num_update_steps) {
+            setPhase(next_phase);
+        }
+    }
+
+    inline void setTime(phase* p, unsigned int msec) {
+        p->update_steps = convertMsecToControlUpdateSteps(msec);
+        p->lerp_steps = p->update_steps * LERPS_PER_CONTROL;
+    }
+
+public:
+    ADSR() : LERPS_PER_CONTROL(LERP_RATE / CONTROL_UPDATE_RATE), update_step_counter(0),
+             num_update_steps(0), adsr_playing(false) {
+        attack.phase_type = ATTACK;
+        decay.phase_type = DECAY;
+        sustain.phase_type = SUSTAIN;
+        release.phase_type = RELEASE;
+        idle.phase_type = IDLE;
+        attack.level = decay.level = sustain.level = release.level = idle.level = 0;
+        attack.update_steps = decay.update_steps = sustain.update_steps = release.update_steps = 0;
+        attack.lerp_steps = decay.lerp_steps = sustain.lerp_steps = release.lerp_steps = 0;
+        idle.update_steps = idle.lerp_steps = 0;
+        current_phase = &idle;
+    }
+
+    // 컨트롤 레이트
+    void update() {
+        switch (current_phase->phase_type) {
+            case ATTACK:  checkForAndSetNextPhase(&decay); break;
+            case DECAY:   checkForAndSetNextPhase(&sustain); break;
+            case SUSTAIN: checkForAndSetNextPhase(&release); break;
+            case RELEASE: checkForAndSetNextPhase(&idle); break;
+            case IDLE:    adsr_playing = false; break;
+        }
+    }
+
+    // 오디오 레이트
+    inline T next() {
+        T out = 0;
+        if (adsr_playing) out = transition.next();
+        return out;
+    }
+
+    inline void noteOn(bool reset = false) {
+        if (reset) transition.set(0);
+        setPhase(&attack);
+        adsr_playing = true;
+    }
+
+    inline void noteOff() {
+        setPhase(&release);
+    }
+
+    inline void setAttackLevel(T value) { attack.level = value; }
+    inline void setDecayLevel(T value) { decay.level = value; }
+    inline void setSustainLevel(T value) { sustain.level = value; }
+    inline void setReleaseLevel(T value) { release.level = value; }
+    inline void setIdleLevel(T value) { idle.level = value; }
+
+    inline void setLevels(T attack_level, T decay_level, T sustain_level, T release_level) {
+        setAttackLevel(attack_level);
+        setDecayLevel(decay_level);
+        setSustainLevel(sustain_level);
+        setReleaseLevel(release_level);
+        setIdleLevel(0);
+    }
+
+    inline void setADLevels(T attack_level, T decay_level) {
+        setAttackLevel(attack_level);
+        setDecayLevel(decay_level);
+        setSustainLevel(decay_level);
+        setReleaseLevel(0);
+        setIdleLevel(0);
+    }
+
+    inline void setAttackTime(unsigned int msec) { setTime(&attack, msec); }
+    inline void setDecayTime(unsigned int msec) { setTime(&decay, msec); }
+    inline void setSustainTime(unsigned int msec) { setTime(&sustain, msec); }
+    inline void setReleaseTime(unsigned int msec) { setTime(&release, msec); }
+
+    inline void setTimes(unsigned int attack_ms, unsigned int decay_ms,
+                         unsigned int sustain_ms, unsigned int release_ms) {
+        setAttackTime(attack_ms);
+        setDecayTime(decay_ms);
+        setSustainTime(sustain_ms);
+        setReleaseTime(release_ms);
+    }
+
+    inline bool playing() const { return adsr_playing; }
+};
+
+#endif // TR808_HOST_ADSR_H
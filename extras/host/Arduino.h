@@ -0,0 +1,54 @@
+/*
+ * 호스트 빌드용 Arduino 최소 대체 헤더
+ *
+ * Mozzi 보이스(mozzi_tr808_drums.cpp)와 네이티브 엔진(tr808_drums.cpp)을
+ * 리눅스에서 컴파일/프로파일하기 위한 부분 구현
+ * - millis()/micros(): 단조 시계 기반, delayMicroseconds()는 바쁜 대기
+ * - IRAM_ATTR 등 배치 속성은 빈 매크로
+ *
+ * 작성일: 2025-10-30
+ * 호환성: 호스트 (g++ / clang++, C++11)
+ */
+
+#ifndef TR808_HOST_ARDUINO_H
+#define TR808_HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#define TR808_HOST_BUILD 1
+
+// 메모리 배치 속성 (호스트에서는 의미 없음)
+#define IRAM_ATTR
+#define DRAM_ATTR
+
+#ifndef PI
+#define PI 3.1415926535897932384626433832795
+#endif
+#ifndef TWO_PI
+#define TWO_PI 6.283185307179586476925286766559
+#endif
+
+typedef uint8_t byte;
+
+inline uint32_t micros() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000);
+}
+
+inline uint32_t millis() {
+    return micros() / 1000;
+}
+
+// 기기와 같은 블로킹 대기 (tr808_drums.cpp 클랩 트리거 등)
+inline void delayMicroseconds(uint32_t us) {
+    uint32_t start = micros();
+    while (micros() - start < us) {
+    }
+}
+
+#endif // TR808_HOST_ARDUINO_H
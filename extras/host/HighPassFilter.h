@@ -0,0 +1,15 @@
+/*
+ * 호스트 빌드용 HighPassFilter 대체 헤더 (Mozzi 2.x와 같은 별칭)
+ *
+ * 작성일: 2025-10-30
+ * 호환성: 호스트
+ */
+
+#ifndef TR808_HOST_HIGH_PASS_FILTER_H
+#define TR808_HOST_HIGH_PASS_FILTER_H
+
+#include "ResonantFilter.h"
+
+typedef ResonantFilter<HIGHPASS> HighPassFilter;
+
+#endif // TR808_HOST_HIGH_PASS_FILTER_H
@@ -0,0 +1,35 @@
+/*
+ * 호스트 빌드용 MozziGuts 대체 헤더
+ *
+ * 오디오/컨트롤 레이트 매크로만 제공 (오디오 출력과 타이머는 없음)
+ * 호스트 렌더러가 AUDIO_RATE 샘플마다 next(), CONTROL_RATE 주기로 update()를 호출
+ *
+ * 작성일: 2025-10-30
+ * 호환성: 호스트 (Mozzi 1.x/2.x API 부분 집합)
+ */
+
+#ifndef TR808_HOST_MOZZI_GUTS_H
+#define TR808_HOST_MOZZI_GUTS_H
+
+#include <Arduino.h>
+#include "mozzi_fixmath.h"
+
+#ifndef AUDIO_RATE
+    #if defined(MOZZI_AUDIO_RATE)
+        #define AUDIO_RATE MOZZI_AUDIO_RATE
+    #elif defined(TR808_SAMPLE_RATE)
+        #define AUDIO_RATE TR808_SAMPLE_RATE
+    #else
+        #define AUDIO_RATE 32768
+    #endif
+#endif
+
+#ifndef CONTROL_RATE
+    #if defined(MOZZI_CONTROL_RATE)
+        #define CONTROL_RATE MOZZI_CONTROL_RATE
+    #else
+        #define CONTROL_RATE 64     // Mozzi 기본값
+    #endif
+#endif
+
+#endif // TR808_HOST_MOZZI_GUTS_H
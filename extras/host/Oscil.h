@@ -0,0 +1,56 @@
+/*
+ * 호스트 빌드용 Oscil 대체 헤더
+ *
+ * Mozzi Oscil과 같은 위상 누산 방식 (16비트 소수부, 테이블 크기 마스크)
+ * next()는 위상을 먼저 증가시킨 뒤 테이블을 읽음 (Mozzi와 동일한 순서)
+ *
+ * 작성일: 2025-10-30
+ * 호환성: 호스트 (Mozzi 1.x/2.x API 부분 집합)
+ */
+
+#ifndef TR808_HOST_OSCIL_H
+#define TR808_HOST_OSCIL_H
+
+#include <stdint.h>
+
+#define OSCIL_F_BITS 16
+#define OSCIL_F_BITS_AS_MULTIPLIER 65536
+
+template <uint16_t NUM_TABLE_CELLS, uint16_t UPDATE_RATE>
+class Oscil {
+private:
+    const int8_t* table;
+    uint32_t phase_fractional;
+    uint32_t phase_increment_fractional;
+
+public:
+    Oscil(const int8_t* TABLE_NAME)
+        : table(TABLE_NAME), phase_fractional(0), phase_increment_fractional(0) {}
+
+    Oscil() : table(0), phase_fractional(0), phase_increment_fractional(0) {}
+
+    void setTable(const int8_t* TABLE_NAME) { table = TABLE_NAME; }
+
+    void setPhase(unsigned int phase) { phase_fractional = (uint32_t)phase << OSCIL_F_BITS; }
+
+    inline int8_t next() {
+        phase_fractional += phase_increment_fractional;
+        return table[(phase_fractional >> OSCIL_F_BITS) & (NUM_TABLE_CELLS - 1)];
+    }
+
+    // 정수 Hz
+    inline void setFreq(int frequency) {
+        phase_increment_fractional = ((uint32_t)frequency) *
+            ((OSCIL_F_BITS_AS_MULTIPLIER * (uint64_t)NUM_TABLE_CELLS) / UPDATE_RATE);
+    }
+
+    // 실수 Hz (설정용)
+    inline void setFreq(float frequency) {
+        phase_increment_fractional = (uint32_t)((((float)NUM_TABLE_CELLS * frequency) / UPDATE_RATE) *
+                                                OSCIL_F_BITS_AS_MULTIPLIER);
+    }
+
+    inline void setPhaseInc(uint32_t phaseinc_fractional) { phase_increment_fractional = phaseinc_fractional; }
+};
+
+#endif // TR808_HOST_OSCIL_H
@@ -0,0 +1,67 @@
+/*
+ * 호스트 빌드용 ResonantFilter 대체 헤더
+ *
+ * Mozzi ResonantFilter와 같은 2버퍼 상태변수 구조 (8비트 계수, >> 8 고정 소수점)
+ * - cutoff 0-255: 0 ~ 약 AUDIO_RATE/4 (Mozzi 문서의 0-8191Hz @ 16384Hz 와 같은 비율)
+ * - resonance 0-255
+ *
+ * 작성일: 2025-10-30
+ * 호환성: 호스트 (Mozzi 2.x API 부분 집합)
+ */
+
+#ifndef TR808_HOST_RESONANT_FILTER_H
+#define TR808_HOST_RESONANT_FILTER_H
+
+#include <stdint.h>
+
+enum filter_types { LOWPASS, BANDPASS, HIGHPASS, NOTCH };
+
+template <int8_t FILTER_TYPE, typename su = uint8_t>
+class ResonantFilter {
+private:
+    int32_t buf0, buf1;
+    su q, f;
+    uint32_t fb;
+
+    static const uint8_t FX_SHIFT = sizeof(su) << 3;
+    static const uint32_t SHIFTED_1 = (1UL << FX_SHIFT) - 1;
+
+    static inline int32_t ucfxmul(uint32_t a, uint32_t b) { return (int32_t)((a * b) >> FX_SHIFT); }
+    static inline int32_t fxmul(int32_t a, int32_t b) { return (int32_t)(((int64_t)a * b) >> FX_SHIFT); }
+
+    inline int32_t current(int32_t in) const {
+        switch (FILTER_TYPE) {
+            case LOWPASS:  return buf1;
+            case HIGHPASS: return in - buf0;
+            case BANDPASS: return buf0 - buf1;
+            default:       return in - buf0 + buf1;    // NOTCH
+        }
+    }
+
+public:
+    ResonantFilter() : buf0(0), buf1(0), q(0), f(0), fb(0) {}
+
+    void setCutoffFreq(su cutoff) {
+        f = cutoff;
+        fb = q + ucfxmul(q, SHIFTED_1 - cutoff);
+    }
+
+    void setResonance(su resonance) {
+        q = resonance;
+        fb = q + ucfxmul(q, SHIFTED_1 - f);
+    }
+
+    void setCutoffFreqAndResonance(su cutoff, su resonance) {
+        f = cutoff;
+        q = resonance;
+        fb = q + ucfxmul(q, SHIFTED_1 - cutoff);
+    }
+
+    inline int32_t next(int32_t in) {
+        buf0 += fxmul(((in - buf0) + fxmul((int32_t)fb, buf0 - buf1)), f);
+        buf1 += fxmul(buf0 - buf1, f);
+        return current(in);
+    }
+};
+
+#endif // TR808_HOST_RESONANT_FILTER_H
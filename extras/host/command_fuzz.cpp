@@ -0,0 +1,245 @@
+/*
+ * 명령 파서 호스트 퍼즈 테스트
+ *
+ * tr808_command_parser를 무작위 입력으로 두드려 메모리 오류와 불변식 위반을 검사
+ * - 토크나이저: 임의 바이트 줄 -> 토큰 수/길이/소문자/구분자 없음
+ * - 숫자 파서: 정수는 strtol, 실수는 strtod 결과와 비교
+ * - 해시 충돌: 알려진 명령마다 FNV-1a 해시가 같은 소문자 토큰을 실제로 만들어
+ *   (앞쪽 4글자 정방향 표 + 뒤쪽 4글자 역산, meet-in-the-middle)
+ *   matches()가 거부하는지 확인 - 해시만으로 분기하면 이 토큰이 명령을 실행함
+ * - AddressSanitizer/UBSan과 함께 빌드해 실행 (실패 시 종료 코드 1)
+ *
+ * 빌드:
+ *   g++ -std=c++11 -O1 -g -fsanitize=address,undefined -Isrc \
+ *       extras/host/command_fuzz.cpp src/tr808_command_parser.cpp -o command_fuzz
+ * 실행:
+ *   ./command_fuzz [반복 횟수] [시드]
+ *
+ * 작성일: 2025-10-30
+ * 호환성: 호스트 (g++ / clang++, C++11)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unordered_map>
+#include "tr808_command_parser.h"
+
+#define FUZZ_ITERATIONS   200000
+#define FUZZ_LINE_MAX     320       // 토큰 길이 255 초과 경로 포함
+#define HALF_LENGTH       4         // 앞/뒤 절반 글자 수 (26^4 = 456976 상태씩, 명령당 기대 충돌 ~48개)
+#define HALF_STATES       (26u * 26u * 26u * 26u)
+
+// 스케치/Mozzi 구현의 명령 및 하위 명령 이름
+static const char* const COMMAND_NAMES[] = {
+    "1", "kick", "2", "snare", "3", "cymbal", "4", "hihat", "5", "6", "tom",
+    "7", "conga", "8", "rimshot", "9", "maracas", "0", "clap", "c", "cowbell",
+    "help", "h", "status", "s", "config", "cfg", "perf", "p", "reset", "r",
+    "test", "t", "examples", "e", "bench", "trace", "memory", "mem", "engine",
+    "bpm", "play", "stop", "clock", "rate", "ctrl", "master",
+    "ext", "wcet", "square", "native", "mozzi",
+    "on", "off", "clear", "arm", "mark", "dump",
+    "?", "volume", "pattern_demo", "pattern_stop", "pattern_pause", "pattern_resume",
+    "list", "patterns", "benchmark", "version", "ver"
+};
+#define COMMAND_COUNT (sizeof(COMMAND_NAMES) / sizeof(COMMAND_NAMES[0]))
+
+static uint32_t failures = 0;
+static uint32_t rngState = 0x808u;
+
+static uint32_t nextRandom() {
+    // xorshift32
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return rngState;
+}
+
+static void fail(const char* what, const char* input) {
+    if (failures < 20) {
+        printf("  ✗ %s: \"%s\"\n", what, input);
+    }
+    failures++;
+}
+
+static bool isSeparator(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+// FNV 소수의 mod 2^32 역원 (뉴턴 반복)
+static uint32_t fnvPrimeInverse() {
+    uint32_t inverse = (uint32_t)TR808_FNV_PRIME;
+    for (int i = 0; i < 5; i++) {
+        inverse *= 2u - (uint32_t)TR808_FNV_PRIME * inverse;
+    }
+    return inverse;
+}
+
+// ================ 토크나이저 / 숫자 파서 ================
+
+static const char FUZZ_ALPHABET[] = "abcXYZ0123456789+-.eE \t\r\n_?";
+
+static void fuzzLine(char* line, char* copy) {
+    size_t length = nextRandom() % FUZZ_LINE_MAX;
+    bool printable = (nextRandom() & 3) != 0;
+    for (size_t i = 0; i < length; i++) {
+        uint32_t r = nextRandom();
+        line[i] = printable ? FUZZ_ALPHABET[r % (sizeof(FUZZ_ALPHABET) - 1)]
+                            : (char)(1 + r % 255);     // '\0' 제외 임의 바이트
+    }
+    line[length] = '\0';
+    memcpy(copy, line, length + 1);
+
+    TR808CommandTokens tokens;
+    uint8_t count = tokens.parse(line);
+    if (count != tokens.size() || count > TR808_CMD_MAX_TOKENS) {
+        fail("토큰 수", copy);
+        return;
+    }
+
+    for (uint8_t i = 0; i < count; i++) {
+        const char* token = tokens.get(i);
+        size_t actual = strlen(token);
+        size_t expected = actual > 255 ? 255 : actual;
+        if (actual == 0 || tokens.length(i) != expected) fail("토큰 길이", copy);
+        for (size_t k = 0; k < actual; k++) {
+            if (isSeparator(token[k]) || (token[k] >= 'A' && token[k] <= 'Z')) {
+                fail("토큰 문자", copy);
+                break;
+            }
+        }
+        if (tokens.length(i) < 255 && !tokens.matches(i, token)) fail("자기 자신 불일치", copy);
+
+        // 정수: strtol과 비교 (전체 토큰, 32비트 범위)
+        int32_t parsedInt;
+        char* end;
+        long long reference = strtoll(token, &end, 10);
+        // strtoll은 앞쪽 \v/\f 공백을 건너뛰므로 부호/숫자로 시작하는 토큰만 기준으로 사용
+        bool numeric = (token[0] >= '0' && token[0] <= '9') || token[0] == '+' || token[0] == '-';
+        bool referenceOk = numeric && end != token && *end == '\0' &&
+                           reference >= INT32_MIN && reference <= INT32_MAX;
+        bool parsedOk = tokens.getInt(i, &parsedInt);
+        if (parsedOk != referenceOk) fail("정수 성공 여부", copy);
+        if (parsedOk && referenceOk && parsedInt != reference) fail("정수 값", copy);
+
+        // 실수: 성공 시 strtod와 상대 오차 비교 (유효 9자리 + float 반올림)
+        float parsedFloat;
+        if (tokens.getFloat(i, &parsedFloat)) {
+            double expectedFloat = strtod(token, &end);
+            if (*end != '\0') {
+                fail("실수 형식", copy);
+            } else if (isfinite(expectedFloat) && fabs(expectedFloat) < 1e37 && fabs(expectedFloat) > 1e-36) {
+                if (fabs(parsedFloat - expectedFloat) > fabs(expectedFloat) * 1e-5) fail("실수 값", copy);
+            }
+        }
+    }
+
+    // 범위 밖 인덱스는 빈 토큰
+    if (tokens.get(count)[0] != '\0' || tokens.length(count) != 0 || tokens.matches(count, "")) {
+        fail("범위 밖 토큰", copy);
+    }
+}
+
+// ================ 해시 충돌 ================
+
+// 26진수 코드 -> 소문자 HALF_LENGTH 글자
+static void decodeHalf(uint32_t code, char* out) {
+    for (int k = HALF_LENGTH - 1; k >= 0; k--) {
+        out[k] = (char)('a' + code % 26);
+        code /= 26;
+    }
+}
+
+/**
+ * target 해시를 갖는 소문자 토큰 생성 (2 * HALF_LENGTH 글자)
+ * 앞쪽 절반의 모든 해시 상태 표(forward)에 대해, 뒤쪽 절반을 target에서
+ * 역산한 상태가 표에 있으면 두 절반을 이어 붙임
+ */
+static bool findCollision(const std::unordered_map<uint32_t, uint32_t>& forward,
+                          uint32_t target, char* out) {
+    static const uint32_t inverse = fnvPrimeInverse();
+    char suffix[HALF_LENGTH];
+    for (uint32_t code = 0; code < HALF_STATES; code++) {
+        decodeHalf(code, suffix);
+        uint32_t hash = target;
+        for (int k = HALF_LENGTH - 1; k >= 0; k--) {
+            hash = (hash * inverse) ^ (uint8_t)suffix[k];
+        }
+        std::unordered_map<uint32_t, uint32_t>::const_iterator hit = forward.find(hash);
+        if (hit == forward.end()) continue;
+
+        decodeHalf(hit->second, out);
+        memcpy(out + HALF_LENGTH, suffix, HALF_LENGTH);
+        out[2 * HALF_LENGTH] = '\0';
+        return true;
+    }
+    return false;
+}
+
+static void checkCollisions() {
+    std::unordered_map<uint32_t, uint32_t> forward;    // 앞쪽 절반 해시 -> 26진수 코드
+    forward.reserve(HALF_STATES);
+    char prefix[HALF_LENGTH];
+    for (uint32_t code = 0; code < HALF_STATES; code++) {
+        decodeHalf(code, prefix);
+        forward[tr808HashToken(prefix, HALF_LENGTH)] = code;
+    }
+
+    uint32_t found = 0;
+    for (size_t i = 0; i < COMMAND_COUNT; i++) {
+        const char* name = COMMAND_NAMES[i];
+        char collision[2 * HALF_LENGTH + 1];
+        if (!findCollision(forward, tr808Hash(name), collision)) {
+            printf("  - %s: 충돌 토큰을 찾지 못함\n", name);
+            continue;
+        }
+        found++;
+
+        char line[64];
+        snprintf(line, sizeof(line), "%s 1.0", collision);
+        TR808CommandTokens tokens;
+        tokens.parse(line);
+        if (tokens.commandHash() != tr808Hash(name)) fail("충돌 토큰 해시 불일치", collision);
+        if (tokens.matches(0, name)) fail("충돌 토큰이 명령으로 인식됨", collision);
+        for (size_t k = 0; k < COMMAND_COUNT; k++) {
+            if (tokens.matches(0, COMMAND_NAMES[k])) fail("충돌 토큰이 다른 명령과 일치", collision);
+        }
+        if (i < 4) printf("  %-8s 0x%08x <- \"%s\" (matches 거부)\n", name, tr808Hash(name), collision);
+    }
+    printf("  명령 %u개 중 %u개에 대해 해시 충돌 토큰 생성 및 거부 확인\n",
+           (unsigned)COMMAND_COUNT, (unsigned)found);
+    if (found != COMMAND_COUNT) failures++;
+
+    // 알려진 명령끼리는 해시가 모두 달라야 함 (스케치 switch의 case 중복 검사와 같은 조건)
+    for (size_t i = 0; i < COMMAND_COUNT; i++) {
+        for (size_t k = i + 1; k < COMMAND_COUNT; k++) {
+            if (strcmp(COMMAND_NAMES[i], COMMAND_NAMES[k]) != 0 &&
+                tr808Hash(COMMAND_NAMES[i]) == tr808Hash(COMMAND_NAMES[k])) {
+                fail("명령끼리 해시 충돌", COMMAND_NAMES[i]);
+            }
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    unsigned long iterations = argc > 1 ? strtoul(argv[1], NULL, 10) : FUZZ_ITERATIONS;
+    if (argc > 2) rngState = (uint32_t)strtoul(argv[2], NULL, 10) | 1u;
+
+    printf("토크나이저/숫자 파서 퍼즈: %lu줄 (시드 %u)\n", iterations, (unsigned)rngState);
+    static char line[FUZZ_LINE_MAX + 1];
+    static char copy[FUZZ_LINE_MAX + 1];
+    for (unsigned long i = 0; i < iterations; i++) {
+        fuzzLine(line, copy);
+    }
+
+    printf("해시 충돌 토큰 검사\n");
+    checkCollisions();
+
+    if (failures > 0) {
+        printf("실패 %u건\n", (unsigned)failures);
+        return 1;
+    }
+    printf("모두 통과\n");
+    return 0;
+}
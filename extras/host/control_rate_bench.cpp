@@ -0,0 +1,124 @@
+/*
+ * 네이티브 엔진 컨트롤 레이트 벤치마크 (호스트)
+ *
+ * 스케치의 'bench' 명령(benchmarkControlRate)과 같은 루프를 호스트에서 실행
+ * - 컨트롤 간격 N = 1/4/8/16/32마다 전체 보이스를 트리거하고 렌더해
+ *   ns/샘플과 N = 1 대비 속도 향상을 출력
+ * - 무음 보이스는 측정을 왜곡하므로(보이스가 바로 종료되면 렌더 비용도 사라짐)
+ *   같은 구간의 출력 RMS를 함께 출력하고, 보이스별 단독 렌더가 N = 1과 16에서
+ *   모두 소리를 내는지 확인 (RMS 비는 참고용: 엔벨롭이 micros() 기준이라
+ *   렌더 속도가 다른 N끼리는 같은 샘플 구간의 엔벨롭 위치가 다름, 특히 클랩)
+ * - 검증 실패 시 종료 코드 1
+ *
+ * 빌드:
+ *   g++ -std=c++11 -O2 -Iextras/host -Isrc extras/host/control_rate_bench.cpp \
+ *       src/tr808_drums.cpp -o control_rate_bench
+ * 실행:
+ *   ./control_rate_bench
+ *
+ * 작성일: 2025-10-30
+ * 호환성: 호스트 (g++ / clang++, C++11)
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include <chrono>
+#include "tr808_drums.h"
+
+#define BENCH_SAMPLES       2048    // CONTROL_BENCH_SAMPLES (TR808_ESP32C3.ino)
+#define BENCH_RUNS          31      // 최소값 채택 (스케줄링 잡음 제거)
+#define VOICE_COUNT         11      // TR808_VOICE_COUNT (닫힌/열린 하이햇 포함)
+#define SOUNDING_RMS        1e-3    // 이 값 미만이면 무음으로 판정
+
+static const uint8_t INTERVALS[] = { 1, 4, 8, 16, 32 };
+static const char* const VOICE_NAMES[VOICE_COUNT] = {
+    "kick", "snare", "cymbal", "hihat", "open hh", "tom",
+    "conga", "rimshot", "maracas", "clap", "cowbell"
+};
+
+static TR808DrumMachine engine;
+static uint32_t failures = 0;
+
+static void trigger(uint8_t voice) {
+    switch (voice) {
+        case 0:  engine.triggerKick(1.0f); break;
+        case 1:  engine.triggerSnare(1.0f); break;
+        case 2:  engine.triggerCymbal(1.0f); break;
+        case 3:  engine.triggerHiHat(1.0f, false); break;
+        case 4:  engine.triggerHiHat(1.0f, true); break;
+        case 5:  engine.triggerTom(1.0f); break;
+        case 6:  engine.triggerConga(1.0f); break;
+        case 7:  engine.triggerRimshot(1.0f); break;
+        case 8:  engine.triggerMaracas(1.0f); break;
+        case 9:  engine.triggerClap(1.0f); break;
+        case 10: engine.triggerCowbell(1.0f); break;
+    }
+}
+
+// BENCH_SAMPLES 렌더, 출력 RMS 반환 (nsPerSample에 ns/샘플)
+static double render(double* nsPerSample) {
+    double power = 0.0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < BENCH_SAMPLES; i++) {
+        float sample = engine.process();
+        power += (double)sample * sample;
+    }
+    *nsPerSample = std::chrono::duration<double, std::nano>(
+        std::chrono::steady_clock::now() - start).count() / BENCH_SAMPLES;
+    return sqrt(power / BENCH_SAMPLES);
+}
+
+// 보이스 단독 렌더 RMS (처음부터 BENCH_SAMPLES)
+static double soloRms(uint8_t voice, uint8_t interval) {
+    engine.setControlInterval(interval);
+    // 이전 보이스 꼬리를 비움
+    for (uint32_t i = 0; i < BENCH_SAMPLES * 8; i++) engine.process();
+    trigger(voice);
+    double ns;
+    return render(&ns);
+}
+
+int main() {
+    printf("컨트롤 레이트 벤치마크 (%d 샘플, 전체 보이스, 호스트 ns/샘플)\n", BENCH_SAMPLES);
+    printf("  %-5s %10s %10s %8s\n", "N", "ns/샘플", "출력 RMS", "향상");
+
+    double baseline = 0.0;
+    for (size_t n = 0; n < sizeof(INTERVALS); n++) {
+        engine.setControlInterval(INTERVALS[n]);
+        double best = 1e30, rms = 0.0;
+        for (int run = 0; run < BENCH_RUNS; run++) {
+            for (uint8_t voice = 0; voice < VOICE_COUNT; voice++) trigger(voice);
+            double ns;
+            double r = render(&ns);
+            if (ns < best) {
+                best = ns;
+                rms = r;
+            }
+        }
+        if (n == 0) baseline = best;
+        printf("  %-5u %10.1f %10.4f %7.2fx\n", INTERVALS[n], best, rms, baseline / best);
+        if (rms < SOUNDING_RMS) {
+            printf("  ✗ N=%u 출력이 무음 (보이스가 트리거 직후 종료)\n", INTERVALS[n]);
+            failures++;
+        }
+    }
+
+    printf("\n보이스별 단독 RMS (N=1 / N=16)\n");
+    for (uint8_t voice = 0; voice < VOICE_COUNT; voice++) {
+        double reference = soloRms(voice, 1);
+        double ramped = soloRms(voice, 16);
+        double ratio = reference > 0.0 ? ramped / reference : 0.0;
+        bool ok = reference >= SOUNDING_RMS && ramped >= SOUNDING_RMS;
+        printf("  %-8s %8.4f %8.4f  (%.2f) %s\n", VOICE_NAMES[voice], reference, ramped, ratio,
+               ok ? "" : "✗");
+        if (!ok) failures++;
+    }
+    engine.setControlInterval(TR808_CONTROL_INTERVAL);
+
+    if (failures > 0) {
+        printf("\n실패 %u건\n", (unsigned)failures);
+        return 1;
+    }
+    printf("\n모두 통과\n");
+    return 0;
+}
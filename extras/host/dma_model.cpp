@@ -0,0 +1,281 @@
+/*
+ * DMA 블록 출력 호스트 모델
+ *
+ * extras/dma_output_esp32c3.cpp의 핑퐁(블록 링) 출력을 이산 사건 시뮬레이션으로 재현해
+ * TR808DmaRing(src/tr808_dma_ring.h) 장부를 검증하고 블록 수/렌더 부하별 언더런을 비교
+ * - DMA 소비자: 샘플 클럭으로 블록을 차례로 재생, 재생 시작 시 슬롯 내용(블록 번호/제출 완료)을 확인
+ * - 블록 완료(EOF)마다 onBlockComplete() + 렌더 태스크 깨움 (깨움 지연 포함)
+ * - 렌더 태스크: 빈 블록이 있는 동안 렌더 (비용 = 블록 주기 x 부하, 가끔 스파이크)
+ * - 검증: 장부의 언더런 수 == 소비자가 실제로 무음/미완성 블록을 재생한 수 (다르면 종료 코드 1)
+ * - 샘플당 타이머 ISR 방식과 인터럽트 수/진입 오버헤드 비교
+ * - 적응형 지연: TR808LatencyController(src/tr808_latency_controller.h)가 부하 구간별로
+ *   블록 크기를 어떻게 바꾸는지, 고정 블록 대비 언더런/평균 지연 비교
+ *
+ * 빌드:
+ *   g++ -std=c++11 -O2 -Isrc extras/host/dma_model.cpp -o dma_model
+ * 실행:
+ *   ./dma_model
+ *
+ * 작성일: 2025-10-30
+ * 호환성: 호스트 (g++ / clang++, C++11)
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include "tr808_dma_ring.h"
+#include "tr808_latency_controller.h"
+
+#define MODEL_SAMPLE_RATE       64000   // extras/mozzi_config.h MOZZI_AUDIO_RATE
+#define MODEL_BLOCK_SAMPLES     128     // MOZZI_OUTPUT_BUFFER_SIZE
+#define MODEL_SECONDS           20
+#define MODEL_CPU_HZ            160000000UL
+#define MODEL_WAKE_NS           12000   // EOF 인터럽트 -> 렌더 태스크 실행 (ISR + 문맥 전환)
+#define MODEL_WAKE_JITTER_NS    20000   // 다른 태스크/인터럽트로 인한 추가 지연 상한
+#define MODEL_ISR_ENTRY_CYCLES  350     // 샘플당 ISR 방식: 진입/복귀 + micros() 2회 + 통계
+
+struct ModelSlot {
+    uint32_t block;     // 마지막으로 제출된 블록 번호
+    bool ready;         // 렌더 완료 (쓰는 중이면 false)
+};
+
+struct ModelResult {
+    uint32_t played;
+    uint32_t silent;        // 소비자가 본 무음/미완성 블록
+    uint32_t underruns;     // 장부 집계
+    uint32_t lateCommits;
+    uint32_t wakeups;
+    int64_t minSlackNs;     // 제출 시각 ~ 재생 시작 여유 최소값
+};
+
+// 결정적 의사 난수 (실행마다 같은 결과)
+static uint32_t modelRandom(uint32_t* state) {
+    *state = *state * 1664525u + 1013904223u;
+    return *state >> 8;
+}
+
+/**
+ * load: 평균 렌더 비용 / 블록 주기
+ * spikePermille: 블록당 스파이크 확률 (천분율), spikeScale: 스파이크 배율
+ */
+static ModelResult runModel(uint8_t blocks, float load, uint32_t spikePermille, float spikeScale) {
+    const int64_t blockNs = (int64_t)MODEL_BLOCK_SAMPLES * 1000000000LL / MODEL_SAMPLE_RATE;
+    const uint32_t totalBlocks = (uint32_t)((int64_t)MODEL_SECONDS * MODEL_SAMPLE_RATE / MODEL_BLOCK_SAMPLES);
+
+    TR808DmaRing ring;
+    ring.begin(blocks, blocks);
+
+    // 프리필: 무음 블록 0..blocks-1 제출 완료 상태
+    ModelSlot slots[TR808_DMA_MAX_BLOCKS];
+    for (uint8_t i = 0; i < blocks; i++) {
+        slots[i].block = i;
+        slots[i].ready = true;
+    }
+
+    ModelResult result = {0, 0, 0, 0, 0, INT64_MAX};
+    uint32_t seed = 12345;
+
+    int64_t nextEof = blockNs;          // 블록 0 재생 끝
+    bool busy = false;
+    int64_t busyUntil = 0;
+    uint32_t busyBlock = 0;
+    uint8_t busySlot = 0;
+    bool woken = false;
+    int64_t wakeAt = 0;
+
+    uint32_t played = 0;
+    result.played = 1;                  // 블록 0 재생 시작 (프리필)
+
+    while (played < totalBlocks) {
+        // 다음 사건: 렌더 완료 / 렌더 깨움 / DMA EOF
+        int64_t now;
+        if (busy && busyUntil <= nextEof) {
+            now = busyUntil;
+            ModelSlot& slot = slots[busySlot];
+            slot.block = busyBlock;
+            slot.ready = true;
+            ring.commit();
+            busy = false;
+
+            // 재생 시작까지 여유 (음수 = 늦음)
+            int64_t playStart = (int64_t)busyBlock * blockNs;
+            int64_t slack = playStart - now;
+            if (slack < result.minSlackNs) result.minSlackNs = slack;
+        } else if (!busy && woken && wakeAt <= nextEof) {
+            now = wakeAt;
+            woken = false;
+        } else {
+            // EOF: 블록 played 재생 끝, 다음 블록 재생 시작
+            now = nextEof;
+            ring.onBlockComplete();
+            played++;
+            nextEof += blockNs;
+
+            ModelSlot& slot = slots[played % blocks];
+            if (!(slot.ready && slot.block == played)) {
+                result.silent++;
+            }
+            result.played++;
+
+            // 블록 완료 인터럽트 -> 렌더 태스크 깨움
+            if (!busy && !woken) {
+                woken = true;
+                wakeAt = now + MODEL_WAKE_NS + modelRandom(&seed) % MODEL_WAKE_JITTER_NS;
+                result.wakeups++;
+            }
+            continue;
+        }
+
+        // 렌더 태스크 실행 중: 빈 블록이 있으면 바로 다음 블록 렌더
+        if (!busy && !woken && ring.freeBlocks() > 0) {
+            busyBlock = ring.nextBlock();
+            busySlot = ring.writeIndex();
+            slots[busySlot].ready = false;
+
+            float cost = load;
+            if (modelRandom(&seed) % 1000 < spikePermille) cost *= spikeScale;
+            busy = true;
+            busyUntil = now + (int64_t)(blockNs * cost);
+        }
+    }
+
+    // 마지막 EOF 이후 재생 시작한 블록은 판정 밖: 장부와 같은 범위로 비교
+    result.played--;
+    ring.freeBlocks();
+    result.underruns = ring.getUnderruns();
+    result.lateCommits = ring.getLateCommits();
+    return result;
+}
+
+// ============================================
+// 적응형 지연 시나리오
+// ============================================
+
+#define ADAPTIVE_SECONDS        90
+#define ADAPTIVE_MIN_BLOCK      32
+#define ADAPTIVE_MAX_BLOCK      512
+#define ADAPTIVE_HICCUP_US      420     // 가끔 끼어드는 고정 지연 (플래시 쓰기, 무선 등)
+
+struct AdaptiveResult {
+    uint32_t misses;
+    uint32_t grows;
+    uint32_t shrinks;
+    double avgLatencyMs;
+    uint16_t finalBlock;
+};
+
+// 구간별 샘플당 렌더 비용 (ns): 0~20초 한산, 20~50초 꽉 찬 패턴 + 잦은 끼어듦, 이후 다시 한산
+static uint32_t scenarioCostNs(uint32_t second) {
+    return (second >= 20 && second < 50) ? 11000 : 4000;
+}
+
+static uint32_t scenarioHiccupPermille(uint32_t second) {
+    return (second >= 20 && second < 50) ? 3 : 0;
+}
+
+/**
+ * 블록 단위 모델: 서비스 시간 = 깨어남 지연 + 렌더 비용 x 블록 크기 (+ 가끔 고정 지연)
+ * 마감(블록 수 - 1 주기)을 넘기면 언더런, 컨트롤러가 고른 크기는 무음 블록에서 적용
+ * fixedBlock != 0이면 컨트롤러 없이 고정 크기
+ */
+static AdaptiveResult runAdaptive(uint16_t fixedBlock, bool printEvents) {
+    TR808LatencyController controller;
+    uint16_t minBlock = fixedBlock ? fixedBlock : ADAPTIVE_MIN_BLOCK;
+    uint16_t maxBlock = fixedBlock ? fixedBlock : ADAPTIVE_MAX_BLOCK;
+    controller.begin(MODEL_SAMPLE_RATE, 2, minBlock, maxBlock);
+
+    AdaptiveResult result = {0, 0, 0, 0.0, 0};
+    uint32_t seed = 777;
+    uint64_t elapsedSamples = 0;
+    double latencyIntegral = 0.0;
+    const uint64_t totalSamples = (uint64_t)ADAPTIVE_SECONDS * MODEL_SAMPLE_RATE;
+
+    while (elapsedSamples < totalSamples) {
+        uint16_t block = controller.getBlockSamples();
+        uint32_t second = (uint32_t)(elapsedSamples / MODEL_SAMPLE_RATE);
+
+        uint32_t serviceNs = MODEL_WAKE_NS + modelRandom(&seed) % MODEL_WAKE_JITTER_NS +
+                             scenarioCostNs(second) * block;
+        if (modelRandom(&seed) % 1000 < scenarioHiccupPermille(second)) {
+            serviceNs += ADAPTIVE_HICCUP_US * 1000;
+        }
+        uint32_t serviceUs = serviceNs / 1000;
+
+        if (serviceUs > controller.getDeadlineUs()) {
+            result.misses++;
+            controller.onMiss();
+        }
+
+        // 드럼 패턴: 블록 약 3개 중 1개는 무음 (히트 사이)
+        bool silent = modelRandom(&seed) % 3 == 0;
+        if (controller.onBlock(serviceUs, silent)) {
+            uint16_t next = controller.getPendingSamples();
+            if (printEvents) {
+                printf("  %6.2fs  %4u -> %4u 샘플  (%s)\n",
+                       (double)elapsedSamples / MODEL_SAMPLE_RATE, block, next,
+                       next > block ? "키움" : "줄임");
+            }
+            controller.applyResize();
+        }
+
+        elapsedSamples += block;
+        latencyIntegral += (double)controller.getLatencySamples() * block;
+    }
+
+    result.grows = controller.getGrows();
+    result.shrinks = controller.getShrinks();
+    result.avgLatencyMs = latencyIntegral / elapsedSamples * 1000.0 / MODEL_SAMPLE_RATE;
+    result.finalBlock = controller.getBlockSamples();
+    return result;
+}
+
+static void printAdaptiveComparison() {
+    printf("\n적응형 지연 (%d초: 0~20s 한산 / 20~50s 고부하 + %dus 끼어듦 / 이후 한산, 2블록)\n",
+           ADAPTIVE_SECONDS, ADAPTIVE_HICCUP_US);
+    AdaptiveResult adaptive = runAdaptive(0, true);
+
+    printf("\n  %-14s %8s %10s %6s %6s\n", "", "언더런", "평균 지연", "키움", "줄임");
+    printf("  %-14s %8lu %8.2fms %6lu %6lu\n", "적응형 32~512", (unsigned long)adaptive.misses,
+           adaptive.avgLatencyMs, (unsigned long)adaptive.grows, (unsigned long)adaptive.shrinks);
+
+    static const uint16_t fixedBlocks[] = {32, 64, 128, 256};
+    for (uint8_t i = 0; i < sizeof(fixedBlocks) / sizeof(fixedBlocks[0]); i++) {
+        AdaptiveResult fixed = runAdaptive(fixedBlocks[i], false);
+        char label[24];
+        snprintf(label, sizeof(label), "고정 %u", fixedBlocks[i]);
+        printf("  %-14s %8lu %8.2fms %6s %6s\n", label, (unsigned long)fixed.misses,
+               fixed.avgLatencyMs, "-", "-");
+    }
+}
+
+int main() {
+    const float blockUs = MODEL_BLOCK_SAMPLES * 1000000.0f / MODEL_SAMPLE_RATE;
+    printf("DMA 블록 출력 모델: %d Hz, 블록 %d샘플 (%.0f us), %d초\n",
+           MODEL_SAMPLE_RATE, MODEL_BLOCK_SAMPLES, blockUs, MODEL_SECONDS);
+
+    // 인터럽트 부담 비교
+    float isrLoad = (float)MODEL_SAMPLE_RATE * MODEL_ISR_ENTRY_CYCLES / MODEL_CPU_HZ * 100.0f;
+    float dmaLoad = (float)MODEL_SAMPLE_RATE / MODEL_BLOCK_SAMPLES * MODEL_ISR_ENTRY_CYCLES / MODEL_CPU_HZ * 100.0f;
+    printf("인터럽트: 샘플당 타이머 %d/s (진입 오버헤드 %.1f%% CPU) -> 블록 EOF %d/s (%.2f%% CPU)\n\n",
+           MODEL_SAMPLE_RATE, isrLoad, MODEL_SAMPLE_RATE / MODEL_BLOCK_SAMPLES, dmaLoad);
+
+    static const uint8_t blockCounts[] = {2, 3, 4};
+    static const float loads[] = {0.50f, 0.80f, 0.95f};
+
+    printf("블록  부하  스파이크   재생   무음  장부 언더런  늦은 제출  최소 여유(us)\n");
+    bool consistent = true;
+    for (uint8_t b = 0; b < sizeof(blockCounts); b++) {
+        for (uint8_t l = 0; l < sizeof(loads) / sizeof(loads[0]); l++) {
+            ModelResult r = runModel(blockCounts[b], loads[l], 5, 1.8f);
+            printf("%4u  %3.0f%%  0.5%%x1.8  %6lu %6lu %12lu %10lu %14.1f\n",
+                   blockCounts[b], loads[l] * 100.0f, (unsigned long)r.played,
+                   (unsigned long)r.silent, (unsigned long)r.underruns,
+                   (unsigned long)r.lateCommits, r.minSlackNs / 1000.0);
+            if (r.silent != r.underruns) consistent = false;
+        }
+    }
+
+    printf("\n장부 검증: %s\n", consistent ? "언더런 집계 = 실제 무음 블록" : "불일치!");
+
+    printAdaptiveComparison();
+    return consistent ? 0 : 1;
+}
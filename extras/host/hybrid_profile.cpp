@@ -0,0 +1,153 @@
+/*
+ * 하이브리드 엔진 호스트 프로파일러
+ *
+ * 네이티브(tr808_drums.cpp)와 Mozzi(mozzi_tr808_drums.cpp) 보이스를 함께 빌드해
+ * 드럼별 백엔드 비용과 하이브리드 구성이 전체 네이티브 대비 줄이는 비용을 출력
+ * - 드럼별: 네이티브/Mozzi 단독 렌더 ns/샘플 (유휴 엔진 비용 차감)과 출력 피크
+ *   (거의 무음인 보이스는 일찍 끝나거나 가벼워 보여 비용 비교를 왜곡하므로 레벨을 함께 표시)
+ * - 믹스: 킥+스네어+심벌+하이햇 동시 재생, 전체 네이티브 vs 기본 구성(킥/스네어 네이티브,
+ *   심벌/하이햇 Mozzi) vs 전체 Mozzi
+ * - 기본 구성에서 Mozzi로 가는 보이스는 네이티브와 피크가 1dB 이내여야 함 (아니면 종료 코드 1:
+ *   레벨이 다르면 절감이 아니라 음량 차이를 잰 것, TR808_HYBRID_MOZZI_*_LEVEL 재조정)
+ * - 호스트 수치는 상대 비교용: 호스트는 FPU가 있어 float 보이스가 싸게 나옴
+ *   (FPU 없는 ESP32C3에서는 격차가 더 큼, 기기 사이클은 스케치의 'engine bench' 명령)
+ *
+ * 빌드:
+ *   g++ -std=c++11 -O2 -Iextras/host -Isrc extras/host/hybrid_profile.cpp \
+ *       src/tr808_hybrid.cpp src/tr808_drums.cpp src/mozzi_tr808_drums.cpp \
+ *       src/tr808_wavetable.cpp src/tr808_perf_monitor.cpp -o hybrid_profile
+ * 실행:
+ *   ./hybrid_profile
+ *
+ * 작성일: 2025-10-30
+ * 호환성: 호스트 (g++ / clang++, C++11)
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include <chrono>
+#include "tr808_hybrid.h"
+
+#define PROFILE_SAMPLES  16384
+#define PROFILE_RUNS     15     // 최소값 채택 (스케줄링 잡음 제거)
+#define LEVEL_PACE_BLOCK 32     // 레벨 측정 렌더를 실시간에 맞추는 블록 (샘플, 2의 거듭제곱)
+#define LEVEL_MATCH_DB   1.0f   // 기본 구성 Mozzi 보이스의 네이티브 대비 피크 허용 차
+
+// profile() 인스턴스 자리 (기기에서는 시작 아레나가 제공)
+alignas(16) static uint8_t profileScratch[TR808_HYBRID_PROFILE_SCRATCH_BYTES];
+
+static const uint8_t PROFILE_VOICES[4] = {
+    TR808_VOICE_KICK, TR808_VOICE_SNARE, TR808_VOICE_CYMBAL, TR808_VOICE_HIHAT_CLOSED
+};
+static const char* const PROFILE_NAMES[4] = {"kick", "snare", "cymbal", "hihat"};
+
+static uint32_t nanoCounter() {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void fillRouting(uint8_t* routing, TR808Backend backend) {
+    for (uint8_t voice = 0; voice < TR808_VOICE_COUNT; voice++) {
+        routing[voice] = tr808HasMozziVoice(voice) ? backend : TR808_BACKEND_NATIVE;
+    }
+}
+
+// 같은 구성으로 렌더한 출력 피크 (-1.0 ~ 1.0 스케일, 짧은 보이스도 창 길이와 무관하게 비교)
+// 새 인스턴스 사용: 네이티브 엔벨롭은 micros() 기준이라 이전 렌더의 꼬리가 샘플 수로는 비워지지 않음
+// 같은 이유로 실시간 속도로 렌더 (빠르게 렌더하면 네이티브 엔벨롭이 어택 구간에 머묾)
+static float levelOf(const uint8_t* routing, uint32_t voiceMask) {
+    TR808DrumMachine* engine = new TR808DrumMachine();
+    TR808HybridMixer* mixer = new TR808HybridMixer(*engine);
+    mixer->begin();
+    for (uint8_t voice = 0; voice < TR808_VOICE_COUNT; voice++) {
+        if (tr808HasMozziVoice(voice)) mixer->setBackend(voice, (TR808Backend)routing[voice]);
+    }
+    for (uint8_t voice = 0; voice < TR808_VOICE_COUNT; voice++) {
+        if (voiceMask & TR808_VOICE_BIT(voice)) mixer->trigger(voice, 1.0f);
+    }
+    float peak = 0.0f;
+    uint32_t start = micros();
+    for (uint32_t i = 0; i < PROFILE_SAMPLES; i++) {
+        float sample = mixer->process();
+        if (fabsf(sample) > peak) peak = fabsf(sample);
+        if ((i & (LEVEL_PACE_BLOCK - 1)) == LEVEL_PACE_BLOCK - 1) {
+            uint32_t due = (uint32_t)((uint64_t)(i + 1) * 1000000ULL / MOZZI_TR808_AUDIO_RATE);
+            while (micros() - start < due) {
+            }
+        }
+    }
+    delete mixer;
+    delete engine;
+    return peak;
+}
+
+static uint32_t measure(const uint8_t* routing, uint32_t voiceMask) {
+    uint32_t best = 0xFFFFFFFF;
+    for (int run = 0; run < PROFILE_RUNS; run++) {
+        uint32_t ns = TR808HybridMixer::profile(routing, voiceMask, PROFILE_SAMPLES, nanoCounter);
+        if (ns < best) best = ns;
+    }
+    return best;
+}
+
+int main() {
+    uint8_t allNative[TR808_VOICE_COUNT];
+    uint8_t allMozzi[TR808_VOICE_COUNT];
+    uint8_t hybrid[TR808_VOICE_COUNT];
+    fillRouting(allNative, TR808_BACKEND_NATIVE);
+    fillRouting(allMozzi, TR808_BACKEND_MOZZI);
+    TR808HybridMixer::setProfileScratch(profileScratch);
+
+    // 기본 하이브리드 구성 (TR808HybridMixer::begin()과 동일)
+    TR808DrumMachine engine;
+    TR808HybridMixer defaults(engine);
+    defaults.begin();
+    for (uint8_t voice = 0; voice < TR808_VOICE_COUNT; voice++) {
+        hybrid[voice] = defaults.getBackend(voice);
+    }
+
+    printf("하이브리드 프로파일: %u Hz, %d 샘플, 최소 %d회 (ns/샘플)\n",
+           (unsigned)MOZZI_TR808_AUDIO_RATE, PROFILE_SAMPLES, PROFILE_RUNS);
+
+    uint32_t idleNative = measure(allNative, 0);
+    uint32_t idleMozzi = measure(allMozzi, 0);
+    printf("%-8s %8s %8s %10s %10s %9s\n", "voice", "native", "mozzi", "native 피크", "mozzi 피크", "차이");
+    printf("%-8s %8u %8u\n", "idle", (unsigned)idleNative, (unsigned)idleMozzi);
+
+    uint32_t mixMask = 0;
+    int mismatched = 0;
+    for (int i = 0; i < 4; i++) {
+        uint32_t mask = TR808_VOICE_BIT(PROFILE_VOICES[i]);
+        mixMask |= mask;
+        uint32_t nativeNs = measure(allNative, mask);
+        uint32_t mozziNs = measure(allMozzi, mask);
+        float nativePeak = levelOf(allNative, mask);
+        float mozziPeak = levelOf(allMozzi, mask);
+        float diffDb = 20.0f * log10f(fmaxf(mozziPeak, 1e-6f) / fmaxf(nativePeak, 1e-6f));
+        bool routed = hybrid[PROFILE_VOICES[i]] == TR808_BACKEND_MOZZI;
+        printf("%-8s %8d %8d %10.4f %10.4f %+6.1f dB   (기본: %s)\n", PROFILE_NAMES[i],
+               (int)(nativeNs - idleNative), (int)(mozziNs - idleMozzi),
+               nativePeak, mozziPeak, diffDb, routed ? "mozzi" : "native");
+        if (routed && fabsf(diffDb) > LEVEL_MATCH_DB) mismatched++;
+    }
+
+    uint32_t nativeMix = measure(allNative, mixMask);
+    uint32_t hybridMix = measure(hybrid, mixMask);
+    uint32_t mozziMix = measure(allMozzi, mixMask);
+    printf("\n4보이스 믹스\n");
+    printf("  전체 네이티브 %6u ns/샘플                피크 %.4f\n", (unsigned)nativeMix,
+           levelOf(allNative, mixMask));
+    printf("  기본 구성     %6u ns/샘플  (절감 %5.1f%%)  피크 %.4f\n", (unsigned)hybridMix,
+           nativeMix > 0 ? 100.0f * ((float)nativeMix - hybridMix) / nativeMix : 0.0f,
+           levelOf(hybrid, mixMask));
+    printf("  전체 Mozzi    %6u ns/샘플  (절감 %5.1f%%)  피크 %.4f\n", (unsigned)mozziMix,
+           nativeMix > 0 ? 100.0f * ((float)nativeMix - mozziMix) / nativeMix : 0.0f,
+           levelOf(allMozzi, mixMask));
+
+    if (mismatched > 0) {
+        printf("\n✗ 기본 구성의 Mozzi 보이스 %d개가 네이티브와 레벨 불일치 (> %.1f dB)\n",
+               mismatched, LEVEL_MATCH_DB);
+        return 1;
+    }
+    return 0;
+}
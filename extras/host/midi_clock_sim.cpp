@@ -0,0 +1,326 @@
+/*
+ * MIDI 클럭 마스터/슬레이브 호스트 시뮬레이션
+ *
+ * TR808MidiClock(src/tr808_midi_clock.h)을 샘플 단위로 돌려 타이밍을 검증
+ * - 마스터: 소수점 BPM으로 10분 동안 생성한 틱 수 == 이상값, 마지막 틱의 누적 오차
+ * - 슬레이브: 이상적인 외부 마스터 틱에 수신 지터(균등 분포)를 더해
+ *   이벤트 큐처럼 타임스탬프 시각에 onExternalTick()으로 전달하고,
+ *   생성된 스텝 시각이 외부 스텝 격자에서 벗어나는 정도(지터)를 측정
+ * - 외부 클럭 중단 시 언락, 템포 급변 후 재록 확인
+ * - 마스터 클럭 출력: 블록 렌더/DMA 지연 타임라인에서 0xF8 전송 시각을 틱의 재생 시각과 비교
+ *   (렌더 시점 즉시 전송 vs TR808ClockOutputQueue + 출력 타임라인 타이머)
+ * - 검증 실패 시 종료 코드 1
+ *
+ * 빌드:
+ *   g++ -std=c++11 -O2 -Isrc extras/host/midi_clock_sim.cpp src/tr808_midi_clock.cpp -o midi_clock_sim
+ * 실행:
+ *   ./midi_clock_sim
+ *
+ * 작성일: 2025-10-30
+ * 호환성: 호스트 (g++ / clang++, C++11)
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <math.h>
+#include "tr808_midi_clock.h"
+
+#define SIM_SAMPLE_RATE     32768   // TR808_SAMPLE_RATE
+#define MASTER_BPM          121.5f
+#define MASTER_SECONDS      600
+#define SLAVE_BPM           127.3
+#define SLAVE_SECONDS       120
+#define SLAVE_JITTER        32      // 수신 타임스탬프 지터 (+/- 샘플)
+#define SLAVE_SETTLE_STEPS  64      // 록 직후 과도 구간 제외
+#define JUMP_BPM            90.0
+#define STEP_JITTER_RMS     8.0     // 슬레이브 스텝 RMS 지터 허용치 (샘플, 입력 RMS 18.5)
+#define STEP_OFFSET_LIMIT   2.0     // 외부 스텝 격자 대비 평균 지연 허용치 (샘플)
+#define OUT_BLOCK           256     // AUDIO_BUFFER_SIZE
+#define OUT_LATENCY         (2 * OUT_BLOCK)     // MIDI_CLOCK_OUT_LATENCY
+#define OUT_RENDER_LOAD     0.6     // 블록 렌더 시간 / 블록 주기
+#define OUT_WAKE_JITTER_US  200     // 렌더 태스크 깨어남 지연 (0 ~ 값)
+#define OUT_TIMER_JITTER_US 50      // esp_timer 콜백 디스패치 지연 (0 ~ 값)
+#define OUT_SECONDS         60
+#define OUT_JITTER_LIMIT_US 300.0   // 타이머 전송의 최대-최소 허용치
+
+static uint32_t failures = 0;
+static uint32_t rngState = 0x808u;
+
+static int32_t uniformJitter(int32_t range) {
+    // xorshift32
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return (int32_t)(rngState % (uint32_t)(2 * range + 1)) - range;
+}
+
+static void check(bool ok, const char* what) {
+    printf("  %s %s\n", ok ? "✓" : "✗", what);
+    if (!ok) failures++;
+}
+
+// ================ 마스터 ================
+
+static void simulateMaster() {
+    TR808MidiClock clock;
+    clock.begin(SIM_SAMPLE_RATE, MASTER_BPM);
+    clock.start(0);
+
+    const uint32_t total = (uint32_t)SIM_SAMPLE_RATE * MASTER_SECONDS;
+    uint32_t ticks = 0, steps = 0, lastTick = 0;
+    for (uint32_t now = 0; now < total; now++) {
+        uint8_t flags = clock.process(now);
+        if (flags & TR808_CLOCK_TICK) {
+            ticks++;
+            lastTick = now;
+        }
+        if (flags & TR808_CLOCK_STEP) steps++;
+    }
+
+    double period = SIM_SAMPLE_RATE * 60.0 / (MASTER_BPM * TR808_CLOCK_PPQN);
+    uint32_t expected = (uint32_t)(MASTER_BPM * TR808_CLOCK_PPQN * MASTER_SECONDS / 60.0 + 0.5);
+    double drift = lastTick - (ticks - 1) * period;
+
+    printf("마스터 %.1f BPM, %d초 (%u Hz)\n", MASTER_BPM, MASTER_SECONDS, SIM_SAMPLE_RATE);
+    printf("  틱 %u (이상값 %u), 스텝 %u, 마지막 틱 누적 오차 %.2f 샘플\n", ticks, expected, steps, drift);
+    check(ticks == expected, "틱 수가 이상값과 같음");
+    check(fabs(drift) < 1.0, "누적 오차 1샘플 미만 (Q16 분수 누적)");
+}
+
+// ================ 슬레이브 ================
+
+struct SlaveResult {
+    uint32_t steps;
+    double meanOffset;      // 외부 스텝 격자 대비 평균 지연 (샘플)
+    double peakJitter;      // 평균 지연 기준 최대 편차
+    double rmsJitter;
+    float tempo;
+    bool locked;
+};
+
+/**
+ * 외부 마스터 (bpm, 지터) -> 슬레이브, seconds 동안
+ * 외부 틱 k의 이상 시각 = start + k * period, 수신 시각 = 이상 시각 + 지터
+ * stopAt > 0이면 그 시각 이후 외부 클럭 중단
+ */
+static SlaveResult simulateSlave(double bpm, int32_t jitter, uint32_t seconds, uint32_t stopAt) {
+    TR808MidiClock clock;
+    clock.begin(SIM_SAMPLE_RATE, 120.0f);
+    clock.setSource(TR808_CLOCK_EXTERNAL);
+
+    const double period = SIM_SAMPLE_RATE * 60.0 / (bpm * TR808_CLOCK_PPQN);
+    const double start = 1000.0;
+    const uint32_t total = (uint32_t)SIM_SAMPLE_RATE * seconds;
+
+    uint32_t externalTick = 0;
+    uint32_t pending = (uint32_t)(start + 0.5) + jitter;    // 첫 수신 시각
+    bool started = false;
+
+    SlaveResult result = { 0, 0.0, 0.0, 0.0, 0.0f, false };
+    double sum = 0.0, sumSquares = 0.0, minOffset = 1e9, maxOffset = -1e9;
+    uint32_t measured = 0;
+
+    for (uint32_t now = 0; now < total; now++) {
+        // 이벤트 큐: 타임스탬프 시각이 된 수신 틱 전달
+        while ((stopAt == 0 || pending < stopAt) && (int32_t)(now - pending) >= 0) {
+            if (!started) {
+                clock.start(now);      // MIDI_START 다음 첫 0xF8
+                started = true;
+            }
+            clock.onExternalTick(pending);
+            externalTick++;
+            double ideal = start + externalTick * period;
+            pending = (uint32_t)(ideal + 0.5) + uniformJitter(jitter);
+        }
+
+        uint8_t flags = clock.process(now);
+        if (!(flags & TR808_CLOCK_STEP)) continue;
+
+        // 생성한 스텝 번호의 외부 격자 시각과 비교
+        result.steps++;
+        uint32_t step = clock.getStep();
+        double ideal = start + (double)step * TR808_CLOCK_TICKS_PER_STEP * period;
+        double offset = now - ideal;
+        if (result.steps > SLAVE_SETTLE_STEPS && (stopAt == 0 || now < stopAt)) {
+            sum += offset;
+            sumSquares += offset * offset;
+            if (offset < minOffset) minOffset = offset;
+            if (offset > maxOffset) maxOffset = offset;
+            measured++;
+        }
+    }
+
+    if (measured > 0) {
+        result.meanOffset = sum / measured;
+        result.peakJitter = fmax(maxOffset - result.meanOffset, result.meanOffset - minOffset);
+        result.rmsJitter = sqrt(sumSquares / measured - result.meanOffset * result.meanOffset);
+    }
+    result.tempo = clock.getTempo();
+    result.locked = clock.isLocked();
+    return result;
+}
+
+static void simulateSlaves() {
+    printf("\n슬레이브 %.1f BPM, 수신 지터 +/-%d 샘플 (RMS %.1f), %d초\n",
+           SLAVE_BPM, SLAVE_JITTER, SLAVE_JITTER / sqrt(3.0), SLAVE_SECONDS);
+    SlaveResult ideal = simulateSlave(SLAVE_BPM, 0, SLAVE_SECONDS, 0);
+    SlaveResult jittered = simulateSlave(SLAVE_BPM, SLAVE_JITTER, SLAVE_SECONDS, 0);
+
+    printf("  %-12s %8s %10s %12s %12s %10s\n", "입력", "스텝", "평균 지연", "최대 지터", "RMS 지터", "추정 BPM");
+    printf("  %-12s %8u %10.2f %12.2f %12.2f %10.2f\n", "지터 없음",
+           ideal.steps, ideal.meanOffset, ideal.peakJitter, ideal.rmsJitter, ideal.tempo);
+    printf("  %-12s %8u %10.2f %12.2f %12.2f %10.2f\n", "지터 +/-32",
+           jittered.steps, jittered.meanOffset, jittered.peakJitter, jittered.rmsJitter, jittered.tempo);
+
+    double expectedSteps = SLAVE_BPM * 4 * SLAVE_SECONDS / 60.0;
+    check(fabs(jittered.steps - expectedSteps) <= 2, "스텝 수가 외부 템포와 같음 (누락/중복 없음)");
+    check(fabs(jittered.meanOffset) < STEP_OFFSET_LIMIT, "스텝이 외부 스텝 격자에 정렬 (한 틱 지연 없음)");
+    check(jittered.rmsJitter < STEP_JITTER_RMS, "스텝 RMS 지터가 수신 지터보다 충분히 작음");
+    check(fabs(jittered.tempo - SLAVE_BPM) < 0.5, "PLL 템포 추정");
+
+    printf("\n외부 클럭 중단 / 템포 급변\n");
+    SlaveResult stopped = simulateSlave(SLAVE_BPM, SLAVE_JITTER, 10, SIM_SAMPLE_RATE * 5);
+    check(!stopped.locked, "외부 클럭 중단 후 언락");
+    SlaveResult jump = simulateSlave(JUMP_BPM, SLAVE_JITTER, 30, 0);
+    printf("  %.0f BPM: 추정 %.2f BPM, 최대 지터 %.2f 샘플\n", JUMP_BPM, jump.tempo, jump.peakJitter);
+    check(jump.locked && fabs(jump.tempo - JUMP_BPM) < 0.5, "120 BPM 초기값에서 다른 템포로 록");
+}
+
+// ================ 클럭 출력 ================
+
+struct SendStats {
+    uint32_t count;
+    double sum, sumSquares, minOffset, maxOffset;
+
+    SendStats() : count(0), sum(0.0), sumSquares(0.0), minOffset(1e18), maxOffset(-1e18) {}
+
+    void add(double offset) {
+        count++;
+        sum += offset;
+        sumSquares += offset * offset;
+        if (offset < minOffset) minOffset = offset;
+        if (offset > maxOffset) maxOffset = offset;
+    }
+    double mean() const { return count ? sum / count : 0.0; }
+    double rms() const { return count ? sqrt(sumSquares / count - mean() * mean()) : 0.0; }
+    double peakToPeak() const { return count ? maxOffset - minOffset : 0.0; }
+};
+
+/**
+ * 장치 타임라인 모델 (마이크로초)
+ * - 샘플 s의 재생 시각 P(s) = (s + OUT_LATENCY) * T
+ * - 블록 k 렌더는 k * OUT_BLOCK * T + 깨어남 지연에 시작해 OUT_RENDER_LOAD 동안 몰아서 실행
+ *   (sampleClock.beginBlock 앵커 = 블록 시작 샘플/시각)
+ * - 기존: 틱을 렌더하는 순간 전송
+ * - 큐: 블록 렌더 후 scheduleClockOutput(), 콜백은 앵커 외삽 - 지연으로 재생 위치를 구해 popDue
+ */
+struct ClockOutputModel {
+    double T;
+    TR808ClockOutputQueue queue;
+    uint32_t anchorSample;
+    double anchorUs;
+    double timerAt;                 // < 0: 예약 없음
+    uint32_t tickSamples[TR808_CLOCK_OUT_QUEUE_SIZE];     // 큐 순서대로 틱 샘플 (오프셋 계산용)
+    uint32_t pushed;
+    uint32_t sent;
+    bool ordered;
+    SendStats timed;
+
+    ClockOutputModel() : T(1e6 / SIM_SAMPLE_RATE), anchorSample(0), anchorUs(0.0), timerAt(-1.0),
+                         pushed(0), sent(0), ordered(true) {}
+
+    uint32_t position(double nowUs) const {
+        return anchorSample + (uint32_t)((nowUs - anchorUs) / T);
+    }
+
+    // scheduleClockOutput(): cyclesUntil을 µs로 올림, 이미 예약돼 있으면 무시
+    void schedule(double nowUs) {
+        uint32_t sampleTime;
+        if (timerAt >= 0.0 || !queue.peek(&sampleTime)) return;
+        int32_t ahead = (int32_t)(sampleTime + OUT_LATENCY - position(nowUs));
+        double delayUs = ahead > 0 ? ceil(ahead * T) : 0.0;
+        timerAt = nowUs + delayUs + uniformJitter(OUT_TIMER_JITTER_US / 2) + OUT_TIMER_JITTER_US / 2;
+    }
+
+    // onClockOutputTimer(): untilUs까지 만료된 타이머 실행 (타이머 태스크가 렌더 루프를 선점)
+    void fireTimers(double untilUs) {
+        while (timerAt >= 0.0 && timerAt <= untilUs) {
+            double nowUs = timerAt;
+            timerAt = -1.0;
+            uint32_t playing = position(nowUs) - OUT_LATENCY;
+            uint8_t status;
+            while (queue.popDue(playing, &status)) {
+                uint32_t sample = tickSamples[sent % TR808_CLOCK_OUT_QUEUE_SIZE];
+                timed.add(nowUs - (sample + OUT_LATENCY) * T);
+                if (status != 0xF8) ordered = false;
+                sent++;
+            }
+            schedule(nowUs);
+        }
+    }
+
+    void push(uint32_t sample) {
+        tickSamples[pushed % TR808_CLOCK_OUT_QUEUE_SIZE] = sample;
+        if (queue.push(sample, 0xF8)) pushed++;
+    }
+};
+
+static void simulateClockOutput() {
+    ClockOutputModel model;
+    const double T = model.T;
+    const double renderUs = OUT_BLOCK * T * OUT_RENDER_LOAD;
+
+    TR808MidiClock clock;
+    clock.begin(SIM_SAMPLE_RATE, MASTER_BPM);
+    clock.start(0);
+    SendStats immediate;
+
+    const uint32_t blocks = (uint32_t)SIM_SAMPLE_RATE * OUT_SECONDS / OUT_BLOCK;
+    for (uint32_t k = 0; k < blocks; k++) {
+        double startUs = k * OUT_BLOCK * T + uniformJitter(OUT_WAKE_JITTER_US / 2) + OUT_WAKE_JITTER_US / 2;
+        model.fireTimers(startUs);
+        model.anchorSample = k * OUT_BLOCK;
+        model.anchorUs = startUs;
+
+        for (uint32_t i = 0; i < OUT_BLOCK; i++) {
+            uint32_t sample = k * OUT_BLOCK + i;
+            double renderAt = startUs + i * renderUs / OUT_BLOCK;
+            model.fireTimers(renderAt);
+            if (!(clock.process(sample) & TR808_CLOCK_TICK)) continue;
+            immediate.add(renderAt - (sample + OUT_LATENCY) * T);
+            model.push(sample);
+        }
+        model.fireTimers(startUs + renderUs);
+        model.schedule(startUs + renderUs);
+    }
+    model.fireTimers(1e18);
+
+    const SendStats& timed = model.timed;
+    printf("\n마스터 클럭 출력 %.1f BPM, 블록 %d, 출력 지연 %d 샘플 (%.0f µs), %d초\n",
+           MASTER_BPM, OUT_BLOCK, OUT_LATENCY, OUT_LATENCY * T, OUT_SECONDS);
+    printf("  %-16s %8s %12s %16s %10s\n", "전송", "바이트", "평균 (µs)", "최대-최소 (µs)", "RMS (µs)");
+    printf("  %-16s %8u %12.1f %16.1f %10.1f\n", "렌더 시점 즉시",
+           immediate.count, immediate.mean(), immediate.peakToPeak(), immediate.rms());
+    printf("  %-16s %8u %12.1f %16.1f %10.1f\n", "큐 + 타이머",
+           timed.count, timed.mean(), timed.peakToPeak(), timed.rms());
+    printf("  (오프셋 = 전송 시각 - 틱 샘플의 재생 시각, 큐 드롭 %u)\n", (unsigned)model.queue.getDropped());
+
+    check(model.queue.getDropped() == 0 && timed.count == immediate.count && model.ordered,
+          "모든 틱을 순서대로 전송");
+    check(immediate.maxOffset < -(OUT_LATENCY - OUT_BLOCK) * T, "렌더 시점 전송은 재생보다 DMA 지연만큼 앞섬 (기존 동작)");
+    check(timed.minOffset >= 0.0 && timed.mean() < OUT_JITTER_LIMIT_US, "타이머 전송은 틱 재생 시각 직후");
+    check(timed.peakToPeak() < OUT_JITTER_LIMIT_US, "타이머 전송 지터가 블록 안 위치와 무관 (깨어남 + 타이머 지연 수준)");
+}
+
+int main() {
+    simulateMaster();
+    simulateSlaves();
+    simulateClockOutput();
+
+    if (failures > 0) {
+        printf("\n실패 %u건\n", (unsigned)failures);
+        return 1;
+    }
+    printf("\n모두 통과\n");
+    return 0;
+}
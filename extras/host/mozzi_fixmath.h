@@ -0,0 +1,44 @@
+/*
+ * 호스트 빌드용 mozzi_fixmath 대체 헤더
+ *
+ * Mozzi와 같은 타입 정의와 변환식 (비트 단위 동일)
+ *
+ * 작성일: 2025-10-30
+ * 호환성: 호스트 (Mozzi 1.x/2.x API 부분 집합)
+ */
+
+#ifndef TR808_HOST_MOZZI_FIXMATH_H
+#define TR808_HOST_MOZZI_FIXMATH_H
+
+#include <stdint.h>
+
+typedef int8_t   Q0n7;
+typedef uint8_t  Q0n8;
+typedef uint8_t  Q8n0;
+typedef int16_t  Q7n8;
+typedef uint16_t Q8n8;
+typedef int16_t  Q1n14;
+typedef int16_t  Q1n15;
+typedef uint16_t Q0n16;
+typedef int32_t  Q15n16;
+typedef uint32_t Q16n16;
+typedef uint32_t Q24n8;
+typedef int32_t  Q23n8;
+
+#define Q8n8_FIX1   ((Q8n8) 256)
+#define Q15n16_FIX1 ((Q15n16) 65536)
+#define Q16n16_FIX1 ((Q16n16) 65536)
+
+inline Q16n16 float_to_Q16n16(float a) { return static_cast<Q16n16>(a * 65536); }
+inline Q15n16 float_to_Q15n16(float a) { return static_cast<Q15n16>(a * 65536); }
+inline float Q16n16_to_float(Q16n16 a) { return ((float)a) / 65536; }
+inline float Q15n16_to_float(Q15n16 a) { return ((float)a) / 65536; }
+inline Q15n16 Q8n0_to_Q15n16(Q8n0 a) { return ((Q15n16)a) << 16; }
+inline Q8n0 Q15n16_to_Q8n0(Q15n16 a) { return (Q8n0)(a >> 16); }
+
+// Q16n16 곱셈 (64비트 중간값)
+inline Q16n16 Q16n16_mult(Q16n16 a, Q16n16 b) {
+    return (Q16n16)(((uint64_t)a * b) >> 16);
+}
+
+#endif // TR808_HOST_MOZZI_FIXMATH_H
@@ -0,0 +1,192 @@
+/*
+ * Mozzi 보이스 호스트 렌더러
+ *
+ * extras/host의 Mozzi 대체 헤더로 mozzi_tr808_drums.cpp를 리눅스에서 빌드해
+ * 보이스 그룹별 원샷을 렌더링하고 비용/레벨/체크섬을 출력
+ * - WAV 저장 (16비트 모노, MOZZI_TR808_AUDIO_RATE)
+ * - ns/샘플: 호스트 기준 상대 비교용 (기기 사이클은 벤치마크 명령으로 측정)
+ * - FNV-1a 체크섬: 알고리즘 변경 시 회귀 확인용
+ * - 벨로시티: 0.5로 트리거한 피크가 1.0 피크의 절반인지 확인
+ * - 처리량: 'benchmark' 명령(mozzi_tr808_implementation.cpp)과 같은 방식으로
+ *   활성 보이스 0~TR808_MAX_VOICES개의 ns/샘플과 레이트별 수용 보이스 수 (호스트 기준)
+ *
+ * 빌드:
+ *   g++ -std=c++11 -O2 -Iextras/host -Isrc extras/host/mozzi_render.cpp \
+ *       src/mozzi_tr808_drums.cpp src/tr808_wavetable.cpp src/tr808_perf_monitor.cpp -o mozzi_render
+ * 실행:
+ *   ./mozzi_render [출력 디렉터리]
+ *
+ * 작성일: 2025-10-30
+ * 호환성: 호스트 (g++ / clang++, C++11)
+ */
+
+#include <stdio.h>
+#include <chrono>
+#include "mozzi_tr808_drums.h"
+
+#define RENDER_SECONDS      2
+#define RENDER_BLOCK_SIZE   32
+#define RENDER_GAIN_Q15     32767
+#define BENCH_BLOCKS        2048    // 보이스 수마다 렌더할 블록 (엔벨롭이 끝나기 전 구간)
+
+// 컨트롤 틱 간격 (ADSR 템플릿과 같은 CONTROL_RATE)
+#define RENDER_SAMPLES_PER_TICK (MOZZI_TR808_AUDIO_RATE / CONTROL_RATE)
+
+static const char* const GROUP_NAMES[4] = {"kick", "snare", "cymbal", "hihat"};
+
+static bool writeWav(const char* path, const int16_t* samples, uint32_t count, uint32_t rate) {
+    FILE* file = fopen(path, "wb");
+    if (!file) return false;
+
+    uint32_t dataBytes = count * 2;
+    uint8_t header[44];
+    memcpy(header, "RIFF", 4);
+    uint32_t riffSize = 36 + dataBytes;
+    memcpy(header + 4, &riffSize, 4);
+    memcpy(header + 8, "WAVEfmt ", 8);
+    uint32_t fmtSize = 16;
+    uint16_t format = 1, channels = 1, blockAlign = 2, bits = 16;
+    uint32_t byteRate = rate * 2;
+    memcpy(header + 16, &fmtSize, 4);
+    memcpy(header + 20, &format, 2);
+    memcpy(header + 22, &channels, 2);
+    memcpy(header + 24, &rate, 4);
+    memcpy(header + 28, &byteRate, 4);
+    memcpy(header + 32, &blockAlign, 2);
+    memcpy(header + 34, &bits, 2);
+    memcpy(header + 36, "data", 4);
+    memcpy(header + 40, &dataBytes, 4);
+
+    bool ok = fwrite(header, 1, sizeof(header), file) == sizeof(header) &&
+              fwrite(samples, 2, count, file) == count;
+    fclose(file);
+    return ok;
+}
+
+static uint32_t fnv1a(const int16_t* samples, uint32_t count) {
+    const uint8_t* bytes = (const uint8_t*)samples;
+    uint32_t hash = 2166136261u;
+    for (uint32_t i = 0; i < count * 2; i++) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static void trigger(TR808VoicePoolMozzi& pool, int group, float velocity = 1.0f) {
+    switch (group) {
+        case TR808_GROUP_KICK:   pool.triggerKick(velocity);          break;
+        case TR808_GROUP_SNARE:  pool.triggerSnare(velocity);         break;
+        case TR808_GROUP_CYMBAL: pool.triggerCymbal(velocity);        break;
+        case TR808_GROUP_HIHAT:  pool.triggerHihat(false, velocity);  break;
+    }
+}
+
+static TR808VoicePoolMozzi oneShotPool;
+
+// 한 그룹 원샷 렌더 (컨트롤 틱 포함), ns/샘플 반환
+static double renderOneShot(int group, float velocity, int16_t* buffer, uint32_t total) {
+    TR808VoicePoolMozzi& pool = oneShotPool;
+    pool.begin();
+    trigger(pool, group, velocity);
+
+    uint32_t untilTick = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t pos = 0; pos < total; pos += RENDER_BLOCK_SIZE) {
+        if (pos >= untilTick) {
+            pool.update();
+            untilTick += RENDER_SAMPLES_PER_TICK;
+        }
+        pool.renderBlock(&buffer[pos], RENDER_BLOCK_SIZE, RENDER_GAIN_Q15);
+    }
+    return std::chrono::duration<double, std::nano>(
+        std::chrono::steady_clock::now() - start).count() / total;
+}
+
+static int32_t peakOf(const int16_t* buffer, uint32_t total) {
+    int32_t peak = 0;
+    for (uint32_t i = 0; i < total; i++) {
+        int32_t v = buffer[i] < 0 ? -buffer[i] : buffer[i];
+        if (v > peak) peak = v;
+    }
+    return peak;
+}
+
+// runThroughputBenchmark()와 같은 측정: 그룹을 돌아가며 active개 트리거 후 블록 렌더
+static void benchmarkThroughput() {
+    static TR808VoicePoolMozzi pool;
+    static int16_t block[RENDER_BLOCK_SIZE];
+    double nsPerSample[TR808_MAX_VOICES + 1];
+
+    printf("\n보이스 처리량 (블록 %d샘플 x %d, 호스트 ns/샘플)\n", RENDER_BLOCK_SIZE, BENCH_BLOCKS);
+    pool.begin();
+    for (uint8_t active = 0; active <= TR808_MAX_VOICES; active++) {
+        pool.stopAll();
+        for (uint8_t v = 0; v < active; v++) trigger(pool, v % 4);
+
+        auto start = std::chrono::steady_clock::now();
+        for (int b = 0; b < BENCH_BLOCKS; b++) {
+            pool.renderBlock(block, RENDER_BLOCK_SIZE, RENDER_GAIN_Q15);
+        }
+        nsPerSample[active] = std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - start).count() / (BENCH_BLOCKS * RENDER_BLOCK_SIZE);
+        printf("  보이스 %u개 (재생 중 %u): %6.1f ns\n", active,
+               (unsigned)pool.getActiveVoiceCount(), nsPerSample[active]);
+    }
+    pool.stopAll();
+
+    double perVoice = (nsPerSample[TR808_MAX_VOICES] - nsPerSample[0]) / TR808_MAX_VOICES;
+    const uint32_t rates[2] = { 32768, 64000 };
+    for (int i = 0; i < 2; i++) {
+        double budget = 1e9 / rates[i];
+        printf("  %u Hz: 샘플당 %.0f ns, 보이스당 %.1f ns -> 최대 약 %.0f개\n",
+               (unsigned)rates[i], budget, perVoice, (budget - nsPerSample[0]) / perVoice);
+    }
+}
+
+int main(int argc, char** argv) {
+    const char* outDir = argc > 1 ? argv[1] : ".";
+    const uint32_t total = MOZZI_TR808_AUDIO_RATE * RENDER_SECONDS;
+    static int16_t buffer[MOZZI_TR808_AUDIO_RATE * RENDER_SECONDS];
+
+    printf("Mozzi 보이스 호스트 렌더: %u Hz, 컨트롤 %u Hz, %d초\n",
+           (unsigned)MOZZI_TR808_AUDIO_RATE, (unsigned)CONTROL_RATE, RENDER_SECONDS);
+    printf("%-8s %10s %8s %8s %10s\n", "voice", "ns/sample", "peak", "rms", "checksum");
+
+    int failures = 0;
+    for (int group = 0; group < 4; group++) {
+        double ns = renderOneShot(group, 1.0f, buffer, total);
+
+        int32_t peak = peakOf(buffer, total);
+        double power = 0.0;
+        for (uint32_t i = 0; i < total; i++) {
+            power += (double)buffer[i] * buffer[i];
+        }
+
+        printf("%-8s %10.1f %8d %8.0f   %08x\n", GROUP_NAMES[group], ns, (int)peak,
+               sqrt(power / total), fnv1a(buffer, total));
+
+        char path[512];
+        snprintf(path, sizeof(path), "%s/mozzi_%s.wav", outDir, GROUP_NAMES[group]);
+        if (!writeWav(path, buffer, total, MOZZI_TR808_AUDIO_RATE)) {
+            fprintf(stderr, "WAV 저장 실패: %s\n", path);
+            failures++;
+        }
+    }
+
+    // 벨로시티 0.5 -> 피크 절반 (마스터 처리의 비트 크러시/필터 오차 허용)
+    printf("\n벨로시티 0.5 / 1.0 피크 비\n");
+    for (int group = 0; group < 4; group++) {
+        renderOneShot(group, 1.0f, buffer, total);
+        int32_t full = peakOf(buffer, total);
+        renderOneShot(group, 0.5f, buffer, total);
+        int32_t half = peakOf(buffer, total);
+        double ratio = full > 0 ? (double)half / full : 0.0;
+        bool ok = full < 64 || (ratio > 0.4 && ratio < 0.6);
+        printf("  %-8s %6d / %6d = %.2f %s\n", GROUP_NAMES[group], (int)half, (int)full, ratio,
+               ok ? "" : "(벨로시티 미반영)");
+        if (!ok) failures++;
+    }
+
+    benchmarkThroughput();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,446 @@
+/*
+ * 패턴/킷 저장소 호스트 테스트 (파일 백엔드)
+ *
+ * TR808PatternStore를 TR808FileBackend 위에서 돌려 마운트/GC/전원 차단/링 순환을 검증
+ * - 마운트: 빈 이미지는 소거 없이, 다른 데이터가 남은 이미지는 섹터 0만 소거하고 포맷
+ *   (전체 파티션 소거 없음), format()은 저장소 섹터만 소거
+ * - 링 순환 + GC: 슬롯마다 최신 값을 기억하는 모델과 비교하며 링을 여러 번 돌고,
+ *   재마운트 후에도 같은지, 링 한 칸당 소거 1회(GC가 미리 소거한 섹터 재사용)이고
+ *   소거 횟수가 고르게 분산되는지 확인
+ * - GC 실패 재시도: tail 소거를 한 번 실패시킨 뒤에도 이후 저장이 계속 성공
+ * - 소거 금지(안전 지점 아님): 소거 없이 현재 섹터에만 기록, 허용 후 대기열 처리
+ * - 전원 차단: 기록/소거 호출 k번째에서 중단(부분 기록, 절반 소거) 후 재마운트하면
+ *   모든 슬롯이 마지막 완료 값 또는 기록 중이던 값이고 이후 저장도 정상
+ * - 저장 중 언더런 모델: 플래시 작업 시간(데이터시트 대표값)이 DMA 여유보다 길면
+ *   그동안 렌더가 멈춰 언더런 (단일 코어 C3는 소거/기록 중 캐시가 꺼지고 스케줄러 정지)
+ *   재생 중 주기적 저장을 소거 허용/금지로 비교 (장치 실측은 'status'와 'perf' 명령)
+ * - 검증 실패 시 종료 코드 1
+ *
+ * 빌드:
+ *   g++ -std=c++11 -O2 -Isrc extras/host/pattern_store_test.cpp \
+ *       src/tr808_pattern_store.cpp -o pattern_store_test
+ * 실행:
+ *   ./pattern_store_test [이미지 파일]
+ *
+ * 작성일: 2025-10-30
+ * 호환성: 호스트 (g++ / clang++, C++11)
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "tr808_pattern_store.h"
+
+#define TEST_SECTORS        32      // partitions_tr808.csv의 tr808 파티션 (128KB)
+#define KIT_BYTES           40      // KitSettings (float 10개)
+#define PATTERN_BYTES       176     // TR808_VOICE_COUNT * TR808_FRAME_STEPS
+#define TEST_SLOTS          8       // 슬롯 수 (타입별)
+#define WRAP_WRITES         20000   // 링을 여러 번 도는 쓰기 수
+#define CUT_WORKLOAD        600     // 전원 차단 테스트 작업량 (쓰기 수, GC 포함)
+#define CUT_STRIDE          7       // 차단 지점 간격 (작업 호출 수)
+
+// 플래시 작업 시간 모델 (SPI NOR 데이터시트 대표값) / 오디오 블록
+#define MODEL_ERASE_US      45000   // 4KB 섹터 소거 (대표값, 최대 수백 ms)
+#define MODEL_PAGE_US       700     // 256바이트 페이지 프로그램
+#define MODEL_BLOCK_US      7812    // 256샘플 @ 32768Hz
+#define MODEL_CUSHION_US    MODEL_BLOCK_US  // 2블록 DMA: 재생 중 블록 외 여유 1블록
+#define MODEL_SAVE_SECONDS  600     // 재생 중 저장 구간
+#define MODEL_SAVE_EVERY_MS 2000    // 저장 간격 (킷 + 패턴)
+
+static uint32_t failures = 0;
+static const char* imagePath = "pattern_store_test.bin";
+
+static void check(bool ok, const char* what) {
+    printf("  %s %s\n", ok ? "✓" : "✗", what);
+    if (!ok) failures++;
+}
+
+/**
+ * 고장/시간 주입 파일 백엔드
+ * - cutAfter: 이 번호의 기록/소거 호출에서 전원 차단 (그 호출은 절반만 반영, 이후 모두 실패)
+ * - failEraseSector: 이 섹터 소거를 한 번 실패
+ * - 작업별 모델 시간으로 DMA 여유를 넘는 정지(언더런 블록) 집계
+ */
+class FaultBackend : public TR808FileBackend {
+public:
+    uint32_t operations;
+    uint32_t cutAfter;
+    bool powerLost;
+    int32_t failEraseSector;
+    uint32_t erases;
+    uint32_t stallBlocks;
+
+    FaultBackend(const char* filePath)
+        : TR808FileBackend(filePath, TEST_SECTORS), operations(0), cutAfter(0), powerLost(false),
+          failEraseSector(-1), erases(0), stallBlocks(0) {}
+
+    bool write(uint32_t offset, const void* data, size_t length) override {
+        if (powerLost) return false;
+        if (cut()) {
+            // 차단 순간의 기록: 앞쪽 절반만 반영
+            TR808FileBackend::write(offset, data, length / 2);
+            return false;
+        }
+        stall((uint32_t)((length + 255) / 256) * MODEL_PAGE_US);
+        return TR808FileBackend::write(offset, data, length);
+    }
+
+    bool eraseSector(uint32_t sector) override {
+        if (powerLost) return false;
+        if ((int32_t)sector == failEraseSector) {
+            failEraseSector = -1;
+            return false;
+        }
+        if (cut()) {
+            // 차단 순간의 소거: 앞쪽 절반만 0xFF (뒤쪽 절반은 이전 내용)
+            static uint8_t rest[TR808_STORE_SECTOR_SIZE / 2];
+            uint32_t half = sector * TR808_STORE_SECTOR_SIZE + sizeof(rest);
+            read(half, rest, sizeof(rest));
+            TR808FileBackend::eraseSector(sector);
+            TR808FileBackend::write(half, rest, sizeof(rest));
+            return false;
+        }
+        erases++;
+        stall(MODEL_ERASE_US);
+        return TR808FileBackend::eraseSector(sector);
+    }
+
+private:
+    bool cut() {
+        operations++;
+        if (cutAfter != 0 && operations >= cutAfter) powerLost = true;
+        return powerLost;
+    }
+
+    void stall(uint32_t us) {
+        if (us > MODEL_CUSHION_US) stallBlocks += (us - MODEL_CUSHION_US + MODEL_BLOCK_US - 1) / MODEL_BLOCK_US;
+    }
+};
+
+// 슬롯/버전마다 다른 내용 (길이도 변화)
+static uint16_t fillRecord(uint8_t* out, TR808RecordType type, uint8_t slot, uint32_t serial) {
+    uint16_t length = type == TR808_RECORD_KIT ? KIT_BYTES : PATTERN_BYTES - (serial % 5) * 4;
+    for (uint16_t i = 0; i < length; i++) {
+        out[i] = (uint8_t)(serial * 31 + slot * 7 + i * 13 + type);
+    }
+    return length;
+}
+
+static void eraseImage(uint8_t fill) {
+    static uint8_t sector[TR808_STORE_SECTOR_SIZE];
+    memset(sector, fill, sizeof(sector));
+    FILE* file = fopen(imagePath, "wb");
+    for (uint32_t s = 0; s < TEST_SECTORS; s++) fwrite(sector, 1, sizeof(sector), file);
+    fclose(file);
+}
+
+// 슬롯별 기대값: 마지막 완료 serial (0 = 없음), 기록 중이던 serial
+struct Model {
+    uint32_t committed[TR808_RECORD_TYPE_COUNT][TEST_SLOTS];
+    uint32_t inflight[TR808_RECORD_TYPE_COUNT][TEST_SLOTS];
+};
+
+static bool slotMatches(TR808PatternStore& store, TR808RecordType type, uint8_t slot, uint32_t serial) {
+    uint8_t expected[TR808_STORE_MAX_RECORD];
+    uint8_t actual[TR808_STORE_MAX_RECORD];
+    if (serial == 0) return !store.exists(type, slot);
+    uint16_t length = fillRecord(expected, type, slot, serial);
+    return store.read(type, slot, actual, sizeof(actual)) == length && memcmp(actual, expected, length) == 0;
+}
+
+static bool modelMatches(TR808PatternStore& store, const Model& model, bool allowInflight) {
+    for (int t = 0; t < TR808_RECORD_TYPE_COUNT; t++) {
+        for (uint8_t slot = 0; slot < TEST_SLOTS; slot++) {
+            TR808RecordType type = (TR808RecordType)t;
+            if (slotMatches(store, type, slot, model.committed[t][slot])) continue;
+            if (allowInflight && model.inflight[t][slot] != 0 &&
+                slotMatches(store, type, slot, model.inflight[t][slot])) continue;
+            return false;
+        }
+    }
+    return true;
+}
+
+// 작업량의 i번째 쓰기 (타입/슬롯 순환)
+static bool writeStep(TR808PatternStore& store, Model& model, uint32_t i) {
+    uint8_t data[TR808_STORE_MAX_RECORD];
+    TR808RecordType type = (i % 3 == 0) ? TR808_RECORD_KIT : TR808_RECORD_PATTERN;
+    uint8_t slot = (uint8_t)((i * 5) % TEST_SLOTS);
+    uint32_t serial = i + 1;
+    uint16_t length = fillRecord(data, type, slot, serial);
+    model.inflight[type][slot] = serial;
+    if (!store.writeNow(type, slot, data, length)) return false;
+    model.committed[type][slot] = serial;
+    model.inflight[type][slot] = 0;
+    return true;
+}
+
+// ================ 마운트 ================
+
+static void testMount() {
+    printf("마운트 / 포맷\n");
+
+    eraseImage(0xFF);
+    {
+        FaultBackend backend(imagePath);
+        TR808PatternStore store(&backend);
+        check(store.begin() && backend.erases == 0, "빈 이미지: 소거 없이 마운트");
+    }
+
+    // 이전 파티션 배치의 데이터가 남은 영역 (예: 같은 오프셋의 옛 spiffs)
+    eraseImage(0x5A);
+    {
+        FaultBackend backend(imagePath);
+        TR808PatternStore store(&backend);
+        check(store.begin() && backend.erases == 1, "다른 데이터가 남은 이미지: 섹터 0만 소거");
+        Model model;
+        memset(&model, 0, sizeof(model));
+        bool ok = true;
+        for (uint32_t i = 0; i < 400 && ok; i++) ok = writeStep(store, model, i);
+        check(ok && modelMatches(store, model, false), "남은 데이터 위로 링 순환 (head 도달 시 섹터 소거)");
+    }
+
+    {
+        FaultBackend backend(imagePath);
+        TR808PatternStore store(&backend);
+        store.begin();
+        uint32_t used = 0;
+        for (uint32_t s = 1; s < TEST_SECTORS; s++) {
+            TR808SectorHeader header;
+            backend.read(s * TR808_STORE_SECTOR_SIZE, &header, sizeof(header));
+            if (header.magic == TR808_STORE_SECTOR_MAGIC) used++;
+        }
+        uint32_t before = backend.erases;
+        // 섹터 0은 헤더가 있으면 그대로, 여유 섹터면 formatSector()가 소거 없이 재사용
+        check(store.format() && backend.erases - before >= used && backend.erases - before <= used + 1,
+              "format(): 저장소 섹터만 소거");
+    }
+    {
+        FaultBackend backend(imagePath);
+        TR808PatternStore store(&backend);
+        check(store.begin() && !store.exists(TR808_RECORD_KIT, 0) && backend.erases == 0,
+              "format() 후 재마운트: 빈 저장소, 소거 없음");
+    }
+}
+
+// ================ 링 순환 + GC ================
+
+static void testWrap() {
+    printf("\n링 순환 + GC (%d섹터, 쓰기 %d)\n", TEST_SECTORS, WRAP_WRITES);
+    eraseImage(0xFF);
+    Model model;
+    memset(&model, 0, sizeof(model));
+
+    FaultBackend backend(imagePath);
+    TR808PatternStore store(&backend);
+    store.begin();
+    bool ok = true, consistent = true;
+    for (uint32_t i = 0; i < WRAP_WRITES && ok; i++) {
+        ok = writeStep(store, model, i);
+        if (i % 997 == 0 && !modelMatches(store, model, false)) consistent = false;
+    }
+    const TR808PatternStore::Stats& stats = store.getStats();
+    printf("  GC %u회, 소거 %u섹터, 최대 소거 횟수 %u\n",
+           (unsigned)stats.gcRuns, (unsigned)stats.sectorsErased, (unsigned)stats.maxEraseCount);
+    check(ok, "모든 쓰기 성공");
+    check(consistent && modelMatches(store, model, false), "쓰는 동안 모든 슬롯이 최신 값");
+    check(stats.gcRuns > TEST_SECTORS * 2, "링을 여러 번 순환 (GC 반복)");
+    check(stats.sectorsErased <= stats.gcRuns + 1, "링 한 칸당 소거 1회 (GC가 소거한 섹터를 head가 재사용)");
+
+    TR808PatternStore remounted(&backend);
+    check(remounted.begin() && modelMatches(remounted, model, false), "재마운트 후 최신 값 유지");
+
+    // 웨어 레벨링: 섹터별 소거 횟수 차이
+    uint32_t low = ~0u, high = 0;
+    for (uint32_t s = 0; s < TEST_SECTORS; s++) {
+        TR808SectorHeader header;
+        backend.read(s * TR808_STORE_SECTOR_SIZE, &header, sizeof(header));
+        if (header.magic != TR808_STORE_SECTOR_MAGIC) continue;
+        if (header.eraseCount < low) low = header.eraseCount;
+        if (header.eraseCount > high) high = header.eraseCount;
+    }
+    printf("  섹터 소거 횟수 %u ~ %u\n", (unsigned)low, (unsigned)high);
+    check(high - low <= 2, "소거 횟수가 섹터 전체에 고르게 분산");
+}
+
+// ================ GC 실패 재시도 ================
+
+static void testGcRetry() {
+    printf("\nGC 실패 재시도\n");
+    eraseImage(0xFF);
+    Model model;
+    memset(&model, 0, sizeof(model));
+
+    FaultBackend backend(imagePath);
+    TR808PatternStore store(&backend);
+    store.begin();
+    // 포맷 직후 tail = 섹터 0: head가 마지막 섹터로 전진할 때의 첫 GC가 소거 실패
+    backend.failEraseSector = 0;
+
+    uint32_t i = 0, failed = 0;
+    while (store.getStats().gcRuns == 0 && i < 2000) {
+        if (!writeStep(store, model, i)) failed++;
+        i++;
+    }
+    check(failed == 1 && backend.failEraseSector < 0, "첫 GC의 tail 소거 실패로 쓰기 1회 실패");
+
+    bool ok = true;
+    for (uint32_t k = 0; k < 1000 && ok; k++, i++) ok = writeStep(store, model, i);
+    check(ok && modelMatches(store, model, true), "이후 쓰기가 GC를 재시도하고 계속 성공");
+
+    TR808PatternStore remounted(&backend);
+    check(remounted.begin() && modelMatches(remounted, model, true), "재마운트 후 최신 값 유지");
+}
+
+// 링이 한 바퀴 이상 돌아 head 전진마다 GC가 필요한 정상 상태로 채움
+static void fillRing(TR808PatternStore& store) {
+    uint8_t data[TR808_STORE_MAX_RECORD];
+    for (uint32_t i = 0; store.getStats().gcRuns <= TEST_SECTORS; i++) {
+        uint8_t slot = (uint8_t)(i % TEST_SLOTS);
+        store.writeNow(TR808_RECORD_PATTERN, slot, data, fillRecord(data, TR808_RECORD_PATTERN, slot, i + 1));
+    }
+}
+
+// ================ 소거 금지 ================
+
+static void testEraseGate() {
+    printf("\n소거 금지 (안전 지점 아님)\n");
+    eraseImage(0xFF);
+    Model model;
+    memset(&model, 0, sizeof(model));
+
+    FaultBackend backend(imagePath);
+    TR808PatternStore store(&backend);
+    store.begin();
+    fillRing(store);
+    store.setEraseAllowed(false);
+
+    uint8_t data[TR808_STORE_MAX_RECORD];
+    uint32_t before = backend.erases, accepted = 0, written = 0;
+    for (uint32_t i = 0; i < 40; i++) {
+        uint16_t length = fillRecord(data, TR808_RECORD_PATTERN, 1, i + 1);
+        if (store.queueWrite(TR808_RECORD_PATTERN, 1, data, length)) accepted++;
+        written += store.flushPending();
+    }
+    check(backend.erases == before, "금지 중 소거 없음");
+    check(written > 0 && written < accepted, "현재 섹터에 들어가는 저장만 기록");
+    check(store.hasPendingWrites() && store.getStats().erasesDeferred > 0, "나머지는 대기열에 남음 (미룬 소거 집계)");
+
+    store.setEraseAllowed(true);
+    store.flushPending();
+    check(!store.hasPendingWrites() && backend.erases > before, "허용 후 대기열 처리");
+    check(slotMatches(store, TR808_RECORD_PATTERN, 1, 40), "마지막 저장 값 유지 (병합)");
+}
+
+// ================ 전원 차단 ================
+
+static void testPowerCut() {
+    printf("\n전원 차단 (작업 %d 쓰기, %d호출마다 차단 지점)\n", CUT_WORKLOAD, CUT_STRIDE);
+
+    // 차단 없는 작업량의 호출 수
+    eraseImage(0xFF);
+    uint32_t totalOperations;
+    {
+        Model model;
+        memset(&model, 0, sizeof(model));
+        FaultBackend backend(imagePath);
+        TR808PatternStore store(&backend);
+        store.begin();
+        for (uint32_t i = 0; i < CUT_WORKLOAD; i++) writeStep(store, model, i);
+        totalOperations = backend.operations;
+    }
+
+    uint32_t points = 0, recovered = 0, continued = 0;
+    for (uint32_t cut = 1; cut < totalOperations; cut += CUT_STRIDE) {
+        eraseImage(0xFF);
+        Model model;
+        memset(&model, 0, sizeof(model));
+        {
+            FaultBackend backend(imagePath);
+            TR808PatternStore store(&backend);
+            store.begin();
+            backend.operations = 0;
+            backend.cutAfter = cut;
+            for (uint32_t i = 0; i < CUT_WORKLOAD; i++) {
+                if (!writeStep(store, model, i)) break;
+            }
+        }
+        points++;
+
+        FaultBackend backend(imagePath);
+        TR808PatternStore store(&backend);
+        if (!store.begin() || !modelMatches(store, model, true)) continue;
+        recovered++;
+
+        // 차단 후 저장 계속: 기록 중이던 값은 새 값으로 대체
+        memset(model.inflight, 0, sizeof(model.inflight));
+        bool ok = true;
+        for (uint32_t i = CUT_WORKLOAD; i < CUT_WORKLOAD + 200 && ok; i++) ok = writeStep(store, model, i);
+        TR808PatternStore remounted(&backend);
+        if (ok && remounted.begin() && modelMatches(remounted, model, false)) continued++;
+    }
+    printf("  차단 지점 %u개: 복구 %u, 이후 저장 정상 %u\n",
+           (unsigned)points, (unsigned)recovered, (unsigned)continued);
+    check(recovered == points, "모든 슬롯이 마지막 완료 값 또는 기록 중이던 값");
+    check(continued == points, "재마운트 후 저장/재마운트 정상");
+}
+
+// ================ 저장 중 언더런 모델 ================
+
+static uint32_t modelSaves(bool gated, uint32_t* deferred, uint32_t* written) {
+    eraseImage(0xFF);
+    FaultBackend backend(imagePath);
+    TR808PatternStore store(&backend);
+    store.begin();
+    fillRing(store);
+    backend.stallBlocks = 0;
+    uint32_t preloaded = store.getStats().recordsWritten;
+
+    uint8_t data[TR808_STORE_MAX_RECORD];
+    uint32_t saves = MODEL_SAVE_SECONDS * 1000 / MODEL_SAVE_EVERY_MS;
+    store.setEraseAllowed(!gated);
+    for (uint32_t i = 0; i < saves; i++) {
+        store.queueWrite(TR808_RECORD_KIT, 0, data, fillRecord(data, TR808_RECORD_KIT, 0, i + 1));
+        store.queueWrite(TR808_RECORD_PATTERN, (uint8_t)(i % TEST_SLOTS), data,
+                         fillRecord(data, TR808_RECORD_PATTERN, (uint8_t)(i % TEST_SLOTS), i + 1));
+        store.flushPending();
+    }
+    uint32_t underruns = backend.stallBlocks;
+    *deferred = store.getStats().erasesDeferred;
+    *written = store.getStats().recordsWritten - preloaded;
+    store.setEraseAllowed(true);    // 정지 후 대기열 처리
+    store.flushPending();
+    return underruns;
+}
+
+static void modelUnderruns() {
+    printf("\n재생 중 저장 언더런 모델 (%d초, %dms마다 킷+패턴, 소거 %dms / 여유 %.1fms)\n",
+           MODEL_SAVE_SECONDS, MODEL_SAVE_EVERY_MS, MODEL_ERASE_US / 1000, MODEL_CUSHION_US / 1000.0);
+    uint32_t deferredOpen, deferredGated, writtenOpen, writtenGated;
+    uint32_t open = modelSaves(false, &deferredOpen, &writtenOpen);
+    uint32_t gated = modelSaves(true, &deferredGated, &writtenGated);
+    printf("  소거 항상 허용:    언더런 블록 %u\n", (unsigned)open);
+    printf("  재생 중 소거 금지: 언더런 블록 %u (미룬 소거 %u, 재생 중 기록 %u / %u 레코드, 나머지는 정지 후)\n",
+           (unsigned)gated, (unsigned)deferredGated, (unsigned)writtenGated, (unsigned)writtenOpen);
+    check(open > 0, "재생 중 소거는 DMA 여유를 넘음");
+    check(gated == 0, "재생 중 소거 금지 시 페이지 프로그램만 (여유 안)");
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1) imagePath = argv[1];
+
+    testMount();
+    testWrap();
+    testGcRetry();
+    testEraseGate();
+    testPowerCut();
+    modelUnderruns();
+
+    remove(imagePath);
+    if (failures > 0) {
+        printf("\n실패 %u건\n", (unsigned)failures);
+        return 1;
+    }
+    printf("\n모두 통과\n");
+    return 0;
+}
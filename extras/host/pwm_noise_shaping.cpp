@@ -0,0 +1,112 @@
+/*
+ * PWM 재양자화 노이즈 셰이핑 비교
+ *
+ * TR808NoiseShaper(src/tr808_noise_shaper.h)의 차수별 16 -> 8비트 재양자화 잡음을 측정
+ * - 기준: 기존 CONVERT_TO_PWM_VALUE (절삭)
+ * - 신호: 1kHz 사인 (-6dBFS) / 감쇠하는 200Hz 사인 (드럼 꼬리처럼 작은 레벨)
+ * - 잡음 = 출력(16비트 환산) - 입력, 대역별 전력을 DFT로 적분해 SNR 계산
+ * - 대역: 0~8kHz / 0~16kHz / 전대역 (PWM RC 필터 차단 주파수 가정별)
+ *
+ * 빌드:
+ *   g++ -std=c++11 -O2 -Isrc extras/host/pwm_noise_shaping.cpp -o pwm_noise_shaping
+ * 실행:
+ *   ./pwm_noise_shaping
+ *
+ * 작성일: 2025-10-30
+ * 호환성: 호스트 (g++ / clang++, C++11)
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <math.h>
+#include "tr808_noise_shaper.h"
+
+#define MODEL_SAMPLE_RATE   64000   // extras/mozzi_config.h MOZZI_AUDIO_RATE
+#define MODEL_SAMPLES       8192    // DFT 길이 (빈 간격 7.8Hz)
+
+static const float bandEdgesHz[] = {8000.0f, 16000.0f, MODEL_SAMPLE_RATE / 2.0f};
+#define BAND_COUNT (sizeof(bandEdgesHz) / sizeof(bandEdgesHz[0]))
+
+static int16_t input[MODEL_SAMPLES];
+static float noise[MODEL_SAMPLES];
+
+// 대역별 잡음 전력 (Hann 창, 단측 스펙트럼 적분)
+static void bandNoisePower(double* power) {
+    static float windowed[MODEL_SAMPLES];
+    for (int n = 0; n < MODEL_SAMPLES; n++) {
+        float w = 0.5f - 0.5f * cosf(2.0f * (float)M_PI * n / MODEL_SAMPLES);
+        windowed[n] = noise[n] * w;
+    }
+    for (uint8_t b = 0; b < BAND_COUNT; b++) power[b] = 0.0;
+
+    for (int k = 1; k < MODEL_SAMPLES / 2; k++) {
+        double re = 0.0, im = 0.0;
+        double step = 2.0 * M_PI * k / MODEL_SAMPLES;
+        for (int n = 0; n < MODEL_SAMPLES; n++) {
+            re += windowed[n] * cos(step * n);
+            im -= windowed[n] * sin(step * n);
+        }
+        double binPower = re * re + im * im;
+        float freq = (float)k * MODEL_SAMPLE_RATE / MODEL_SAMPLES;
+        for (uint8_t b = 0; b < BAND_COUNT; b++) {
+            if (freq <= bandEdgesHz[b]) power[b] += binPower;
+        }
+    }
+}
+
+static double signalPower() {
+    double sum = 0.0;
+    for (int n = 0; n < MODEL_SAMPLES; n++) sum += (double)input[n] * input[n];
+    return sum / MODEL_SAMPLES;
+}
+
+// order < 0: 기존 절삭 변환
+static void runCase(const char* name, int order, double inputPower) {
+    TR808NoiseShaper shaper;
+    if (order >= 0) shaper.begin((uint8_t)order);
+
+    for (int n = 0; n < MODEL_SAMPLES; n++) {
+        uint8_t level = order < 0 ? (uint8_t)((input[n] + 32768) >> 8) : shaper.process(input[n]);
+        noise[n] = (float)((int32_t)level * TR808_SHAPER_STEP - 32768 - input[n]);
+    }
+
+    double power[BAND_COUNT];
+    bandNoisePower(power);
+
+    // 창 전력 보정: Hann 창 에너지 = 3/8, 파스발 -> 평균 전력
+    double scale = 1.0 / ((double)MODEL_SAMPLES * MODEL_SAMPLES * 0.375) * 2.0;
+    printf("  %-10s", name);
+    for (uint8_t b = 0; b < BAND_COUNT; b++) {
+        double snr = 10.0 * log10(inputPower / (power[b] * scale + 1e-12));
+        printf(" %10.1f", snr);
+    }
+    printf("\n");
+}
+
+static void runSignal(const char* title) {
+    double inputPower = signalPower();
+    printf("%s\n", title);
+    printf("  %-10s %10s %10s %10s  (SNR dB)\n", "", "0-8kHz", "0-16kHz", "0-32kHz");
+    runCase("truncate", -1, inputPower);
+    runCase("order 0", 0, inputPower);
+    runCase("order 1", 1, inputPower);
+    runCase("order 2", 2, inputPower);
+    printf("\n");
+}
+
+int main() {
+    printf("PWM 재양자화: 16 -> %d비트, %d Hz, %d샘플\n\n",
+           TR808_SHAPER_OUTPUT_BITS, MODEL_SAMPLE_RATE, MODEL_SAMPLES);
+
+    for (int n = 0; n < MODEL_SAMPLES; n++) {
+        input[n] = (int16_t)(16384.0f * sinf(2.0f * (float)M_PI * 1000.0f * n / MODEL_SAMPLE_RATE));
+    }
+    runSignal("1kHz 사인 -6dBFS");
+
+    for (int n = 0; n < MODEL_SAMPLES; n++) {
+        float envelope = 4096.0f * expf(-(float)n / (MODEL_SAMPLE_RATE * 0.05f));
+        input[n] = (int16_t)(envelope * sinf(2.0f * (float)M_PI * 200.0f * n / MODEL_SAMPLE_RATE));
+    }
+    runSignal("200Hz 감쇠 사인 -18dBFS 시작 (50ms 시상수)");
+    return 0;
+}
@@ -0,0 +1,207 @@
+/*
+ * 금속성 구형파 에일리어싱 / 비용 비교
+ *
+ * TR808Oscillator의 naive 구형파와 PolyBLEP 구형파(generateSquareBlep)를 비교
+ * - 에일리어싱: 0~16kHz 대역에서 홀수 배음 빈 밖의 전력 / 배음 전력 (dB, 낮을수록 깨끗)
+ *   naive 32768Hz / naive 64000Hz (Mozzi 엔진 레이트) / PolyBLEP 32768Hz
+ *   신호: 금속성 뱅크 주파수 단독 + 심벌 뱅크 6개 합
+ * - 비용: 오실레이터 ns/샘플과 오디오 1초당 ns, 전체 킷 렌더 32768Hz vs 64000Hz
+ * - 호스트 수치는 상대 비교용: FPU 없는 ESP32C3 사이클은 스케치의 'bench square' 명령
+ *
+ * 빌드:
+ *   g++ -std=c++11 -O2 -Iextras/host -Isrc extras/host/square_alias.cpp \
+ *       src/tr808_drums.cpp -o square_alias
+ * 실행:
+ *   ./square_alias
+ *
+ * 작성일: 2025-10-30
+ * 호환성: 호스트 (g++ / clang++, C++11)
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include <chrono>
+#include "tr808_drums.h"
+
+#define BASE_RATE        32768
+#define OVERSAMPLED_RATE 64000      // MOZZI_TR808_AUDIO_RATE (기존 64kHz 구성)
+#define BAND_HZ          16000.0f   // 비교 대역 (32768Hz 나이퀴스트 이하)
+#define BIN_HZ           4.0f       // 두 레이트에서 같은 빈 간격이 되도록 FFT 길이 선택
+#define HARMONIC_BINS    6          // 배음 빈 좌우 폭 (Blackman-Harris 주엽 +-4빈 + 주파수 오차)
+#define MAX_FFT          16384
+#define COST_SAMPLES     65536
+#define COST_RUNS        5          // 최소값 채택 (스케줄링 잡음 제거)
+
+enum SquareKind : uint8_t {
+    SQUARE_NAIVE = 0,
+    SQUARE_BLEP
+};
+
+static double re[MAX_FFT];
+static double im[MAX_FFT];
+static bool harmonic[MAX_FFT / 2];
+
+static uint64_t nanoCounter() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 반복형 radix-2 FFT (제자리)
+static void fft(uint32_t n) {
+    for (uint32_t i = 1, j = 0; i < n; i++) {
+        uint32_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) {
+            double t = re[i]; re[i] = re[j]; re[j] = t;
+            t = im[i]; im[i] = im[j]; im[j] = t;
+        }
+    }
+    for (uint32_t len = 2; len <= n; len <<= 1) {
+        double angle = -2.0 * M_PI / len;
+        for (uint32_t i = 0; i < n; i += len) {
+            for (uint32_t k = 0; k < len / 2; k++) {
+                double wr = cos(angle * k), wi = sin(angle * k);
+                uint32_t a = i + k, b = i + k + len / 2;
+                double xr = re[b] * wr - im[b] * wi;
+                double xi = re[b] * wi + im[b] * wr;
+                re[b] = re[a] - xr; im[b] = im[a] - xi;
+                re[a] += xr; im[a] += xi;
+            }
+        }
+    }
+}
+
+static float render(TR808Oscillator& osc, SquareKind kind) {
+    return kind == SQUARE_BLEP ? osc.generateSquareBlep() : osc.generateSquare();
+}
+
+/**
+ * 오실레이터 뱅크를 렌더해 대역 내 에일리어싱 비율(dB) 계산
+ * 배음 빈 = 각 주파수의 홀수 배음(나이퀴스트 이하) 주변, 나머지 대역 내 빈 = 에일리어싱
+ */
+static double aliasDb(const float* freqs, uint8_t count, uint32_t rate, SquareKind kind) {
+    tr808Rate.set(rate);
+    uint32_t n = 1;
+    while (n < rate / BIN_HZ) n <<= 1;
+    float binHz = (float)rate / n;
+
+    TR808Oscillator bank[6];
+    for (uint8_t i = 0; i < count; i++) {
+        bank[i].setFrequency(freqs[i]);
+    }
+    // 시작 과도 구간을 건너뜀
+    for (uint32_t s = 0; s < n / 4; s++) {
+        for (uint8_t i = 0; i < count; i++) render(bank[i], kind);
+    }
+    for (uint32_t s = 0; s < n; s++) {
+        float mixed = 0.0f;
+        for (uint8_t i = 0; i < count; i++) mixed += render(bank[i], kind);
+        // 4항 Blackman-Harris 창 (부엽 -92dB)
+        double w = 2.0 * M_PI * s / n;
+        double window = 0.35875 - 0.48829 * cos(w) + 0.14128 * cos(2 * w) - 0.01168 * cos(3 * w);
+        re[s] = mixed / count * window;
+        im[s] = 0.0;
+    }
+    fft(n);
+
+    for (uint32_t k = 0; k < n / 2; k++) harmonic[k] = false;
+    for (uint8_t i = 0; i < count; i++) {
+        for (float h = freqs[i]; h < rate / 2.0f; h += 2.0f * freqs[i]) {
+            int32_t center = (int32_t)(h / binHz + 0.5f);
+            for (int32_t k = center - HARMONIC_BINS; k <= center + HARMONIC_BINS; k++) {
+                if (k >= 0 && k < (int32_t)(n / 2)) harmonic[k] = true;
+            }
+        }
+    }
+
+    double harmonicPower = 0.0, aliasPower = 0.0;
+    for (uint32_t k = 1; k < n / 2 && k * binHz <= BAND_HZ; k++) {
+        double power = re[k] * re[k] + im[k] * im[k];
+        if (harmonic[k]) harmonicPower += power;
+        else aliasPower += power;
+    }
+    return 10.0 * log10(aliasPower / harmonicPower);
+}
+
+// 오실레이터 6개 뱅크 렌더 비용 (ns/샘플)
+static double oscillatorCost(SquareKind kind) {
+    tr808Rate.set(BASE_RATE);
+    TR808Oscillator bank[6];
+    for (uint8_t i = 0; i < 6; i++) bank[i].setFrequency(TR808_METAL_FREQS[i]);
+
+    uint64_t best = ~0ULL;
+    volatile float sink = 0.0f;
+    for (int run = 0; run < COST_RUNS; run++) {
+        uint64_t start = nanoCounter();
+        for (uint32_t s = 0; s < COST_SAMPLES; s++) {
+            float mixed = 0.0f;
+            for (uint8_t i = 0; i < 6; i++) mixed += render(bank[i], kind);
+            sink = sink + mixed;
+        }
+        uint64_t ns = nanoCounter() - start;
+        if (ns < best) best = ns;
+    }
+    return (double)best / COST_SAMPLES;
+}
+
+// 전체 킷 렌더 비용 (오디오 1초당 ms), 모든 보이스 트리거 상태
+static double kitCostPerSecond(uint32_t rate) {
+    static TR808DrumMachine engine;
+    engine.setSampleRate(rate);
+    engine.applyPendingSampleRate();
+
+    uint64_t best = ~0ULL;
+    volatile float sink = 0.0f;
+    for (int run = 0; run < COST_RUNS; run++) {
+        engine.triggerKick(); engine.triggerSnare(); engine.triggerCymbal();
+        engine.triggerHiHat(1.0f, true); engine.triggerTom(); engine.triggerConga();
+        engine.triggerRimshot(); engine.triggerMaracas(); engine.triggerClap();
+        engine.triggerCowbell();
+        uint64_t start = nanoCounter();
+        for (uint32_t s = 0; s < COST_SAMPLES; s++) {
+            sink = sink + engine.process();
+        }
+        uint64_t ns = nanoCounter() - start;
+        if (ns < best) best = ns;
+    }
+    return (double)best / COST_SAMPLES * rate / 1e6;
+}
+
+int main() {
+    printf("금속성 구형파 에일리어싱 (0~%.0f Hz, 배음 밖 전력 / 배음 전력)\n", BAND_HZ);
+    printf("%-14s %14s %14s %14s\n", "신호", "naive 32768", "naive 64000", "BLEP 32768");
+
+    for (uint8_t i = 0; i < 6; i++) {
+        char name[16];
+        snprintf(name, sizeof(name), "%.1f Hz", TR808_METAL_FREQS[i]);
+        const float* f = &TR808_METAL_FREQS[i];
+        printf("%-14s %11.1f dB %11.1f dB %11.1f dB\n", name,
+               aliasDb(f, 1, BASE_RATE, SQUARE_NAIVE),
+               aliasDb(f, 1, OVERSAMPLED_RATE, SQUARE_NAIVE),
+               aliasDb(f, 1, BASE_RATE, SQUARE_BLEP));
+    }
+    printf("%-14s %11.1f dB %11.1f dB %11.1f dB\n", "심벌 뱅크 6개",
+           aliasDb(TR808_METAL_FREQS, 6, BASE_RATE, SQUARE_NAIVE),
+           aliasDb(TR808_METAL_FREQS, 6, OVERSAMPLED_RATE, SQUARE_NAIVE),
+           aliasDb(TR808_METAL_FREQS, 6, BASE_RATE, SQUARE_BLEP));
+    printf("%-14s %11.1f dB %11.1f dB %11.1f dB\n", "카우벨 2개",
+           aliasDb(TR808_METAL_FREQS, 2, BASE_RATE, SQUARE_NAIVE),
+           aliasDb(TR808_METAL_FREQS, 2, OVERSAMPLED_RATE, SQUARE_NAIVE),
+           aliasDb(TR808_METAL_FREQS, 2, BASE_RATE, SQUARE_BLEP));
+
+    double naive = oscillatorCost(SQUARE_NAIVE);
+    double blep = oscillatorCost(SQUARE_BLEP);
+    printf("\n오실레이터 뱅크 6개 (호스트 ns/샘플)\n");
+    printf("  naive  %6.2f ns  -> 32768Hz %.2f ms/s, 64000Hz %.2f ms/s\n",
+           naive, naive * BASE_RATE / 1e6, naive * OVERSAMPLED_RATE / 1e6);
+    printf("  BLEP   %6.2f ns  -> 32768Hz %.2f ms/s (naive 대비 %.2fx)\n",
+           blep, blep * BASE_RATE / 1e6, blep / naive);
+
+    double kitBase = kitCostPerSecond(BASE_RATE);
+    double kitOversampled = kitCostPerSecond(OVERSAMPLED_RATE);
+    printf("\n전체 킷 (모든 보이스 재생, 오디오 1초당 호스트 렌더 ms)\n");
+    printf("  32768Hz %.2f ms  /  64000Hz %.2f ms  (%.2fx)\n",
+           kitBase, kitOversampled, kitOversampled / kitBase);
+    return 0;
+}
@@ -0,0 +1,16 @@
+/*
+ * 호스트 빌드용 brownnoise8192_int8 대체 테이블 (tr808_host_tables.h 참조)
+ */
+
+#ifndef BROWNNOISE8192_INT8_H_
+#define BROWNNOISE8192_INT8_H_
+
+#include "tr808_host_tables.h"
+
+#define BROWNNOISE8192_NUM_CELLS 8192
+#define BROWNNOISE8192_SAMPLERATE 8192
+
+static const TR808HostBrownNoiseTable<BROWNNOISE8192_NUM_CELLS> tr808HostBrownNoise8192;
+#define BROWNNOISE8192_DATA (tr808HostBrownNoise8192.data)
+
+#endif /* BROWNNOISE8192_INT8_H_ */
@@ -0,0 +1,16 @@
+/*
+ * 호스트 빌드용 sin2048_int8 대체 테이블 (tr808_host_tables.h 참조)
+ */
+
+#ifndef SIN2048_INT8_H_
+#define SIN2048_INT8_H_
+
+#include "tr808_host_tables.h"
+
+#define SIN2048_NUM_CELLS 2048
+#define SIN2048_SAMPLERATE 2048
+
+static const TR808HostSineTable<SIN2048_NUM_CELLS> tr808HostSin2048;
+#define SIN2048_DATA (tr808HostSin2048.data)
+
+#endif /* SIN2048_INT8_H_ */
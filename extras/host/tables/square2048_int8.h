@@ -0,0 +1,16 @@
+/*
+ * 호스트 빌드용 square2048_int8 대체 테이블 (tr808_host_tables.h 참조)
+ */
+
+#ifndef SQUARE2048_INT8_H_
+#define SQUARE2048_INT8_H_
+
+#include "tr808_host_tables.h"
+
+#define SQUARE2048_NUM_CELLS 2048
+#define SQUARE2048_SAMPLERATE 2048
+
+static const TR808HostSquareTable<SQUARE2048_NUM_CELLS> tr808HostSquare2048;
+#define SQUARE2048_DATA (tr808HostSquare2048.data)
+
+#endif /* SQUARE2048_INT8_H_ */
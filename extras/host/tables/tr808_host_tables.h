@@ -0,0 +1,61 @@
+/*
+ * 호스트 빌드용 Mozzi 웨이브테이블 생성기
+ *
+ * Mozzi 배포 테이블 데이터를 복사하지 않고 같은 크기/형식(int8)으로 재생성
+ * - 사인/사각: 수식으로 생성 (Mozzi 값과 최대 1 LSB 차이 가능)
+ * - 브라운 노이즈: 고정 시드 랜덤 워크 (파형 통계만 유사, 샘플 값은 다름)
+ * 정적 초기화 시 한 번 생성, Oscil은 포인터만 보관하므로 초기화 순서와 무관
+ *
+ * 작성일: 2025-10-30
+ * 호환성: 호스트
+ */
+
+#ifndef TR808_HOST_TABLES_H
+#define TR808_HOST_TABLES_H
+
+#include <stdint.h>
+#include <math.h>
+
+template <int CELLS>
+struct TR808HostSineTable {
+    int8_t data[CELLS];
+    TR808HostSineTable() {
+        for (int i = 0; i < CELLS; i++) {
+            data[i] = (int8_t)lrint(127.0 * sin(6.283185307179586 * i / CELLS));
+        }
+    }
+};
+
+template <int CELLS>
+struct TR808HostSquareTable {
+    int8_t data[CELLS];
+    TR808HostSquareTable() {
+        for (int i = 0; i < CELLS; i++) {
+            data[i] = (i < CELLS / 2) ? 127 : -128;
+        }
+    }
+};
+
+template <int CELLS>
+struct TR808HostBrownNoiseTable {
+    int8_t data[CELLS];
+    TR808HostBrownNoiseTable() {
+        // 누적 랜덤 워크 -> 누설 적분으로 DC 억제 -> 최대값 정규화
+        static float walk[CELLS];
+        uint32_t seed = 0x808808u;
+        float level = 0.0f;
+        float peak = 1e-6f;
+        for (int i = 0; i < CELLS; i++) {
+            seed = seed * 1664525u + 1013904223u;
+            float white = (float)(int32_t)seed / 2147483648.0f;
+            level = level * 0.995f + white;
+            walk[i] = level;
+            if (fabsf(level) > peak) peak = fabsf(level);
+        }
+        for (int i = 0; i < CELLS; i++) {
+            data[i] = (int8_t)lrintf(walk[i] * 127.0f / peak);
+        }
+    }
+};
+
+#endif // TR808_HOST_TABLES_H
@@ -0,0 +1,128 @@
+/*
+ * 트레이스 덤프 -> Chrome/Perfetto 트레이스 JSON 변환기
+ *
+ * 스케치의 'trace dump' 출력(시리얼 캡처 파일)에서 TR808_TRACE_MAGIC을 찾아
+ * 헤더 + 레코드를 읽고 chrome://tracing / ui.perfetto.dev에서 여는 JSON으로 변환
+ * - 앞뒤의 콘솔 텍스트는 무시 (표식 이후 바이너리만 해석)
+ * - 타임스탬프: 32비트 사이클을 부호 있는 차분으로 이어 붙임 (랩/ISR 교차 기록 허용)
+ * - 트랙별 B/E 짝: 덤프 시작 전에 열린 구간의 E는 버림
+ *
+ * 빌드:
+ *   g++ -std=c++11 -O2 -Isrc extras/host/trace_to_json.cpp -o trace_to_json
+ * 실행:
+ *   pio device monitor --raw > capture.bin   (콘솔에서 'trace dump' 입력 후 종료)
+ *   ./trace_to_json capture.bin > trace.json
+ *
+ * 작성일: 2025-10-30
+ * 호환성: 호스트 (g++ / clang++, C++11)
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "tr808_trace.h"
+
+static const char* const TRACK_NAMES[] = {
+    "", "audio", "isr", "serial", "control", "sequencer"
+};
+
+static bool readFile(const char* path, std::vector<uint8_t>* data) {
+    FILE* file = fopen(path, "rb");
+    if (!file) return false;
+    uint8_t chunk[4096];
+    size_t count;
+    while ((count = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        data->insert(data->end(), chunk, chunk + count);
+    }
+    fclose(file);
+    return true;
+}
+
+// 마지막 덤프를 사용 (캡처에 여러 번 덤프한 경우)
+static long findMagic(const std::vector<uint8_t>& data) {
+    const size_t magicSize = 8;
+    if (data.size() < magicSize) return -1;
+    for (long i = (long)(data.size() - magicSize); i >= 0; i--) {
+        if (memcmp(&data[i], TR808_TRACE_MAGIC, magicSize) == 0) return i;
+    }
+    return -1;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "사용법: %s <덤프 파일> > trace.json\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<uint8_t> data;
+    if (!readFile(argv[1], &data)) {
+        fprintf(stderr, "파일을 열 수 없음: %s\n", argv[1]);
+        return 1;
+    }
+
+    long offset = findMagic(data);
+    if (offset < 0 || offset + sizeof(TR808TraceHeader) > data.size()) {
+        fprintf(stderr, "트레이스 덤프 표식(%s)을 찾지 못함\n", TR808_TRACE_MAGIC);
+        return 1;
+    }
+
+    TR808TraceHeader header;
+    memcpy(&header, &data[offset], sizeof(header));
+    if (header.version != TR808_TRACE_VERSION || header.recordSize != sizeof(TR808TraceRecord)) {
+        fprintf(stderr, "지원하지 않는 덤프 형식 (버전 %u, 레코드 %u바이트)\n",
+                header.version, header.recordSize);
+        return 1;
+    }
+
+    size_t available = (data.size() - offset - sizeof(header)) / sizeof(TR808TraceRecord);
+    uint32_t count = header.recordCount;
+    if (count > available) {
+        fprintf(stderr, "경고: 레코드 %u개 중 %u개만 수신됨\n", count, (unsigned)available);
+        count = (uint32_t)available;
+    }
+    const uint8_t* recordBytes = &data[offset + sizeof(header)];
+    double usPerCycle = header.cycleHz > 0 ? 1000000.0 / header.cycleHz : 1.0;
+
+    printf("{\"displayTimeUnit\":\"ns\",\"otherData\":{\"cycleHz\":%u,\"lost\":%u},\n",
+           header.cycleHz, header.lost);
+    printf("\"traceEvents\":[\n");
+    for (int track = TR808_TRACK_AUDIO; track <= TR808_TRACK_SEQUENCER; track++) {
+        printf("{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}},\n",
+               track, TRACK_NAMES[track]);
+    }
+
+    int depth[TR808_TRACK_SEQUENCER + 1] = {0};
+    int64_t time = 0;
+    uint32_t previous = 0;
+    bool started = false;               // 기준 레코드 (첫 유효 레코드, 앞쪽 빈 슬롯은 건너뜀)
+    uint32_t written = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        TR808TraceRecord record;
+        memcpy(&record, recordBytes + i * sizeof(record), sizeof(record));
+        if (record.event == TR808_TRACE_NONE || record.event >= TR808_TRACE_EVENT_COUNT) continue;
+
+        // 마지막으로 받아들인 레코드 기준 경과 시간 (건너뛴 레코드의 사이클은 쓰지 않음)
+        if (started) time += (int32_t)(record.cycles - previous);
+        previous = record.cycles;
+        started = true;
+
+        const TR808TraceEventInfo& info = TR808_TRACE_EVENT_INFO[record.event];
+        if (info.phase == 'B') {
+            depth[info.track]++;
+        } else if (info.phase == 'E') {
+            if (depth[info.track] == 0) continue;
+            depth[info.track]--;
+        }
+
+        printf("%s{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%u",
+               written > 0 ? ",\n" : "", info.name, info.phase, time * usPerCycle, info.track);
+        if (info.phase == 'i') printf(",\"s\":\"t\"");
+        if (info.phase != 'E') printf(",\"args\":{\"arg\":%u}", record.arg);
+        printf("}");
+        written++;
+    }
+    printf("\n]}\n");
+
+    fprintf(stderr, "이벤트 %u개 변환 (덮어써져 빠진 레코드 %u개)\n", written, header.lost);
+    return 0;
+}
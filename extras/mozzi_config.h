@@ -2,7 +2,7 @@
  * Mozzi Library ESP32C3 최적화 설정 파일
  * 
  * ESP32C3 (RISC-V)와 Mozzi Library의 호환성을 위한 최적화된 설정
- * 32.768kHz AudioRate, 외부 출력 모드, ESP32_C3_TimerInterrupt 활용
+ * 64kHz AudioRate, I2S DMA 블록 출력 (샘플당 타이머 ISR 없음)
  * 
  * 작성일: 2025-10-30
  * 호환성: ESP32C3 + Mozzi Library
@@ -25,23 +25,46 @@
 #define MOZZI_OUTPUT_EXTERNAL_TIMED
 
 // =============================================================================
-// ESP32C3 전용 타이머 인터럽트 설정
+// ESP32C3 DMA 블록 출력 설정 (dma_output_esp32c3.cpp)
 // =============================================================================
 
-// ESP32C3 TimerInterrupt 라이브러리 사용
-#define ESP32C3_TIMER_INTERRUPT
+// 샘플 주기 (마이크로초 단위)
+#define TIMER_INTERVAL_US (1000000UL / MOZZI_AUDIO_RATE)  // 15.6μs @ 64kHz
+
+// I2S DMA 디스크립터 링: 블록 하나 완료(2블록이면 링 절반) 때마다 렌더 태스크를 깨움
+// 샘플당 64000회 타이머 인터럽트 -> 블록당 1회 (500회/초 @ 128샘플)
+#define DMA_OUTPUT_BLOCKS 2                                 // 핑퐁 (렌더 여유 = 1블록 주기)
+#define DMA_BLOCK_SAMPLES MOZZI_OUTPUT_BUFFER_SIZE          // 블록당 샘플
+#define DMA_BLOCK_PERIOD_US ((1000000UL * DMA_BLOCK_SAMPLES) / MOZZI_AUDIO_RATE)  // 2ms
+#define DMA_WAIT_TIMEOUT_MS 20                              // 블록 완료 대기 상한 (정지 감지)
+
+// 적응형 지연 (buffer_manager_esp32c3.cpp): 언더런/서비스 시간으로 블록 크기를 2배씩 조정
+// 최소 크기에서 시작, 크기 변경은 무음 블록(안전 지점)에서 출력 재설정
+// 라이브 연주는 최소를 낮게, 설치물은 setAdaptiveLatencyLimits()로 최소=최대 (고정)
+#define ADAPTIVE_LATENCY_ENABLED
+#define ADAPTIVE_MIN_BLOCK_SAMPLES 32                       // 0.5ms @ 64kHz
+#define ADAPTIVE_MAX_BLOCK_SAMPLES 512                      // 8ms @ 64kHz
+#define ADAPTIVE_SILENCE_THRESHOLD 64                       // 안전 지점: 블록 피크 |샘플| 이하
+
+#ifdef ADAPTIVE_LATENCY_ENABLED
+    #define DMA_INITIAL_BLOCK_SAMPLES ADAPTIVE_MIN_BLOCK_SAMPLES
+    #define DMA_MAX_BLOCK_SAMPLES ADAPTIVE_MAX_BLOCK_SAMPLES    // 정적 버퍼 크기
+#else
+    #define DMA_INITIAL_BLOCK_SAMPLES DMA_BLOCK_SAMPLES
+    #define DMA_MAX_BLOCK_SAMPLES DMA_BLOCK_SAMPLES
+#endif
 
-// 타이머 기본 설정
-#define TIMER_BASE_CLK 80000000UL      // 80MHz 기준 클럭
-#define TIMER_DIVIDER 80               // 1MHz 타이머 클럭 (분주 계수)
-#define TIMER_CLOCK_FREQ 1000000UL     // 최종 타이머 클럭
+// 렌더 태스크 (블록 완료 이벤트로 깨어남)
+#define DMA_RENDER_TASK_PRIORITY (configMAX_PRIORITIES - 2)
+#define DMA_RENDER_TASK_STACK 4096
 
-// 타이머 인터럽트 우선순위 (높을수록 중요)
-#define AUDIO_TIMER_PRIORITY 5
-#define AUDIO_TIMER_SUB_PRIORITY 0
+// 컨트롤 갱신 간격 (렌더 루프에서 샘플 수로 호출)
+#define CONTROL_UPDATE_SAMPLES (MOZZI_AUDIO_RATE / MOZZI_CONTROL_RATE)
 
-// 인터럽트 간격 계산 (마이크로초 단위)
-#define TIMER_INTERVAL_US (1000000UL / MOZZI_AUDIO_RATE)  // 15.6μs @ 64kHz
+// I2S 핀 (외부 DAC)
+#define DMA_I2S_BCK_PIN 7
+#define DMA_I2S_WS_PIN 8
+#define DMA_I2S_DATA_PIN 9
 
 // =============================================================================
 // 버퍼 관리 최적화 설정
@@ -115,10 +138,19 @@
 // 오디오 출력 채널 매핑
 #define AUDIO_OUTPUT_CHANNEL GPIO_NUM_18  // GPIO 18 (I2S 또는 PWM)
 
-// PWM 설정 (필요 시 사용)
+// PWM 설정 (AUDIO_OUTPUT_PWM 빌드, audio_output_esp32c3.cpp)
 #define PWM_CHANNEL 0
 #define PWM_RESOLUTION 8                    // 8-bit PWM
-#define PWM_FREQUENCY 8000                  // 8kHz PWM 주파수
+#define PWM_FREQUENCY 312500                // 80MHz / 256: 8비트 최대 캐리어 (샘플 레이트의 ~5배)
+
+// 출력 백엔드: 기본 I2S DMA (외부 DAC), 정의하면 LEDC PWM 블록 출력 (저가형 보드)
+// #define AUDIO_OUTPUT_PWM
+
+// PWM 블록 출력: 렌더 태스크가 16 -> 8비트 재양자화한 블록을 링에 넣고
+// 짧은 샘플 ISR은 링에서 듀티 값 하나를 읽어 레지스터에 쓰기만 함
+#define PWM_OUTPUT_BLOCKS 2                 // 핑퐁
+#define PWM_NOISE_SHAPING_ORDER 1           // 0: 반올림, 1/2: 오차 피드백 차수 (extras/host/pwm_noise_shaping.cpp)
+#define PWM_SAMPLE_TIMER_DIVIDER 2          // 80MHz / 2 = 40MHz (64kHz 주기 = 625틱)
 
 // =============================================================================
 // 메모리 최적화 설정
@@ -133,6 +165,18 @@
 // 메모리 사용량 모니터링
 #define MONITOR_MEMORY_USAGE
 
+// 시작 메모리 아레나 (buffer_manager_esp32c3.cpp): 표 순서대로 한 번 할당 후 봉인, 오디오 경로 힙 사용 없음
+// 예산 합계가 TR808_ARENA_LIMIT_BYTES(src/tr808_arena.h, -D로 변경)를 넘으면 빌드 실패
+#define MOZZI_MEMORY_POOL_BLOCKS 4          // allocateAudioMemory() 블록 수 (MOZZI_OUTPUT_BUFFER_SIZE 샘플씩)
+
+enum MozziArenaSlot : uint8_t {
+    MOZZI_ARENA_RENDER_BLOCK = 0,       // audioHook 렌더 블록 (DMA_MAX_BLOCK_SAMPLES)
+    MOZZI_ARENA_PWM_BLOCKS,             // PWM 듀티 링 (AUDIO_OUTPUT_PWM)
+    MOZZI_ARENA_MEMORY_POOL,            // 오디오 메모리 풀
+    MOZZI_ARENA_TRACE_RING,             // 트레이스 링 (TR808_TRACE)
+    MOZZI_ARENA_SLOT_COUNT
+};
+
 // =============================================================================
 // 실시간 성능 모니터링
 // =============================================================================
@@ -146,7 +190,7 @@
 // CPU 사용률 모니터링
 #define MONITOR_CPU_USAGE
 
-// 인터럽트 서비스 시간 측정
+// 블록 서비스 시간 측정 (DMA 블록 완료 -> 다음 블록 제출)
 #define MEASURE_ISR_TIMING
 
 // =============================================================================
@@ -194,9 +238,6 @@
 // 버퍼 지연 시간 (밀리초)
 #define BUFFER_LATENCY_MS ((MOZZI_OUTPUT_BUFFER_SIZE * 1000) / MOZZI_AUDIO_RATE)
 
-// 타이머 카운터 값 (32.768kHz를 위한 카운터)
-#define TIMER_COUNTER_VALUE (TIMER_CLOCK_FREQ / MOZZI_AUDIO_RATE)
-
 // =============================================================================
 // 함수 원형 선언
 // =============================================================================
@@ -211,9 +252,6 @@ void audioOutput(int16_t output);
 // Mozzi 오디오 훅 (외부 구현 필요)
 void audioHook();
 
-// ISR 핸들러 (외부 구현 필요)
-bool IRAM_ATTR TimerHandler(void *timerNo);
-
 // 성능 모니터링 함수들
 void initializePerformanceMonitoring(void);
 void updatePerformanceMetrics(void);
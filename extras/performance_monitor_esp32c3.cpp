@@ -3,9 +3,12 @@
  * 
  * 실시간 성능 측정, 지연 시간 분석, CPU 사용률 모니터링
  * ESP32C3의 RISC-V 아키텍처 특성을 고려한 최적화된 성능 추적
+ * 지연 시간은 로그-선형 히스토그램(CPU 사이클)으로 기록해 p50/p99/p99.9 꼬리를 추적
  */
 
 #include "mozzi_config.h"
+#include "../src/tr808_histogram.h"
+#include "../src/tr808_log.h"
 #include "esp_log.h"
 #include "esp_system.h"
 #include "freertos/FreeRTOS.h"
@@ -19,7 +22,6 @@ static const char* TAG = "ESP32C3_Performance";
 
 // 성능 측정 버퍼
 #define PERFORMANCE_BUFFER_SIZE 1000
-#define LATENCY_BUFFER_SIZE 100
 #define CPU_MONITORING_PERIOD 1000  // 1초
 
 // 오디오 성능 지표
@@ -27,33 +29,41 @@ volatile uint32_t audioSamplesProcessed = 0;
 volatile uint32_t audioDroppedSamples = 0;
 volatile uint32_t audioBufferOverflows = 0;
 
-// 타이머 성능 지표
-volatile uint32_t timerInterruptCount = 0;
-volatile uint32_t timerInterruptMisses = 0;
-volatile uint32_t maxTimerLatency = 0;
-volatile uint32_t avgTimerLatency = 0;
+// 블록 서비스 지표 (DMA 블록 완료 -> 다음 블록 제출)
+volatile uint32_t blockServiceCount = 0;
+volatile uint32_t blockServiceMisses = 0;
+volatile uint32_t maxBlockServiceTime = 0;
+volatile uint32_t avgBlockServiceTime = 0;
 
 // CPU 성능 지표
 volatile uint32_t cpuUsagePercent = 0;
 volatile uint32_t freeHeapBytes = 0;
 volatile uint32_t minFreeHeapBytes = 0;
 
-// 지연 시간 측정 버퍼
-static uint32_t latencyBuffer[LATENCY_BUFFER_SIZE];
-static size_t latencyIndex = 0;
-static uint32_t lastInterruptTime = 0;
+// 지연 히스토그램 (CPU 사이클, 보고 시 μs 변환)
+enum LatencyHistogramId {
+    LATENCY_BLOCK_SERVICE = 0,  // 블록 서비스 시간 (깨어남 -> 제출)
+    LATENCY_BLOCK_RENDER,       // 오디오 렌더 (audioHook 1회)
+    LATENCY_TRIGGER_OUTPUT,     // 트리거 -> 트리거 후 첫 출력 샘플
+    LATENCY_HISTOGRAM_COUNT
+};
 
-// 성능 통계 구조체
-typedef struct {
-    uint32_t min;
-    uint32_t max;
-    uint32_t avg;
-    uint32_t count;
-} PerformanceStats;
+static const char* const latencyHistogramNames[LATENCY_HISTOGRAM_COUNT] = {
+    "Block service", "Block render", "Trigger->output"
+};
 
-static PerformanceStats audioProcessingStats = {0};
-static PerformanceStats bufferOperationStats = {0};
-static PerformanceStats interruptServiceStats = {0};
+static TR808Histogram latencyHistograms[LATENCY_HISTOGRAM_COUNT];
+static TR808HistogramSnapshot sessionLatency[LATENCY_HISTOGRAM_COUNT];  // 구간 스냅샷 누적
+static TR808HistogramSnapshot intervalLatency;                          // 보고 시 재사용
+
+static uint32_t renderStartCycles = 0;
+static uint32_t serviceStartCycles = 0;
+static volatile uint32_t triggerCycles = 0;
+static volatile bool triggerPending = false;
+
+static void collectLatencyHistograms();
+void printLatencyHistograms();
+uint32_t getAudioBlockPeriodUs();   // buffer_manager_esp32c3.cpp (적응형 지연의 현재 블록 주기)
 
 // =============================================================================
 // 성능 모니터링 초기화
@@ -62,24 +72,26 @@ static PerformanceStats interruptServiceStats = {0};
 void initializePerformanceMonitoring() {
     DEBUG_PRINTLN("Initializing ESP32C3 performance monitoring...");
     
-    // 성능 버퍼 초기화
-    memset(latencyBuffer, 0, sizeof(latencyBuffer));
-    latencyIndex = 0;
-    lastInterruptTime = 0;
+    // 주기 보고/경고 출력 태스크 (타이머 설정 로그도 여기서 출력)
+    if (!tr808Log.startTask()) {
+        DEBUG_PRINTLN("WARNING: Failed to start log task");
+    }
     
-    // 통계 구조체 초기화
-    audioProcessingStats = (PerformanceStats){0, 0, 0, 0};
-    bufferOperationStats = (PerformanceStats){0, 0, 0, 0};
-    interruptServiceStats = (PerformanceStats){0, 0, 0, 0};
+    // 지연 히스토그램 초기화
+    for (int i = 0; i < LATENCY_HISTOGRAM_COUNT; i++) {
+        latencyHistograms[i].reset();
+        sessionLatency[i].clear();
+    }
+    triggerPending = false;
     
     // 성능 지표 초기화
     audioSamplesProcessed = 0;
     audioDroppedSamples = 0;
     audioBufferOverflows = 0;
-    timerInterruptCount = 0;
-    timerInterruptMisses = 0;
-    maxTimerLatency = 0;
-    avgTimerLatency = 0;
+    blockServiceCount = 0;
+    blockServiceMisses = 0;
+    maxBlockServiceTime = 0;
+    avgBlockServiceTime = 0;
     cpuUsagePercent = 0;
     
     // 최소 힙 메모리 초기화
@@ -99,25 +111,40 @@ void initializePerformanceMonitoring() {
 
 void startAudioProcessingTimer() {
 #ifdef MEASURE_LATENCY
-    lastInterruptTime = micros();
+    renderStartCycles = ESP.getCycleCount();
 #endif
 }
 
 void endAudioProcessingTimer() {
 #ifdef MEASURE_LATENCY
-    uint32_t latency = micros() - lastInterruptTime;
-    
-    // 지연 시간 버퍼에 저장
-    latencyBuffer[latencyIndex] = latency;
-    latencyIndex = (latencyIndex + 1) % LATENCY_BUFFER_SIZE;
-    
-    // 통계 업데이트
-    updatePerformanceStats(&audioProcessingStats, latency);
+    uint32_t now = ESP.getCycleCount();
+    latencyHistograms[LATENCY_BLOCK_RENDER].record(now - renderStartCycles);
+#endif
+}
+
+void markTriggerTime() {
+#ifdef MEASURE_LATENCY
+    // 렌더 전 연속 트리거는 첫 트리거 기준 (최악 지연)
+    if (!triggerPending) {
+        triggerCycles = ESP.getCycleCount();
+        triggerPending = true;
+    }
+#endif
+}
+
+void markFirstOutputSample() {
+#ifdef MEASURE_LATENCY
+    // 렌더 태스크는 트리거 경로보다 우선순위가 높아 트리거는 블록 사이에만 들어옴
+    // -> 트리거 후 처음 만든 블록의 첫 샘플이 트리거가 반영된 첫 출력 샘플
+    if (triggerPending) {
+        latencyHistograms[LATENCY_TRIGGER_OUTPUT].record(ESP.getCycleCount() - triggerCycles);
+        triggerPending = false;
+    }
 #endif
 }
 
-void incrementAudioSampleCount() {
-    audioSamplesProcessed++;
+void incrementAudioSampleCount(uint32_t samples) {
+    audioSamplesProcessed += samples;
     
 #ifdef MONITOR_MEMORY_USAGE
     // 주기적으로 메모리 사용량 체크
@@ -142,66 +169,54 @@ void recordBufferOverflow() {
 }
 
 // =============================================================================
-// 인터럽트 성능 측정
+// 블록 서비스 측정
 // =============================================================================
 
-void startInterruptTimer() {
+void startBlockServiceTimer() {
 #ifdef MEASURE_ISR_TIMING
-    lastInterruptTime = micros();
+    serviceStartCycles = ESP.getCycleCount();
 #endif
 }
 
-void endInterruptTimer() {
+void endBlockServiceTimer() {
 #ifdef MEASURE_ISR_TIMING
-    uint32_t isrTime = micros() - lastInterruptTime;
-    
-    timerInterruptCount++;
-    
-    // 최대 지연 시간 업데이트
-    if (isrTime > maxTimerLatency) {
-        maxTimerLatency = isrTime;
-    }
-    
-    // 인터럽트 누락 감지 (지연이 2배 이상인 경우)
-    if (isrTime > (TIMER_INTERVAL_US * 2)) {
-        timerInterruptMisses++;
-    }
+    uint32_t serviceCycles = ESP.getCycleCount() - serviceStartCycles;
     
-    // 평균 지연 시간 계산 (移動平均)
-    static uint32_t isrSamples = 0;
-    static uint32_t isrSum = 0;
+    blockServiceCount++;
+    latencyHistograms[LATENCY_BLOCK_SERVICE].record(serviceCycles);
     
-    isrSum += isrTime;
-    isrSamples++;
-    
-    if (isrSamples >= 1000) { // 1000샘플마다 업데이트
-        avgTimerLatency = isrSum / isrSamples;
-        isrSum = 0;
-        isrSamples = 0;
+    // 블록 주기를 넘긴 서비스 = 다음 완료 이벤트를 놓침 (핑퐁이면 언더런 직전)
+    if (serviceCycles > getAudioBlockPeriodUs() * ESP.getCpuFreqMHz()) {
+        blockServiceMisses++;
     }
-    
-    // 통계 업데이트
-    updatePerformanceStats(&interruptServiceStats, isrTime);
 #endif
 }
 
 // =============================================================================
-// 통계 업데이트 함수
+// 지연 히스토그램 스냅샷
 // =============================================================================
 
-void updatePerformanceStats(PerformanceStats* stats, uint32_t value) {
-    stats->count++;
-    
-    if (stats->min == 0 || value < stats->min) {
-        stats->min = value;
-    }
-    
-    if (value > stats->max) {
-        stats->max = value;
+/**
+ * 구간 스냅샷을 읽고 초기화한 뒤 세션 누적에 병합
+ * 모니터 태스크/보고 함수에서만 호출 (기록자보다 낮은 우선순위)
+ */
+static void collectLatencyHistograms() {
+    for (int i = 0; i < LATENCY_HISTOGRAM_COUNT; i++) {
+        latencyHistograms[i].snapshot(&intervalLatency, true);
+        sessionLatency[i].merge(intervalLatency);
     }
     
-    // 평균 계산 (이동 평균)
-    stats->avg = ((stats->avg * (stats->count - 1)) + value) / stats->count;
+    // 기존 지표는 세션 분포에서 파생 (μs)
+    uint32_t cyclesPerUs = ESP.getCpuFreqMHz();
+    const TR808HistogramSnapshot& service = sessionLatency[LATENCY_BLOCK_SERVICE];
+    maxBlockServiceTime = service.maxValue / cyclesPerUs;
+    avgBlockServiceTime = service.mean() / cyclesPerUs;
+}
+
+const TR808HistogramSnapshot* getLatencyHistogram(uint8_t id) {
+    if (id >= LATENCY_HISTOGRAM_COUNT) return NULL;
+    collectLatencyHistograms();
+    return &sessionLatency[id];
 }
 
 // =============================================================================
@@ -254,44 +269,26 @@ void printPerformanceReport() {
         DEBUG_PRINTLN("%");
     }
     
-    // 타이머 성능 정보
-    DEBUG_PRINT("Timer Interrupts: ");
-    DEBUG_PRINTLN(timerInterruptCount);
+    // 블록 서비스 정보
+    DEBUG_PRINT("Blocks Serviced: ");
+    DEBUG_PRINTLN(blockServiceCount);
+    
+    DEBUG_PRINT("Block Service Misses: ");
+    DEBUG_PRINTLN(blockServiceMisses);
     
-    DEBUG_PRINT("Timer Interrupt Misses: ");
-    DEBUG_PRINTLN(timerInterruptMisses);
+    // 구간 히스토그램을 세션 누적에 반영 (최대/평균도 여기서 갱신)
+    collectLatencyHistograms();
     
-    DEBUG_PRINT("Max Timer Latency: ");
-    DEBUG_PRINT(maxTimerLatency);
+    DEBUG_PRINT("Max Block Service: ");
+    DEBUG_PRINT(maxBlockServiceTime);
     DEBUG_PRINTLN(" μs");
     
-    DEBUG_PRINT("Avg Timer Latency: ");
-    DEBUG_PRINT(avgTimerLatency);
+    DEBUG_PRINT("Avg Block Service: ");
+    DEBUG_PRINT(avgBlockServiceTime);
     DEBUG_PRINTLN(" μs");
     
-    // 오디오 처리 통계
-    if (audioProcessingStats.count > 0) {
-        DEBUG_PRINT("Audio Processing Stats (μs):");
-        DEBUG_PRINT(" Min: ");
-        DEBUG_PRINT(audioProcessingStats.min);
-        DEBUG_PRINT(" Max: ");
-        DEBUG_PRINT(audioProcessingStats.max);
-        DEBUG_PRINT(" Avg: ");
-        DEBUG_PRINT(audioProcessingStats.avg);
-        DEBUG_PRINTLN();
-    }
-    
-    // 인터럽트 서비스 통계
-    if (interruptServiceStats.count > 0) {
-        DEBUG_PRINT("ISR Stats (μs):");
-        DEBUG_PRINT(" Min: ");
-        DEBUG_PRINT(interruptServiceStats.min);
-        DEBUG_PRINT(" Max: ");
-        DEBUG_PRINT(interruptServiceStats.max);
-        DEBUG_PRINT(" Avg: ");
-        DEBUG_PRINT(interruptServiceStats.avg);
-        DEBUG_PRINTLN();
-    }
+    // 지연 분포 (세션 누적)
+    printLatencyHistograms();
     
     // CPU 사용률 정보
     DEBUG_PRINT("CPU Usage: ");
@@ -376,65 +373,51 @@ void printSystemInfo() {
 // 지연 시간 분석
 // =============================================================================
 
+static void printLatencyLine(const char* name, const TR808HistogramSnapshot& h, uint32_t cyclesPerUs) {
+    // 힙 String 없이 한 번에 포맷
+    DEBUG_PRINTF("%s (μs): p50 %.1f p99 %.1f p99.9 %.1f max %.1f n=%lu\n", name,
+                 h.percentile(TR808_P50) / (float)cyclesPerUs,
+                 h.percentile(TR808_P99) / (float)cyclesPerUs,
+                 h.percentile(TR808_P999) / (float)cyclesPerUs,
+                 h.maxValue / (float)cyclesPerUs, (unsigned long)h.total);
+}
+
+void printLatencyHistograms() {
+    uint32_t cyclesPerUs = ESP.getCpuFreqMHz();
+    for (int i = 0; i < LATENCY_HISTOGRAM_COUNT; i++) {
+        if (sessionLatency[i].total > 0) {
+            printLatencyLine(latencyHistogramNames[i], sessionLatency[i], cyclesPerUs);
+        }
+    }
+}
+
 void analyzeLatency() {
-    if (latencyIndex == 0) {
+    collectLatencyHistograms();
+    
+    const TR808HistogramSnapshot& render = sessionLatency[LATENCY_BLOCK_RENDER];
+    const TR808HistogramSnapshot& service = sessionLatency[LATENCY_BLOCK_SERVICE];
+    if (render.total == 0 && service.total == 0) {
         DEBUG_PRINTLN("No latency data available");
         return;
     }
     
     DEBUG_PRINTLN("=== Latency Analysis ===");
+    printLatencyHistograms();
     
-    uint32_t min = UINT32_MAX;
-    uint32_t max = 0;
-    uint32_t sum = 0;
-    uint32_t count = 0;
-    
-    // 지연 시간 통계 계산
-    for (size_t i = 0; i < LATENCY_BUFFER_SIZE; i++) {
-        if (latencyBuffer[i] > 0) {
-            uint32_t val = latencyBuffer[i];
-            min = min(min, val);
-            max = max(max, val);
-            sum += val;
-            count++;
-        }
-    }
+    // 언더런 위험: 블록 주기 대비 블록 서비스 시간 꼬리 (p99.9)
+    uint32_t budgetCycles = getAudioBlockPeriodUs() * ESP.getCpuFreqMHz();
+    const TR808HistogramSnapshot& tail = service.total > 0 ? service : render;
+    float tailRatio = (float)tail.percentile(TR808_P999) / budgetCycles;
     
-    if (count > 0) {
-        uint32_t avg = sum / count;
-        
-        DEBUG_PRINT("Latency Stats (μs):");
-        DEBUG_PRINT(" Min: ");
-        DEBUG_PRINT(min);
-        DEBUG_PRINT(" Max: ");
-        DEBUG_PRINT(max);
-        DEBUG_PRINT(" Avg: ");
-        DEBUG_PRINT(avg);
-        DEBUG_PRINT(" Count: ");
-        DEBUG_PRINTLN(count);
-        
-        // 지연 시간 등급 평가
-        if (avg < 10) {
-            DEBUG_PRINTLN("Latency Grade: EXCELLENT");
-        } else if (avg < 20) {
-            DEBUG_PRINTLN("Latency Grade: GOOD");
-        } else if (avg < 50) {
-            DEBUG_PRINTLN("Latency Grade: FAIR");
-        } else {
-            DEBUG_PRINTLN("Latency Grade: POOR - Consider optimization");
-        }
-        
-        // 목표 지연 시간 대비 평가
-        uint32_t targetLatency = TIMER_INTERVAL_US;
-        float latencyRatio = (float)avg / targetLatency;
-        
-        DEBUG_PRINT("Latency vs Target: ");
-        DEBUG_PRINT(latencyRatio * 100, 1);
-        DEBUG_PRINTLN("%");
-        
-        if (latencyRatio > 0.8) {
-            DEBUG_PRINTLN("WARNING: Latency approaching target interval");
-        }
+    DEBUG_PRINTF("p99.9 vs Block Period: %.1f%%\n", tailRatio * 100);
+    DEBUG_PRINTF("Over Period: %.2f%% of blocks\n", tail.exceedance(budgetCycles) / 100.0f);
+    
+    if (tailRatio >= 1.0f) {
+        DEBUG_PRINTLN("Underrun Risk: HIGH - p99.9 exceeds block period");
+    } else if (tailRatio > 0.8f) {
+        DEBUG_PRINTLN("Underrun Risk: MEDIUM - p99.9 approaching block period");
+    } else {
+        DEBUG_PRINTLN("Underrun Risk: LOW");
     }
 }
 
@@ -457,11 +440,7 @@ void performanceMonitoringTask(void* parameters) {
         reportCount++;
         
         if (reportCount >= 60) { // 1분마다 간단한 보고
-            DEBUG_PRINT("Performance Summary - CPU: ");
-            DEBUG_PRINT(cpuUsagePercent);
-            DEBUG_PRINT("%, Heap: ");
-            DEBUG_PRINT(ESP.getFreeHeap());
-            DEBUG_PRINTLN(" bytes");
+            tr808Log.log(TR808_LOG_PERF_SUMMARY, cpuUsagePercent, ESP.getFreeHeap());
             reportCount = 0;
         }
         
@@ -479,39 +458,33 @@ void checkPerformanceWarnings() {
     
     // CPU 사용률 경고
     if (cpuUsagePercent > 80) {
-        DEBUG_PRINT("WARNING: High CPU usage: ");
-        DEBUG_PRINT(cpuUsagePercent);
-        DEBUG_PRINTLN("%");
+        tr808Log.log(TR808_LOG_WARN_CPU, cpuUsagePercent);
         warning = true;
     }
     
     // 메모리 부족 경고
     if (ESP.getFreeHeap() < 10000) { // 10KB 미만
-        DEBUG_PRINT("WARNING: Low memory: ");
-        DEBUG_PRINT(ESP.getFreeHeap());
-        DEBUG_PRINTLN(" bytes");
+        tr808Log.log(TR808_LOG_WARN_HEAP, ESP.getFreeHeap());
         warning = true;
     }
     
-    // 지연 시간 경고
-    if (avgTimerLatency > TIMER_INTERVAL_US * 0.7) {
-        DEBUG_PRINT("WARNING: High latency: ");
-        DEBUG_PRINT(avgTimerLatency);
-        DEBUG_PRINT(" μs (target: ");
-        DEBUG_PRINT(TIMER_INTERVAL_US);
-        DEBUG_PRINTLN(" μs)");
+    // 지연 시간 경고 (평균이 아닌 p99.9 꼬리 기준)
+    collectLatencyHistograms();
+    uint32_t serviceTailUs = sessionLatency[LATENCY_BLOCK_SERVICE].percentile(TR808_P999) / ESP.getCpuFreqMHz();
+    uint32_t blockPeriodUs = getAudioBlockPeriodUs();
+    if (serviceTailUs > blockPeriodUs * 0.7) {
+        tr808Log.log(TR808_LOG_WARN_SERVICE_TAIL, serviceTailUs, blockPeriodUs);
         warning = true;
     }
     
     // 버퍼 오버플로우 경고
     if (audioBufferOverflows > 10) {
-        DEBUG_PRINT("WARNING: Multiple buffer overflows: ");
-        DEBUG_PRINTLN(audioBufferOverflows);
+        tr808Log.log(TR808_LOG_WARN_OVERFLOW, audioBufferOverflows);
         warning = true;
     }
     
     if (warning) {
-        DEBUG_PRINTLN("Performance degradation detected - consider optimization");
+        tr808Log.log(TR808_LOG_WARN_DEGRADED);
     }
 }
 
@@ -576,20 +549,18 @@ void resetPerformanceCounters() {
     audioDroppedSamples = 0;
     audioBufferOverflows = 0;
     
-    // 타이머 성능 지표 초기화
-    timerInterruptCount = 0;
-    timerInterruptMisses = 0;
-    maxTimerLatency = 0;
-    avgTimerLatency = 0;
-    
-    // 통계 구조체 초기화
-    audioProcessingStats = (PerformanceStats){0, 0, 0, 0};
-    bufferOperationStats = (PerformanceStats){0, 0, 0, 0};
-    interruptServiceStats = (PerformanceStats){0, 0, 0, 0};
+    // 블록 서비스 지표 초기화
+    blockServiceCount = 0;
+    blockServiceMisses = 0;
+    maxBlockServiceTime = 0;
+    avgBlockServiceTime = 0;
     
-    // 지연 시간 버퍼 초기화
-    memset(latencyBuffer, 0, sizeof(latencyBuffer));
-    latencyIndex = 0;
+    // 지연 히스토그램 초기화
+    for (int i = 0; i < LATENCY_HISTOGRAM_COUNT; i++) {
+        latencyHistograms[i].reset();
+        sessionLatency[i].clear();
+    }
+    triggerPending = false;
     
     DEBUG_PRINTLN("Performance counters reset completed");
 }
@@ -0,0 +1,309 @@
+"""
+TR-808 렌더 경로 배치 보고서
+
+렌더 진입점(processAudio, audioHook 등)에서 호출/참조로 도달하는 함수와 테이블을 모아
+각각의 출력 섹션(IRAM / DRAM / FLASH / ROM)을 표로 출력
+- 섹션/크기: ELF 심볼 표 (objdump -t), 객체 파일: 링커 맵 (-Wl,-Map)
+- 도달 관계: 역어셈블 (objdump -d -r)의 호출 대상과 재배치 심볼
+  (데이터 테이블 참조는 재배치로만 보이므로 -Wl,--emit-relocs 필요)
+- FLASH 항목은 캐시 미스 때 플래시 읽기를 기다리는 후보 (--strict면 실패 코드)
+  newlib(libm/libc) 객체는 미리 빌드된 라이브러리라 옮길 수 없으므로 따로 세고 --strict에서 제외
+  (sinf/tanhf 등, 객체 열이 있어야 구분하므로 --map 필요)
+
+PlatformIO (env:placement): extra_scripts = post:extras/tools/placement_report.py
+  빌드 후 $BUILD_DIR/placement_report.txt 생성
+단독 실행:
+  python3 extras/tools/placement_report.py firmware.elf --map firmware.map \\
+      --objdump riscv32-esp-elf-objdump [--entry 함수] [--strict]
+
+호환성: Python 3 / PlatformIO extra_scripts (SCons)
+"""
+
+import bisect
+import os
+import re
+import subprocess
+import sys
+from collections import deque
+
+DEFAULT_ENTRIES = [
+    "processAudio",
+    "renderBenchBlock",
+    "audioHook",
+    "TR808DrumMachine::process",
+    "TR808HybridMixer::process",
+    "TR808VoicePoolMozzi::renderBlock",
+]
+
+# 배치 속성/fragment를 적용할 수 없는 미리 빌드된 라이브러리 (Arduino 빌드의 newlib)
+LIBRARY_OBJECTS = ("libm.a", "libc.a")
+
+# 출력 섹션 -> 배치 영역 (ESP32-C3 링커 스크립트 기준)
+REGIONS = [
+    (".iram", "IRAM"),
+    (".dram", "DRAM"),
+    (".data", "DRAM"),
+    (".bss", "DRAM"),
+    (".noinit", "DRAM"),
+    (".rtc", "RTC"),
+    (".flash", "FLASH"),
+    (".text", "FLASH"),
+    (".rodata", "FLASH"),
+    ("*ABS*", "ROM"),       # ROM 링커 스크립트의 PROVIDE (soft-float 등)
+    ("*UND*", "EXTERN"),    # 동적 링크 (호스트 빌드 전용)
+]
+
+SYMBOL_LINE = re.compile(r"^([0-9a-f]+) (.{7}) (\S+)\t([0-9a-f]+)\s+(?:\.hidden )?(.*)$")
+FUNCTION_LINE = re.compile(r"^([0-9a-f]+) <(.+)>:$")
+TARGET = re.compile(r"<(.+)>\s*$")
+RELOC = re.compile(r"^\s*[0-9a-f]+:\s+R_\S+\s+(\S.*)$")
+MAP_INPUT = re.compile(r"^\s+(\.\S+)?\s*0x([0-9a-f]+)\s+0x([0-9a-f]+)\s+(\S.*)$")
+
+
+def region_of(section):
+    for prefix, region in REGIONS:
+        if section.startswith(prefix):
+            return region
+    return "OTHER"
+
+
+def base_name(name):
+    """'Foo::bar(int) const' -> 'Foo::bar' (진입점/표 정렬용)"""
+    depth = 0
+    for i, ch in enumerate(name):
+        if ch == "<":
+            depth += 1
+        elif ch == ">":
+            depth -= 1
+        elif ch == "(" and depth == 0 and i > 0:
+            return name[:i]
+    return name
+
+
+def strip_offset(target):
+    return re.sub(r"\+0x[0-9a-f]+$", "", target)
+
+
+def run(tool, args, env=None):
+    return subprocess.run([tool] + args, stdout=subprocess.PIPE, stderr=subprocess.DEVNULL,
+                          universal_newlines=True, check=True, env=env).stdout
+
+
+def read_symbols(objdump, elf, env=None):
+    """이름 -> (주소, 크기, 섹션, 종류), 섹션 이름 -> 시작 주소"""
+    symbols = {}
+    sections = {}
+    for line in run(objdump, ["-t", "-C", elf], env).splitlines():
+        m = SYMBOL_LINE.match(line)
+        if not m:
+            continue
+        addr, flags, section, size, name = m.groups()
+        addr, size, kind = int(addr, 16), int(size, 16), flags[6]
+        if kind == "d":
+            sections[section] = addr
+            continue
+        if kind not in ("F", "O") and section not in ("*ABS*", "*UND*"):
+            continue
+        if name not in symbols or size > symbols[name][1]:
+            symbols[name] = (addr, size, section, kind)
+    return symbols, sections
+
+
+def read_references(objdump, elf, env=None):
+    """함수 -> 참조 대상 이름 집합 (호출 주석 + 재배치)"""
+    refs = {}
+    current = None
+    for line in run(objdump, ["-d", "-r", "-C", "--no-show-raw-insn", elf], env).splitlines():
+        m = FUNCTION_LINE.match(line)
+        if m:
+            current = m.group(2)
+            refs.setdefault(current, set())
+            continue
+        if current is None:
+            continue
+        m = RELOC.match(line)
+        target = m.group(1) if m else None
+        if target is None:
+            m = TARGET.search(line)
+            target = m.group(1) if m else None
+        if target is None:
+            continue
+        target = target.strip().replace("@plt", "")
+        if target.startswith(".L"):
+            continue
+        refs[current].add(target)
+    return refs
+
+
+def read_map(path):
+    """링커 맵 입력 섹션 -> [(시작, 끝, 객체)] 정렬 목록"""
+    ranges = []
+    pending = None
+    with open(path, errors="replace") as f:
+        for line in f:
+            m = MAP_INPUT.match(line)
+            if m and (m.group(1) or pending):
+                start, size, obj = int(m.group(2), 16), int(m.group(3), 16), m.group(4).strip()
+                if size > 0 and not obj.startswith("0x"):
+                    ranges.append((start, start + size, obj))
+                pending = None
+                continue
+            # 긴 입력 섹션 이름은 다음 줄에 주소/크기/객체가 옴
+            stripped = line.strip()
+            pending = stripped if stripped.startswith(".") and " " not in stripped else None
+    ranges.sort()
+    return ranges
+
+
+def object_for(ranges, starts, addr):
+    i = bisect.bisect_right(starts, addr) - 1
+    if i >= 0 and ranges[i][0] <= addr < ranges[i][1]:
+        obj = ranges[i][2]
+        return os.path.basename(obj)
+    return ""
+
+
+def resolve(target, symbols, sections, by_addr, addrs):
+    """재배치 대상 (심볼, 심볼+오프셋, 섹션+오프셋) -> 심볼 이름"""
+    name = strip_offset(target)
+    if name in symbols:
+        return name
+    for sym in symbols:
+        if sym.startswith(name + "@"):      # 버전 심볼 (sinf@GLIBC_2.2.5)
+            return sym
+    m = re.match(r"^(\S+)\+0x([0-9a-f]+)$", target)
+    base = m.group(1) if m else target
+    if base in sections:
+        addr = sections[base] + (int(m.group(2), 16) if m else 0)
+        i = bisect.bisect_right(addrs, addr) - 1
+        if i >= 0:
+            start, size, sym = by_addr[i]
+            if start <= addr < start + max(size, 1):
+                return sym
+    return None
+
+
+def reachable(entries, refs, symbols, sections):
+    by_addr = sorted((v[0], v[1], k) for k, v in symbols.items() if v[2] != "*ABS*")
+    addrs = [a for a, _, _ in by_addr]
+    by_base = {}
+    for name in list(symbols) + list(refs):
+        by_base.setdefault(base_name(name), set()).add(name)
+
+    seen = set()
+    queue = deque()
+    missing = []
+    for entry in entries:
+        names = by_base.get(base_name(entry), set()) | ({entry} if entry in symbols else set())
+        if not names:
+            missing.append(entry)
+        for name in names:
+            if name not in seen:
+                seen.add(name)
+                queue.append(name)
+
+    while queue:
+        name = queue.popleft()
+        for target in refs.get(name, ()):
+            sym = resolve(target, symbols, sections, by_addr, addrs)
+            if sym is not None and sym != name and sym not in seen:
+                seen.add(sym)
+                queue.append(sym)
+    return seen, missing
+
+
+def build_report(elf, map_path, objdump, entries, env=None):
+    symbols, sections = read_symbols(objdump, elf, env)
+    refs = read_references(objdump, elf, env)
+    seen, missing = reachable(entries, refs, symbols, sections)
+
+    ranges = read_map(map_path) if map_path and os.path.exists(map_path) else []
+    starts = [r[0] for r in ranges]
+
+    rows = []
+    for name in seen:
+        addr, size, section, flag = symbols.get(name, (0, 0, "?", " "))
+        kind = "함수" if name in refs or flag == "F" else "데이터"
+        obj = object_for(ranges, starts, addr) if section not in ("*ABS*", "*UND*") else ""
+        rows.append((region_of(section), kind, name, section, size, obj))
+    order = {"FLASH": 0, "OTHER": 1, "IRAM": 2, "DRAM": 3, "RTC": 4, "ROM": 5, "EXTERN": 6}
+    rows.sort(key=lambda r: (order.get(r[0], 9), r[1], base_name(r[2])))
+
+    lines = []
+    lines.append("TR-808 렌더 경로 배치 보고서")
+    lines.append("ELF: %s" % elf)
+    lines.append("진입점: %s" % ", ".join(e for e in entries if e not in missing))
+    if missing:
+        lines.append("없는 진입점 (이 빌드에 없음): %s" % ", ".join(missing))
+    lines.append("")
+    lines.append("%-6s %-6s %7s  %-22s %-28s %s" % ("영역", "종류", "바이트", "섹션", "객체", "심볼"))
+    for region, kind, name, section, size, obj in rows:
+        lines.append("%-6s %-6s %7d  %-22s %-28s %s" % (region, kind, size, section[:22], obj[:28], name))
+
+    totals = {}
+    for region, kind, _, _, size, _ in rows:
+        count, total = totals.get((region, kind), (0, 0))
+        totals[(region, kind)] = (count + 1, total + size)
+    lines.append("")
+    lines.append("요약:")
+    for (region, kind), (count, total) in sorted(totals.items(), key=lambda kv: order.get(kv[0][0], 9)):
+        lines.append("  %-6s %-6s %4d개 %8d 바이트" % (region, kind, count, total))
+    library = [r for r in rows if r[0] == "FLASH" and any(lib in r[5] for lib in LIBRARY_OBJECTS)]
+    flash = [r for r in rows if r[0] == "FLASH" and r not in library]
+    lines.append("")
+    if flash:
+        lines.append("⚠️ 플래시 상주 %d개: 캐시 미스 시 플래시 읽기 대기 후보 "
+                     "(TR808_HOT / TR808_HOT_DATA 또는 extras/linker/tr808_placement.lf)" % len(flash))
+    else:
+        lines.append("✅ 프로젝트 렌더 경로의 모든 항목이 IRAM/DRAM/ROM")
+    if library:
+        lines.append("ℹ️ 라이브러리 플래시 상주 %d개 (%s): 옮길 수 없음, --strict에서 제외"
+                     % (len(library), ", ".join(LIBRARY_OBJECTS)))
+    return "\n".join(lines) + "\n", len(flash)
+
+
+def main(argv):
+    import argparse
+    parser = argparse.ArgumentParser(description="TR-808 렌더 경로 배치 보고서")
+    parser.add_argument("elf")
+    parser.add_argument("--map", help="링커 맵 (-Wl,-Map), 객체 열 표시")
+    parser.add_argument("--objdump", default="objdump")
+    parser.add_argument("--entry", action="append", default=[], help="추가 진입점 (반복 가능)")
+    parser.add_argument("--output", help="보고서 파일 (기본: 표준 출력)")
+    parser.add_argument("--strict", action="store_true", help="프로젝트 플래시 상주 항목이 있으면 종료 코드 1 (newlib 제외)")
+    args = parser.parse_args(argv)
+
+    report, flash = build_report(args.elf, args.map, args.objdump, DEFAULT_ENTRIES + args.entry)
+    if args.output:
+        with open(args.output, "w") as f:
+            f.write(report)
+    else:
+        sys.stdout.write(report)
+    return 1 if args.strict and flash else 0
+
+
+# PlatformIO post 스크립트: 링크 옵션 추가 + 빌드 후 보고서 생성
+try:
+    Import("env")  # noqa: F821 (SCons)
+except NameError:
+    env = None
+
+if env is not None:
+    env.Append(LINKFLAGS=[
+        "-Wl,--emit-relocs",
+        "-Wl,-Map=%s" % env.subst("$BUILD_DIR/${PROGNAME}.map"),
+    ])
+
+    def _placement_report(source, target, env):
+        elf = str(target[0])
+        objdump = re.sub(r"(gcc|g\+\+)$", "objdump", env.subst("$CC"))
+        out = env.subst("$BUILD_DIR/placement_report.txt")
+        report, flash = build_report(elf, env.subst("$BUILD_DIR/${PROGNAME}.map"), objdump,
+                                     DEFAULT_ENTRIES, env["ENV"])
+        with open(out, "w") as f:
+            f.write(report)
+        print("배치 보고서: %s (플래시 상주 %d개)" % (out, flash))
+
+    env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", _placement_report)
+elif __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
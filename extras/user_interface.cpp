@@ -1,4 +1,5 @@
 #include "user_interface.h"
+#include "esp32c3_mozzi_integration.h"
 
 // 전역 MIDI 객체 생성
 MIDIClass MIDI;
@@ -473,6 +474,9 @@ void TR808UserInterface::triggerDrum(DrumSource drum, uint8_t velocity) {
         return;
     }
     
+    // 트리거 -> 첫 출력 샘플 지연 측정 시작 (performance_monitor_esp32c3.cpp)
+    markTriggerTime();
+    
     // 실제 드럼 트리거 (하드웨어 제어 함수 호출 필요)
     // TODO: 실제 하드웨어 인터페이스와 연동
     
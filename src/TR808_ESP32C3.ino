@@ -24,17 +24,47 @@
  */
 
 #include <I2S.h>
+#include <esp_timer.h>
 #include "arduino_tr808_config.h"
 #include "tr808_drums.h"
+#include "tr808_pattern_store.h"
+#include "tr808_serial_protocol.h"
+#include "tr808_command_parser.h"
+#include "tr808_midi.h"
+#include "tr808_midi_clock.h"
+#include "tr808_trace.h"
+#include "tr808_log.h"
+#include "tr808_arena.h"
+#include "tr808_placement.h"
+#if CONFIG_IDF_TARGET_ESP32C3
+#include "esp32c3/rom/cache.h"     // Cache_Invalidate_ICache_All (bench wcet 콜드 캐시)
+#endif
+
+// 하이브리드 빌드 (-DMOZZI_INTEGRATION_MODE=1, mozzi_integration_plan.h의 MOZZI_HYBRID):
+// 드럼별로 네이티브/Mozzi 백엔드를 골라 한 믹서로 렌더 (Mozzi 라이브러리 필요)
+#if defined(MOZZI_INTEGRATION_MODE) && MOZZI_INTEGRATION_MODE == 1
+    #define TR808_HYBRID_ENGINE
+    #include "tr808_hybrid.h"
+#endif
 
 // ============================================
 // 전역 설정 및 상수
 // ============================================
 
 // I2S 설정 (ESP32C3 최적화)
-#define SAMPLE_RATE 32768           // 32.768kHz (ESP32C3 권장)
+// 샘플 레이트는 tr808_sample_rate.h의 TR808_SAMPLE_RATE 하나로 통일 (-DSAMPLE_RATE로 변경)
+// I2S는 부팅 시 I2S_SAMPLE_RATE로 설정되고 엔진은 TR808AudioRate로 시작하므로 두 값이 같아야 함
+static_assert(I2S_SAMPLE_RATE == TR808AudioRate::rate, "I2S 출력 레이트와 엔진 레이트 불일치");
 #define BUFFER_SIZE 256             // I2S 버퍼 크기
 #define MONO_OUTPUT true            // 모노 출력 (메모리 절약)
+#define RATE_CHANGE_SILENCE_BLOCKS 4 // 레이트 전환 전 DMA를 비우는 무음 블록 수
+#define STORAGE_SILENCE_PEAK 16     // 블록 피크가 이 값 미만이면 무음 (저장소 섹터 소거 허용)
+#define CONTROL_BENCH_SAMPLES 2048  // 컨트롤 레이트 벤치마크 렌더 길이
+#define HYBRID_BENCH_SAMPLES 2048   // 하이브리드 백엔드 프로파일 렌더 길이
+#define WCET_BENCH_BLOCKS 64        // 렌더 WCET 측정 블록 수
+#define WCET_RETRIGGER_BLOCKS 8     // 전체 보이스 재트리거 간격 (블록)
+#define SQUARE_BENCH_SAMPLES 2048   // 구형파 오실레이터 벤치마크 렌더 길이
+#define SQUARE_BENCH_OVERSAMPLED 64000 // naive 비교 레이트 (기존 Mozzi 64kHz 구성)
 
 // TR808 설정
 #define MASTER_VOLUME 0.8f          // 기본 마스터 볼륨
@@ -47,31 +77,143 @@
 // 메인 TR808 드럼 머신
 TR808DrumMachine drumMachine;
 
-// I2S 버퍼 (ESP32C3 최적화)
-int16_t i2sBuffer[BUFFER_SIZE];
+#ifdef TR808_HYBRID_ENGINE
+// 드럼별 백엔드 믹서 (네이티브 보이스는 drumMachine, Mozzi 보이스는 믹서 내부 풀)
+TR808HybridMixer hybridMixer(drumMachine);
+#endif
+
+// I2S 버퍼 (ESP32C3 최적화, 시작 아레나)
+int16_t* i2sBuffer = nullptr;
+
+// 킷 설정 (플래시 저장소에 바이너리 레코드로 저장)
+struct KitSettings {
+    float masterVolume;
+    float kickDecay;
+    float kickTone;
+    float snareTone;
+    float snareSnappy;
+    float cymbalDecay;
+    float cymbalTone;
+    float hihatDecay;
+    float tomTuning;
+    float congaTuning;
+};
+
+KitSettings kitSettings = {
+    MASTER_VOLUME,  // 마스터 볼륨
+    500.0f,         // 킥: 500ms
+    0.5f,           // 킥: 중간 톤
+    0.7f,           // 스네어: 밝은 톤
+    0.8f,           // 스네어: 강한 스냅
+    800.0f,         // 심벌: 800ms
+    0.6f,           // 심벌: 중간 톤
+    50.0f,          // 하이햇: 클로즈드
+    165.0f,         // 톰: 165Hz
+    370.0f          // 콩가: 370Hz
+};
+KitSettings savedKitSettings;
+
+// 패턴/킷 저장소 (로그 구조 플래시, partitions_tr808*.csv의 tr808 파티션)
+TR808PartitionBackend storageBackend;
+TR808PatternStore patternStore(&storageBackend);
+int32_t blockPeak = 0;              // 마지막 블록 출력 피크 (소거 안전 지점 판정)
+
+// 시리얼 입력 (바이너리 프레임 + 텍스트 콘솔, 블로킹 없음)
+TR808FrameDecoder frameDecoder;
+char commandLine[COMMAND_BUFFER_SIZE];
+uint8_t commandLength = 0;
+
+// 스텝 시퀀서 (바이너리 프레임으로 일괄 설정, 시작 아레나)
+uint8_t (*stepVelocity)[TR808_FRAME_STEPS] = nullptr;  // [보이스][스텝], 0 = 빈 스텝, 1-127 = 강도
+TR808MidiClock stepClock;           // 샘플 기반 스텝 클럭 (MIDI 클럭 마스터/슬레이브)
+
+// MIDI 입력 (UART 수신 콜백 -> 샘플 타임스탬프 -> 오디오 이벤트 큐)
+TR808MidiParser midiParser;
+TR808EventQueue audioEvents;
+TR808SampleClock sampleClock;
+uint32_t renderSample = 0;          // 다음에 렌더링할 샘플 시각
+
+// MIDI 클럭 출력 (마스터): 렌더한 틱을 큐에 넣고, 그 샘플이 재생될 때 타이머가 전송
+TR808ClockOutputQueue clockOutput;
+esp_timer_handle_t clockOutputTimer = nullptr;
 
 // 성능 모니터링
 unsigned long lastPerfCheck = 0;
 unsigned long sampleCount = 0;
-float cpuUsage = 0.0f;
+float cpuUsage = 0.0f;              // 평균 블록 부하 (%)
+TR808LoadMeter audioLoad;           // 블록 렌더 사이클 / 블록 마감
+
+// 런타임 샘플 레이트 전환 (페이드아웃 블록 -> 무음 -> I2S 재설정 -> 페이드인 블록)
+bool rateFadeIn = false;
+bool i2sStopped = false;            // 새 레이트와 이전 레이트 모두 I2S 시작 실패 ('reset'으로 재시작)
+
+// 시작 메모리 아레나: setup() 첫 단계에서 표 순서대로 할당, 이후 봉인 (오디오 경로 힙 사용 없음)
+enum EngineArenaSlot {
+    ARENA_I2S_BLOCK = 0,
+    ARENA_STEP_PATTERN,
+    ARENA_TRACE_RING,
+    ARENA_PROFILE_SCRATCH,
+    ARENA_MOZZI_TABLES,
+    ARENA_SLOT_COUNT
+};
+
+static constexpr TR808ArenaBudget engineArenaBudget[ARENA_SLOT_COUNT] = {
+    {"i2s block",       BUFFER_SIZE * sizeof(int16_t), 16},
+    {"step pattern",    TR808_VOICE_COUNT * TR808_FRAME_STEPS, 4},
+#ifdef TR808_TRACE
+    {"trace ring",      TR808_TRACE_RECORDS * sizeof(TR808TraceRecord), 8},
+#else
+    {"trace ring",      0, 8},
+#endif
+#ifdef TR808_HYBRID_ENGINE
+    {"profile scratch", TR808_HYBRID_PROFILE_SCRATCH_BYTES, 16},
+    {"mozzi tables",    TR808_MOZZI_TABLE_COPY_BYTES, 4},   // 렌더 경로 테이블 DRAM 사본 (배치 빌드만)
+#else
+    {"profile scratch", 0, 16},
+    {"mozzi tables",    0, 4},
+#endif
+};
+
+#define ENGINE_ARENA_BYTES tr808ArenaTotal(engineArenaBudget, ARENA_SLOT_COUNT)
+static_assert(ENGINE_ARENA_BYTES <= TR808_ARENA_LIMIT_BYTES,
+              "엔진 아레나가 이 환경의 메모리 예산 초과 (platformio.ini TR808_ARENA_LIMIT_BYTES)");
+
+alignas(TR808_ARENA_STORAGE_ALIGN) static uint8_t engineArenaStorage[ENGINE_ARENA_BYTES];
+TR808Arena engineArena;
+uint32_t sealedFreeHeap = 0;        // 봉인 시점 여유 힙 (이후 감소 = 누군가 힙 사용)
+
+// 부팅 단계: setup()은 오디오 경로만 준비, 나머지는 첫 블록 이후 loop()에서 블록 사이에 한 단계씩
+enum BootStage : uint8_t {
+    BOOT_STAGE_BANNER = 0,   // 배너 + 첫 샘플까지 시간 보고
+    BOOT_STAGE_MIDI,
+    BOOT_STAGE_STORAGE,      // 저장소 마운트 + 저장된 킷 적용
+    BOOT_STAGE_MONITORING,   // 성능 수집/로그 태스크
+    BOOT_STAGE_SEQUENCER,
+    BOOT_STAGE_SEAL,         // 아레나 봉인 + 힙 기준점
+    BOOT_STAGE_INFO,         // 시스템 정보
+    BOOT_STAGE_HELP,         // 사용법/예제 + 자동 테스트
+    BOOT_STAGE_DONE
+};
+uint8_t bootStage = BOOT_STAGE_BANNER;
+uint32_t setupStartUs = 0;          // setup() 진입 시각 (앱 시작 기준 us)
+uint32_t firstBlockUs = 0;          // 첫 블록 I2S 제출 시각 (0 = 아직)
 
 // ============================================
 // 초기화 함수들
 // ============================================
 
 void setup() {
-    // Serial 통신 초기화
-    Serial.begin(115200);
-    delay(1000); // 안정화를 위한 지연
+    setupStartUs = micros();
     
-    Serial.println("\n");
-    Serial.println("===========================================");
-    Serial.println("  ESP32C3 TR-808 드럼 머신 시작");
-    Serial.println("===========================================");
-    Serial.println("버전: 1.0.0");
-    Serial.println("제작일: 2025-10-30");
-    Serial.println("Arduino 프레임워크: " + String(ARDUINO));
-    Serial.println("");
+    // Serial 통신 초기화 (RX 링버퍼는 begin 전에 설정, 배너는 오디오 시작 후 출력)
+    Serial.setRxBufferSize(SERIAL_RX_RING_SIZE);
+    Serial.begin(115200);
+
+    // 엔진 버퍼를 시작 아레나에서 할당 (다른 초기화보다 먼저)
+    if (!initializeArena()) {
+        Serial.println("❌ 메모리 아레나 할당 실패!");
+        while(true) delay(1000);
+    }
 
     // I2S 오디오 출력 초기화
     if (!initializeI2SAudio()) {
@@ -80,39 +222,126 @@ void setup() {
         while(true) delay(1000); // 무한 루프
     }
     
-    // TR808 드럼 머신 초기화
+    // 렌더 경로가 읽는 클럭/측정기 (보이스 기본 상태는 컴파일 타임 상수)
+    sampleClock.begin(TR808_SAMPLE_RATE, ESP.getCpuFreqMHz() * 1000000UL);
+    stepClock.begin(TR808_SAMPLE_RATE, DEFAULT_BPM);
+    if (MIDI_CLOCK_SLAVE) {
+        stepClock.setSource(TR808_CLOCK_EXTERNAL);
+    }
+    initializePerformanceMonitoring();
+    
+    // TR808 드럼 머신 초기화 (기본 킷, 저장된 킷은 저장소 단계에서 적용)
     if (!initializeTR808()) {
         Serial.println("❌ TR-808 초기화 실패!");
         while(true) delay(1000);
     }
     
-    // 성능 모니터링 초기화
-    initializePerformanceMonitoring();
-    
-    // 시퀀서 초기화 (선택사항)
-    initializeSequencer();
-    
-    Serial.println("✅ 모든 시스템 초기화 완료!");
-    Serial.println("");
-    
-    // 시작 정보 출력
-    printSystemInfo();
-    printInstructions();
-    printExamples();
-    
-    // 오디오 테스트 (선택사항)
-    if (AUTO_TEST_ON_STARTUP) {
-        runAudioTest();
+    // MIDI, 저장소, 태스크, 시퀀서, 안내 출력은 runDeferredSetup()에서
+}
+
+/**
+ * 부팅 후속 단계 (loop()에서 블록 렌더 후 한 단계씩)
+ * 첫 블록이 I2S에 들어간 뒤 실행되므로 마운트/태스크 생성/출력이 첫 샘플을 늦추지 않음
+ * 단계 하나가 DMA 버퍼 여유보다 길면 (UART 출력 대기 등) 그 블록은 언더런 가능
+ */
+void runDeferredSetup() {
+    switch (bootStage) {
+        case BOOT_STAGE_BANNER:
+            printBootBanner();
+            break;
+        case BOOT_STAGE_MIDI:
+            if (ENABLE_MIDI) {
+                initializeMidi();
+            }
+            break;
+        case BOOT_STAGE_STORAGE:
+            // 패턴/킷 저장소 마운트 (실패해도 기본값으로 계속 동작)
+            initializeStorage();
+            loadSavedKit();
+            break;
+        case BOOT_STAGE_MONITORING:
+            startMonitoringTasks();
+            break;
+        case BOOT_STAGE_SEQUENCER:
+            initializeSequencer();
+            break;
+        case BOOT_STAGE_SEAL:
+            // 이후 아레나 할당 금지, 힙 기준점 기록 ('memory' 명령에서 비교)
+            engineArena.seal();
+            sealedFreeHeap = ESP.getFreeHeap();
+            Serial.println("✅ 모든 시스템 초기화 완료!");
+            Serial.println("");
+            break;
+        case BOOT_STAGE_INFO:
+            printSystemInfo();
+            break;
+        case BOOT_STAGE_HELP:
+            printInstructions();
+            printExamples();
+            
+            // 오디오 테스트 (선택사항)
+            if (AUTO_TEST_ON_STARTUP) {
+                runAudioTest();
+            }
+            
+            Serial.println("");
+            Serial.println("🎵 TR-808 드럼 머신이 준비되었습니다!");
+            Serial.println("💡 'help' 명령어로 사용법을 확인하세요.");
+            break;
+        default:
+            return;
     }
-    
+    bootStage++;
+}
+
+/**
+ * 시작 배너 + 첫 오디오 블록까지 걸린 시간
+ * micros()는 앱 시작(esp_timer 초기화) 기준이라 ROM/부트로더 시간은 포함하지 않음
+ */
+void printBootBanner() {
+    Serial.println("\n");
+    Serial.println("===========================================");
+    Serial.println("  ESP32C3 TR-808 드럼 머신 시작");
+    Serial.println("===========================================");
+    Serial.println("버전: 1.0.0");
+    Serial.println("제작일: 2025-10-30");
+    Serial.println("Arduino 프레임워크: " + String(ARDUINO));
+    Serial.println("");
+    Serial.println("🔊 I2S 오디오");
+    Serial.println("     샘플 레이트: " + String(drumMachine.getSampleRate()) + " Hz");
+    Serial.println("     버퍼 크기: " + String(BUFFER_SIZE) + " 샘플");
+    Serial.println("     출력 모드: " + String(MONO_OUTPUT ? "모노" : "스테레오"));
+    printBootTime();
     Serial.println("");
-    Serial.println("🎵 TR-808 드럼 머신이 준비되었습니다!");
-    Serial.println("💡 'help' 명령어로 사용법을 확인하세요.");
 }
 
-bool initializeI2SAudio() {
-    Serial.println("🔊 I2S 오디오 시스템 초기화...");
+void printBootTime() {
+    Serial.printf("⏱️ 첫 오디오 블록: 앱 시작 후 %.1f ms (setup 진입 후 %.1f ms)\n",
+                  firstBlockUs / 1000.0f, (firstBlockUs - setupStartUs) / 1000.0f);
+}
+
+/**
+ * 엔진 버퍼를 예산 표 순서대로 아레나에서 할당
+ * 크기는 컴파일 타임에 고정 (engineArenaBudget), 이 빌드에서 쓰지 않는 항목은 0바이트로 건너뜀
+ */
+bool initializeArena() {
+    engineArena.begin(engineArenaStorage, sizeof(engineArenaStorage));
     
+    i2sBuffer = (int16_t*)engineArena.allocate(engineArenaBudget[ARENA_I2S_BLOCK]);
+    stepVelocity = (uint8_t (*)[TR808_FRAME_STEPS])engineArena.allocate(engineArenaBudget[ARENA_STEP_PATTERN]);
+#ifdef TR808_TRACE
+    tr808Trace.begin((TR808TraceRecord*)engineArena.allocate(engineArenaBudget[ARENA_TRACE_RING]));
+#endif
+#ifdef TR808_HYBRID_ENGINE
+    TR808HybridMixer::setProfileScratch(engineArena.allocate(engineArenaBudget[ARENA_PROFILE_SCRATCH]));
+    // 보이스 풀 begin()보다 먼저: 풀이 이 사본에 오실레이터를 연결
+    TR808VoicePoolMozzi::setTableStorage(engineArena.allocate(engineArenaBudget[ARENA_MOZZI_TABLES]));
+#endif
+    
+    return i2sBuffer != nullptr && stepVelocity != nullptr && engineArena.getFailures() == 0;
+}
+
+bool beginI2S(uint32_t sampleRate) {
     // I2S 포트 설정
     i2s_mode_t mode = I2S_STANDARD;
     if (MONO_OUTPUT) {
@@ -121,41 +350,122 @@ bool initializeI2SAudio() {
         mode = I2S_MODE_MASTER | I2S_MODE_TX | I2S_MODE_DUAL;
     }
     
-    // I2S 초기화
-    if (!I2S.begin(mode, SAMPLE_RATE, 16, 1)) {
+    return I2S.begin(mode, sampleRate, 16, 1);
+}
+
+bool initializeI2SAudio() {
+    // I2S 초기화 (설정 출력은 printBootBanner()에서)
+    // 부팅 레이트는 컴파일 타임 상수 (엔진 레이트와의 일치는 위 static_assert로 검증)
+    if (!beginI2S(I2S_SAMPLE_RATE)) {
         Serial.println("  ❌ I2S.begin() 실패");
         return false;
     }
-    
-    Serial.println("  ✅ I2S 초기화 성공");
-    Serial.println("     샘플 레이트: " + String(SAMPLE_RATE) + " Hz");
-    Serial.println("     버퍼 크기: " + String(BUFFER_SIZE) + " 샘플");
-    Serial.println("     출력 모드: " + String(MONO_OUTPUT ? "모노" : "스테레오"));
-    
     return true;
 }
 
 bool initializeTR808() {
-    Serial.println("🥁 TR-808 드럼 머신 초기화...");
-    
-    // 마스터 볼륨 설정
-    drumMachine.setMasterVolume(MASTER_VOLUME);
-    
-    // 드럼별 기본 설정
-    drumMachine.setKickDecay(500.0f);      // 킥: 500ms
-    drumMachine.setKickTone(0.5f);         // 킥: 중간 톤
-    drumMachine.setSnareTone(0.7f);        // 스네어: 밝은 톤
-    drumMachine.setSnareSnappy(0.8f);      // 스네어: 강한 스냅
-    drumMachine.setCymbalDecay(800.0f);    // 심벌: 800ms
-    drumMachine.setCymbalTone(0.6f);       // 심벌: 중간 톤
-    drumMachine.setHiHatDecay(50.0f);      // 하이햇: 클로즈드
-    drumMachine.setTomTuning(165.0f);      // 톰: 165Hz
-    drumMachine.setCongaTuning(370.0f);    // 콩가: 370Hz
-    
-    Serial.println("  ✅ TR-808 초기화 완료");
-    Serial.println("     마스터 볼륨: " + String(MASTER_VOLUME));
-    Serial.println("     버퍼 크기: " + String(BUFFER_SIZE));
+#ifdef TR808_HYBRID_ENGINE
+    hybridMixer.begin();
+#endif
+    applyKitSettings(kitSettings);
+    return true;
+}
+
+/**
+ * 저장된 킷 설정 적용 (저장소 마운트 후, 오디오 동작 중)
+ * 읽기가 끝까지 성공한 경우에만 교체
+ */
+void loadSavedKit() {
+    KitSettings loaded;
+    if (patternStore.isMounted() &&
+        patternStore.read(TR808_RECORD_KIT, 0, &loaded, sizeof(loaded)) == sizeof(loaded)) {
+        kitSettings = loaded;
+        applyKitSettings(kitSettings);
+        Serial.println("  📂 저장된 킷 설정 로드됨");
+    }
+    savedKitSettings = kitSettings;
+    Serial.println("🥁 킷: 마스터 볼륨 " + String(kitSettings.masterVolume));
+}
+
+void applyKitSettings(const KitSettings& kit) {
+    setOutputVolume(kit.masterVolume);
+    drumMachine.setKickDecay(kit.kickDecay);
+    drumMachine.setKickTone(kit.kickTone);
+    drumMachine.setSnareTone(kit.snareTone);
+    drumMachine.setSnareSnappy(kit.snareSnappy);
+    drumMachine.setCymbalDecay(kit.cymbalDecay);
+    drumMachine.setCymbalTone(kit.cymbalTone);
+    drumMachine.setHiHatDecay(kit.hihatDecay);
+    drumMachine.setTomTuning(kit.tomTuning);
+    drumMachine.setCongaTuning(kit.congaTuning);
+#ifdef TR808_HYBRID_ENGINE
+    applyMozziKitSettings(kit);
+#endif
+}
+
+void setOutputVolume(float volume) {
+#ifdef TR808_HYBRID_ENGINE
+    hybridMixer.setMasterVolume(volume);
+#else
+    drumMachine.setMasterVolume(volume);
+#endif
+}
+
+bool requestSampleRate(uint32_t rate) {
+#ifdef TR808_HYBRID_ENGINE
+    // Mozzi 보이스가 라우팅되어 있으면 빌드 레이트만 허용
+    return hybridMixer.setSampleRate(rate);
+#else
+    return drumMachine.setSampleRate(rate);
+#endif
+}
+
+#ifdef TR808_HYBRID_ENGINE
+void applyMozziKitSettings(const KitSettings& kit) {
+    // Mozzi 보이스는 감쇠 시간만 지원 (톤/스내피는 네이티브 전용)
+    TR808VoicePoolMozzi& mozzi = hybridMixer.getMozzi();
+    mozzi.setKickDecay(kit.kickDecay);
+    mozzi.setCymbalDecay(kit.cymbalDecay);
+    mozzi.setHihatDecay(kit.hihatDecay);
+}
+#endif
+
+void initializeMidi() {
+    Serial.println("🎹 MIDI 입력 초기화...");
+    
+    Serial1.begin(MIDI_BAUDRATE, SERIAL_8N1, MIDI_RX_PIN, MIDI_TX_PIN);
+    // 바이트마다 수신 콜백 호출 (FIFO 임계값 1) - 폴링 지연 제거
+    Serial1.setRxFIFOFull(1);
+    Serial1.onReceive(onMidiReceive);
+    
+    // 클럭 출력 타이머 (esp_timer 태스크에서 실행, UART 쓰기 가능)
+    if (MIDI_CLOCK_OUTPUT) {
+        esp_timer_create_args_t timerArgs = {};
+        timerArgs.callback = onClockOutputTimer;
+        timerArgs.name = "tr808_clock_out";
+        if (esp_timer_create(&timerArgs, &clockOutputTimer) != ESP_OK) {
+            clockOutputTimer = nullptr;
+            Serial.println("  ⚠️ 클럭 출력 타이머 생성 실패 - MIDI 클럭 출력 비활성화");
+        }
+    }
     
+    Serial.println("  ✅ MIDI 준비 완료 (채널 " + String(MIDI_CHANNEL) + ")");
+}
+
+bool initializeStorage() {
+    Serial.println("💾 패턴/킷 저장소 마운트...");
+    
+    if (!patternStore.begin()) {
+        Serial.println("  ⚠️ tr808 파티션 없음 (partitions_tr808.csv 사용) - 자동 저장 비활성화");
+        return false;
+    }
+    
+    // 플래시 기록은 저우선순위 태스크에서 처리 (오디오 루프는 대기열 복사만)
+    // 기록/소거 중에는 캐시가 꺼져 루프도 멈추므로 소거는 loop()가 허용한 안전 지점에서만
+    patternStore.startWriterTask();
+    
+    Serial.println("  ✅ 저장소 준비 완료");
+    Serial.println("     최대 소거 횟수: " + String(patternStore.getStats().maxEraseCount));
     return true;
 }
 
@@ -163,6 +473,21 @@ void initializePerformanceMonitoring() {
     lastPerfCheck = millis();
     sampleCount = 0;
     cpuUsage = 0.0f;
+    audioLoad.begin(drumMachine.getSampleRate(), ESP.getCpuFreqMHz() * 1000000UL);
+    
+    // 스테이지별 사이클 집계: 오디오 루프(우선순위 1)보다 낮은 태스크에서 백분위 계산
+    tr808Perf.begin(drumMachine.getSampleRate(), ESP.getCpuFreqMHz() * 1000000UL);
+}
+
+void startMonitoringTasks() {
+    if (!tr808Perf.startCollectorTask()) {
+        Serial.println("⚠️ 성능 수집 태스크 생성 실패");
+    }
+    
+    // 오디오 경로 로그는 레코드만 남기고 출력은 저우선순위 태스크에서
+    if (!tr808Log.startTask()) {
+        Serial.println("⚠️ 로그 출력 태스크 생성 실패");
+    }
     Serial.println("📊 성능 모니터링 준비 완료");
 }
 
@@ -179,18 +504,25 @@ void initializeSequencer() {
 void loop() {
     unsigned long currentTime = millis();
     
-    // Serial 명령 처리 (우선순위 높음)
-    if (Serial.available()) {
-        handleSerialCommands();
+    // Serial 입력 처리 (수신된 바이트만 처리, 블로킹 없음)
+    pollSerialInput();
+    
+    // 오디오 처리 (실시간, I2S가 멈춘 동안은 블록 페이싱이 없으므로 렌더 중단)
+    if (!i2sStopped) {
+        processAudio();
     }
     
-    // 시퀀서 처리 (선택사항)
-    if (ENABLE_SEQUENCER) {
-        handleSequencer(currentTime);
+    // 섹터 소거(캐시 꺼짐, 수십 ms)는 트랜스포트 정지 + 무음 블록에서만
+    // 그 밖에는 현재 섹터에 들어가는 기록만 수행하고 나머지 저장은 대기
+    patternStore.setEraseAllowed(!stepClock.isRunning() && blockPeak < STORAGE_SILENCE_PEAK);
+    if (firstBlockUs == 0) {
+        firstBlockUs = micros();
     }
     
-    // 오디오 처리 (실시간)
-    processAudio();
+    // 부팅 후속 단계 (첫 블록 이후, 블록마다 한 단계)
+    if (bootStage != BOOT_STAGE_DONE) {
+        runDeferredSetup();
+    }
     
     // 성능 모니터링 (1초마다)
     if (currentTime - lastPerfCheck >= 1000) {
@@ -207,270 +539,674 @@ void loop() {
     delayMicroseconds(30); // 30.5μs @ 32.768kHz
 }
 
-void processAudio() {
-    // TR808 드럼 머신에서 오디오 샘플 생성
-    float audioSample = drumMachine.process();
+void TR808_HOT processAudio() {
+    // 블록 시작 샘플 시각 기록 (MIDI 타임스탬프 기준점)
+    sampleClock.beginBlock(renderSample, ESP.getCycleCount());
+    tr808Perf.beginBlock();
+    audioLoad.startBlock();
+    TR808_TRACE_EVENT(TR808_TRACE_RENDER_BEGIN, BUFFER_SIZE);
     
-    // 32-bit float를 16-bit int로 변환
-    int16_t intSample = (int16_t)(audioSample * 32767);
+    // 레이트 변경 요청이 있으면 이 블록을 페이드아웃, 전환 직후 블록은 페이드인
+    bool rateChange = drumMachine.hasPendingSampleRate();
+    float rampGain = 1.0f;
+    float rampStep = 0.0f;
+    if (rateChange) {
+        rampStep = -1.0f / BUFFER_SIZE;
+    } else if (rateFadeIn) {
+        rampGain = 0.0f;
+        rampStep = 1.0f / BUFFER_SIZE;
+    }
+    rateFadeIn = false;
+    int32_t peak = 0;
     
-    // I2S 버퍼 채우기
     for (int i = 0; i < BUFFER_SIZE; i++) {
-        i2sBuffer[i] = intSample;
+        // 재생 시각이 된 이벤트를 샘플 단위로 적용
+        TR808AudioEvent event;
+        while (audioEvents.popDue(renderSample, &event)) {
+            dispatchAudioEvent(event);
+        }
+        
+        // 스텝 클럭 (샘플 단위 틱)
+        uint8_t clockFlags = stepClock.process(renderSample);
+        if (clockFlags != 0) {
+            handleClockTick(clockFlags);
+        }
+        
+        // TR808 드럼 머신에서 오디오 샘플 생성 (32-bit float -> 16-bit int)
+#ifdef TR808_HYBRID_ENGINE
+        float audioSample = hybridMixer.process() * rampGain;
+#else
+        float audioSample = drumMachine.process() * rampGain;
+#endif
+        {
+            TR808_PROFILE_STAGE(TR808_STAGE_OUTPUT);
+            rampGain += rampStep;
+            int16_t output = (int16_t)(audioSample * 32767);
+            i2sBuffer[i] = output;
+            if (output > peak) peak = output;
+            else if (-output > peak) peak = -output;
+        }
+        renderSample++;
     }
+    blockPeak = peak;
+    
+    // I2S 대기 시간은 렌더 비용에서 제외
+    tr808Perf.endBlock(BUFFER_SIZE);
+    audioLoad.endBlock(BUFFER_SIZE);
+    TR808_TRACE_EVENT(TR808_TRACE_RENDER_END, 0);
     
     // I2S로 출력
     size_t bytesWritten = 0;
+    TR808_TRACE_EVENT(TR808_TRACE_I2S_BEGIN, 0);
     I2S.write(i2sBuffer, BUFFER_SIZE, &bytesWritten);
+    TR808_TRACE_EVENT(TR808_TRACE_I2S_END, bytesWritten);
     
     if (bytesWritten != BUFFER_SIZE) {
-        Serial.println("⚠️ I2S 버퍼 경고: " + String(bytesWritten) + "/" + String(BUFFER_SIZE));
+        tr808Perf.updateBufferUnderrun();
+#ifdef TR808_TRACE
+        tr808Trace.recordUnderrun(bytesWritten);
+#endif
+        // 이미 늦은 블록: 포맷팅/UART 대기 없이 레코드만 기록
+        tr808Log.log(TR808_LOG_I2S_SHORT_WRITE, (int32_t)bytesWritten, BUFFER_SIZE);
     }
     
+    // 이 블록에서 나온 클럭 바이트의 전송 예약 (앵커가 갱신된 뒤)
+    scheduleClockOutput();
+    
     // 성능 모니터링
-    sampleCount++;
+    sampleCount += BUFFER_SIZE;
+    
+    // 블록 경계: 페이드아웃이 끝났으므로 여기서 레이트 전환
+    if (rateChange) {
+        switchSampleRate();
+    }
 }
 
-// ============================================
-// Serial 명령 처리
-// ============================================
-
-void handleSerialCommands() {
-    String command = Serial.readString();
-    command.trim();
-    command.toLowerCase();
-    
-    if (command.length() == 0) return;
-    
-    Serial.println("명령 수신: " + command);
+void switchSampleRate() {
+    uint32_t oldRate = drumMachine.getSampleRate();
     
-    // 기본 드럼 트리거 (숫자키)
-    if (command == "1") {
-        drumMachine.triggerKick(1.0f);
-        Serial.println("🥁 Kick!");
-    }
-    else if (command == "2") {
-        drumMachine.triggerSnare(1.0f);
-        Serial.println("🥁 Snare!");
-    }
-    else if (command == "3") {
-        drumMachine.triggerCymbal(1.0f);
-        Serial.println("🥁 Cymbal!");
-    }
-    else if (command == "4") {
-        drumMachine.triggerHiHat(1.0f, false);
-        Serial.println("🥁 Closed Hi-Hat!");
-    }
-    else if (command == "5") {
-        drumMachine.triggerHiHat(1.0f, true);
-        Serial.println("🥁 Open Hi-Hat!");
-    }
-    else if (command == "6") {
-        drumMachine.triggerTom(1.0f);
-        Serial.println("🥁 Tom!");
-    }
-    else if (command == "7") {
-        drumMachine.triggerConga(1.0f);
-        Serial.println("🥁 Conga!");
-    }
-    else if (command == "8") {
-        drumMachine.triggerRimshot(1.0f);
-        Serial.println("🥁 Rimshot!");
-    }
-    else if (command == "9") {
-        drumMachine.triggerMaracas(1.0f);
-        Serial.println("🥁 Maracas!");
-    }
-    else if (command == "0") {
-        drumMachine.triggerClap(1.0f);
-        Serial.println("🥁 Clap!");
-    }
-    else if (command == "c") {
-        drumMachine.triggerCowbell(1.0f);
-        Serial.println("🥁 Cowbell!");
+    // DMA에 남은 샘플을 무음으로 밀어내 클럭 정지 시 클릭 방지
+    memset(i2sBuffer, 0, BUFFER_SIZE * sizeof(int16_t));
+    for (int i = 0; i < RATE_CHANGE_SILENCE_BLOCKS; i++) {
+        size_t bytesWritten = 0;
+        I2S.write(i2sBuffer, BUFFER_SIZE, &bytesWritten);
     }
     
-    // 풀 네임 명령
-    else if (command == "kick" || command.startsWith("kick ")) {
-        handleKickCommand(command);
-    }
-    else if (command == "snare" || command.startsWith("snare ")) {
-        handleSnareCommand(command);
-    }
-    else if (command == "cymbal" || command.startsWith("cymbal ")) {
-        handleCymbalCommand(command);
-    }
-    else if (command == "hihat" || command.startsWith("hihat ")) {
-        handleHiHatCommand(command);
-    }
-    else if (command == "tom" || command.startsWith("tom ")) {
-        handleTomCommand(command);
-    }
-    else if (command == "conga" || command.startsWith("conga ")) {
-        handleCongaCommand(command);
-    }
-    else if (command == "rimshot") {
-        drumMachine.triggerRimshot(1.0f);
-        Serial.println("🥁 Rimshot!");
-    }
-    else if (command == "maracas") {
-        drumMachine.triggerMaracas(1.0f);
-        Serial.println("🥁 Maracas!");
+    // 엔진 계수와 I2S 클럭을 같은 경계에서 전환
+    I2S.end();
+    drumMachine.applyPendingSampleRate();
+    uint32_t newRate = drumMachine.getSampleRate();
+    TR808_TRACE_EVENT(TR808_TRACE_RATE_CHANGE, newRate / 100);
+    if (!beginI2S(newRate)) {
+        // 실패 시 이전 레이트로 복구
+        uint32_t failedRate = newRate;
+        drumMachine.setSampleRate(oldRate);
+        drumMachine.applyPendingSampleRate();
+        newRate = oldRate;
+        if (beginI2S(oldRate)) {
+            tr808Log.log(TR808_LOG_RATE_RESTORED, (int32_t)oldRate);
+        } else {
+            // 복구도 실패: 출력 없이 렌더하지 않도록 오디오 루프 중단
+            i2sStopped = true;
+            tr808Log.log(TR808_LOG_RATE_RESTORE_FAILED, (int32_t)failedRate, (int32_t)oldRate);
+        }
     }
-    else if (command == "clap" || command.startsWith("clap ")) {
-        handleClapCommand(command);
+    
+    // 샘플 시각 기반 모듈: 템포와 다음 스텝까지 남은 시간 유지
+    sampleClock.begin(newRate, ESP.getCpuFreqMHz() * 1000000UL);
+    stepClock.setSampleRate(newRate, renderSample);
+    tr808Perf.begin(newRate, ESP.getCpuFreqMHz() * 1000000UL);
+    audioLoad.begin(newRate, ESP.getCpuFreqMHz() * 1000000UL);
+    
+    rateFadeIn = true;
+}
+
+void dispatchAudioEvent(const TR808AudioEvent& event) {
+    switch (event.type) {
+        case TR808_EVENT_TRIGGER:
+            triggerVoice(event.voice, event.value / 127.0f);
+            break;
+        case TR808_EVENT_VOLUME:
+            kitSettings.masterVolume = event.value / 127.0f;
+            setOutputVolume(kitSettings.masterVolume);
+            break;
+        case TR808_EVENT_CLOCK:
+            stepClock.onExternalTick(event.sampleTime);
+            break;
+        case TR808_EVENT_START:
+            if (stepClock.getSource() == TR808_CLOCK_EXTERNAL) stepClock.start(event.sampleTime);
+            break;
+        case TR808_EVENT_CONTINUE:
+            if (stepClock.getSource() == TR808_CLOCK_EXTERNAL) stepClock.resume(event.sampleTime);
+            break;
+        case TR808_EVENT_STOP:
+            if (stepClock.getSource() == TR808_CLOCK_EXTERNAL) stepClock.stop();
+            break;
+        case TR808_EVENT_SONG_POSITION:
+            stepClock.setSongPosition((uint16_t)(event.voice | (event.value << 7)));
+            break;
     }
-    else if (command == "cowbell") {
-        drumMachine.triggerCowbell(1.0f);
-        Serial.println("🥁 Cowbell!");
+}
+
+void handleClockTick(uint8_t clockFlags) {
+    // 마스터 모드: 틱 샘플 시각과 함께 큐에 넣음 (전송은 그 샘플이 재생될 때)
+    if (ENABLE_MIDI && MIDI_CLOCK_OUTPUT && stepClock.getSource() == TR808_CLOCK_INTERNAL) {
+        clockOutput.push(renderSample, (uint8_t)MIDI_CLOCK);
     }
     
-    // 시스템 명령
-    else if (command == "help" || command == "h") {
-        printInstructions();
+    if (ENABLE_SEQUENCER && (clockFlags & TR808_CLOCK_STEP)) {
+        TR808_TRACE_EVENT(TR808_TRACE_STEP, stepClock.getStep() % TR808_FRAME_STEPS);
+        playSequencerStep(stepClock.getStep() % TR808_FRAME_STEPS);
     }
-    else if (command == "status" || command == "s") {
-        printStatus();
-    }
-    else if (command == "config" || command == "cfg") {
-        printConfig();
+}
+
+void setTransport(bool run) {
+    if (stepClock.getSource() == TR808_CLOCK_EXTERNAL) {
+        return; // 슬레이브: 외부 Start/Stop을 따름
     }
-    else if (command == "perf" || command == "p") {
-        printPerformance();
+    
+    if (run && !stepClock.isRunning()) {
+        if (ENABLE_MIDI && MIDI_CLOCK_OUTPUT) clockOutput.push(renderSample, (uint8_t)MIDI_START);
+        stepClock.start(renderSample);
+    } else if (!run && stepClock.isRunning()) {
+        if (ENABLE_MIDI && MIDI_CLOCK_OUTPUT) clockOutput.push(renderSample, (uint8_t)MIDI_STOP);
+        stepClock.stop();
     }
-    else if (command == "reset" || command == "r") {
-        resetSystem();
+}
+
+/**
+ * 큐에서 가장 이른 클럭 바이트의 재생 시각에 타이머 예약
+ * 재생 시각 = 렌더 타임라인이 (틱 샘플 + MIDI_CLOCK_OUT_LATENCY)에 도달하는 순간
+ * 이미 예약되어 있으면 esp_timer_start_once가 거절 -> 렌더 루프와 콜백 양쪽에서 호출해도 됨
+ */
+void scheduleClockOutput() {
+    uint32_t sampleTime;
+    if (clockOutputTimer == nullptr || !clockOutput.peek(&sampleTime)) {
+        return;
     }
-    else if (command == "test" || command == "t") {
-        runAudioTest();
+    uint32_t cpuMHz = ESP.getCpuFreqMHz();
+    uint32_t cycles = sampleClock.cyclesUntil(sampleTime + MIDI_CLOCK_OUT_LATENCY, ESP.getCycleCount());
+    // 올림: 일찍 깨어나 아무것도 못 보내고 다시 예약하는 일 방지
+    esp_timer_start_once(clockOutputTimer, (cycles + cpuMHz - 1) / cpuMHz);
+}
+
+/**
+ * 클럭 출력 타이머 콜백 (esp_timer 태스크)
+ * 재생 타임라인에 도달한 바이트만 전송하고, 남은 바이트가 있으면 다시 예약
+ */
+void onClockOutputTimer(void* arg) {
+    uint32_t playing = sampleClock.now(ESP.getCycleCount()) - MIDI_CLOCK_OUT_LATENCY;
+    uint8_t status;
+    while (clockOutput.popDue(playing, &status)) {
+        Serial1.write(status);
     }
-    else if (command == "examples" || command == "e") {
-        printExamples();
+    scheduleClockOutput();
+}
+
+// ============================================
+// MIDI 입력 처리
+// ============================================
+
+void onMidiReceive() {
+    // 수신 시점의 오디오 샘플 시각 (블록 내부 위치까지 보간)
+    uint32_t timestamp = sampleClock.now(ESP.getCycleCount());
+    
+    while (Serial1.available()) {
+        TR808MidiMessage message;
+        if (midiParser.feed((uint8_t)Serial1.read(), timestamp, &message)) {
+            handleMidiMessage(message);
+        }
     }
+}
+
+void handleMidiMessage(const TR808MidiMessage& message) {
+    // 고정 지연 후 재생 -> 수신 타이밍 지터가 출력에 나타나지 않음
+    TR808AudioEvent event;
+    event.sampleTime = message.timestamp + MIDI_EVENT_LATENCY;
+    event.voice = 0;
+    event.value = 0;
     
-    // 마스터 컨트롤
-    else if (command.startsWith("master ")) {
-        float volume = command.substring(7).toFloat();
-        if (volume >= 0.0f && volume <= 1.0f) {
-            drumMachine.setMasterVolume(volume);
-            Serial.println("🔊 마스터 볼륨: " + String(volume));
-        } else {
-            Serial.println("❌ 볼륨은 0.0-1.0 사이의 값이어야 합니다.");
+    // 시스템 메시지: 클럭/트랜스포트
+    if (message.status >= 0xF0) {
+        switch (message.status) {
+            case MIDI_CLOCK:         event.type = TR808_EVENT_CLOCK; break;
+            case MIDI_START:         event.type = TR808_EVENT_START; break;
+            case MIDI_CONTINUE:      event.type = TR808_EVENT_CONTINUE; break;
+            case MIDI_STOP:          event.type = TR808_EVENT_STOP; break;
+            case MIDI_SONG_POSITION:
+                event.type = TR808_EVENT_SONG_POSITION;
+                event.voice = message.data1;
+                event.value = message.data2;
+                break;
+            default:
+                return;
         }
+        audioEvents.push(event);
+        return;
     }
     
-    else {
-        Serial.println("❓ 알 수 없는 명령: " + command);
-        Serial.println("💡 'help' 명령어로 사용법을 확인하세요.");
+    if ((message.status & 0x0F) != MIDI_CHANNEL - 1) {
+        return;
+    }
+    
+    switch (message.status & 0xF0) {
+        case MIDI_STATUS_NOTE_ON:
+            if (message.data2 == 0) return; // 벨로시티 0 = Note Off
+            event.voice = TR808_NOTE_TO_VOICE[message.data1 & 0x7F];
+            if (event.voice == TR808_MIDI_NO_VOICE) return;
+            event.type = TR808_EVENT_TRIGGER;
+            event.value = message.data2;
+            audioEvents.push(event);
+            break;
+            
+        case MIDI_STATUS_CONTROL_CHANGE:
+            if (message.data1 == 7) { // Volume
+                event.type = TR808_EVENT_VOLUME;
+                event.value = message.data2;
+                audioEvents.push(event);
+            }
+            break;
     }
 }
 
 // ============================================
-// 개별 드럼 명령 처리 함수들
+// Serial 명령 처리
 // ============================================
 
-void handleKickCommand(const String& command) {
-    if (command == "kick") {
-        drumMachine.triggerKick(1.0f);
-        Serial.println("🥁 Kick!");
-    } else if (command.startsWith("kick ")) {
-        float velocity = command.substring(5).toFloat();
-        if (velocity >= 0.0f && velocity <= 1.0f) {
-            drumMachine.triggerKick(velocity);
-            Serial.println("🥁 Kick (벨로시티: " + String(velocity) + ")");
-        } else {
-            Serial.println("❌ 벨로시티는 0.0-1.0 사이여야 합니다.");
+void pollSerialInput() {
+    uint8_t chunk[SERIAL_RX_CHUNK_SIZE];
+    
+    // UART RX 링버퍼에 이미 들어온 만큼만 읽음 (readString 타임아웃 대기 제거)
+    int available = Serial.available();
+    if (available <= 0) return;
+    TR808_TRACE_EVENT(TR808_TRACE_SERIAL_BEGIN, available);
+    while (available > 0) {
+        size_t count = Serial.read(chunk, min(available, SERIAL_RX_CHUNK_SIZE));
+        if (count == 0) break;
+        available -= count;
+        
+        for (size_t i = 0; i < count; i++) {
+            uint8_t byte = chunk[i];
+            
+            // 0x00 구분자로 시작하는 구간은 바이너리 프레임
+            if (byte == TR808_FRAME_DELIMITER || frameDecoder.isReceiving()) {
+                if (frameDecoder.feed(byte)) {
+                    handleFrame(frameDecoder.getFrame());
+                }
+                continue;
+            }
+            
+            // 텍스트 콘솔: 줄 단위로 모아서 처리
+            if (byte == '\n' || byte == '\r') {
+                if (commandLength > 0) {
+                    commandLine[commandLength] = '\0';
+                    handleSerialCommands(commandLine);
+                    commandLength = 0;
+                }
+            } else if (commandLength < COMMAND_BUFFER_SIZE - 1) {
+                commandLine[commandLength++] = (char)byte;
+            }
         }
     }
+    TR808_TRACE_EVENT(TR808_TRACE_SERIAL_END, 0);
 }
 
-void handleSnareCommand(const String& command) {
-    if (command == "snare") {
-        drumMachine.triggerSnare(1.0f);
-        Serial.println("🥁 Snare!");
-    } else if (command.startsWith("snare ")) {
-        float velocity = command.substring(6).toFloat();
-        if (velocity >= 0.0f && velocity <= 1.0f) {
-            drumMachine.triggerSnare(velocity);
-            Serial.println("🥁 Snare (벨로시티: " + String(velocity) + ")");
-        } else {
-            Serial.println("❌ 벨로시티는 0.0-1.0 사이여야 합니다.");
-        }
+void sendFrame(uint8_t command, uint8_t sequence, const uint8_t* payload, uint8_t length) {
+    uint8_t encoded[TR808_FRAME_MAX_ENCODED];
+    size_t size = tr808EncodeFrame(command, sequence, payload, length, encoded);
+    if (size > 0) {
+        Serial.write(encoded, size);
     }
 }
 
-void handleCymbalCommand(const String& command) {
-    if (command == "cymbal") {
-        drumMachine.triggerCymbal(1.0f);
-        Serial.println("🥁 Cymbal!");
-    } else if (command.startsWith("cymbal ")) {
-        float velocity = command.substring(7).toFloat();
-        if (velocity >= 0.0f && velocity <= 1.0f) {
-            drumMachine.triggerCymbal(velocity);
-            Serial.println("🥁 Cymbal (벨로시티: " + String(velocity) + ")");
-        } else {
-            Serial.println("❌ 벨로시티는 0.0-1.0 사이여야 합니다.");
-        }
+void sendNack(const TR808Frame& frame, uint8_t error) {
+    uint8_t payload[2] = { frame.command, error };
+    sendFrame(TR808_FRAME_NACK, frame.sequence, payload, sizeof(payload));
+}
+
+void triggerVoice(uint8_t voice, float velocity) {
+    TR808_TRACE_EVENT(TR808_TRACE_TRIGGER, voice | ((uint16_t)(velocity * 127.0f) << 8));
+#ifdef TR808_HYBRID_ENGINE
+    // 드럼별 백엔드 라우팅 (네이티브 보이스는 믹서가 drumMachine으로 전달)
+    hybridMixer.trigger(voice, velocity);
+#else
+    switch (voice) {
+        case TR808_VOICE_KICK:         drumMachine.triggerKick(velocity); break;
+        case TR808_VOICE_SNARE:        drumMachine.triggerSnare(velocity); break;
+        case TR808_VOICE_CYMBAL:       drumMachine.triggerCymbal(velocity); break;
+        case TR808_VOICE_HIHAT_CLOSED: drumMachine.triggerHiHat(velocity, false); break;
+        case TR808_VOICE_HIHAT_OPEN:   drumMachine.triggerHiHat(velocity, true); break;
+        case TR808_VOICE_TOM:          drumMachine.triggerTom(velocity); break;
+        case TR808_VOICE_CONGA:        drumMachine.triggerConga(velocity); break;
+        case TR808_VOICE_RIMSHOT:      drumMachine.triggerRimshot(velocity); break;
+        case TR808_VOICE_MARACAS:      drumMachine.triggerMaracas(velocity); break;
+        case TR808_VOICE_CLAP:         drumMachine.triggerClap(velocity); break;
+        case TR808_VOICE_COWBELL:      drumMachine.triggerCowbell(velocity); break;
     }
+#endif
 }
 
-void handleHiHatCommand(const String& command) {
-    if (command == "hihat") {
-        drumMachine.triggerHiHat(1.0f, false);
-        Serial.println("🥁 Closed Hi-Hat!");
-    } else if (command.startsWith("hihat ")) {
-        float velocity = command.substring(6).toFloat();
-        if (velocity >= 0.0f && velocity <= 1.0f) {
-            drumMachine.triggerHiHat(velocity, false);
-            Serial.println("🥁 Hi-Hat (벨로시티: " + String(velocity) + ")");
-        } else {
-            Serial.println("❌ 벨로시티는 0.0-1.0 사이여야 합니다.");
-        }
+// 킷 파라미터 허용 범위 (KitSettings 필드 순서, arduino_tr808_config.h 범위)
+struct KitParamRange {
+    float minValue;
+    float maxValue;
+};
+
+const KitParamRange KIT_PARAM_RANGES[] = {
+    {MIN_VOLUME, MAX_VOLUME},
+    {KICK_DECAY_RANGE_MIN, KICK_DECAY_RANGE_MAX},
+    {KICK_TONE_RANGE_MIN, KICK_TONE_RANGE_MAX},
+    {SNARE_TONE_RANGE_MIN, SNARE_TONE_RANGE_MAX},
+    {SNARE_SNAPPY_RANGE_MIN, SNARE_SNAPPY_RANGE_MAX},
+    {CYMBAL_DECAY_RANGE_MIN, CYMBAL_DECAY_RANGE_MAX},
+    {CYMBAL_TONE_RANGE_MIN, CYMBAL_TONE_RANGE_MAX},
+    {HIHAT_DECAY_RANGE_MIN, HIHAT_DECAY_RANGE_MAX},
+    {TOM_TUNING_RANGE_MIN, TOM_TUNING_RANGE_MAX},
+    {CONGA_TUNING_RANGE_MIN, CONGA_TUNING_RANGE_MAX}
+};
+static_assert(sizeof(KIT_PARAM_RANGES) / sizeof(KIT_PARAM_RANGES[0]) == sizeof(KitSettings) / sizeof(float),
+              "킷 파라미터 범위 표와 KitSettings 필드 수 불일치");
+
+bool setKitParameter(uint8_t param, float value) {
+    // 바이너리 프레임의 float는 검증 없이 들어오므로 텍스트 명령과 같은 범위 검사 (NaN/무한대 거부)
+    if (param >= sizeof(KIT_PARAM_RANGES) / sizeof(KIT_PARAM_RANGES[0]) || !isfinite(value) ||
+        value < KIT_PARAM_RANGES[param].minValue || value > KIT_PARAM_RANGES[param].maxValue) {
+        return false;
     }
+    
+    // 파라미터 번호 = KitSettings 필드 순서
+    switch (param) {
+        case 0: kitSettings.masterVolume = value; setOutputVolume(value); break;
+        case 1: kitSettings.kickDecay = value;    drumMachine.setKickDecay(value); break;
+        case 2: kitSettings.kickTone = value;     drumMachine.setKickTone(value); break;
+        case 3: kitSettings.snareTone = value;    drumMachine.setSnareTone(value); break;
+        case 4: kitSettings.snareSnappy = value;  drumMachine.setSnareSnappy(value); break;
+        case 5: kitSettings.cymbalDecay = value;  drumMachine.setCymbalDecay(value); break;
+        case 6: kitSettings.cymbalTone = value;   drumMachine.setCymbalTone(value); break;
+        case 7: kitSettings.hihatDecay = value;   drumMachine.setHiHatDecay(value); break;
+        case 8: kitSettings.tomTuning = value;    drumMachine.setTomTuning(value); break;
+        case 9: kitSettings.congaTuning = value;  drumMachine.setCongaTuning(value); break;
+        default: return false;
+    }
+#ifdef TR808_HYBRID_ENGINE
+    applyMozziKitSettings(kitSettings);
+#endif
+    return true;
 }
 
-void handleTomCommand(const String& command) {
-    if (command == "tom") {
-        drumMachine.triggerTom(1.0f);
-        Serial.println("🥁 Tom!");
-    } else if (command.startsWith("tom ")) {
-        float velocity = command.substring(4).toFloat();
-        if (velocity >= 0.0f && velocity <= 1.0f) {
-            drumMachine.triggerTom(velocity);
-            Serial.println("🥁 Tom (벨로시티: " + String(velocity) + ")");
-        } else {
-            Serial.println("❌ 벨로시티는 0.0-1.0 사이여야 합니다.");
+void handleFrame(const TR808Frame& frame) {
+    const uint8_t* p = frame.payload;
+    
+    switch (frame.command) {
+        case TR808_FRAME_TRIGGER:
+            if (frame.length != 2) { sendNack(frame, TR808_FRAME_ERR_BAD_LENGTH); return; }
+            if (p[0] >= TR808_VOICE_COUNT) { sendNack(frame, TR808_FRAME_ERR_BAD_VALUE); return; }
+            triggerVoice(p[0], p[1] / 127.0f);
+            break;
+            
+        case TR808_FRAME_TRIGGER_MASK: {
+            if (frame.length != 3) { sendNack(frame, TR808_FRAME_ERR_BAD_LENGTH); return; }
+            uint16_t mask = tr808ReadU16(p);
+            float velocity = p[2] / 127.0f;
+            for (uint8_t voice = 0; voice < TR808_VOICE_COUNT; voice++) {
+                if (mask & (1u << voice)) triggerVoice(voice, velocity);
+            }
+            break;
+        }
+        
+        case TR808_FRAME_SET_PARAM:
+            if (frame.length != 5) { sendNack(frame, TR808_FRAME_ERR_BAD_LENGTH); return; }
+            if (!setKitParameter(p[0], tr808ReadFloat(&p[1]))) {
+                sendNack(frame, TR808_FRAME_ERR_BAD_VALUE);
+                return;
+            }
+            break;
+            
+        case TR808_FRAME_SET_STEPS: {
+            // {voice, start, count, velocity[count]} - 한 프레임으로 최대 16스텝 설정
+            if (frame.length < 3 || frame.length != 3 + p[2]) {
+                sendNack(frame, TR808_FRAME_ERR_BAD_LENGTH);
+                return;
+            }
+            uint8_t voice = p[0], start = p[1], count = p[2];
+            if (voice >= TR808_VOICE_COUNT || start + count > TR808_FRAME_STEPS) {
+                sendNack(frame, TR808_FRAME_ERR_BAD_VALUE);
+                return;
+            }
+            memcpy(&stepVelocity[voice][start], &p[3], count);
+            break;
+        }
+        
+        case TR808_FRAME_TRANSPORT:
+            if (frame.length != 3) { sendNack(frame, TR808_FRAME_ERR_BAD_LENGTH); return; }
+            if (tr808ReadU16(&p[1]) != 0) {
+                stepClock.setTempo(constrain(tr808ReadU16(&p[1]), MIN_BPM * 10, MAX_BPM * 10) / 10.0f);
+            }
+            setTransport(p[0] != 0);
+            break;
+            
+        case TR808_FRAME_STATUS: {
+            uint8_t payload[8];
+            uint16_t cpu = (uint16_t)(cpuUsage * 10.0f);
+            uint16_t bpmX10 = (uint16_t)(stepClock.getTempo() * 10.0f + 0.5f);
+            uint32_t samples = sampleCount;
+            payload[0] = stepClock.isRunning() ? 1 : 0;
+            payload[1] = (uint8_t)(bpmX10 & 0xFF);
+            payload[2] = (uint8_t)(bpmX10 >> 8);
+            payload[3] = (uint8_t)(cpu & 0xFF);
+            payload[4] = (uint8_t)(cpu >> 8);
+            payload[5] = (uint8_t)(samples & 0xFF);
+            payload[6] = (uint8_t)((samples >> 8) & 0xFF);
+            payload[7] = (uint8_t)((samples >> 16) & 0xFF);
+            sendFrame(TR808_FRAME_STATUS, frame.sequence, payload, sizeof(payload));
+            return;
         }
+        
+        default:
+            sendNack(frame, TR808_FRAME_ERR_UNKNOWN_COMMAND);
+            return;
     }
+    
+    uint8_t ack = frame.command;
+    sendFrame(TR808_FRAME_ACK, frame.sequence, &ack, 1);
 }
 
-void handleCongaCommand(const String& command) {
-    if (command == "conga") {
-        drumMachine.triggerConga(1.0f);
-        Serial.println("🥁 Conga!");
-    } else if (command.startsWith("conga ")) {
-        float velocity = command.substring(6).toFloat();
-        if (velocity >= 0.0f && velocity <= 1.0f) {
-            drumMachine.triggerConga(velocity);
-            Serial.println("🥁 Conga (벨로시티: " + String(velocity) + ")");
-        } else {
-            Serial.println("❌ 벨로시티는 0.0-1.0 사이여야 합니다.");
+// 보이스별 표시 이름 (TR808Voice 순서)
+const char* const VOICE_NAMES[TR808_VOICE_COUNT] = {
+    "Kick", "Snare", "Cymbal", "Closed Hi-Hat", "Open Hi-Hat",
+    "Tom", "Conga", "Rimshot", "Maracas", "Clap", "Cowbell"
+};
+
+void handleSerialCommands(char* line) {
+    TR808CommandTokens tokens;
+    if (tokens.parse(line) == 0) return;
+    
+    Serial.print("명령 수신: ");
+    Serial.println(tokens.get(0));
+    
+    int voice = -1;
+    
+    // 해시가 맞은 case마다 토큰 문자열을 다시 비교: 해시만 충돌한 토큰은 break로 빠져 알 수 없는 명령 처리
+    switch (tokens.commandHash()) {
+        // 기본 드럼 트리거 (숫자키) 및 풀 네임 명령 (선택 인자: 벨로시티)
+        case TR808_CMD("1"): case TR808_CMD("kick"):
+            if (!tokens.matches(0, "1", "kick")) break;
+            voice = TR808_VOICE_KICK; break;
+        case TR808_CMD("2"): case TR808_CMD("snare"):
+            if (!tokens.matches(0, "2", "snare")) break;
+            voice = TR808_VOICE_SNARE; break;
+        case TR808_CMD("3"): case TR808_CMD("cymbal"):
+            if (!tokens.matches(0, "3", "cymbal")) break;
+            voice = TR808_VOICE_CYMBAL; break;
+        case TR808_CMD("4"): case TR808_CMD("hihat"):
+            if (!tokens.matches(0, "4", "hihat")) break;
+            voice = TR808_VOICE_HIHAT_CLOSED; break;
+        case TR808_CMD("5"):
+            if (!tokens.matches(0, "5")) break;
+            voice = TR808_VOICE_HIHAT_OPEN; break;
+        case TR808_CMD("6"): case TR808_CMD("tom"):
+            if (!tokens.matches(0, "6", "tom")) break;
+            voice = TR808_VOICE_TOM; break;
+        case TR808_CMD("7"): case TR808_CMD("conga"):
+            if (!tokens.matches(0, "7", "conga")) break;
+            voice = TR808_VOICE_CONGA; break;
+        case TR808_CMD("8"): case TR808_CMD("rimshot"):
+            if (!tokens.matches(0, "8", "rimshot")) break;
+            voice = TR808_VOICE_RIMSHOT; break;
+        case TR808_CMD("9"): case TR808_CMD("maracas"):
+            if (!tokens.matches(0, "9", "maracas")) break;
+            voice = TR808_VOICE_MARACAS; break;
+        case TR808_CMD("0"): case TR808_CMD("clap"):
+            if (!tokens.matches(0, "0", "clap")) break;
+            voice = TR808_VOICE_CLAP; break;
+        case TR808_CMD("c"): case TR808_CMD("cowbell"):
+            if (!tokens.matches(0, "c", "cowbell")) break;
+            voice = TR808_VOICE_COWBELL; break;
+        
+        // 시스템 명령
+        case TR808_CMD("help"):     case TR808_CMD("h"):
+            if (!tokens.matches(0, "help", "h")) break;
+            printInstructions(); return;
+        case TR808_CMD("status"):   case TR808_CMD("s"):
+            if (!tokens.matches(0, "status", "s")) break;
+            printStatus(); return;
+        case TR808_CMD("config"):   case TR808_CMD("cfg"):
+            if (!tokens.matches(0, "config", "cfg")) break;
+            printConfig(); return;
+        case TR808_CMD("perf"):     case TR808_CMD("p"):
+            if (!tokens.matches(0, "perf", "p")) break;
+            printPerformance(); return;
+        case TR808_CMD("reset"):    case TR808_CMD("r"):
+            if (!tokens.matches(0, "reset", "r")) break;
+            resetSystem(); return;
+        case TR808_CMD("test"):     case TR808_CMD("t"):
+            if (!tokens.matches(0, "test", "t")) break;
+            runAudioTest(); return;
+        case TR808_CMD("examples"): case TR808_CMD("e"):
+            if (!tokens.matches(0, "examples", "e")) break;
+            printExamples(); return;
+        case TR808_CMD("bench"):
+            if (!tokens.matches(0, "bench")) break;
+            handleBenchCommand(tokens); return;
+        case TR808_CMD("trace"):
+            if (!tokens.matches(0, "trace")) break;
+            handleTraceCommand(tokens); return;
+        case TR808_CMD("memory"):   case TR808_CMD("mem"):
+            if (!tokens.matches(0, "memory", "mem")) break;
+            printMemoryReport(); return;
+#ifdef TR808_HYBRID_ENGINE
+        case TR808_CMD("engine"):
+            if (!tokens.matches(0, "engine")) break;
+            handleEngineCommand(tokens); return;
+#endif
+        
+        // 템포/트랜스포트
+        case TR808_CMD("bpm"): {
+            if (!tokens.matches(0, "bpm")) break;
+            float bpm;
+            if (tokens.getFloat(1, &bpm) && bpm >= MIN_BPM && bpm <= MAX_BPM) {
+                stepClock.setTempo(bpm);
+                Serial.print("⏱️ BPM: ");
+                Serial.println(bpm, 1);
+            } else {
+                Serial.print("⏱️ 현재 BPM: ");
+                Serial.println(stepClock.getTempo(), 1);
+            }
+            return;
         }
+        case TR808_CMD("play"):
+            if (!tokens.matches(0, "play")) break;
+            setTransport(true);
+            return;
+        case TR808_CMD("stop"):
+            if (!tokens.matches(0, "stop")) break;
+            setTransport(false);
+            return;
+        case TR808_CMD("clock"):
+            if (!tokens.matches(0, "clock")) break;
+            if (tokens.size() > 1) {
+                stepClock.setSource(tokens.matches(1, "ext")
+                                    ? TR808_CLOCK_EXTERNAL : TR808_CLOCK_INTERNAL);
+            }
+            Serial.print("⏱️ 클럭: ");
+            Serial.print(stepClock.getSource() == TR808_CLOCK_EXTERNAL ? "외부 (슬레이브)" : "내부 (마스터)");
+            Serial.println(stepClock.isLocked() ? "" : " - 동기 대기 중");
+            return;
+        
+        // 샘플 레이트 (다음 블록 경계에서 전환)
+        case TR808_CMD("rate"): {
+            if (!tokens.matches(0, "rate")) break;
+            float rate;
+            if (tokens.getFloat(1, &rate) && rate >= MIN_SAMPLE_RATE && rate <= MAX_SAMPLE_RATE &&
+                requestSampleRate((uint32_t)rate)) {
+                Serial.println("🎚️ 샘플 레이트 변경 예약: " + String((uint32_t)rate) + " Hz");
+            } else {
+                Serial.println("🎚️ 현재 샘플 레이트: " + String(drumMachine.getSampleRate()) + " Hz (" +
+                               String(MIN_SAMPLE_RATE) + "-" + String(MAX_SAMPLE_RATE) + ")");
+            }
+            return;
+        }
+        
+        // 컨트롤 레이트 간격 (엔벨롭/피치 변조 계산 주기, 샘플)
+        case TR808_CMD("ctrl"): {
+            if (!tokens.matches(0, "ctrl")) break;
+            float interval;
+            if (tokens.getFloat(1, &interval) && interval >= 1 && interval <= TR808_CONTROL_INTERVAL_MAX) {
+                drumMachine.setControlInterval((uint8_t)interval);
+            }
+            Serial.println("🎛️ 컨트롤 간격: " + String(drumMachine.getControlInterval()) + " 샘플");
+            return;
+        }
+        
+        // 마스터 컨트롤
+        case TR808_CMD("master"): {
+            if (!tokens.matches(0, "master")) break;
+            float volume;
+            if (tokens.getFloat(1, &volume) && volume >= 0.0f && volume <= 1.0f) {
+                kitSettings.masterVolume = volume;
+                setOutputVolume(volume);
+                Serial.print("🔊 마스터 볼륨: ");
+                Serial.println(volume);
+            } else {
+                Serial.println("❌ 볼륨은 0.0-1.0 사이의 값이어야 합니다.");
+            }
+            return;
+        }
+        
+        default:
+            break;
+    }
+    
+    if (voice < 0) {
+        Serial.print("❓ 알 수 없는 명령: ");
+        Serial.println(tokens.get(0));
+        Serial.println("💡 'help' 명령어로 사용법을 확인하세요.");
+        return;
     }
+    handleDrumCommand(voice, tokens);
 }
 
-void handleClapCommand(const String& command) {
-    if (command == "clap") {
-        drumMachine.triggerClap(1.0f);
-        Serial.println("🥁 Clap!");
-    } else if (command.startsWith("clap ")) {
-        float velocity = command.substring(5).toFloat();
-        if (velocity >= 0.0f && velocity <= 1.0f) {
-            drumMachine.triggerClap(velocity);
-            Serial.println("🥁 Clap (벨로시티: " + String(velocity) + ")");
-        } else {
-            Serial.println("❌ 벨로시티는 0.0-1.0 사이여야 합니다.");
-        }
+// ============================================
+// 드럼 명령 처리
+// ============================================
+
+void handleDrumCommand(int voice, const TR808CommandTokens& tokens) {
+    float velocity;
+    if (!tokens.getFloatOr(1, 1.0f, &velocity) || velocity < 0.0f || velocity > 1.0f) {
+        Serial.println("❌ 벨로시티는 0.0-1.0 사이여야 합니다.");
+        return;
+    }
+    
+    triggerVoice(voice, velocity);
+    
+    Serial.print("🥁 ");
+    Serial.print(VOICE_NAMES[voice]);
+    if (tokens.size() > 1) {
+        Serial.print(" (벨로시티: ");
+        Serial.print(velocity);
+        Serial.println(")");
+    } else {
+        Serial.println("!");
     }
 }
 
@@ -478,17 +1214,14 @@ void handleClapCommand(const String& command) {
 // 시퀀서 처리 (선택사항)
 // ============================================
 
-void handleSequencer(unsigned long currentTime) {
-    // TODO: 패턴 기반 자동 드럼 연주
-    // static unsigned long lastStepTime = 0;
-    // static int currentStep = 0;
-    // 
-    // if (currentTime - lastStepTime >= 120) { // 120 BPM
-    //     // 현재 스텝의 패턴 실행
-    //     executePattern(currentStep);
-    //     currentStep = (currentStep + 1) % 16;
-    //     lastStepTime = currentTime;
-    // }
+void playSequencerStep(uint8_t step) {
+    // 스텝 클럭이 렌더 루프 안에서 호출 -> 샘플 단위로 정확한 스텝 타이밍
+    for (uint8_t voice = 0; voice < TR808_VOICE_COUNT; voice++) {
+        uint8_t velocity = stepVelocity[voice][step];
+        if (velocity > 0) {
+            triggerVoice(voice, velocity / 127.0f);
+        }
+    }
 }
 
 // ============================================
@@ -504,11 +1237,12 @@ void updatePerformanceMetrics(unsigned long currentTime) {
     
     if (elapsed > 0) {
         float actualSampleRate = (samplesThisPeriod * 1000.0f) / elapsed;
-        cpuUsage = (actualSampleRate / SAMPLE_RATE) * 100.0f;
+        cpuUsage = audioLoad.getAverage() / 10.0f;
         
         if (PERFORMANCE_MONITORING) {
-            Serial.println("📊 성능: " + String(actualSampleRate, 0) + " Hz (" + 
-                         String(cpuUsage, 1) + "%) | 샘플: " + String(sampleCount));
+            Serial.println("📊 성능: " + String(actualSampleRate, 0) + " Hz | 부하 " + 
+                         String(cpuUsage, 1) + "% (피크 " + String(audioLoad.getPeak() / 10.0f, 1) +
+                         "%) | 샘플: " + String(sampleCount));
         }
     }
     
@@ -516,31 +1250,283 @@ void updatePerformanceMetrics(unsigned long currentTime) {
     lastSampleCount = sampleCount;
 }
 
+/**
+ * bench          컨트롤 레이트 간격별 렌더 비용
+ * bench wcet     렌더 블록 최악 실행 시간 (캐시 적중/콜드)
+ */
+void handleBenchCommand(const TR808CommandTokens& tokens) {
+    if (tokens.matches(1, "wcet")) {
+        benchmarkRenderWcet();
+        return;
+    }
+    if (tokens.matches(1, "square")) {
+        benchmarkSquareOscillators();
+        return;
+    }
+    benchmarkControlRate();
+}
+
+/**
+ * 금속성 뱅크(오실레이터 6개) 구형파 비용: naive vs PolyBLEP
+ * naive 64kHz는 샘플 수가 늘어나는 만큼 환산 (에일리어싱 비교는 extras/host/square_alias.cpp)
+ */
+void benchmarkSquareOscillators() {
+    uint32_t cpuHz = ESP.getCpuFreqMHz() * 1000000UL;
+    uint32_t rate = drumMachine.getSampleRate();
+    uint32_t cycles[2];
+    
+    Serial.println("⏱️ 구형파 벤치마크 (" + String(SQUARE_BENCH_SAMPLES) + " 샘플, 오실레이터 6개)");
+    for (uint8_t kind = 0; kind < 2; kind++) {
+        TR808Oscillator bank[6];
+        for (uint8_t i = 0; i < 6; i++) {
+            bank[i].setFrequency(TR808_METAL_FREQS[i]);
+        }
+        
+        volatile float sink = 0.0f;
+        uint32_t start = ESP.getCycleCount();
+        for (int n = 0; n < SQUARE_BENCH_SAMPLES; n++) {
+            float mixed = 0.0f;
+            for (uint8_t i = 0; i < 6; i++) {
+                mixed += kind ? bank[i].generateSquareBlep() : bank[i].generateSquare();
+            }
+            sink += mixed;
+        }
+        cycles[kind] = (ESP.getCycleCount() - start) / SQUARE_BENCH_SAMPLES;
+    }
+    
+    Serial.printf("  naive  %5lu 사이클/샘플  CPU %5.2f%% @ %lu Hz, %5.2f%% @ %lu Hz\n",
+                  (unsigned long)cycles[0], (float)cycles[0] * rate * 100.0f / cpuHz, (unsigned long)rate,
+                  (float)cycles[0] * SQUARE_BENCH_OVERSAMPLED * 100.0f / cpuHz,
+                  (unsigned long)SQUARE_BENCH_OVERSAMPLED);
+    Serial.printf("  BLEP   %5lu 사이클/샘플  CPU %5.2f%% @ %lu Hz (naive 대비 %.2fx)\n",
+                  (unsigned long)cycles[1], (float)cycles[1] * rate * 100.0f / cpuHz, (unsigned long)rate,
+                  cycles[0] > 0 ? (float)cycles[1] / cycles[0] : 0.0f);
+}
+
+/**
+ * 컨트롤 레이트 간격별 렌더 비용 비교
+ * 모든 보이스를 트리거한 뒤 같은 길이를 렌더링 (간격 1 = 매 샘플 변조 계산)
+ * 렌더 루프를 잠시 멈추므로 출력이 끊길 수 있음
+ */
+void benchmarkControlRate() {
+    static const uint8_t intervals[] = {1, 4, 8, 16, 32};
+    uint8_t savedInterval = drumMachine.getControlInterval();
+    uint32_t cpuHz = ESP.getCpuFreqMHz() * 1000000UL;
+    uint32_t baseline = 0;
+    
+    Serial.println("⏱️ 컨트롤 레이트 벤치마크 (" + String(CONTROL_BENCH_SAMPLES) + " 샘플, 전체 보이스)");
+    
+    for (uint8_t n = 0; n < sizeof(intervals); n++) {
+        drumMachine.setControlInterval(intervals[n]);
+        for (uint8_t voice = 0; voice < TR808_VOICE_COUNT; voice++) {
+            triggerVoice(voice, 1.0f);
+        }
+        
+        // 출력 전력도 누적: 보이스가 트리거 직후 종료되면 렌더 비용이 사라져 향상이 부풀려짐
+        float power = 0.0f;
+        uint32_t start = ESP.getCycleCount();
+        for (int i = 0; i < CONTROL_BENCH_SAMPLES; i++) {
+            float sample = drumMachine.process();
+            power += sample * sample;
+        }
+        uint32_t cyclesPerSample = (ESP.getCycleCount() - start) / CONTROL_BENCH_SAMPLES;
+        if (n == 0) baseline = cyclesPerSample;
+        
+        float load = (float)cyclesPerSample * drumMachine.getSampleRate() * 100.0f / cpuHz;
+        Serial.printf("  N=%-3u %5lu 사이클/샘플  CPU %5.1f%%  RMS %.3f  (%.2fx)\n",
+                      intervals[n], (unsigned long)cyclesPerSample, load,
+                      sqrtf(power / CONTROL_BENCH_SAMPLES),
+                      cyclesPerSample > 0 ? (float)baseline / cyclesPerSample : 0.0f);
+    }
+    
+    drumMachine.setControlInterval(savedInterval);
+}
+
+// processAudio()의 렌더 루프와 같은 배치 (이벤트/I2S 제외), 블록 사이클 반환
+uint32_t TR808_HOT renderBenchBlock() {
+    uint32_t start = ESP.getCycleCount();
+    for (int i = 0; i < BUFFER_SIZE; i++) {
+#ifdef TR808_HYBRID_ENGINE
+        float audioSample = hybridMixer.process();
+#else
+        float audioSample = drumMachine.process();
+#endif
+        i2sBuffer[i] = (int16_t)(audioSample * 32767);
+    }
+    return ESP.getCycleCount() - start;
+}
+
+/**
+ * 렌더 경로 최악 실행 시간 (배치 정책 전후 비교용)
+ * BUFFER_SIZE 블록을 WCET_BENCH_BLOCKS번 렌더해 블록당 최대/평균 사이클을 블록 마감과 비교
+ * - warm: 연속 렌더 (코드/테이블이 캐시에 있음)
+ * - cold: 블록마다 캐시 무효화 후 렌더 (플래시 쓰기, 긴 렌더, 다른 태스크 실행 뒤와 같은 상태)
+ * 배치 전(env:flashpath)과 후(env:performance)를 같은 명령으로 비교, 렌더 루프가 잠시 멈춤
+ */
+void benchmarkRenderWcet() {
+    uint32_t cpuHz = ESP.getCpuFreqMHz() * 1000000UL;
+    uint32_t deadline = (uint32_t)((uint64_t)BUFFER_SIZE * cpuHz / drumMachine.getSampleRate());
+    
+    Serial.printf("⏱️ 렌더 WCET (%u 샘플 블록 x %u, 배치: %s, 마감 %lu 사이클)\n",
+                  BUFFER_SIZE, WCET_BENCH_BLOCKS, TR808_PLACE_ACTIVE ? "IRAM/DRAM" : "플래시",
+                  (unsigned long)deadline);
+    
+    for (uint8_t cold = 0; cold < 2; cold++) {
+        uint32_t worst = 0;
+        uint64_t total = 0;
+        for (uint16_t block = 0; block < WCET_BENCH_BLOCKS; block++) {
+            if (block % WCET_RETRIGGER_BLOCKS == 0) {
+                for (uint8_t voice = 0; voice < TR808_VOICE_COUNT; voice++) {
+                    triggerVoice(voice, 1.0f);
+                }
+            }
+#if CONFIG_IDF_TARGET_ESP32C3
+            if (cold) Cache_Invalidate_ICache_All();
+#endif
+            uint32_t cycles = renderBenchBlock();
+            if (cycles > worst) worst = cycles;
+            total += cycles;
+        }
+        uint32_t mean = (uint32_t)(total / WCET_BENCH_BLOCKS);
+        Serial.printf("  %s  최대 %7lu  평균 %7lu 사이클  (최대 = 마감의 %5.1f%%)\n",
+                      cold ? "cold" : "warm", (unsigned long)worst, (unsigned long)mean,
+                      worst * 100.0f / deadline);
+    }
+}
+
+#ifdef TR808_HYBRID_ENGINE
+// ============================================
+// 하이브리드 백엔드 (engine 명령)
+// ============================================
+
+uint32_t readCycleCount() {
+    return ESP.getCycleCount();
+}
+
+/**
+ * engine                   드럼별 백엔드 표 출력
+ * engine <드럼> mozzi|native  kick, snare, cymbal, hihat 백엔드 변경
+ * engine mozzi|native      Mozzi 지원 드럼 일괄 변경
+ * engine bench             드럼별 비용과 전체 네이티브 대비 절감량
+ */
+void handleEngineCommand(const TR808CommandTokens& tokens) {
+    if (tokens.size() > 1) {
+        // 해시 switch 전에 실제 하위 명령인지 확인 (해시 충돌 토큰 거부)
+        int voice = -1;
+        uint32_t command = tokens.matches(1, "bench", "native", "mozzi", "kick", "snare", "cymbal", "hihat")
+                               ? tr808HashToken(tokens.get(1), tokens.length(1)) : 0;
+        switch (command) {
+            case TR808_CMD("bench"):  benchmarkHybrid(); return;
+            case TR808_CMD("native"): hybridMixer.setAllBackends(TR808_BACKEND_NATIVE); break;
+            case TR808_CMD("mozzi"):  hybridMixer.setAllBackends(TR808_BACKEND_MOZZI); break;
+            case TR808_CMD("kick"):   voice = TR808_VOICE_KICK; break;
+            case TR808_CMD("snare"):  voice = TR808_VOICE_SNARE; break;
+            case TR808_CMD("cymbal"): voice = TR808_VOICE_CYMBAL; break;
+            case TR808_CMD("hihat"):  voice = TR808_VOICE_HIHAT_CLOSED; break;
+            default:
+                Serial.println("❌ Mozzi 백엔드 지원 드럼: kick, snare, cymbal, hihat");
+                return;
+        }
+        
+        if (voice >= 0) {
+            TR808Backend backend = TR808_BACKEND_NATIVE;
+            if (tokens.matches(2, "mozzi")) {
+                backend = TR808_BACKEND_MOZZI;
+            }
+            if (!hybridMixer.setBackend(voice, backend)) {
+                Serial.println("❌ Mozzi 백엔드는 빌드 레이트(" + String(MOZZI_TR808_AUDIO_RATE) + " Hz)에서만 사용 가능");
+            }
+        }
+    }
+    
+    printEngineTable();
+}
+
+void printEngineTable() {
+    Serial.println("🔀 드럼별 백엔드 (Mozzi " + String(hybridMixer.getMozziVoiceCount()) + "개):");
+    for (uint8_t voice = 0; voice < TR808_VOICE_COUNT; voice++) {
+        Serial.print("  ");
+        Serial.print(VOICE_NAMES[voice]);
+        Serial.print(": ");
+        if (hybridMixer.getBackend(voice) == TR808_BACKEND_MOZZI) {
+            Serial.println("Mozzi (고정소수점)");
+        } else {
+            Serial.println(tr808HasMozziVoice(voice) ? "네이티브 (float)" : "네이티브 (float, 전용)");
+        }
+    }
+}
+
+/**
+ * 하이브리드 구성 비용 프로파일
+ * 드럼별로 네이티브/Mozzi 단독 비용(유휴 엔진 비용 차감)을 재고,
+ * 4보이스 동시 재생 시 현재 구성과 전체 네이티브를 비교
+ * 측정은 별도 엔진 인스턴스에서 수행 (렌더 루프가 잠시 멈춰 출력이 끊길 수 있음)
+ */
+void benchmarkHybrid() {
+    static const uint8_t drums[] = {
+        TR808_VOICE_KICK, TR808_VOICE_SNARE, TR808_VOICE_CYMBAL, TR808_VOICE_HIHAT_CLOSED
+    };
+    uint8_t allNative[TR808_VOICE_COUNT];
+    uint8_t allMozzi[TR808_VOICE_COUNT];
+    uint8_t current[TR808_VOICE_COUNT];
+    for (uint8_t voice = 0; voice < TR808_VOICE_COUNT; voice++) {
+        allNative[voice] = TR808_BACKEND_NATIVE;
+        allMozzi[voice] = tr808HasMozziVoice(voice) ? TR808_BACKEND_MOZZI : TR808_BACKEND_NATIVE;
+        current[voice] = hybridMixer.getBackend(voice);
+    }
+    uint32_t cpuHz = ESP.getCpuFreqMHz() * 1000000UL;
+    
+    Serial.println("⏱️ 하이브리드 프로파일 (" + String(HYBRID_BENCH_SAMPLES) + " 샘플, 사이클/샘플)");
+    
+    uint32_t idleNative = TR808HybridMixer::profile(allNative, 0, HYBRID_BENCH_SAMPLES, readCycleCount);
+    uint32_t idleMozzi = TR808HybridMixer::profile(allMozzi, 0, HYBRID_BENCH_SAMPLES, readCycleCount);
+    
+    uint32_t mixMask = 0;
+    for (uint8_t n = 0; n < sizeof(drums); n++) {
+        uint32_t mask = TR808_VOICE_BIT(drums[n]);
+        mixMask |= mask;
+        uint32_t nativeCycles = TR808HybridMixer::profile(allNative, mask, HYBRID_BENCH_SAMPLES, readCycleCount);
+        uint32_t mozziCycles = TR808HybridMixer::profile(allMozzi, mask, HYBRID_BENCH_SAMPLES, readCycleCount);
+        Serial.printf("  %-14s 네이티브 %5ld  Mozzi %5ld  [%s]\n", VOICE_NAMES[drums[n]],
+                      (long)nativeCycles - (long)idleNative, (long)mozziCycles - (long)idleMozzi,
+                      current[drums[n]] == TR808_BACKEND_MOZZI ? "Mozzi" : "네이티브");
+    }
+    
+    uint32_t nativeMix = TR808HybridMixer::profile(allNative, mixMask, HYBRID_BENCH_SAMPLES, readCycleCount);
+    uint32_t hybridMix = TR808HybridMixer::profile(current, mixMask, HYBRID_BENCH_SAMPLES, readCycleCount);
+    uint32_t rate = drumMachine.getSampleRate();
+    Serial.printf("  4보이스 전체 네이티브: %5lu 사이클/샘플  CPU %5.1f%%\n", (unsigned long)nativeMix,
+                  (float)nativeMix * rate * 100.0f / cpuHz);
+    Serial.printf("  4보이스 현재 구성:     %5lu 사이클/샘플  CPU %5.1f%%  (절감 %.1f%%)\n", (unsigned long)hybridMix,
+                  (float)hybridMix * rate * 100.0f / cpuHz,
+                  nativeMix > 0 ? 100.0f * ((float)nativeMix - hybridMix) / nativeMix : 0.0f);
+}
+#endif
+
 // ============================================
 // 자동 저장 처리
 // ============================================
 
 void handleAutoSave(unsigned long currentTime) {
     static unsigned long lastSave = 0;
-    static String lastState = "";
     
-    String currentState = getCurrentState();
+    if (!patternStore.isMounted()) return;
     
-    if (currentState != lastState && currentTime - lastSave > AUTO_SAVE_INTERVAL) {
-        saveStateToEEPROM(currentState);
+    // 바이너리 비교로 변경 감지 (String 할당 없음)
+    if (memcmp(&kitSettings, &savedKitSettings, sizeof(KitSettings)) != 0 &&
+        currentTime - lastSave > AUTO_SAVE_INTERVAL) {
+        saveKitSettings();
         lastSave = currentTime;
-        lastState = currentState;
     }
 }
 
-String getCurrentState() {
-    // 현재 설정 상태를 JSON으로 반환
-    return "{}"; // TODO: 실제 구현
-}
-
-void saveStateToEEPROM(const String& state) {
-    // EEPROM에 상태 저장
-    Serial.println("💾 설정 자동 저장됨");
+void saveKitSettings() {
+    // 대기열에 복사만 하고 즉시 반환 - 실제 플래시 기록은 쓰기 태스크에서 수행
+    // (섹터를 새로 써야 하는 저장은 트랜스포트가 멈추고 소리가 끝날 때까지 대기)
+    if (patternStore.queueWrite(TR808_RECORD_KIT, 0, &kitSettings, sizeof(kitSettings))) {
+        savedKitSettings = kitSettings;
+        Serial.println("💾 설정 자동 저장됨");
+    }
 }
 
 // ============================================
@@ -557,6 +1543,80 @@ void printSystemInfo() {
     Serial.println("");
 }
 
+/**
+ * 시작 아레나 보고 (memory 명령)
+ * 소비자별 오프셋/크기, 봉인 후 할당 시도 수, 봉인 시점 대비 여유 힙 변화
+ */
+void printMemoryReport() {
+    Serial.printf("🧱 시작 아레나: %lu/%lu 바이트 (예산 상한 %lu)\n",
+                  (unsigned long)engineArena.getUsed(), (unsigned long)engineArena.getCapacity(),
+                  (unsigned long)TR808_ARENA_LIMIT_BYTES);
+    for (uint8_t i = 0; i < engineArena.getConsumerCount(); i++) {
+        const TR808ArenaConsumer& consumer = engineArena.getConsumer(i);
+        Serial.printf("  %-16s @%5lu  %6lu 바이트\n", consumer.name,
+                      (unsigned long)consumer.offset, (unsigned long)consumer.bytes);
+    }
+    Serial.printf("  봉인: %s, 실패한 할당 %u\n",
+                  engineArena.isSealed() ? "예" : "아니오", (unsigned)engineArena.getFailures());
+    Serial.printf("  여유 힙: 봉인 시 %lu -> 현재 %lu 바이트 (최저 %lu)\n",
+                  (unsigned long)sealedFreeHeap, (unsigned long)ESP.getFreeHeap(),
+                  (unsigned long)ESP.getMinFreeHeap());
+}
+
+// ============================================
+// 트레이스 (trace 명령, -DTR808_TRACE 빌드)
+// ============================================
+
+#ifdef TR808_TRACE
+void writeTraceToSerial(const uint8_t* data, size_t length) {
+    Serial.write(data, length);
+}
+#endif
+
+/**
+ * trace                    기록 상태 출력
+ * trace on|off|clear       기록 시작/정지/비우기
+ * trace arm                다음 I2S 언더런에서 자동 정지 (직전 이력 보존)
+ * trace mark               표식 이벤트 기록
+ * trace dump               바이너리 덤프 (호스트: extras/host/trace_to_json.cpp)
+ * 덤프 중에는 렌더 루프가 멈추므로 출력이 끊김: 캡처 후 분석용
+ */
+void handleTraceCommand(const TR808CommandTokens& tokens) {
+#ifdef TR808_TRACE
+    if (tokens.size() > 1) {
+        // 해시 switch 전에 실제 하위 명령인지 확인 (해시 충돌 토큰 거부)
+        uint32_t command = tokens.matches(1, "on", "off", "clear", "arm", "mark", "dump")
+                               ? tr808HashToken(tokens.get(1), tokens.length(1)) : 0;
+        switch (command) {
+            case TR808_CMD("on"):    tr808Trace.setEnabled(true); break;
+            case TR808_CMD("off"):   tr808Trace.setEnabled(false); break;
+            case TR808_CMD("clear"): tr808Trace.clear(); break;
+            case TR808_CMD("arm"):   tr808Trace.clear(); tr808Trace.setEnabled(true); tr808Trace.armFreeze(true); break;
+            case TR808_CMD("mark"):  TR808_TRACE_EVENT(TR808_TRACE_MARK, 0); break;
+            case TR808_CMD("dump"): {
+                Serial.flush();
+                size_t size = tr808Trace.dump(writeTraceToSerial);
+                Serial.flush();
+                Serial.printf("\n🧵 트레이스 덤프 완료: %u 바이트\n", (unsigned)size);
+                return;
+            }
+            default:
+                Serial.println("❌ trace on|off|clear|arm|mark|dump");
+                return;
+        }
+    }
+    
+    Serial.printf("🧵 트레이스: %s%s, 레코드 %lu/%u (덮어씀 %lu)\n",
+                  tr808Trace.isEnabled() ? "기록 중" : "정지",
+                  tr808Trace.isArmed() ? " (언더런 시 정지)" : "",
+                  (unsigned long)tr808Trace.getCount(), (unsigned)TR808_TRACE_RECORDS,
+                  (unsigned long)tr808Trace.getLost());
+#else
+    (void)tokens;
+    Serial.println("🧵 트레이스 비활성: -DTR808_TRACE 빌드 필요 (pio run -e trace)");
+#endif
+}
+
 void printInstructions() {
     Serial.println("📖 사용법:");
     Serial.println("");
@@ -571,6 +1631,14 @@ void printInstructions() {
     Serial.println("");
     Serial.println("🔧 시스템 제어:");
     Serial.println("  master 0.7  (마스터 볼륨)");
+    Serial.println("  rate 44100  (샘플 레이트, 블록 경계에서 전환)");
+    Serial.println("  ctrl 16     (컨트롤 레이트 간격, 샘플)");
+    Serial.println("  bench       (컨트롤 레이트 벤치마크, bench wcet: 렌더 최악 실행 시간, bench square: 구형파)");
+    Serial.println("  trace       (이벤트 트레이스: trace arm, trace dump)");
+    Serial.println("  memory      (시작 아레나 소비자별 사용량)");
+#ifdef TR808_HYBRID_ENGINE
+    Serial.println("  engine      (드럼별 백엔드: engine hihat mozzi, engine bench)");
+#endif
     Serial.println("  status      (현재 상태)");
     Serial.println("  config      (설정 정보)");
     Serial.println("  perf        (성능 정보)");
@@ -603,14 +1671,32 @@ void printStatus() {
     Serial.println("📊 현재 상태:");
     Serial.println("");
     Serial.println("🎵 오디오:");
-    Serial.println("  샘플 레이트: " + String(SAMPLE_RATE) + " Hz");
+    Serial.println("  샘플 레이트: " + String(drumMachine.getSampleRate()) + " Hz");
     Serial.println("  마스터 볼륨: " + String(MASTER_VOLUME));
     Serial.println("  I2S 상태: 정상");
+#ifdef TR808_HYBRID_ENGINE
+    Serial.println("  하이브리드: Mozzi 보이스 " + String(hybridMixer.getMozziVoiceCount()) + "개 ('engine'으로 확인)");
+#endif
     Serial.println("");
     Serial.println("💻 시스템:");
     Serial.println("  RAM 사용: " + String(ESP.getFreeHeap()) + " bytes");
-    Serial.println("  CPU 사용률: " + String(cpuUsage, 1) + "%");
+    // 블록 렌더 사이클 / 블록 마감 (100% 초과 = 언더런 위험)
+    Serial.printf("  CPU 부하: 현재 %.1f%% / 평균 %.1f%% / 피크 %.1f%%\n",
+                  audioLoad.getLoad() / 10.0f, audioLoad.getAverage() / 10.0f, audioLoad.getPeak() / 10.0f);
+    Serial.printf("  최대 부하: %.1f%% (마감 초과 %lu블록, 샘플당 %lu 사이클)\n",
+                  audioLoad.getMax() / 10.0f, (unsigned long)audioLoad.getOverruns(),
+                  (unsigned long)audioLoad.getSampleCycles());
+    Serial.printf("  저장소: 기록 %lu, 소거 %lu, 미룬 소거 %lu, 대기 %s\n",
+                  (unsigned long)patternStore.getStats().recordsWritten,
+                  (unsigned long)patternStore.getStats().sectorsErased,
+                  (unsigned long)patternStore.getStats().erasesDeferred,
+                  patternStore.hasPendingWrites() ? "있음" : "없음");
+    Serial.printf("  로그: 출력 %lu, 대기 %lu, 유실 %lu\n",
+                  (unsigned long)tr808Log.getWritten(), (unsigned long)tr808Log.getPending(),
+                  (unsigned long)tr808Log.getDropped());
     Serial.println("  실행시간: " + String(millis() / 1000) + "초");
+    Serial.print("  ");
+    printBootTime();
     Serial.println("");
     Serial.println("🔧 설정:");
     Serial.println("  시퀀서: " + String(ENABLE_SEQUENCER ? "활성화" : "비활성화"));
@@ -623,7 +1709,7 @@ void printConfig() {
     Serial.println("⚙️ 현재 설정:");
     Serial.println("");
     Serial.println("🎵 오디오 설정:");
-    Serial.println("  SAMPLE_RATE: " + String(SAMPLE_RATE));
+    Serial.println("  TR808_SAMPLE_RATE: " + String(TR808_SAMPLE_RATE) + " (현재 " + String(drumMachine.getSampleRate()) + ")");
     Serial.println("  BUFFER_SIZE: " + String(BUFFER_SIZE));
     Serial.println("  MONO_OUTPUT: " + String(MONO_OUTPUT ? "true" : "false"));
     Serial.println("  MASTER_VOLUME: " + String(MASTER_VOLUME));
@@ -647,12 +1733,12 @@ void printPerformance() {
     Serial.println("⚡ 성능 정보:");
     Serial.println("");
     Serial.println("📊 샘플링:");
-    Serial.println("  목표 레이트: " + String(SAMPLE_RATE) + " Hz");
-    Serial.println("  실제 레이트: ~" + String(SAMPLE_RATE) + " Hz");
+    Serial.println("  목표 레이트: " + String(drumMachine.getSampleRate()) + " Hz");
+    Serial.println("  실제 레이트: ~" + String(drumMachine.getSampleRate()) + " Hz");
     Serial.println("  버퍼 크기: " + String(BUFFER_SIZE) + " 샘플");
     Serial.println("");
     Serial.println("💻 시스템:");
-    Serial.println("  CPU 사용률: " + String(cpuUsage, 1) + "%");
+    Serial.println("  CPU 부하 (평균): " + String(cpuUsage, 1) + "%");
     Serial.println("  메모리: " + String(ESP.getFreeHeap()) + "/" + String(ESP.getHeapSize()) + " bytes");
     Serial.println("  실행시간: " + String(millis() / 1000) + "초");
     Serial.println("  총 샘플 수: " + String(sampleCount));
@@ -661,15 +1747,20 @@ void printPerformance() {
     Serial.println("  동시 음향 제한: " + String(POLYPHONY_LIMIT));
     Serial.println("  마스터 볼륨: " + String(MASTER_VOLUME));
     Serial.println("");
+    tr808Perf.printReport();
+    Serial.println("");
 }
 
 void resetSystem() {
     Serial.println("🔄 시스템 리셋 중...");
     
-    // I2S 재초기화
+    // I2S 재초기화 (rate 명령으로 바뀐 현재 엔진 레이트 유지)
     I2S.end();
     delay(100);
-    initializeI2SAudio();
+    i2sStopped = !beginI2S(drumMachine.getSampleRate());
+    if (i2sStopped) {
+        Serial.println("  ❌ I2S.begin() 실패");
+    }
     
     // TR808 재초기화
     initializeTR808();
@@ -677,6 +1768,8 @@ void resetSystem() {
     // 성능 카운터 리셋
     sampleCount = 0;
     lastPerfCheck = millis();
+    tr808Perf.reset();
+    audioLoad.reset();
     
     Serial.println("✅ 시스템 리셋 완료!");
 }
@@ -721,6 +1814,8 @@ void showHardwareInstructions() {
 // ============================================
 
 // Arduino IDE에서 라이브러리로 인식하기 위한 함수들
+// (하이브리드 빌드는 실제 Mozzi 라이브러리가 링크되므로 제외)
+#ifndef TR808_HYBRID_ENGINE
 void startMozzi() {
     // Mozzi 호환성 함수 (빈 구현)
 }
@@ -728,6 +1823,7 @@ void startMozzi() {
 void stopMozzi() {
     // Mozzi 정지 함수 (빈 구현)
 }
+#endif
 
 // ============================================
 // End of File
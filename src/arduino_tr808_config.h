@@ -14,6 +14,7 @@
 #define ARDUINO_TR808_CONFIG_H
 
 #include <Arduino.h>
+#include "tr808_sample_rate.h"
 
 // ============================================
 // 버전 및 메타 정보
@@ -49,8 +50,13 @@
 #define I2S_MCK_PIN    0   // Master Clock (선택사항) - GPIO 0
 
 // 오디오 품질 설정
-#define DEFAULT_SAMPLE_RATE    32768   // 32.768kHz (ESP32C3 권장)
-#define MAX_SAMPLE_RATE        32768   // 최대 샘플링 레이트
+// I2S 부팅 레이트: 기본은 엔진 레이트, DAC/코덱 클럭이 고정된 보드는 -DI2S_SAMPLE_RATE로 지정
+// (엔진 레이트와 다르면 스케치의 static_assert가 빌드를 막음)
+#ifndef I2S_SAMPLE_RATE
+#define I2S_SAMPLE_RATE        TR808_SAMPLE_RATE   // tr808_sample_rate.h (빌드 플래그 SAMPLE_RATE)
+#endif
+#define DEFAULT_SAMPLE_RATE    I2S_SAMPLE_RATE
+#define MAX_SAMPLE_RATE        TR808_SAMPLE_RATE_MAX   // 엔진 계수 범위와 같음 (Mozzi 64kHz 구성 포함)
 #define MIN_SAMPLE_RATE        16000   // 최소 샘플링 레이트
 #define I2S_BITS_PER_SAMPLE    16      // 16-bit 오디오
 #define I2S_CHANNELS          1       // 모노 출력 (메모리 절약)
@@ -187,6 +193,8 @@
 #define SERIAL_BAUDRATE         115200 // Serial 통신 속도
 #define SERIAL_TIMEOUT          1000   // Serial 타임아웃 (ms)
 #define COMMAND_BUFFER_SIZE     64     // 명령어 버퍼 크기
+#define SERIAL_RX_RING_SIZE     1024   // UART RX 링버퍼 (바이너리 프레임 버스트 수용)
+#define SERIAL_RX_CHUNK_SIZE    64     // loop()당 한 번에 읽는 바이트 수
 
 // 자동 저장 설정
 #define ENABLE_AUTO_SAVE        false  // 자동 저장 기능
@@ -201,6 +209,14 @@
 #define ENABLE_MIDI             false  // MIDI 지원 (기본 비활성화)
 #define MIDI_BAUDRATE           31250  // MIDI 통신 속도
 #define MIDI_CHANNEL            10     // GM 드럼 채널 (10)
+#define MIDI_RX_PIN             20     // MIDI IN (UART1 RX) - GPIO 20
+#define MIDI_TX_PIN             21     // MIDI OUT (UART1 TX) - GPIO 21
+#define MIDI_EVENT_LATENCY      AUDIO_BUFFER_SIZE  // 이벤트 재생 고정 지연 (샘플, 블록 1개)
+#define MIDI_CLOCK_SLAVE        false  // true: 외부 MIDI 클럭에 동기, false: 내부 템포 (마스터)
+#define MIDI_CLOCK_OUTPUT       true   // 마스터 모드에서 MIDI OUT으로 클럭/트랜스포트 전송
+// 렌더 -> DAC 지연 (샘플): 클럭 바이트를 틱 샘플이 실제로 재생될 때 전송
+// I2S 라이브러리 링 버퍼 + DMA 깊이, 스코프로 틱 소리와 0xF8 시작 비트를 비교해 보정
+#define MIDI_CLOCK_OUT_LATENCY  (2 * AUDIO_BUFFER_SIZE)
 
 // MIDI 노트 매핑
 #define MIDI_KICK_NOTE          36     // Kick Drum
@@ -271,6 +287,7 @@
 // 컴파일 타임 설정 검증
 static_assert(DEFAULT_SAMPLE_RATE >= MIN_SAMPLE_RATE && DEFAULT_SAMPLE_RATE <= MAX_SAMPLE_RATE, 
                "샘플레이트 설정 오류");
+static_assert(MIN_SAMPLE_RATE >= TR808_SAMPLE_RATE_MIN, "rate 명령 하한이 엔진 레이트 범위 밖");
 static_assert(I2S_BUFFER_SIZE >= MIN_BUFFER_SIZE && I2S_BUFFER_SIZE <= MAX_BUFFER_SIZE, 
                "버퍼 크기 설정 오류");
 static_assert(DEFAULT_MASTER_VOLUME >= MIN_VOLUME && DEFAULT_MASTER_VOLUME <= MAX_VOLUME, 
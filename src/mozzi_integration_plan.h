@@ -252,6 +252,7 @@ public:
 /**
  * 드럼 음성 풀 매니저
  * 제한된 자원으로 최대 성능 제공
+ * 음성 슬롯은 시작 아레나(tr808_arena.h)에서 한 번 할당, 할당/해제는 사용 표시만 바꿈
  */
 class DrumVoicePool {
 private:
@@ -273,6 +274,7 @@ public:
 /**
  * 버퍼 풀 매니저
  * 오디오 버퍼 재사용으로 메모리 절약
+ * 버퍼는 시작 아레나에서 예산 표 순서대로 할당 (힙 사용 없음, extras/buffer_manager_esp32c3.cpp 메모리 풀과 같은 방식)
  */
 class AudioBufferPool {
 private:
@@ -292,43 +294,8 @@ public:
 // 성능 모니터링 클래스
 // =============================================================================
 
-/**
- * Mozzi 전용 성능 메트릭
- */
-struct MozziPerformanceMetrics {
-    float audioCpuUsage;      // 오디오 처리 CPU 사용률
-    float controlCpuUsage;    // 컨트롤 처리 CPU 사용률
-    uint32_t bufferUnderruns; // 버퍼 언더런 발생 횟수
-    uint32_t activeVoices;    // 활성 음성 수
-    uint32_t maxVoices;       // 최대 동시 음성 수
-    float envelopeLatency;    // 엔벨롭 지연 시간 (μs)
-    float filterLatency;      // 필터 지연 시간 (μs)
-    uint32_t memoryUsage;     // 메모리 사용량 (바이트)
-};
-
-/**
- * 성능 모니터링 관리자
- */
-class PerformanceMonitor {
-private:
-    MozziPerformanceMetrics metrics;
-    uint32_t lastUpdateTime;
-    uint32_t sampleCount;
-    uint32_t controlCount;
-    
-public:
-    PerformanceMonitor();
-    void startAudioSample();
-    void endAudioSample();
-    void startControlUpdate();
-    void endControlUpdate();
-    void updateBufferUnderrun();
-    void updateVoiceCount(uint32_t count);
-    void calculateMetrics();
-    MozziPerformanceMetrics getMetrics();
-    void printReport();
-    void reset();
-};
+// MozziPerformanceMetrics / PerformanceMonitor: 스테이지별 사이클 집계 구현
+#include "tr808_perf_monitor.h"
 
 // =============================================================================
 // 통합 관리자 클래스
@@ -11,16 +11,19 @@
 #ifndef MOZZI_TR808_CONFIG_H
 #define MOZZI_TR808_CONFIG_H
 
-#include "mozzi_config.h"
 #include "arduino_tr808_config.h"
 #include <Arduino.h>
+#include "mozzi_tr808_drums.h"
+#include "tr808_sample_rate.h"
 
 // =============================================================================
 // Mozzi Library 기본 설정 (AudioOutput_AUDIOINTERFACE)
 // =============================================================================
 
-// AudioRate: 32.768kHz (ESP32C3 권장, 최고 품질)
-#define MOZZI_AUDIO_RATE 32768
+// AudioRate: 엔진 공용 레이트 (tr808_sample_rate.h, 기본 32.768kHz)
+#ifndef MOZZI_AUDIO_RATE
+#define MOZZI_AUDIO_RATE TR808_SAMPLE_RATE
+#endif
 
 // Control Rate: 128 (실시간 드럼 트리거에 최적화)
 #define MOZZI_CONTROL_RATE 128
@@ -38,8 +41,8 @@
 // TimerInterrupt 라이브러리 설정
 #define TIMER_NUMBER 0               // Timer 0 사용
 #define TIMER_INTERRUPT_CH 0         // 채널 0
-#define TIMER_FREQUENCY 32768        // 32.768kHz
-#define TIMER_PERIOD 30              // 30.5μs 주기
+#define TIMER_FREQUENCY MOZZI_AUDIO_RATE                 // 오디오 레이트와 동일
+#define TIMER_PERIOD (1000000UL / TIMER_FREQUENCY)      // 30μs @ 32.768kHz
 #define TIMER_RESOLUTION 1000000     // 마이크로초 단위
 
 // 인터럽트 우선순위 (최고 우선순위)
@@ -116,6 +119,12 @@ enum TR808DrumSource {
 // 원형 버퍼 크기
 #define MOZZI_CIRCULAR_BUFFER_SIZE 128
 
+// 보이스 풀 렌더 블록 크기 (오디오 콜백은 블록에서 한 샘플씩 꺼냄)
+#define MOZZI_RENDER_BLOCK_SIZE 32
+
+// 처리량 벤치마크 블록 수 (보이스가 끝나기 전에 측정 완료)
+#define MOZZI_BENCHMARK_BLOCKS 16
+
 // =============================================================================
 // 실시간 패턴 설정
 // =============================================================================
@@ -303,14 +312,19 @@ private:
     uint32_t patternStep;
     uint32_t patternTempo;
     
-    // 드럼 소스
-    void* drumSources[TR808_NUM_SOURCES];
+    // 드럼 보이스 풀 (mozzi_tr808_drums.h)
+    TR808VoicePoolMozzi voices;
+    
+    // 블록 렌더 버퍼
+    int16_t audioBlock[MOZZI_RENDER_BLOCK_SIZE];
+    uint16_t blockPosition;
     
     // 내부 함수들
     bool initializeDrumSources();
     void updatePerformanceMetrics();
     void processDrumSource(uint8_t source, float velocity);
     void loadDefaultPatterns();
+    void renderNextBlock();
     
 public:
     TR808DrumMachineMozzi();
@@ -322,7 +336,7 @@ public:
     
     // 드럼 제어
     void triggerDrum(uint8_t drumType, float velocity = 1.0f);
-    void triggerDrum(const String& drumName, float velocity = 1.0f);
+    void triggerDrum(const char* drumName, float velocity = 1.0f);
     void setMasterVolume(float volume);
     
     // 패턴 제어
@@ -344,12 +358,15 @@ public:
     void printPatternList();
     void printDrumList();
     
-    // Serial 명령 처리
-    bool processSerialCommand(const String& command);
+    // Serial 명령 처리 (버퍼를 제자리에서 토큰화, 힙 할당 없음)
+    bool processSerialCommand(char* commandLine);
+    
+    // 보이스 수별 처리량 측정 (32768Hz / 64000Hz에서 수용 가능한 보이스 수)
+    void runThroughputBenchmark();
     
     // Mozzi 통합 함수
     void updateControl();
-    void updateAudio();
+    int16_t updateAudio();
 };
 
 // =============================================================================
@@ -401,6 +418,12 @@ extern TR808DrumMachineMozzi tr808Mozzi;
 #error "Audio rate too high for ESP32C3. Maximum recommended is 32768Hz"
 #endif
 
+// 출력 드라이버(타이머/Mozzi)와 보이스 계수가 같은 레이트를 쓰는지 검증
+static_assert(MOZZI_AUDIO_RATE == TR808_SAMPLE_RATE,
+              "MOZZI_AUDIO_RATE와 SAMPLE_RATE 빌드 플래그가 다름");
+static_assert(MOZZI_TR808_AUDIO_RATE == MOZZI_AUDIO_RATE,
+              "보이스 Oscil 레이트와 Mozzi 출력 레이트가 다름");
+
 #if MOZZI_CONTROL_RATE > 256
 #error "Control rate too high. Maximum recommended is 256Hz"
 #endif
@@ -2,7 +2,7 @@
  * Mozzi 기반 TR-808 드럼 클래스 구현
  * 
  * 고성능 Mozzi Library를 완전히 활용한 TR-808 드럼 알고리즘
- * fastMath, generation, envelope 최적화, 64kHz 샘플링 레이트 지원
+ * fastMath, generation, envelope 최적화, 공용 샘플 레이트 정책(tr808_sample_rate.h) 사용
  * 
  * 작성일: 2025-10-30
  * 호환성: ESP32C3 + Mozzi Library
@@ -10,29 +10,49 @@
 
 #include "mozzi_tr808_drums.h"
 
+// 렌더 경로 테이블 주소 (mozzi_tr808_drums.h), setTableStorage() 전에는 플래시 원본
+const int8_t* tr808MozziSin2048 = SIN2048_DATA;
+const int8_t* tr808MozziSquare2048 = SQUARE2048_DATA;
+const int8_t* tr808MozziBrownNoise8192 = BROWNNOISE8192_DATA;
+
 // =============================================================================
 // TR808KickMozzi 구현
 // =============================================================================
 
+// Hz(Q16) -> 32비트 위상 증분 변환 계수 (컴파일 타임 상수)
+static constexpr uint64_t KICK_PHASE_PER_HZ = TR808RatePolicy<MOZZI_TR808_AUDIO_RATE>::phasePerHzQ16;
+
 TR808KickMozzi::TR808KickMozzi() 
     : _frequency(TR808_FREQ_C2), _decay_time(TR808_DECAY_TIME)
     , _pitch_decay(0), _current_pitch(TR808_FREQ_C2)
+    , _decay_reciprocal(0), _decay_rate(0)
     , _envelope(), _is_playing(false), _start_time(0)
-    , _note_duration(1000), _lookup_index(0) {
+    , _note_duration(1000) {
     
     // Kick envelope 설정
     _envelope.setADLevels(32768, 16384);
     _envelope.setTimes(TR808_ATTACK_TIME, 500, 200, TR808_RELEASE_TIME); // A, D, S, R
+    
+    updateDecayCoefficients();
+    _osc.setFrequencyQ16(_current_pitch, KICK_PHASE_PER_HZ);
 }
 
 TR808_FASTMATH_INLINE void TR808KickMozzi::setFrequency(float freq_hz) {
-    _frequency = Q16n16::toQ16n16(freq_hz);
+    _frequency = float_to_Q16n16(freq_hz);
     _current_pitch = _frequency;
+    _osc.setFrequencyQ16(_current_pitch, KICK_PHASE_PER_HZ);
 }
 
 TR808_FASTMATH_INLINE void TR808KickMozzi::setDecayTime(float decay_ms) {
-    _decay_time = Q16n16::toQ16n16(decay_ms);
+    _decay_time = float_to_Q16n16(decay_ms);
     _envelope.setDecayTime((int)decay_ms);
+    updateDecayCoefficients();
+}
+
+void TR808KickMozzi::updateDecayCoefficients() {
+    // 나눗셈은 파라미터 변경 시에만 (C3는 정수 나눗셈이 수십 사이클)
+    _decay_reciprocal = tr808Q16n16Div(Q16n16_FIX1, _decay_time);
+    _decay_rate = Q16n16_FIX1 - _decay_reciprocal;
 }
 
 TR808_AUDIO_INLINE void TR808KickMozzi::start() {
@@ -40,47 +60,36 @@ TR808_AUDIO_INLINE void TR808KickMozzi::start() {
     _start_time = millis();
     _current_pitch = _frequency;
     _pitch_decay = 0;
-    _envelope.start();
+    _osc.reset();
+    _osc.setFrequencyQ16(_current_pitch, KICK_PHASE_PER_HZ);
+    _envelope.noteOn();
 }
 
 TR808_AUDIO_INLINE void TR808KickMozzi::stop() {
     _is_playing = false;
-    _envelope.stop();
+    _envelope.noteOff();
 }
 
 TR808_ISR_OPTIMIZED void TR808KickMozzi::updatePitchDecay() {
-    // Pitch envelope: exponential decay
-    Q16n16 decay_rate = Q16n16(1) - Q16n16::div(Q16n16(1), _decay_time);
-    _pitch_decay = _pitch_decay * decay_rate + Q16n16(1) * Q16n16::div(1, _decay_time);
-    _current_pitch = _frequency - (_frequency * _pitch_decay);
+    // Pitch envelope: exponential decay (캐시된 계수로 곱셈만 수행)
+    _pitch_decay = Q16n16_mult(_pitch_decay, _decay_rate) + _decay_reciprocal;
+    _current_pitch = _frequency - Q16n16_mult(_frequency, _pitch_decay);
+    
+    // 피치 -> 위상 증분 (곱셈 + 시프트)
+    _osc.setFrequencyQ16(_current_pitch, KICK_PHASE_PER_HZ);
 }
 
-TR808_AUDIO_INLINE Q15n16 TR808KickMozzi::generateKickWave(Q16n16 phase) {
-    // TR-808 kick wave: sine wave with exponential decay
-    // Fast lookup table approach
-    int table_index = (int)(phase >> 8) & 0xFF;
-    Q15n16 sine_value = sin2048_int8[table_index];
-    
-    // Apply pitch modulation
-    Q15n16 pitch_modulated = (Q15n16)((int32_t)sine_value * (int32_t)_current_pitch >> 16);
-    
-    return pitch_modulated;
+TR808_AUDIO_INLINE Q15n16 TR808KickMozzi::generateKickWave() {
+    // TR-808 kick wave: 16비트 사인 테이블 선형 보간
+    // (이전: sin2048_int8의 앞 256 엔트리만 보간 없이 조회)
+    return (Q15n16)(_osc.next() >> TR808_KICK_WAVE_SHIFT);
 }
 
 TR808_AUDIO_INLINE Q15n16 TR808KickMozzi::next() {
     if (!_is_playing) return 0;
     
-    // Generate phase increment
-    Q16n16 phase_increment = _current_pitch >> 8;
-    _phase += phase_increment;
-    
-    // Wrap phase
-    if (_phase >= Q16n16(1)) {
-        _phase -= Q16n16(1);
-    }
-    
-    // Generate wave
-    Q15n16 wave = generateKickWave(_phase);
+    // Generate wave (위상 증분은 컨트롤 레이트에서 갱신)
+    Q15n16 wave = generateKickWave();
     
     // Apply envelope
     Q15n16 envelope_value = _envelope.next();
@@ -102,7 +111,7 @@ TR808_ISR_OPTIMIZED void TR808KickMozzi::update() {
 }
 
 TR808_FASTMATH_INLINE bool TR808KickMozzi::isFinished() const {
-    return !_is_playing && _envelope.isFinished();
+    return !_is_playing && !_envelope.playing();
 }
 
 // =============================================================================
@@ -110,8 +119,8 @@ TR808_FASTMATH_INLINE bool TR808KickMozzi::isFinished() const {
 // =============================================================================
 
 TR808SnareMozzi::TR808SnareMozzi()
-    : _noise_osc(BROWNNOISE8192_DATA)
-    , _tone_osc(SQUARE2048_DATA)
+    : _noise_osc(TR808_MOZZI_BROWNNOISE8192)
+    , _tone_osc(TR808_MOZZI_SQUARE2048)
     , _noise_env(), _tone_env()
     , _highpass(), _lowpass()
     , _is_playing(false), _start_time(0)
@@ -125,12 +134,12 @@ TR808SnareMozzi::TR808SnareMozzi()
     _tone_env.setTimes(5, _tone_decay, 0, 100);
     
     // Filter 설정
-    _highpass.setCutoff(2000);
-    _lowpass.setCutoff(10000);
+    _highpass.setCutoffFreq(tr808MozziCutoff(2000));
+    _lowpass.setCutoffFreq(tr808MozziCutoff(10000));
 }
 
 TR808_FASTMATH_INLINE void TR808SnareMozzi::setDecayTime(float decay_ms) {
-    _decay_time = Q16n16::toQ16n16(decay_ms);
+    _decay_time = float_to_Q16n16(decay_ms);
     _noise_env.setDecayTime((int)decay_ms);
 }
 
@@ -138,17 +147,22 @@ TR808_FASTMATH_INLINE void TR808SnareMozzi::setTone(float tone_hz) {
     _tone_osc.setFreq((int)tone_hz);
 }
 
+void TR808SnareMozzi::bindTables() {
+    _noise_osc.setTable(TR808_MOZZI_BROWNNOISE8192);
+    _tone_osc.setTable(TR808_MOZZI_SQUARE2048);
+}
+
 TR808_AUDIO_INLINE void TR808SnareMozzi::start() {
     _is_playing = true;
     _start_time = millis();
-    _noise_env.start();
-    _tone_env.start();
+    _noise_env.noteOn();
+    _tone_env.noteOn();
 }
 
 TR808_AUDIO_INLINE void TR808SnareMozzi::stop() {
     _is_playing = false;
-    _noise_env.stop();
-    _tone_env.stop();
+    _noise_env.noteOff();
+    _tone_env.noteOff();
 }
 
 TR808_AUDIO_INLINE Q15n16 TR808SnareMozzi::next() {
@@ -171,8 +185,9 @@ TR808_AUDIO_INLINE Q15n16 TR808SnareMozzi::next() {
     Q15n16 noise_env = _noise_env.next();
     Q15n16 tone_env = _tone_env.next();
     
-    // Combine with envelopes
-    Q15n16 output = ((noise * noise_env) + (tone * tone_env)) >> 1;
+    // Combine with envelopes (Q15 엔벨롭 곱 -> int8 << TR808_SNARE_LEVEL_SHIFT)
+    Q15n16 output = (((noise * noise_env) >> (15 - TR808_SNARE_LEVEL_SHIFT)) +
+                     ((tone * tone_env) >> (15 - TR808_SNARE_LEVEL_SHIFT))) >> 1;
     
     // Check if finished
     if (noise_env == 0 && tone_env == 0) {
@@ -186,13 +201,11 @@ TR808_ISR_OPTIMIZED void TR808SnareMozzi::update() {
     if (_is_playing) {
         _noise_env.update();
         _tone_env.update();
-        _highpass.update();
-        _lowpass.update();
     }
 }
 
 TR808_FASTMATH_INLINE bool TR808SnareMozzi::isFinished() const {
-    return !_is_playing && _noise_env.isFinished() && _tone_env.isFinished();
+    return !_is_playing && !_noise_env.playing() && !_tone_env.playing();
 }
 
 // =============================================================================
@@ -200,12 +213,12 @@ TR808_FASTMATH_INLINE bool TR808SnareMozzi::isFinished() const {
 // =============================================================================
 
 TR808CymbalMozzi::TR808CymbalMozzi()
-    : _osc1(SIN2048_DATA), _osc2(SIN2048_DATA), _osc3(SIN2048_DATA)
-    , _noise(BROWNNOISE8192_DATA)
+    : _osc1(TR808_MOZZI_SIN2048), _osc2(TR808_MOZZI_SIN2048), _osc3(TR808_MOZZI_SIN2048)
+    , _noise(TR808_MOZZI_BROWNNOISE8192)
     , _bandpass1(), _bandpass2(), _bandpass3()
     , _envelope()
-    , _is_playing(false), _decay_time(2000), _resonance(0.5f)
-    , _fm_phase(0), _fm_frequency(100), _fm_depth(0.1f) {
+    , _is_playing(false), _decay_time(2000), _resonance(float_to_Q16n16(0.5f))
+    , _fm_phase(0), _fm_frequency(100), _fm_depth(float_to_Q16n16(0.1f)) {
     
     // Oscillator frequencies (harmonic series)
     _osc1.setFreq(800);    // Fundamental
@@ -213,49 +226,56 @@ TR808CymbalMozzi::TR808CymbalMozzi()
     _osc3.setFreq(2400);   // 3rd harmonic
     
     // Band-pass filters for metallic sound
-    _bandpass1.setCutoffFreq(800);
-    _bandpass1.setResonance(TR808_BRIDGED_T_RESONANCE);
+    _bandpass1.setCutoffFreq(tr808MozziCutoff(800));
+    _bandpass1.setResonance(tr808MozziResonance(TR808_BRIDGED_T_RESONANCE));
     
-    _bandpass2.setCutoffFreq(1600);
-    _bandpass2.setResonance(TR808_BRIDGED_T_RESONANCE);
+    _bandpass2.setCutoffFreq(tr808MozziCutoff(1600));
+    _bandpass2.setResonance(tr808MozziResonance(TR808_BRIDGED_T_RESONANCE));
     
-    _bandpass3.setCutoffFreq(2400);
-    _bandpass3.setResonance(TR808_BRIDGED_T_RESONANCE);
+    _bandpass3.setCutoffFreq(tr808MozziCutoff(2400));
+    _bandpass3.setResonance(tr808MozziResonance(TR808_BRIDGED_T_RESONANCE));
     
     // Envelope
     _envelope.setADLevels(32768, 0);
     _envelope.setTimes(50, 1000, 0, 200);
     
     // FM settings
-    _fm_frequency = Q16n16::toQ16n16(100);
-    _fm_depth = Q16n16::toQ16n16(0.1f);
+    _fm_frequency = float_to_Q16n16(100);
+    _fm_depth = float_to_Q16n16(0.1f);
 }
 
 TR808_FASTMATH_INLINE void TR808CymbalMozzi::setDecayTime(float decay_ms) {
-    _decay_time = Q16n16::toQ16n16(decay_ms);
+    _decay_time = float_to_Q16n16(decay_ms);
     _envelope.setDecayTime((int)decay_ms);
 }
 
 TR808_FASTMATH_INLINE void TR808CymbalMozzi::setResonance(float resonance) {
-    _resonance = resonance;
-    _bandpass1.setResonance(resonance);
-    _bandpass2.setResonance(resonance);
-    _bandpass3.setResonance(resonance);
+    _resonance = float_to_Q16n16(resonance);
+    _bandpass1.setResonance(tr808MozziResonance(resonance));
+    _bandpass2.setResonance(tr808MozziResonance(resonance));
+    _bandpass3.setResonance(tr808MozziResonance(resonance));
 }
 
 TR808_FASTMATH_INLINE void TR808CymbalMozzi::setFMDepth(float depth) {
-    _fm_depth = Q16n16::toQ16n16(depth);
+    _fm_depth = float_to_Q16n16(depth);
+}
+
+void TR808CymbalMozzi::bindTables() {
+    _osc1.setTable(TR808_MOZZI_SIN2048);
+    _osc2.setTable(TR808_MOZZI_SIN2048);
+    _osc3.setTable(TR808_MOZZI_SIN2048);
+    _noise.setTable(TR808_MOZZI_BROWNNOISE8192);
 }
 
 TR808_AUDIO_INLINE void TR808CymbalMozzi::start() {
     _is_playing = true;
-    _envelope.start();
+    _envelope.noteOn();
     _fm_phase = 0;
 }
 
 TR808_AUDIO_INLINE void TR808CymbalMozzi::stop() {
     _is_playing = false;
-    _envelope.stop();
+    _envelope.noteOff();
 }
 
 TR808_AUDIO_INLINE Q15n16 TR808CymbalMozzi::next() {
@@ -263,11 +283,11 @@ TR808_AUDIO_INLINE Q15n16 TR808CymbalMozzi::next() {
     
     // Generate FM modulation
     _fm_phase += _fm_frequency >> 8;
-    if (_fm_phase >= Q16n16(1)) {
-        _fm_phase -= Q16n16(1);
+    if (_fm_phase >= Q16n16_FIX1) {
+        _fm_phase -= Q16n16_FIX1;
     }
     
-    Q15n16 fm_value = sin2048_int8[(int)(_fm_phase >> 8) & 0xFF];
+    Q15n16 fm_value = TR808_MOZZI_SIN2048[(int)(_fm_phase >> 8) & 0xFF];
     Q16n16 fm_modulation = _fm_depth * fm_value;
     
     // Generate oscillator components with FM
@@ -304,14 +324,11 @@ TR808_AUDIO_INLINE Q15n16 TR808CymbalMozzi::next() {
 TR808_ISR_OPTIMIZED void TR808CymbalMozzi::update() {
     if (_is_playing) {
         _envelope.update();
-        _bandpass1.update();
-        _bandpass2.update();
-        _bandpass3.update();
     }
 }
 
 TR808_FASTMATH_INLINE bool TR808CymbalMozzi::isFinished() const {
-    return !_is_playing && _envelope.isFinished();
+    return !_is_playing && !_envelope.playing();
 }
 
 // =============================================================================
@@ -319,35 +336,34 @@ TR808_FASTMATH_INLINE bool TR808CymbalMozzi::isFinished() const {
 // =============================================================================
 
 TR808HihatMozzi::TR808HihatMozzi()
-    : _noise(BROWNNOISE8192_DATA)
-    , _hp1(), _hp2(), _lp()
+    : _noise_state(TR808_HIHAT_NOISE_SEED)
+    , _hp1(), _hp2()
     , _envelope()
     , _is_playing(false), _decay_time(200)
-    , _cutoff_freq(8000), _attack_coeff(0), _decay_coeff(0) {
+    , _cutoff_freq(6000), _attack_coeff(0), _decay_coeff(0) {
     
     // Filter setup for bright hi-hat sound
-    _hp1.setCutoff(6000);
-    _hp2.setCutoff(10000);
-    _lp.setCutoff(12000);
+    _hp1.setCutoffFreq(tr808MozziCutoff(6000));
+    _hp2.setCutoffFreq(tr808MozziCutoff(6000));
     
     // Envelope (fast attack, short decay)
     _envelope.setADLevels(32768, 0);
     _envelope.setTimes(10, 200, 0, 50);
     
     // Calculate envelope coefficients
-    _attack_coeff = Q16n16::toQ16n16(0.1f);
-    _decay_coeff = Q16n16::toQ16n16(0.95f);
+    _attack_coeff = float_to_Q16n16(0.1f);
+    _decay_coeff = float_to_Q16n16(0.95f);
 }
 
 TR808_FASTMATH_INLINE void TR808HihatMozzi::setDecayTime(float decay_ms) {
-    _decay_time = Q16n16::toQ16n16(decay_ms);
+    _decay_time = float_to_Q16n16(decay_ms);
     _envelope.setDecayTime((int)decay_ms);
 }
 
 TR808_FASTMATH_INLINE void TR808HihatMozzi::setCutoff(float cutoff_hz) {
-    _cutoff_freq = Q16n16::toQ16n16(cutoff_hz);
-    _hp1.setCutoff(cutoff_hz);
-    _hp2.setCutoff(cutoff_hz * 1.5f);
+    _cutoff_freq = float_to_Q16n16(cutoff_hz);
+    _hp1.setCutoffFreq(tr808MozziCutoff(cutoff_hz));
+    _hp2.setCutoffFreq(tr808MozziCutoff(cutoff_hz));
 }
 
 TR808_FASTMATH_INLINE void TR808HihatMozzi::setOpen(bool open) {
@@ -359,27 +375,31 @@ TR808_FASTMATH_INLINE void TR808HihatMozzi::setOpen(bool open) {
 }
 
 TR808_AUDIO_INLINE void TR808HihatMozzi::start() {
+    // 같은 잡음 열로 시작: 히트마다 레벨이 같음 (벨로시티만 음량 결정)
+    _noise_state = TR808_HIHAT_NOISE_SEED;
     _is_playing = true;
-    _envelope.start();
+    _envelope.noteOn();
 }
 
 TR808_AUDIO_INLINE void TR808HihatMozzi::stop() {
     _is_playing = false;
-    _envelope.stop();
+    _envelope.noteOff();
 }
 
 TR808_AUDIO_INLINE Q15n16 TR808HihatMozzi::next() {
     if (!_is_playing) return 0;
     
-    // Generate high-frequency noise
-    Q15n16 noise = _noise.next();
+    // 백색 잡음 (xorshift32 상위 8비트 = int8 범위) << TR808_HIHAT_LEVEL_SHIFT
+    _noise_state ^= _noise_state << 13;
+    _noise_state ^= _noise_state >> 17;
+    _noise_state ^= _noise_state << 5;
+    Q15n16 noise = (Q15n16)(int8_t)(_noise_state >> 24) << TR808_HIHAT_LEVEL_SHIFT;
     
     // Apply multiple filters for brightness
     noise = _hp1.next(noise);
     noise = _hp2.next(noise);
-    noise = _lp.next(noise);
     
-    // Apply fast envelope
+    // Apply fast envelope (Q15)
     Q15n16 envelope_value = _envelope.next();
     Q15n16 output = (noise * envelope_value) >> 15;
     
@@ -394,14 +414,11 @@ TR808_AUDIO_INLINE Q15n16 TR808HihatMozzi::next() {
 TR808_ISR_OPTIMIZED void TR808HihatMozzi::update() {
     if (_is_playing) {
         _envelope.update();
-        _hp1.update();
-        _hp2.update();
-        _lp.update();
     }
 }
 
 TR808_FASTMATH_INLINE bool TR808HihatMozzi::isFinished() const {
-    return !_is_playing && _envelope.isFinished();
+    return !_is_playing && !_envelope.playing();
 }
 
 // =============================================================================
@@ -410,33 +427,34 @@ TR808_FASTMATH_INLINE bool TR808HihatMozzi::isFinished() const {
 
 TR808BridgedTOscillatorMozzi::TR808BridgedTOscillatorMozzi()
     : _frequency(TR808_FREQ_C1), _phase(0), _phase_increment(0)
-    , _resonance(TR808_BRIDGED_T_RESONANCE), _capacitance(0.01f)
+    , _resonance(float_to_Q16n16(TR808_BRIDGED_T_RESONANCE)), _capacitance(float_to_Q16n16(0.01f))
     , _is_active(false), _output(0)
-    , _rc_coeff(0), _feedback_coeff(0) {
+    , _rc_coeff(0), _feedback_coeff(0), _coeff_dirty(false) {
     
     updateCoefficients();
     setFrequency(TR808_BRIDGED_T_FREQ);
 }
 
 TR808_FASTMATH_INLINE void TR808BridgedTOscillatorMozzi::setFrequency(float freq_hz) {
-    _frequency = Q16n16::toQ16n16(freq_hz);
+    _frequency = float_to_Q16n16(freq_hz);
     _phase_increment = _frequency >> 8; // Convert to phase increment
 }
 
 TR808_FASTMATH_INLINE void TR808BridgedTOscillatorMozzi::setResonance(float resonance) {
-    _resonance = Q16n16::toQ16n16(resonance);
-    updateCoefficients();
+    _resonance = float_to_Q16n16(resonance);
+    _coeff_dirty = true;
 }
 
 TR808_FASTMATH_INLINE void TR808BridgedTOscillatorMozzi::setCapacitance(float capacitance) {
-    _capacitance = Q16n16::toQ16n16(capacitance);
-    updateCoefficients();
+    _capacitance = float_to_Q16n16(capacitance);
+    _coeff_dirty = true;
 }
 
 TR808_ISR_OPTIMIZED void TR808BridgedTOscillatorMozzi::updateCoefficients() {
     // Calculate RC network coefficients (fixed-point)
-    _rc_coeff = Q16n16::toQ16n16(1.0f / (2.0f * PI * TR808_BRIDGED_T_FREQ * _capacitance));
-    _feedback_coeff = _resonance * _rc_coeff;
+    _rc_coeff = float_to_Q16n16(1.0f / (2.0f * PI * TR808_BRIDGED_T_FREQ * Q16n16_to_float(_capacitance)));
+    _feedback_coeff = Q16n16_mult(_resonance, _rc_coeff);
+    _coeff_dirty = false;
 }
 
 TR808_AUDIO_INLINE void TR808BridgedTOscillatorMozzi::start() {
@@ -464,13 +482,13 @@ TR808_AUDIO_INLINE Q15n16 TR808BridgedTOscillatorMozzi::next() {
     
     // Update phase
     _phase += _phase_increment;
-    if (_phase >= Q16n16(1)) {
-        _phase -= Q16n16(1);
+    if (_phase >= Q16n16_FIX1) {
+        _phase -= Q16n16_FIX1;
     }
     
     // Generate sine wave
     int table_index = (int)(_phase >> 8) & 0xFF;
-    Q15n16 sine_wave = sin2048_int8[table_index];
+    Q15n16 sine_wave = TR808_MOZZI_SIN2048[table_index];
     
     // Apply bridged-T filter
     Q16n16 input = Q16n16(sine_wave) << 8; // Convert to Q16n16
@@ -482,50 +500,45 @@ TR808_AUDIO_INLINE Q15n16 TR808BridgedTOscillatorMozzi::next() {
 }
 
 TR808_ISR_OPTIMIZED void TR808BridgedTOscillatorMozzi::update() {
-    if (_is_active) {
-        // Update filter coefficients if needed
+    // 파라미터가 바뀐 경우에만 계수 재계산 (평상시 틱은 분기 하나)
+    if (_coeff_dirty) {
         updateCoefficients();
     }
 }
 
 // =============================================================================
-// TR808DrumMachineMozzi 구현
+// TR808VoicePoolMozzi 구현
 // =============================================================================
 
-TR808DrumMachineMozzi::TR808DrumMachineMozzi()
+TR808VoicePoolMozzi::TR808VoicePoolMozzi()
     : _kick_voice_index(0), _snare_voice_index(0)
     , _cymbal_voice_index(0), _hihat_voice_index(0)
     , _rms(), _bitcrusher(8), _master_lpf()
-    , _performance_mode(false), _processing_time_us(0)
-    , _max_processing_time_us(0) {
+    , _performance_mode(false), _load() {
+    
+    // Set default mix levels (Q15, 믹스에서 >> 15)
+    _mix_levels[0] = (Q15n16)(0.8f * 32768); // Kick
+    _mix_levels[1] = (Q15n16)(0.7f * 32768); // Snare
+    _mix_levels[2] = (Q15n16)(0.6f * 32768); // Cymbal
+    _mix_levels[3] = (Q15n16)(0.5f * 32768); // Hi-hat
     
-    // Set default mix levels
-    _mix_levels[0] = Q15n16(0.8f); // Kick
-    _mix_levels[1] = Q15n16(0.7f); // Snare
-    _mix_levels[2] = Q15n16(0.6f); // Cymbal
-    _mix_levels[3] = Q15n16(0.5f); // Hi-hat
+    for (int i = 0; i < TR808_KICK_VOICES; i++) _kick_velocity[i] = 32767;
+    for (int i = 0; i < TR808_SNARE_VOICES; i++) _snare_velocity[i] = 32767;
+    for (int i = 0; i < TR808_CYMBAL_VOICES; i++) _cymbal_velocity[i] = 32767;
+    for (int i = 0; i < TR808_HIHAT_VOICES; i++) _hihat_velocity[i] = 32767;
     
     // Master filter setup
-    _master_lpf.setCutoff(15000);
+    _master_lpf.setCutoffFreq(tr808MozziCutoff(15000));
 }
 
-TR808_FASTMATH_INLINE void TR808DrumMachineMozzi::begin() {
-    // Initialize all voices
-    for (int i = 0; i < TR808_KICK_VOICES; i++) {
-        _kicks[i] = TR808KickMozzi();
-    }
+TR808_FASTMATH_INLINE void TR808VoicePoolMozzi::begin() {
+    // Initialize all voices (ADSR은 const 멤버가 있어 재대입 대신 정지)
+    stopAll();
+    _load.begin(MOZZI_TR808_AUDIO_RATE, tr808CycleHz());
     
-    for (int i = 0; i < TR808_SNARE_VOICES; i++) {
-        _snares[i] = TR808SnareMozzi();
-    }
-    
-    for (int i = 0; i < TR808_CYMBAL_VOICES; i++) {
-        _cymbals[i] = TR808CymbalMozzi();
-    }
-    
-    for (int i = 0; i < TR808_HIHAT_VOICES; i++) {
-        _hihats[i] = TR808HihatMozzi();
-    }
+    // Oscil은 생성 시(전역 생성자) 테이블 주소를 받아 두므로 setTableStorage() 이후 주소로 다시 연결
+    for (int i = 0; i < TR808_SNARE_VOICES; i++) _snares[i].bindTables();
+    for (int i = 0; i < TR808_CYMBAL_VOICES; i++) _cymbals[i].bindTables();
     
     // Start performance monitoring if enabled
     if (_performance_mode) {
@@ -533,20 +546,29 @@ TR808_FASTMATH_INLINE void TR808DrumMachineMozzi::begin() {
     }
 }
 
-TR808_FASTMATH_INLINE void TR808DrumMachineMozzi::setSampleRate(uint32_t rate) {
-    // Adjust all components for new sample rate
-    for (int i = 0; i < TR808_KICK_VOICES; i++) {
-        // Update kick sample rate dependent parameters
-    }
+void TR808VoicePoolMozzi::setTableStorage(void* storage) {
+    if (storage == nullptr || TR808_MOZZI_TABLE_COPY_BYTES == 0) return;
     
-    for (int i = 0; i < TR808_SNARE_VOICES; i++) {
-        // Update snare sample rate dependent parameters
-    }
+    int8_t* sin2048 = (int8_t*)storage;
+    int8_t* square2048 = sin2048 + SIN2048_NUM_CELLS;
+    int8_t* brownNoise8192 = square2048 + SQUARE2048_NUM_CELLS;
+    memcpy(sin2048, SIN2048_DATA, SIN2048_NUM_CELLS);
+    memcpy(square2048, SQUARE2048_DATA, SQUARE2048_NUM_CELLS);
+    memcpy(brownNoise8192, BROWNNOISE8192_DATA, BROWNNOISE8192_NUM_CELLS);
     
-    // Similar for other drum types...
+    tr808MozziSin2048 = sin2048;
+    tr808MozziSquare2048 = square2048;
+    tr808MozziBrownNoise8192 = brownNoise8192;
+}
+
+TR808_FASTMATH_INLINE void TR808VoicePoolMozzi::setSampleRate(uint32_t rate) {
+    // Mozzi의 오디오 레이트와 Oscil 증분은 템플릿/매크로 상수 (MOZZI_TR808_AUDIO_RATE)라
+    // 런타임 변경 불가: 빌드 레이트와 다른 요청은 무시
+    // 런타임 전환은 네이티브 엔진(TR808DrumMachine::setSampleRate)에서 지원
+    (void)rate;
 }
 
-TR808_ISR_OPTIMIZED uint8_t TR808DrumMachineMozzi::allocateKickVoice() {
+TR808_ISR_OPTIMIZED uint8_t TR808VoicePoolMozzi::allocateKickVoice() {
     // Allocate first available kick voice
     for (int i = 0; i < TR808_KICK_VOICES; i++) {
         if (!_kicks[i].isPlaying()) {
@@ -559,7 +581,7 @@ TR808_ISR_OPTIMIZED uint8_t TR808DrumMachineMozzi::allocateKickVoice() {
     return _kick_voice_index;
 }
 
-TR808_ISR_OPTIMIZED uint8_t TR808DrumMachineMozzi::allocateSnareVoice() {
+TR808_ISR_OPTIMIZED uint8_t TR808VoicePoolMozzi::allocateSnareVoice() {
     for (int i = 0; i < TR808_SNARE_VOICES; i++) {
         if (!_snares[i].isPlaying()) {
             _snare_voice_index = i;
@@ -570,7 +592,7 @@ TR808_ISR_OPTIMIZED uint8_t TR808DrumMachineMozzi::allocateSnareVoice() {
     return _snare_voice_index;
 }
 
-TR808_ISR_OPTIMIZED uint8_t TR808DrumMachineMozzi::allocateCymbalVoice() {
+TR808_ISR_OPTIMIZED uint8_t TR808VoicePoolMozzi::allocateCymbalVoice() {
     for (int i = 0; i < TR808_CYMBAL_VOICES; i++) {
         if (!_cymbals[i].isPlaying()) {
             _cymbal_voice_index = i;
@@ -581,7 +603,7 @@ TR808_ISR_OPTIMIZED uint8_t TR808DrumMachineMozzi::allocateCymbalVoice() {
     return _cymbal_voice_index;
 }
 
-TR808_ISR_OPTIMIZED uint8_t TR808DrumMachineMozzi::allocateHihatVoice() {
+TR808_ISR_OPTIMIZED uint8_t TR808VoicePoolMozzi::allocateHihatVoice() {
     for (int i = 0; i < TR808_HIHAT_VOICES; i++) {
         if (!_hihats[i].isPlaying()) {
             _hihat_voice_index = i;
@@ -592,71 +614,83 @@ TR808_ISR_OPTIMIZED uint8_t TR808DrumMachineMozzi::allocateHihatVoice() {
     return _hihat_voice_index;
 }
 
-TR808_AUDIO_INLINE void TR808DrumMachineMozzi::triggerKick() {
+// 벨로시티 (0.0 ~ 1.0) -> Q15 슬롯 게인
+static inline Q15n16 velocityToQ15(float velocity) {
+    if (velocity <= 0.0f) return 0;
+    if (velocity >= 1.0f) return 32767;
+    return (Q15n16)(velocity * 32767.0f);
+}
+
+TR808_AUDIO_INLINE void TR808VoicePoolMozzi::triggerKick(float velocity) {
     uint8_t voice = allocateKickVoice();
+    _kick_velocity[voice] = velocityToQ15(velocity);
     _kicks[voice].start();
 }
 
-TR808_AUDIO_INLINE void TR808DrumMachineMozzi::triggerSnare() {
+TR808_AUDIO_INLINE void TR808VoicePoolMozzi::triggerSnare(float velocity) {
     uint8_t voice = allocateSnareVoice();
+    _snare_velocity[voice] = velocityToQ15(velocity);
     _snares[voice].start();
 }
 
-TR808_AUDIO_INLINE void TR808DrumMachineMozzi::triggerCymbal() {
+TR808_AUDIO_INLINE void TR808VoicePoolMozzi::triggerCymbal(float velocity) {
     uint8_t voice = allocateCymbalVoice();
+    _cymbal_velocity[voice] = velocityToQ15(velocity);
     _cymbals[voice].start();
 }
 
-TR808_AUDIO_INLINE void TR808DrumMachineMozzi::triggerHihat() {
+TR808_AUDIO_INLINE void TR808VoicePoolMozzi::triggerHihat(bool open, float velocity) {
     uint8_t voice = allocateHihatVoice();
+    _hihat_velocity[voice] = velocityToQ15(velocity);
+    _hihats[voice].setOpen(open);
     _hihats[voice].start();
 }
 
-TR808_FASTMATH_INLINE void TR808DrumMachineMozzi::setKickDecay(float decay_ms) {
+TR808_FASTMATH_INLINE void TR808VoicePoolMozzi::setKickDecay(float decay_ms) {
     for (int i = 0; i < TR808_KICK_VOICES; i++) {
         _kicks[i].setDecayTime(decay_ms);
     }
 }
 
-TR808_FASTMATH_INLINE void TR808DrumMachineMozzi::setSnareDecay(float decay_ms) {
+TR808_FASTMATH_INLINE void TR808VoicePoolMozzi::setSnareDecay(float decay_ms) {
     for (int i = 0; i < TR808_SNARE_VOICES; i++) {
         _snares[i].setDecayTime(decay_ms);
     }
 }
 
-TR808_FASTMATH_INLINE void TR808DrumMachineMozzi::setCymbalDecay(float decay_ms) {
+TR808_FASTMATH_INLINE void TR808VoicePoolMozzi::setCymbalDecay(float decay_ms) {
     for (int i = 0; i < TR808_CYMBAL_VOICES; i++) {
         _cymbals[i].setDecayTime(decay_ms);
     }
 }
 
-TR808_FASTMATH_INLINE void TR808DrumMachineMozzi::setHihatDecay(float decay_ms) {
+TR808_FASTMATH_INLINE void TR808VoicePoolMozzi::setHihatDecay(float decay_ms) {
     for (int i = 0; i < TR808_HIHAT_VOICES; i++) {
         _hihats[i].setDecayTime(decay_ms);
     }
 }
 
-TR808_FASTMATH_INLINE void TR808DrumMachineMozzi::setMixLevel(uint8_t drum_type, float level) {
+TR808_FASTMATH_INLINE void TR808VoicePoolMozzi::setMixLevel(uint8_t drum_type, float level) {
     if (drum_type < 4) {
-        _mix_levels[drum_type] = Q15n16(level);
+        _mix_levels[drum_type] = (Q15n16)(level * 32768);
     }
 }
 
-TR808_ISR_OPTIMIZED void TR808DrumMachineMozzi::updateProcessingTime() {
+TR808_ISR_OPTIMIZED void TR808VoicePoolMozzi::updateProcessingTime() {
+    // 컨트롤 틱 사이에 next()로 누산한 샘플을 한 블록으로 반영
     if (_performance_mode) {
-        uint32_t current_time = micros();
-        // Processing time would be calculated in next() method
+        _load.flush();
     }
 }
 
-TR808_AUDIO_INLINE Q15n16 TR808DrumMachineMozzi::mixVoices() IRAM_ATTR {
+TR808_AUDIO_INLINE Q15n16 TR808VoicePoolMozzi::mixVoices() {
     Q15n16 mixed = 0;
     
     // Mix all active kick voices
     for (int i = 0; i < TR808_KICK_VOICES; i++) {
         if (_kicks[i].isPlaying()) {
             Q15n16 kick_out = _kicks[i].next();
-            mixed += (kick_out * _mix_levels[0]) >> 15;
+            mixed += (((kick_out * _mix_levels[0]) >> 15) * _kick_velocity[i]) >> 15;
         }
     }
     
@@ -664,7 +698,7 @@ TR808_AUDIO_INLINE Q15n16 TR808DrumMachineMozzi::mixVoices() IRAM_ATTR {
     for (int i = 0; i < TR808_SNARE_VOICES; i++) {
         if (_snares[i].isPlaying()) {
             Q15n16 snare_out = _snares[i].next();
-            mixed += (snare_out * _mix_levels[1]) >> 15;
+            mixed += (((snare_out * _mix_levels[1]) >> 15) * _snare_velocity[i]) >> 15;
         }
     }
     
@@ -672,7 +706,7 @@ TR808_AUDIO_INLINE Q15n16 TR808DrumMachineMozzi::mixVoices() IRAM_ATTR {
     for (int i = 0; i < TR808_CYMBAL_VOICES; i++) {
         if (_cymbals[i].isPlaying()) {
             Q15n16 cymbal_out = _cymbals[i].next();
-            mixed += (cymbal_out * _mix_levels[2]) >> 15;
+            mixed += (((cymbal_out * _mix_levels[2]) >> 15) * _cymbal_velocity[i]) >> 15;
         }
     }
     
@@ -680,14 +714,14 @@ TR808_AUDIO_INLINE Q15n16 TR808DrumMachineMozzi::mixVoices() IRAM_ATTR {
     for (int i = 0; i < TR808_HIHAT_VOICES; i++) {
         if (_hihats[i].isPlaying()) {
             Q15n16 hihat_out = _hihats[i].next();
-            mixed += (hihat_out * _mix_levels[3]) >> 15;
+            mixed += (((hihat_out * _mix_levels[3]) >> 15) * _hihat_velocity[i]) >> 15;
         }
     }
     
     return mixed;
 }
 
-TR808_ISR_OPTIMIZED void TR808DrumMachineMozzi::applyMasterProcessing(Q15n16 &audio) {
+TR808_ISR_OPTIMIZED void TR808VoicePoolMozzi::applyMasterProcessing(Q15n16 &audio) {
     // Apply RMS compression
     audio = _rms.next(audio);
     
@@ -702,9 +736,9 @@ TR808_ISR_OPTIMIZED void TR808DrumMachineMozzi::applyMasterProcessing(Q15n16 &au
     else if (audio < -32768) audio = -32768;
 }
 
-TR808_AUDIO_INLINE Q15n16 TR808DrumMachineMozzi::next() {
+TR808_AUDIO_INLINE Q15n16 TR808VoicePoolMozzi::next() {
     if (_performance_mode) {
-        uint32_t start_time = micros();
+        _load.startSample();
     }
     
     // Mix all voices
@@ -714,17 +748,29 @@ TR808_AUDIO_INLINE Q15n16 TR808DrumMachineMozzi::next() {
     applyMasterProcessing(mixed_audio);
     
     if (_performance_mode) {
-        uint32_t end_time = micros();
-        _processing_time_us = end_time - start_time;
-        if (_processing_time_us > _max_processing_time_us) {
-            _max_processing_time_us = _processing_time_us;
-        }
+        _load.endSample();
     }
     
     return mixed_audio;
 }
 
-TR808_ISR_OPTIMIZED void TR808DrumMachineMozzi::update() {
+TR808_ISR_OPTIMIZED void TR808VoicePoolMozzi::renderBlock(int16_t* out, uint16_t count, int32_t gain_q15) {
+    if (_performance_mode) {
+        _load.startBlock();
+    }
+    
+    for (uint16_t i = 0; i < count; i++) {
+        Q15n16 sample = mixVoices();
+        applyMasterProcessing(sample);
+        out[i] = (int16_t)((sample * gain_q15) >> 15);
+    }
+    
+    if (_performance_mode) {
+        _load.endBlock(count);
+    }
+}
+
+TR808_ISR_OPTIMIZED void TR808VoicePoolMozzi::update() {
     // Update all drum voices
     for (int i = 0; i < TR808_KICK_VOICES; i++) {
         _kicks[i].update();
@@ -742,12 +788,10 @@ TR808_ISR_OPTIMIZED void TR808DrumMachineMozzi::update() {
         _hihats[i].update();
     }
     
-    // Update master processing components
-    _rms.update();
-    _master_lpf.update();
+    updateProcessingTime();
 }
 
-TR808_FASTMATH_INLINE void TR808DrumMachineMozzi::stopAll() {
+TR808_FASTMATH_INLINE void TR808VoicePoolMozzi::stopAll() {
     for (int i = 0; i < TR808_KICK_VOICES; i++) {
         _kicks[i].stop();
     }
@@ -765,7 +809,7 @@ TR808_FASTMATH_INLINE void TR808DrumMachineMozzi::stopAll() {
     }
 }
 
-TR808_FASTMATH_INLINE bool TR808DrumMachineMozzi::isAnyVoicePlaying() const {
+TR808_FASTMATH_INLINE bool TR808VoicePoolMozzi::isAnyVoicePlaying() const {
     for (int i = 0; i < TR808_KICK_VOICES; i++) {
         if (_kicks[i].isPlaying()) return true;
     }
@@ -785,14 +829,37 @@ TR808_FASTMATH_INLINE bool TR808DrumMachineMozzi::isAnyVoicePlaying() const {
     return false;
 }
 
-TR808_FASTMATH_INLINE void TR808DrumMachineMozzi::enablePerformanceMode(bool enable) {
+TR808_FASTMATH_INLINE uint8_t TR808VoicePoolMozzi::getActiveVoiceCount() const {
+    uint8_t count = 0;
+    
+    for (int i = 0; i < TR808_KICK_VOICES; i++) {
+        if (_kicks[i].isPlaying()) count++;
+    }
+    
+    for (int i = 0; i < TR808_SNARE_VOICES; i++) {
+        if (_snares[i].isPlaying()) count++;
+    }
+    
+    for (int i = 0; i < TR808_CYMBAL_VOICES; i++) {
+        if (_cymbals[i].isPlaying()) count++;
+    }
+    
+    for (int i = 0; i < TR808_HIHAT_VOICES; i++) {
+        if (_hihats[i].isPlaying()) count++;
+    }
+    
+    return count;
+}
+
+TR808_FASTMATH_INLINE void TR808VoicePoolMozzi::enablePerformanceMode(bool enable) {
     _performance_mode = enable;
     if (enable) {
+        _load.reset();
         optimizeForPerformance();
     }
 }
 
-TR808_ISR_OPTIMIZED void TR808DrumMachineMozzi::optimizeForPerformance() {
+TR808_ISR_OPTIMIZED void TR808VoicePoolMozzi::optimizeForPerformance() {
     // Enable performance optimizations
     // This would include cache optimization, memory management, etc.
     #ifdef ESP32C3_RISCV_OPTIMIZATION
@@ -804,25 +871,22 @@ TR808_ISR_OPTIMIZED void TR808DrumMachineMozzi::optimizeForPerformance() {
     #endif
 }
 
-TR808_FASTMATH_INLINE float TR808DrumMachineMozzi::getCPUUsage() const {
-    if (_processing_time_us == 0) return 0.0f;
-    
-    // Calculate CPU usage based on processing time vs available time
-    uint32_t available_time_us = 1000000UL / MOZZI_TR808_AUDIO_RATE; // 15.6μs @ 64kHz
-    return (float)_processing_time_us / (float)available_time_us * 100.0f;
+TR808_FASTMATH_INLINE float TR808VoicePoolMozzi::getCPUUsage() const {
+    // 최근 블록 부하 (퍼밀 -> %), 마감 대비 사이클 기준
+    return _load.getLoad() / 10.0f;
 }
 
-TR808_FASTMATH_INLINE void TR808DrumMachineMozzi::setMasterVolume(float volume) {
+TR808_FASTMATH_INLINE void TR808VoicePoolMozzi::setMasterVolume(float volume) {
     // Apply volume to all mix levels
     for (int i = 0; i < 4; i++) {
-        _mix_levels[i] = _mix_levels[i] * Q15n16(volume);
+        _mix_levels[i] = (_mix_levels[i] * (Q15n16)(volume * 32768)) >> 15;
     }
 }
 
-TR808_FASTMATH_INLINE void TR808DrumMachineMozzi::setBitCrushDepth(uint8_t depth) {
+TR808_FASTMATH_INLINE void TR808VoicePoolMozzi::setBitCrushDepth(uint8_t depth) {
     _bitcrusher.setBits(depth);
 }
 
-TR808_FASTMATH_INLINE void TR808DrumMachineMozzi::setMasterFilterCutoff(float cutoff_hz) {
-    _master_lpf.setCutoff(cutoff_hz);
+TR808_FASTMATH_INLINE void TR808VoicePoolMozzi::setMasterFilterCutoff(float cutoff_hz) {
+    _master_lpf.setCutoffFreq(tr808MozziCutoff(cutoff_hz));
 }
\ No newline at end of file
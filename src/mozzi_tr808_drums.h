@@ -2,7 +2,7 @@
  * Mozzi 기반 TR-808 드럼 클래스 구현
  * 
  * 고성능 Mozzi Library를 완전히 활용한 TR-808 드럼 알고리즘
- * fastMath, generation, envelope 최적화, 64kHz 샘플링 레이트 지원
+ * fastMath, generation, envelope 최적화, 공용 샘플 레이트 정책(tr808_sample_rate.h) 사용
  * 
  * 작성일: 2025-10-30
  * 호환성: ESP32C3 + Mozzi Library
@@ -14,35 +14,30 @@
 #include <Arduino.h>
 #include <MozziGuts.h>
 #include <mozzi_fixmath.h>
-#include <mozzi_midi.h>
 #include <Oscil.h>
+#include <ADSR.h>
 #include <tables/square2048_int8.h>
-#include <tables/triangle2048_int8.h>
 #include <tables/sin2048_int8.h>
 #include <tables/brownnoise8192_int8.h>
-#include <tables/cos2048_int8.h>
-#include <tables/envelope___adsr.h>
-#include <mozzi_utils.h>
-#include <DCfilter.h>
 #include <LowPassFilter.h>
 #include <HighPassFilter.h>
 #include <ResonantFilter.h>
-#include <BitCrusher.h>
-#include <Phasor.h>
-#include <RMS.h>
-#include <AutoMap.h>
+#include "tr808_wavetable.h"
+#include "tr808_sample_rate.h"
+#include "tr808_perf_monitor.h"
+#include "tr808_placement.h"
 
-// Mozzi 64kHz 설정
-#define MOZZI_TR808_AUDIO_RATE 64000
+// Mozzi 보이스 레이트 (Oscil 템플릿 인자, 엔진 공용 레이트와 동일)
+#define MOZZI_TR808_AUDIO_RATE TR808_SAMPLE_RATE
 #define MOZZI_TR808_CONTROL_RATE 512
 
-// TR-808 음정 정의 (fastMath 사용)
-#define TR808_FREQ_C1   65536  // 32.7Hz
-#define TR808_FREQ_C2   131072 // 65.4Hz  
-#define TR808_FREQ_D2   147456 // 73.4Hz
-#define TR808_FREQ_F#2  185856 // 92.5Hz
-#define TR808_FREQ_A2   207360 // 103.4Hz
-#define TR808_FREQ_C3   262144 // 130.8Hz
+// TR-808 음정 정의 (Hz, Q16n16)
+#define TR808_FREQ_C1   2143027  // 32.7Hz
+#define TR808_FREQ_C2   4286054  // 65.4Hz
+#define TR808_FREQ_D2   4810342  // 73.4Hz
+#define TR808_FREQ_FS2  6062080  // 92.5Hz
+#define TR808_FREQ_A2   6776422  // 103.4Hz
+#define TR808_FREQ_C3   8572109  // 130.8Hz
 
 // 폴리포니 설정
 #define TR808_MAX_VOICES 8
@@ -57,17 +52,63 @@
 #define TR808_RELEASE_TIME 500   // 0.5초
 #define TR808_SUSTAIN_LEVEL 32768 // 0.5
 
+// 킥 파형 레벨: 16비트 사인(+-32767) >> 2 = +-8191
+// 이전 int8 조회 x 피치(C2, 127 x 65.4 = +-8300)와 같은 헤드룸 (스네어와 동시 재생 시 클리핑 방지)
+#define TR808_KICK_WAVE_SHIFT 2
+
+// 스네어 레벨: int8 노이즈/톤 << 6 = +-8128 (킥과 같은 헤드룸)
+// 이전에는 엔벨롭(Q15) 곱 뒤 >> 15가 빠져 +-2M으로 항상 출력 클램프에 걸림 (벨로시티 무의미)
+#define TR808_SNARE_LEVEL_SHIFT 6
+
+// 하이햇 레벨: 백색 잡음(int8) << 6을 필터에 넣음 (8비트 계수 필터의 >> 8 정밀도 손실 방지)
+#define TR808_HIHAT_LEVEL_SHIFT 6
+#define TR808_HIHAT_NOISE_SEED  0x808808u
+
 // 브리지드-T 발진기 설정
 #define TR808_BRIDGED_T_FREQ 100.0f
 #define TR808_BRIDGED_T_Q 5.0f
 #define TR808_BRIDGED_T_RESONANCE 0.7f
 
-// 드럼 타입 열거
-enum TR808DrumType {
-    TR808_KICK = 0,
-    TR808_SNARE = 1,
-    TR808_CYMBAL = 2,
-    TR808_HIHAT = 3
+// 렌더 경로 테이블: Mozzi 테이블은 라이브러리 헤더의 const 배열(플래시 .rodata)
+// 배치 정책(tr808_placement.h)이 켜진 빌드는 시작 아레나에서 DRAM 사본 자리를 받아 옮김
+// (TR808VoicePoolMozzi::setTableStorage), 자리를 안 주면 플래시 테이블 그대로 사용
+#if TR808_PLACE_ACTIVE
+#define TR808_MOZZI_TABLE_COPY_BYTES (SIN2048_NUM_CELLS + SQUARE2048_NUM_CELLS + BROWNNOISE8192_NUM_CELLS)
+#else
+#define TR808_MOZZI_TABLE_COPY_BYTES 0
+#endif
+extern const int8_t* tr808MozziSin2048;
+extern const int8_t* tr808MozziSquare2048;
+extern const int8_t* tr808MozziBrownNoise8192;
+#define TR808_MOZZI_SIN2048         tr808MozziSin2048
+#define TR808_MOZZI_SQUARE2048      tr808MozziSquare2048
+#define TR808_MOZZI_BROWNNOISE8192  tr808MozziBrownNoise8192
+
+// 엔벨롭: 16비트 레벨 (0-32768, 출력에 곱한 뒤 >> 15)
+typedef ADSR<CONTROL_RATE, AUDIO_RATE, unsigned int> TR808EnvelopeMozzi;
+
+// Hz -> Mozzi ResonantFilter 8비트 계수 (0-255 = 0 ~ 오디오 레이트/4)
+inline uint8_t tr808MozziCutoff(float cutoff_hz) {
+    float coeff = cutoff_hz * 1024.0f / MOZZI_TR808_AUDIO_RATE;
+    return coeff >= 255.0f ? 255 : (uint8_t)coeff;
+}
+
+// Q16n16 나눗셈 (64비트 중간값, 설정 경로 전용)
+inline Q16n16 tr808Q16n16Div(Q16n16 a, Q16n16 b) {
+    return (Q16n16)(((uint64_t)a << 16) / b);
+}
+
+// 0.0-1.0 -> Mozzi 레조넌스 (0-255)
+inline uint8_t tr808MozziResonance(float resonance) {
+    return resonance >= 1.0f ? 255 : (resonance <= 0.0f ? 0 : (uint8_t)(resonance * 255.0f));
+}
+
+// 보이스 그룹 (믹스 레벨 인덱스)
+enum TR808VoiceGroup {
+    TR808_GROUP_KICK = 0,
+    TR808_GROUP_SNARE = 1,
+    TR808_GROUP_CYMBAL = 2,
+    TR808_GROUP_HIHAT = 3
 };
 
 /**
@@ -82,18 +123,21 @@ private:
     Q16n16 _pitch_decay;
     Q16n16 _current_pitch;
     
+    // 컨트롤 레이트 계수 캐시 (setDecayTime에서만 계산, 틱마다 나눗셈 없음)
+    Q16n16 _decay_reciprocal;   // 1 / decay_time
+    Q16n16 _decay_rate;         // 1 - 1 / decay_time
+    
+    // 16비트 보간 사인 오실레이터 (32비트 위상 누산기)
+    TR808SineOscillator _osc;
+    
     //Envelope
-    ADSR<CONTROL_RATE, AUDIO_RATE> _envelope;
+    TR808EnvelopeMozzi _envelope;
     
     // 상태 변수
     bool _is_playing;
     uint32_t _start_time;
     uint32_t _note_duration;
     
-    // 성능 최적화 변수
-    static constexpr int _table_size = 256;
-    int _lookup_index;
-    
 public:
     TR808KickMozzi();
     
@@ -115,8 +159,9 @@ public:
     
 private:
     // TR-808 고유 알고리즘 (fastMath)
-    Q15n16 generateKickWave(Q16n16 phase) IRAM_ATTR;
+    Q15n16 generateKickWave() IRAM_ATTR;
     void updatePitchDecay() IRAM_ATTR;
+    void updateDecayCoefficients();
 };
 
 /**
@@ -126,14 +171,14 @@ private:
 class TR808SnareMozzi {
 private:
     // Noise 소스 (brown noise table 사용)
-    Oscil<BROWNNOISE8192_ISTEP, MOZZI_TR808_AUDIO_RATE> _noise_osc;
+    Oscil<BROWNNOISE8192_NUM_CELLS, MOZZI_TR808_AUDIO_RATE> _noise_osc;
     
     // Tone component
-    Oscil<SQUARE2048_ISTEP, MOZZI_TR808_AUDIO_RATE> _tone_osc;
+    Oscil<SQUARE2048_NUM_CELLS, MOZZI_TR808_AUDIO_RATE> _tone_osc;
     
     // Envelope (optimized)
-    ADSR<CONTROL_RATE, AUDIO_RATE> _noise_env;
-    ADSR<CONTROL_RATE, AUDIO_RATE> _tone_env;
+    TR808EnvelopeMozzi _noise_env;
+    TR808EnvelopeMozzi _tone_env;
     
     // Filters
     HighPassFilter _highpass;
@@ -155,6 +200,7 @@ public:
     void stop();
     void setDecayTime(float decay_ms);
     void setTone(float tone_hz);
+    void bindTables();  // 오실레이터 테이블을 현재 TR808_MOZZI_* 주소로 다시 연결
     
     // Audio rate update
     Q15n16 next() IRAM_ATTR;
@@ -174,18 +220,18 @@ public:
 class TR808CymbalMozzi {
 private:
     // Noise 기반 소스 (여러 주파수 성분)
-    Oscil<SIN2048_ISTEP, MOZZI_TR808_AUDIO_RATE> _osc1;
-    Oscil<SIN2048_ISTEP, MOZZI_TR808_AUDIO_RATE> _osc2;
-    Oscil<SIN2048_ISTEP, MOZZI_TR808_AUDIO_RATE> _osc3;
-    Oscil<BROWNNOISE8192_ISTEP, MOZZI_TR808_AUDIO_RATE> _noise;
+    Oscil<SIN2048_NUM_CELLS, MOZZI_TR808_AUDIO_RATE> _osc1;
+    Oscil<SIN2048_NUM_CELLS, MOZZI_TR808_AUDIO_RATE> _osc2;
+    Oscil<SIN2048_NUM_CELLS, MOZZI_TR808_AUDIO_RATE> _osc3;
+    Oscil<BROWNNOISE8192_NUM_CELLS, MOZZI_TR808_AUDIO_RATE> _noise;
     
     // Band-pass filters (metallic sound)
-    ResonantFilter _bandpass1;
-    ResonantFilter _bandpass2;
-    ResonantFilter _bandpass3;
+    ResonantFilter<BANDPASS> _bandpass1;
+    ResonantFilter<BANDPASS> _bandpass2;
+    ResonantFilter<BANDPASS> _bandpass3;
     
     // Envelope
-    ADSR<CONTROL_RATE, AUDIO_RATE> _envelope;
+    TR808EnvelopeMozzi _envelope;
     
     // 상태 변수
     bool _is_playing;
@@ -193,7 +239,7 @@ private:
     Q16n16 _resonance;
     
     // Frequency modulation
-    Phasor _fm_phase;
+    Q16n16 _fm_phase;
     Q16n16 _fm_frequency;
     Q16n16 _fm_depth;
     
@@ -206,6 +252,7 @@ public:
     void setDecayTime(float decay_ms);
     void setResonance(float resonance);
     void setFMDepth(float depth);
+    void bindTables();  // 오실레이터 테이블을 현재 TR808_MOZZI_* 주소로 다시 연결
     
     // Audio rate update
     Q15n16 next() IRAM_ATTR;
@@ -224,16 +271,17 @@ public:
  */
 class TR808HihatMozzi {
 private:
-    // High-frequency noise
-    Oscil<BROWNNOISE8192_ISTEP, MOZZI_TR808_AUDIO_RATE> _noise;
+    // 백색 잡음 (xorshift32): 브라운 노이즈 테이블은 에너지가 저역에 몰려 있어
+    // 6k/10k 하이패스를 지나면 거의 남지 않음 (피크 2/32767)
+    uint32_t _noise_state;
     
-    // Multiple band-pass filters
+    // 하이패스 2단 (같은 컷오프, 기울기 2배)
+    // ResonantFilter 컷오프 상한은 오디오 레이트/4 (32768Hz에서 8192Hz): 상한에 둔 하이패스는 전부 제거
     HighPassFilter _hp1;
     HighPassFilter _hp2;
-    LowPassFilter _lp;
     
     // Envelope (fast decay)
-    ADSR<CONTROL_RATE, AUDIO_RATE> _envelope;
+    TR808EnvelopeMozzi _envelope;
     
     // 상태 변수
     bool _is_playing;
@@ -285,6 +333,7 @@ private:
     // 브리지드-T 네트워크 계수 (고정 소수점)
     Q16n16 _rc_coeff;
     Q16n16 _feedback_coeff;
+    bool _coeff_dirty;          // 파라미터 변경 후 update()에서 한 번만 재계산
     
 public:
     TR808BridgedTOscillatorMozzi();
@@ -312,10 +361,47 @@ private:
 };
 
 /**
- * TR-808 드럼 머신 (폴리포니 지원)
- * 여러 드럼 소스를 동시에 재생
+ * 마스터 RMS 측정 (신호는 그대로 통과)
+ */
+class TR808RMSMeter {
+private:
+    int32_t _mean_square;       // 1차 평균 (Q15)
+
+public:
+    TR808RMSMeter() : _mean_square(0) {}
+
+    inline Q15n16 next(Q15n16 in) {
+        int32_t power = (int32_t)(((int64_t)in * in) >> 15);
+        _mean_square += (power - _mean_square) >> 8;
+        return in;
+    }
+
+    int32_t getMeanSquare() const { return _mean_square; }
+};
+
+/**
+ * 마스터 비트 크러셔 (16비트 샘플의 하위 비트 제거)
  */
-class TR808DrumMachineMozzi {
+class TR808BitCrusher {
+private:
+    uint8_t _bits;
+
+public:
+    TR808BitCrusher(uint8_t bits = 16) : _bits(bits) {}
+
+    void setBits(uint8_t bits) { _bits = bits; }
+
+    inline Q15n16 next(Q15n16 in) const {
+        if (_bits >= 16) return in;
+        return in & ~((Q15n16)(1 << (16 - _bits)) - 1);
+    }
+};
+
+/**
+ * TR-808 보이스 풀 (폴리포니 지원)
+ * 여러 드럼 소스를 동시에 재생, mozzi_tr808_config.h의 드럼 머신이 블록 단위로 렌더
+ */
+class TR808VoicePoolMozzi {
 private:
     // 드럼 voices (폴리포니)
     TR808KickMozzi _kicks[TR808_KICK_VOICES];
@@ -330,30 +416,41 @@ private:
     uint8_t _hihat_voice_index;
     
     // Global envelope/compression
-    RMS _rms;
-    BitCrusher _bitcrusher;
+    TR808RMSMeter _rms;
+    TR808BitCrusher _bitcrusher;
     LowPassFilter _master_lpf;
     
-    // Performance monitoring
+    // Performance monitoring (블록 마감 대비 사이클 부하)
     bool _performance_mode;
-    uint32_t _processing_time_us;
-    uint32_t _max_processing_time_us;
+    TR808LoadMeter _load;
     
     // Audio mixing
     Q15n16 _mix_levels[4]; // kick, snare, cymbal, hihat
     
+    // 보이스 슬롯별 트리거 벨로시티 (Q15, 믹스에서 그룹 레벨 다음에 곱함)
+    Q15n16 _kick_velocity[TR808_KICK_VOICES];
+    Q15n16 _snare_velocity[TR808_SNARE_VOICES];
+    Q15n16 _cymbal_velocity[TR808_CYMBAL_VOICES];
+    Q15n16 _hihat_velocity[TR808_HIHAT_VOICES];
+    
 public:
-    TR808DrumMachineMozzi();
+    TR808VoicePoolMozzi();
     
-    // 초기화
+    // 초기화 (오실레이터를 현재 렌더 경로 테이블에 연결)
     void begin();
     void setSampleRate(uint32_t rate);
     
-    // Drum triggers
-    void triggerKick();
-    void triggerSnare();
-    void triggerCymbal();
-    void triggerHihat();
+    /**
+     * 렌더 경로 테이블을 storage(TR808_MOZZI_TABLE_COPY_BYTES, 시작 아레나)로 복사하고 그 주소로 전환
+     * begin() 전에 한 번 (이후 begin()하는 모든 풀이 사본을 씀), nullptr이면 플래시 테이블 유지
+     */
+    static void setTableStorage(void* storage);
+    
+    // Drum triggers (벨로시티 0.0 ~ 1.0)
+    void triggerKick(float velocity = 1.0f);
+    void triggerSnare(float velocity = 1.0f);
+    void triggerCymbal(float velocity = 1.0f);
+    void triggerHihat(bool open = false, float velocity = 1.0f);
     
     // Parameter control
     void setKickDecay(float decay_ms);
@@ -365,18 +462,26 @@ public:
     // Audio rate update (main processing)
     Q15n16 next() IRAM_ATTR;
     
+    // 블록 렌더: count 샘플을 mixVoices() + 마스터 처리 후 게인(Q15) 적용
+    void renderBlock(int16_t* out, uint16_t count, int32_t gain_q15) IRAM_ATTR;
+    
     // Control rate update
     void update();
     
     // Performance monitoring
+    // next(): 샘플마다 누산 후 update()(컨트롤 틱)에서 한 블록으로 반영
+    // renderBlock(): 블록 단위로 바로 반영
     void enablePerformanceMode(bool enable);
-    uint32_t getProcessingTime() const { return _processing_time_us; }
-    uint32_t getMaxProcessingTime() const { return _max_processing_time_us; }
+    uint32_t getProcessingTime() const { return _load.getSampleTimeUs(); }
+    uint32_t getMaxProcessingTime() const { return _load.getMaxSampleTimeUs(); }
     float getCPUUsage() const;
+    const TR808LoadMeter& getLoadMeter() const { return _load; }
+    void resetLoadMeter() { _load.reset(); }
     
     // State management
     void stopAll();
     bool isAnyVoicePlaying() const;
+    uint8_t getActiveVoiceCount() const;
     
     // Advanced features
     void setMasterVolume(float volume);
@@ -403,16 +508,19 @@ private:
 // 성능 최적화 매크로들
 // =============================================================================
 
+// 클래스 밖 멤버 정의용 배치 매크로
+// (다른 번역 단위에서 호출되므로 static/always_inline 불가, IRAM 배치만 지정)
+
 // ISR 최적화 매크로
-#define TR808_ISR_OPTIMIZED __attribute__((always_inline)) IRAM_ATTR
+#define TR808_ISR_OPTIMIZED IRAM_ATTR
 
 // 메모리 최적화 매크로  
 #define TR808_USE_DTCM __attribute__((section(".dtcm")))
 
-// fastMath 최적화 매크로
-#define TR808_FASTMATH_INLINE static inline __attribute__((always_inline)) 
+// fastMath 최적화 매크로 (설정 경로, 플래시 배치)
+#define TR808_FASTMATH_INLINE
 
 // Audio rate 최적화
-#define TR808_AUDIO_INLINE static inline Q15n16 __attribute__((always_inline)) IRAM_ATTR
+#define TR808_AUDIO_INLINE IRAM_ATTR
 
 #endif /* MOZZI_TR808_DRUMS_H */
\ No newline at end of file
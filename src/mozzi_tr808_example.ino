@@ -1,7 +1,7 @@
 /*
  * Mozzi 기반 TR-808 드럼 머신 예제
  * 
- * 64kHz 고성능 TR-808 드럼 구현
+ * 고성능 TR-808 드럼 구현 (레이트는 tr808_sample_rate.h)
  * fastMath, generation, envelope 최적화, 폴리포니 지원
  * 
  * 작성일: 2025-10-30
@@ -14,7 +14,7 @@
 #include "mozzi_config.h"
 
 // 전역 오브젝트
-TR808DrumMachineMozzi drum_machine;
+TR808VoicePoolMozzi drum_machine;
 
 // 성능 모니터링
 unsigned long last_performance_check = 0;
@@ -43,12 +43,15 @@ const uint8_t hihat_pattern[16] = {
 
 uint8_t current_step = 0;
 
+// 시리얼 명령 줄 버퍼
+#define SERIAL_LINE_SIZE 16
+
 void setup() {
     Serial.begin(115200);
     delay(1000);
     
     Serial.println("=== Mozzi TR-808 드럼 머신 시작 ===");
-    Serial.println("64kHz 샘플링 레이트, 폴리포니 지원, fastMath 최적화");
+    Serial.printf("%lu Hz 샘플링 레이트, 폴리포니 지원, fastMath 최적화\n", (unsigned long)MOZZI_TR808_AUDIO_RATE);
     
     // Mozzi 초기화
     startMozzi(MOZZI_TR808_AUDIO_RATE);
@@ -66,16 +69,17 @@ void setup() {
     drum_machine.setHihatDecay(150.0f);     // Hi-hat: 150ms decay
     
     // 믹스 레벨 설정
-    drum_machine.setMixLevel(TR808_KICK, 0.9f);
-    drum_machine.setMixLevel(TR808_SNARE, 0.8f);
-    drum_machine.setMixLevel(TR808_CYMBAL, 0.7f);
-    drum_machine.setMixLevel(TR808_HIHAT, 0.6f);
+    drum_machine.setMixLevel(TR808_GROUP_KICK, 0.9f);
+    drum_machine.setMixLevel(TR808_GROUP_SNARE, 0.8f);
+    drum_machine.setMixLevel(TR808_GROUP_CYMBAL, 0.7f);
+    drum_machine.setMixLevel(TR808_GROUP_HIHAT, 0.6f);
     
     // 마스터 설정
     drum_machine.setMasterVolume(0.8f);
     drum_machine.setMasterFilterCutoff(12000.0f);
     
     Serial.println("드럼 머신 초기화 완료");
+    Serial.println("벤치마크: 시리얼에 'bench' 입력");
     Serial.println("시퀀스 시작...");
     
     // 초기 시퀀스 출력
@@ -85,6 +89,9 @@ void setup() {
 void loop() {
     audioHook(); // Mozzi 오디오 처리
     
+    // 시리얼 명령 (벤치마크는 부팅마다 돌리지 않고 요청 시에만)
+    handleSerialCommands();
+    
     unsigned long current_time = millis();
     
     // 시퀀스 처리 (16步 패턴)
@@ -107,6 +114,36 @@ void loop() {
     }
 }
 
+// =============================================================================
+// 시리얼 명령
+// =============================================================================
+
+void handleSerialCommands() {
+    static char line[SERIAL_LINE_SIZE];
+    static uint8_t length = 0;
+    
+    while (Serial.available()) {
+        char c = (char)Serial.read();
+        if (c != '\n' && c != '\r') {
+            if (length < SERIAL_LINE_SIZE - 1) line[length++] = c;
+            continue;
+        }
+        if (length == 0) continue;
+        line[length] = '\0';
+        length = 0;
+        
+        if (strcmp(line, "bench") == 0) {
+            // 컨트롤 레이트 계수 캐시 효과 측정
+            benchmarkControlRate();
+            // 킥 웨이브테이블 품질/비용 비교
+            benchmarkKickOscillator();
+        } else {
+            Serial.print("알 수 없는 명령: ");
+            Serial.println(line);
+        }
+    }
+}
+
 // =============================================================================
 // 시퀀스 처리 함수들
 // =============================================================================
@@ -186,12 +223,16 @@ void printPerformanceReport() {
     Serial.printf("최대 처리 시간: %lu μs\n", max_processing_time);
     Serial.printf("CPU 사용률: %.2f%%\n", cpu_usage);
     
-    // 가용 시간 계산 (64kHz 기준)
+    // 가용 시간 계산 (샘플 주기)
     uint32_t available_time_us = 1000000UL / MOZZI_TR808_AUDIO_RATE;
     Serial.printf("가용 처리 시간: %lu μs\n", available_time_us);
     
-    if (processing_time > available_time_us) {
-        Serial.println("⚠️  처리 시간 초과! 성능 최적화 필요");
+    // 블록 부하 미터: 평균/피크와 마감 초과 블록 수
+    const TR808LoadMeter& load = drum_machine.getLoadMeter();
+    Serial.printf("평균 부하: %.1f%%, 피크: %.1f%%\n", load.getAverage() / 10.0f, load.getPeak() / 10.0f);
+    
+    if (load.getOverruns() > 0) {
+        Serial.printf("⚠️  마감 초과 %lu블록! 성능 최적화 필요\n", (unsigned long)load.getOverruns());
     } else {
         Serial.println("✅ 성능 양호");
     }
@@ -206,7 +247,7 @@ void printPerformanceReport() {
 // =============================================================================
 
 /**
- * Mozzi 오디오 업데이트 (64kHz)
+ * Mozzi 오디오 업데이트 (MOZZI_TR808_AUDIO_RATE)
  * ISR에서 호출됨
  */
 AudioOutput_t updateAudio() {
@@ -300,7 +341,7 @@ void testParameterChanges() {
     float mix_levels[] = {0.3f, 0.6f, 0.9f, 1.0f};
     
     for (int i = 0; i < 4; i++) {
-        drum_machine.setMixLevel(TR808_KICK, mix_levels[i]);
+        drum_machine.setMixLevel(TR808_GROUP_KICK, mix_levels[i]);
         Serial.printf("Mix level: %.1f\n", mix_levels[i]);
         
         drum_machine.triggerKick();
@@ -308,4 +349,161 @@ void testParameterChanges() {
     }
     
     Serial.println("파라미터 테스트 완료\n");
-}
\ No newline at end of file
+}
+
+// =============================================================================
+// 컨트롤 레이트 마이크로벤치마크
+// =============================================================================
+
+#define CONTROL_BENCH_VOICES 8
+#define CONTROL_BENCH_TICKS  MOZZI_TR808_CONTROL_RATE   // 1초 분량
+
+// 계수 캐시 이전 방식: 틱마다 나눗셈 2회 + 브리지드-T 계수 재계산
+struct LegacyControlState {
+    Q16n16 decay_time;
+    Q16n16 pitch_decay;
+    Q16n16 capacitance;
+    Q16n16 resonance;
+    Q16n16 rc_coeff;
+    Q16n16 feedback_coeff;
+};
+
+static void legacyControlTick(LegacyControlState &state) {
+    Q16n16 decay_rate = Q16n16_FIX1 - tr808Q16n16Div(Q16n16_FIX1, state.decay_time);
+    state.pitch_decay = Q16n16_mult(state.pitch_decay, decay_rate) + tr808Q16n16Div(Q16n16_FIX1, state.decay_time);
+    
+    state.rc_coeff = float_to_Q16n16(1.0f / (2.0f * PI * TR808_BRIDGED_T_FREQ * Q16n16_to_float(state.capacitance)));
+    state.feedback_coeff = Q16n16_mult(state.resonance, state.rc_coeff);
+}
+
+void benchmarkControlRate() {
+    Serial.println("=== 컨트롤 레이트 벤치마크 ===");
+    
+    static TR808KickMozzi kicks[CONTROL_BENCH_VOICES];
+    static TR808BridgedTOscillatorMozzi oscillators[CONTROL_BENCH_VOICES];
+    static LegacyControlState legacy[CONTROL_BENCH_VOICES];
+    
+    for (int i = 0; i < CONTROL_BENCH_VOICES; i++) {
+        kicks[i].setDecayTime(800.0f);
+        kicks[i].start();
+        oscillators[i].start();
+        
+        legacy[i].decay_time = float_to_Q16n16(800.0f);
+        legacy[i].pitch_decay = 0;
+        legacy[i].capacitance = float_to_Q16n16(0.01f);
+        legacy[i].resonance = float_to_Q16n16(TR808_BRIDGED_T_RESONANCE);
+    }
+    
+    // 이전 방식
+    uint32_t start = ESP.getCycleCount();
+    for (int tick = 0; tick < CONTROL_BENCH_TICKS; tick++) {
+        for (int i = 0; i < CONTROL_BENCH_VOICES; i++) {
+            legacyControlTick(legacy[i]);
+        }
+    }
+    uint32_t legacy_cycles = ESP.getCycleCount() - start;
+    
+    // 캐시된 계수 (파라미터 변경 없음, 엔벨로프 갱신까지 포함한 실제 update())
+    start = ESP.getCycleCount();
+    for (int tick = 0; tick < CONTROL_BENCH_TICKS; tick++) {
+        for (int i = 0; i < CONTROL_BENCH_VOICES; i++) {
+            kicks[i].update();
+            oscillators[i].update();
+        }
+    }
+    uint32_t cached_cycles = ESP.getCycleCount() - start;
+    
+    uint32_t ticks = CONTROL_BENCH_TICKS;
+    Serial.printf("보이스 %d개, %lu 틱\n", CONTROL_BENCH_VOICES, (unsigned long)ticks);
+    Serial.printf("이전 방식: %lu 사이클/틱\n", (unsigned long)(legacy_cycles / ticks));
+    Serial.printf("계수 캐시: %lu 사이클/틱\n", (unsigned long)(cached_cycles / ticks));
+    if (cached_cycles > 0) {
+        Serial.printf("감소율: %.1fx\n", (float)legacy_cycles / (float)cached_cycles);
+    }
+    
+    for (int i = 0; i < CONTROL_BENCH_VOICES; i++) {
+        kicks[i].stop();
+        oscillators[i].stop();
+    }
+    Serial.println();
+}
+
+// =============================================================================
+// 킥 오실레이터 품질/비용 비교
+// =============================================================================
+
+#define OSC_BENCH_SAMPLES 4096
+#define OSC_BENCH_CYCLES  13      // 분석 구간에 정수 주기 (누설 없는 빈)
+#define OSC_BENCH_HARMONICS 5
+
+static int16_t osc_bench_buffer[OSC_BENCH_SAMPLES];
+
+// 이전 방식: 32비트 위상 상위 8비트로 sin2048_int8 앞 256 엔트리 조회
+static inline int16_t legacyKickLookup(uint32_t phase) {
+    return (int16_t)(SIN2048_DATA[(phase >> 24) & 0xFF] << 8);
+}
+
+// Goertzel 알고리즘으로 단일 빈 전력 계산
+static float goertzelPower(const int16_t* samples, int count, int bin) {
+    float w = 2.0f * PI * bin / count;
+    float coeff = 2.0f * cosf(w);
+    float s1 = 0.0f, s2 = 0.0f;
+    for (int i = 0; i < count; i++) {
+        float s = samples[i] + coeff * s1 - s2;
+        s2 = s1;
+        s1 = s;
+    }
+    return (s1 * s1 + s2 * s2 - coeff * s1 * s2) * 2.0f / count;
+}
+
+// THD(2~5차 고조파)와 SINAD를 dB로 출력
+static void printToneQuality(const char* name, const int16_t* samples, int count) {
+    float total = 0.0f;
+    for (int i = 0; i < count; i++) {
+        total += (float)samples[i] * samples[i];
+    }
+    
+    float fundamental = goertzelPower(samples, count, OSC_BENCH_CYCLES);
+    float harmonics = 0.0f;
+    for (int k = 2; k <= OSC_BENCH_HARMONICS; k++) {
+        harmonics += goertzelPower(samples, count, OSC_BENCH_CYCLES * k);
+    }
+    float noise = total - fundamental;
+    if (harmonics < 1e-3f) harmonics = 1e-3f;
+    if (noise < 1e-3f) noise = 1e-3f;
+    
+    Serial.printf("%s: THD %.1f dB, SINAD %.1f dB\n", name,
+                  10.0f * log10f(harmonics / fundamental),
+                  10.0f * log10f(fundamental / noise));
+}
+
+void benchmarkKickOscillator() {
+    Serial.println("=== 킥 오실레이터 비교 ===");
+    
+    uint32_t increment = (uint32_t)(((uint64_t)OSC_BENCH_CYCLES << 32) / OSC_BENCH_SAMPLES);
+    
+    // 이전 방식
+    uint32_t phase = 0;
+    uint32_t start = ESP.getCycleCount();
+    for (int i = 0; i < OSC_BENCH_SAMPLES; i++) {
+        osc_bench_buffer[i] = legacyKickLookup(phase);
+        phase += increment;
+    }
+    uint32_t legacy_cycles = ESP.getCycleCount() - start;
+    printToneQuality("8비트 256 엔트리", osc_bench_buffer, OSC_BENCH_SAMPLES);
+    
+    // 16비트 보간 테이블
+    TR808SineOscillator osc;
+    osc.setIncrement(increment);
+    start = ESP.getCycleCount();
+    for (int i = 0; i < OSC_BENCH_SAMPLES; i++) {
+        osc_bench_buffer[i] = osc.next();
+    }
+    uint32_t interp_cycles = ESP.getCycleCount() - start;
+    printToneQuality("16비트 보간", osc_bench_buffer, OSC_BENCH_SAMPLES);
+    
+    Serial.printf("사이클/샘플: 이전 %.1f, 보간 %.1f\n",
+                  (float)legacy_cycles / OSC_BENCH_SAMPLES,
+                  (float)interp_cycles / OSC_BENCH_SAMPLES);
+    Serial.println();
+}
@@ -8,9 +8,10 @@
  * 버전: 1.0.0
  */
 
-#include "../src/mozzi_tr808_config.h"
-#include "../src/esp32c3_mozzi_integration.h"
-#include "../src/tr808_drums.h"
+#include "mozzi_tr808_config.h"
+#include "tr808_command_parser.h"
+#include "tr808_perf_monitor.h"
+#include "tr808_trace.h"
 
 // =============================================================================
 // 전역 인스턴스 생성
@@ -39,10 +40,9 @@ TR808DrumMachineMozzi::TR808DrumMachineMozzi() {
     memset(&systemStatus, 0, sizeof(systemStatus));
     systemStatus.masterVolume = masterVolume;
     
-    // 드럼 소스 포인터 초기화
-    for (int i = 0; i < TR808_NUM_SOURCES; i++) {
-        drumSources[i] = nullptr;
-    }
+    // 첫 updateAudio()에서 블록 렌더
+    memset(audioBlock, 0, sizeof(audioBlock));
+    blockPosition = MOZZI_RENDER_BLOCK_SIZE;
 }
 
 // =============================================================================
@@ -87,6 +87,9 @@ bool TR808DrumMachineMozzi::initializePerformanceMonitoring() {
     memset(&performance, 0, sizeof(performance));
     performance.maxPolyphony = MAX_POLYPHONY;
     
+    // 블록 렌더 사이클 부하 계측 (renderBlock 앞뒤 사이클 카운터 2회)
+    voices.enablePerformanceMode(true);
+    
     // 시스템 상태 업데이트
     systemStatus.performanceMonitoring = true;
     systemStatus.uptimeMs = millis();
@@ -98,39 +101,14 @@ bool TR808DrumMachineMozzi::initializePerformanceMonitoring() {
 bool TR808DrumMachineMozzi::initializeDrumSources() {
     Serial.println(F("🔧 드럼 소스 초기화..."));
     
-    // 드럼 소스별 초기화 (간단한 구현)
-    for (int i = 0; i < TR808_NUM_SOURCES; i++) {
-        switch (i) {
-            case TR808_KICK:
-                // Kick 드럼 초기화
-                drumSources[i] = new TR808Oscillator();
-                ((TR808Oscillator*)drumSources[i])->setFrequency(KICK_FREQUENCY);
-                break;
-                
-            case TR808_SNARE:
-                // Snare 드럼 초기화
-                drumSources[i] = new TR808Oscillator();
-                ((TR808Oscillator*)drumSources[i])->setFrequency(SNARE_FREQUENCY);
-                break;
-                
-            case TR808_HIHAT_CLOSED:
-            case TR808_HIHAT_OPEN:
-                // Hi-Hat 초기화
-                drumSources[i] = new TR808Oscillator();
-                ((TR808Oscillator*)drumSources[i])->setFrequency(HIHAT_FREQUENCY);
-                break;
-                
-            default:
-                // 기타 드럼 초기화
-                drumSources[i] = new TR808Oscillator();
-                ((TR808Oscillator*)drumSources[i])->setFrequency(100.0f);
-                break;
-        }
-        
-        TR808_DEBUG_PRINT(F("드럼 소스 "));
-        TR808_DEBUG_PRINT(i);
-        TR808_DEBUG_PRINTLN(F(" 초기화 완료"));
-    }
+    // 보이스 풀 초기화 (드럼별 기본 decay)
+    voices.begin();
+    voices.setKickDecay(KICK_DECAY_TIME);
+    voices.setSnareDecay(SNARE_DECAY_TIME);
+    voices.setHihatDecay(HIHAT_DECAY_TIME_CLOSED);
+    
+    TR808_DEBUG_PRINT(F("보이스 풀 초기화 완료: "));
+    TR808_DEBUG_PRINTLN(TR808_MAX_VOICES);
     
     return true;
 }
@@ -147,11 +125,6 @@ void TR808DrumMachineMozzi::triggerDrum(uint8_t drumType, float velocity) {
     // 벨로시티 검증
     velocity = constrain(velocity, 0.0f, 1.0f);
     
-    // 폴리포니 증가
-    if (performance.polyphony < performance.maxPolyphony) {
-        performance.polyphony++;
-    }
-    
     // 드럼 소스별 처리
     switch (drumType) {
         case TR808_KICK:
@@ -182,28 +155,31 @@ void TR808DrumMachineMozzi::triggerDrum(uint8_t drumType, float velocity) {
     TR808_DEBUG_PRINTLN(velocity);
 }
 
-void TR808DrumMachineMozzi::triggerDrum(const String& drumName, float velocity) {
-    // 드럼 이름 매핑
-    if (drumName == "kick") {
-        triggerDrum(TR808_KICK, velocity);
-    } else if (drumName == "snare") {
-        triggerDrum(TR808_SNARE, velocity);
-    } else if (drumName == "cymbal") {
-        triggerDrum(TR808_CYMBAL, velocity);
-    } else if (drumName == "hihat") {
-        triggerDrum(TR808_HIHAT_CLOSED, velocity);
-    } else if (drumName == "tom") {
-        triggerDrum(TR808_TOM_MID, velocity);
-    } else if (drumName == "conga") {
-        triggerDrum(TR808_CONGA_MID, velocity);
-    } else if (drumName == "rimshot") {
-        triggerDrum(TR808_RIMSHOT, velocity);
-    } else if (drumName == "maracas") {
-        triggerDrum(TR808_MARACAS, velocity);
-    } else if (drumName == "clap") {
-        triggerDrum(TR808_CLAW, velocity);
-    } else if (drumName == "cowbell") {
-        triggerDrum(TR808_COWBELL, velocity);
+// 드럼 이름 -> 소스 번호 (알 수 없으면 -1)
+// 해시가 맞아도 이름 문자열을 다시 비교 (해시만 충돌한 토큰은 알 수 없는 이름)
+static int drumSourceFromName(const char* name, size_t length) {
+#define DRUM_SOURCE(str, source) \
+        case TR808_CMD(str): return tr808TokenIs(name, length, str) ? (source) : -1
+    switch (tr808HashToken(name, length)) {
+        DRUM_SOURCE("kick",    TR808_KICK);
+        DRUM_SOURCE("snare",   TR808_SNARE);
+        DRUM_SOURCE("cymbal",  TR808_CYMBAL);
+        DRUM_SOURCE("hihat",   TR808_HIHAT_CLOSED);
+        DRUM_SOURCE("tom",     TR808_TOM_MID);
+        DRUM_SOURCE("conga",   TR808_CONGA_MID);
+        DRUM_SOURCE("rimshot", TR808_RIMSHOT);
+        DRUM_SOURCE("maracas", TR808_MARACAS);
+        DRUM_SOURCE("clap",    TR808_CLAW);
+        DRUM_SOURCE("cowbell", TR808_COWBELL);
+        default:               return -1;
+    }
+#undef DRUM_SOURCE
+}
+
+void TR808DrumMachineMozzi::triggerDrum(const char* drumName, float velocity) {
+    int source = drumSourceFromName(drumName, strlen(drumName));
+    if (source >= 0) {
+        triggerDrum((uint8_t)source, velocity);
     }
 }
 
@@ -270,14 +246,6 @@ void TR808DrumMachineMozzi::resumePattern() {
     TR808_DEBUG_PRINTLN(F("패턴 재개"));
 }
 
-// =============================================================================
-// 상태 확인 함수들
-// =============================================================================
-
-float TR808DrumMachineMozzi::getMasterVolume() const {
-    return masterVolume;
-}
-
 // =============================================================================
 // 정보 출력 함수들
 // =============================================================================
@@ -306,27 +274,33 @@ void TR808DrumMachineMozzi::printPerformanceReport() {
     uint32_t totalHeap = 32000; // ESP32C3 추정 총 메모리
     uint32_t memoryUsage = totalHeap - freeHeap;
     
-    Serial.print(F"💾 메모리 사용: ");
+    Serial.print(F("💾 메모리 사용: "));
     Serial.print(memoryUsage);
-    Serial.print(F" / ");
+    Serial.print(F(" / "));
     Serial.print(totalHeap);
     Serial.println(F(" bytes"));
     
-    Serial.print(F"🎭 현재 폴리포니: ");
+    // 블록 마감 대비 렌더 부하 (퍼밀 -> %)
+    const TR808LoadMeter& load = voices.getLoadMeter();
+    Serial.printf("⏱️ CPU 부하: 현재 %.1f%% / 평균 %.1f%% / 피크 %.1f%% (최대 %.1f%%, 마감 초과 %lu블록)\n",
+                  load.getLoad() / 10.0f, load.getAverage() / 10.0f, load.getPeak() / 10.0f,
+                  load.getMax() / 10.0f, (unsigned long)load.getOverruns());
+    
+    Serial.print(F("🎭 현재 폴리포니: "));
     Serial.print(performance.polyphony);
-    Serial.print(F" / ");
+    Serial.print(F(" / "));
     Serial.println(performance.maxPolyphony);
     
-    Serial.print(F"🔊 처리된 샘플: ");
+    Serial.print(F("🔊 처리된 샘플: "));
     Serial.println(performance.sampleCount);
     
-    Serial.print(F"⚠️ 드롭된 샘플: ");
+    Serial.print(F("⚠️ 드롭된 샘플: "));
     Serial.println(performance.dropCount);
     
-    Serial.print(F"🔄 버퍼 언더런: ");
+    Serial.print(F("🔄 버퍼 언더런: "));
     Serial.println(performance.bufferUnderruns);
     
-    Serial.print(F"📶 최종 메모리 사용률: "));
+    Serial.print(F("📶 최종 메모리 사용률: "));
     Serial.print((float)memoryUsage / totalHeap * 100.0f);
     Serial.println(F("%"));
 }
@@ -361,132 +335,163 @@ void TR808DrumMachineMozzi::printDrumList() {
 // Serial 명령 처리
 // =============================================================================
 
-bool TR808DrumMachineMozzi::processSerialCommand(const String& command) {
-    // 명령어 파싱
-    int spacePos = command.indexOf(' ');
-    String cmd = (spacePos > 0) ? command.substring(0, spacePos) : command;
-    String param = (spacePos > 0) ? command.substring(spacePos + 1) : "";
-    
-    cmd.trim();
-    param.trim();
-    
-    // 도움말 명령
-    if (cmd == "help" || cmd == "?") {
-        Serial.println(HELP_TEXT);
-        return true;
+static const char HELP_TEXT[] =
+    "\n📖 === 명령어 ===\n"
+    "kick|snare|cymbal|hihat|tom|conga|rimshot|maracas|clap|cowbell [벨로시티 0-1]\n"
+    "volume [0-1]        마스터 볼륨 (인자 없으면 현재 값)\n"
+    "pattern_demo | pattern_stop | pattern_pause | pattern_resume\n"
+    "status | list | patterns\n"
+    "test | reset | benchmark | version\n"
+    "help | ?";
+
+bool TR808DrumMachineMozzi::processSerialCommand(char* commandLine) {
+    // 명령어 파싱 (제자리 토큰화)
+    TR808CommandTokens tokens;
+    if (tokens.parse(commandLine) == 0) {
+        return false;
     }
     
+    uint32_t cmd = tokens.commandHash();
+    
     // 드럼 트리거 명령들
-    if (cmd == "kick" || cmd == "snare" || cmd == "cymbal" || cmd == "hihat" ||
-        cmd == "tom" || cmd == "conga" || cmd == "rimshot" || cmd == "maracas" ||
-        cmd == "clap" || cmd == "cowbell") {
-        
-        float velocity = VELOCITY_NORMAL;
-        if (param.length() > 0) {
-            velocity = param.toFloat();
+    int source = drumSourceFromName(tokens.get(0), tokens.length(0));
+    if (source >= 0) {
+        float velocity;
+        if (!tokens.getFloatOr(1, VELOCITY_NORMAL, &velocity)) {
+            return false;
         }
-        
-        triggerDrum(cmd, velocity);
+        triggerDrum((uint8_t)source, velocity);
         return true;
     }
     
-    // 볼륨 명령
-    if (cmd == "volume") {
-        if (param.length() > 0) {
-            float volume = param.toFloat();
-            setMasterVolume(volume);
-            Serial.print(F("마스터 볼륨 설정: "));
-            Serial.println(volume);
-        } else {
-            Serial.print(F("현재 마스터 볼륨: "));
-            Serial.println(masterVolume);
+    // 해시가 맞은 case마다 토큰 문자열을 다시 비교 (해시만 충돌한 토큰은 알 수 없는 명령)
+    switch (cmd) {
+        // 도움말 명령
+        case TR808_CMD("help"):
+        case TR808_CMD("?"):
+            if (!tokens.matches(0, "help", "?")) break;
+            Serial.println(HELP_TEXT);
+            return true;
+    
+        // 볼륨 명령
+        case TR808_CMD("volume"): {
+            if (!tokens.matches(0, "volume")) break;
+            float volume;
+            if (tokens.getFloat(1, &volume)) {
+                setMasterVolume(volume);
+                Serial.print(F("마스터 볼륨 설정: "));
+                Serial.println(volume);
+            } else {
+                Serial.print(F("현재 마스터 볼륨: "));
+                Serial.println(masterVolume);
+            }
+            return true;
         }
-        return true;
-    }
     
-    // 패턴 명령들
-    if (cmd == "pattern_demo") {
-        startPattern(0); // 첫 번째 패턴 시작
-        Serial.println(F("데모 패턴 재생 시작"));
-        return true;
-    }
+        // 패턴 명령들
+        case TR808_CMD("pattern_demo"): {
+            if (!tokens.matches(0, "pattern_demo")) break;
+            startPattern(0); // 첫 번째 패턴 시작
+            Serial.println(F("데모 패턴 재생 시작"));
+            return true;
+        }
     
-    if (cmd == "pattern_stop") {
-        stopPattern();
-        Serial.println(F("패턴 중지"));
-        return true;
-    }
+        case TR808_CMD("pattern_stop"): {
+            if (!tokens.matches(0, "pattern_stop")) break;
+            stopPattern();
+            Serial.println(F("패턴 중지"));
+            return true;
+        }
     
-    if (cmd == "pattern_pause") {
-        pausePattern();
-        Serial.println(F("패턴 일시중지"));
-        return true;
-    }
+        case TR808_CMD("pattern_pause"): {
+            if (!tokens.matches(0, "pattern_pause")) break;
+            pausePattern();
+            Serial.println(F("패턴 일시중지"));
+            return true;
+        }
     
-    if (cmd == "pattern_resume") {
-        resumePattern();
-        Serial.println(F("패턴 재개"));
-        return true;
-    }
+        case TR808_CMD("pattern_resume"): {
+            if (!tokens.matches(0, "pattern_resume")) break;
+            resumePattern();
+            Serial.println(F("패턴 재개"));
+            return true;
+        }
     
-    // 상태 명령들
-    if (cmd == "status") {
-        printSystemStatus();
-        printPerformanceReport();
-        return true;
-    }
+        // 상태 명령들
+        case TR808_CMD("status"): {
+            if (!tokens.matches(0, "status")) break;
+            printSystemStatus();
+            printPerformanceReport();
+            return true;
+        }
     
-    if (cmd == "list") {
-        printDrumList();
-        printPatternList();
-        return true;
-    }
+        case TR808_CMD("list"): {
+            if (!tokens.matches(0, "list")) break;
+            printDrumList();
+            printPatternList();
+            return true;
+        }
     
-    if (cmd == "patterns") {
-        printPatternList();
-        return true;
-    }
+        case TR808_CMD("patterns"): {
+            if (!tokens.matches(0, "patterns")) break;
+            printPatternList();
+            return true;
+        }
     
-    // 테스트 명령
-    if (cmd == "test") {
-        Serial.println(F("🔊 오디오 테스트 시작..."));
+        // 테스트 명령
+        case TR808_CMD("test"): {
+            if (!tokens.matches(0, "test")) break;
+            Serial.println(F("🔊 오디오 테스트 시작..."));
         
-        // 각 드럼을 순차적으로 재생
-        const char* testDrums[] = {"kick", "snare", "hihat", "tom"};
-        for (int i = 0; i < 4; i++) {
-            Serial.print(F("  ▶️ "));
-            Serial.println(testDrums[i]);
-            triggerDrum(testDrums[i], 0.7f);
-            delay(800);
-        }
+            // 각 드럼을 순차적으로 재생
+            const char* testDrums[] = {"kick", "snare", "hihat", "tom"};
+            for (int i = 0; i < 4; i++) {
+                Serial.print(F("  ▶️ "));
+                Serial.println(testDrums[i]);
+                triggerDrum(testDrums[i], 0.7f);
+                delay(800);
+            }
         
-        Serial.println(F("✅ 오디오 테스트 완료"));
-        return true;
-    }
+            Serial.println(F("✅ 오디오 테스트 완료"));
+            return true;
+        }
     
-    // 리셋 명령
-    if (cmd == "reset") {
-        Serial.println(F("🔄 시스템 리셋..."));
-        initialized = false;
-        audioActive = false;
-        stopPattern();
+        // 리셋 명령
+        case TR808_CMD("reset"): {
+            if (!tokens.matches(0, "reset")) break;
+            Serial.println(F("🔄 시스템 리셋..."));
+            initialized = false;
+            audioActive = false;
+            stopPattern();
         
-        // 재초기화
-        if (initialize()) {
-            Serial.println(F("✅ 시스템 리셋 완료"));
-        } else {
-            Serial.println(F("❌ 시스템 리셋 실패"));
+            // 재초기화
+            if (initialize()) {
+                Serial.println(F("✅ 시스템 리셋 완료"));
+            } else {
+                Serial.println(F("❌ 시스템 리셋 실패"));
+            }
+            return true;
         }
-        return true;
-    }
     
-    // 버전 명령
-    if (cmd == "version" || cmd == "ver") {
-        Serial.print(F("Mozzi TR-808 ESP32C3 v"));
-        Serial.println(MOZZI_TR808_VERSION);
-        return true;
-    }
+        // 처리량 벤치마크
+        case TR808_CMD("benchmark"): {
+            if (!tokens.matches(0, "benchmark")) break;
+            runThroughputBenchmark();
+            return true;
+        }
+    
+        // 버전 명령
+        case TR808_CMD("version"):
+        case TR808_CMD("ver"): {
+            if (!tokens.matches(0, "version", "ver")) break;
+            Serial.print(F("Mozzi TR-808 ESP32C3 v"));
+            Serial.println(MOZZI_TR808_VERSION);
+            return true;
+        }
     
+        default:
+            break;
+    }
     return false;
 }
 
@@ -495,6 +500,15 @@ bool TR808DrumMachineMozzi::processSerialCommand(const String& command) {
 // =============================================================================
 
 void TR808DrumMachineMozzi::updateControl() {
+    // 보이스 엔벨로프/필터 컨트롤 레이트 갱신
+    tr808Perf.startControlUpdate();
+    TR808_TRACE_EVENT(TR808_TRACE_CONTROL_BEGIN, 0);
+    voices.update();
+    TR808_TRACE_EVENT(TR808_TRACE_CONTROL_END, 0);
+    tr808Perf.endControlUpdate();
+    performance.polyphony = voices.getActiveVoiceCount();
+    tr808Perf.updateVoiceCount(performance.polyphony);
+    
     // 성능 메트릭 업데이트
     updatePerformanceMetrics();
     
@@ -520,37 +534,68 @@ void TR808DrumMachineMozzi::updateControl() {
     }
 }
 
+void TR808DrumMachineMozzi::renderNextBlock() {
+    // 마스터 볼륨은 블록 단위로 한 번만 변환
+    int32_t gainQ15 = (int32_t)(masterVolume * 32767.0f);
+    tr808Perf.beginBlock();
+    voices.renderBlock(audioBlock, MOZZI_RENDER_BLOCK_SIZE, gainQ15);
+    tr808Perf.endBlock(MOZZI_RENDER_BLOCK_SIZE);
+    blockPosition = 0;
+    performance.sampleCount += MOZZI_RENDER_BLOCK_SIZE;
+}
+
 int16_t TR808DrumMachineMozzi::updateAudio() {
-    static int16_t lastSample = 0;
-    
-    // 간단한 드럼 합성 (실제 구현에서는 더 복잡한 신세시스 필요)
-    int32_t mixedSample = 0;
-    
-    // 마스터 볼륨 적용
-    mixedSample = (int32_t)(lastSample * masterVolume * 32767.0f);
-    
-    // 클리핑 방지
-    if (mixedSample > 32767) mixedSample = 32767;
-    if (mixedSample < -32768) mixedSample = -32768;
-    
-    // 성능 메트릭 업데이트
-    performance.sampleCount++;
-    
-    // 폴리포니 감소 (간단한 방법)
-    if (performance.polyphony > 0) {
-        performance.polyphony--;
+    // 오디오 콜백은 샘플 단위, 보이스 렌더는 블록 단위
+    if (blockPosition >= MOZZI_RENDER_BLOCK_SIZE) {
+        renderNextBlock();
     }
-    
-    // 랜덤한 드럼 소스 생성 (데모용)
-    if (random(0, 1000) < 5) { // 0.5% 확률로 드럼 발생
-        int drumType = random(0, 5); // 5개 기본 드럼만 사용
-        float velocity = random(30, 100) / 100.0f;
-        triggerDrum(drumType, velocity);
+    return audioBlock[blockPosition++];
+}
+
+void TR808DrumMachineMozzi::runThroughputBenchmark() {
+    Serial.println(F("\n⏱️ === 보이스 처리량 벤치마크 ==="));
+    
+    static int16_t benchBlock[MOZZI_RENDER_BLOCK_SIZE];
+    const uint32_t samples = (uint32_t)MOZZI_BENCHMARK_BLOCKS * MOZZI_RENDER_BLOCK_SIZE;
+    const int32_t gainQ15 = (int32_t)(masterVolume * 32767.0f);
+    uint32_t cyclesPerSample[TR808_MAX_VOICES + 1];
+    
+    for (uint8_t active = 0; active <= TR808_MAX_VOICES; active++) {
+        // 그룹을 돌아가며 active개 보이스 트리거
+        voices.stopAll();
+        for (uint8_t v = 0; v < active; v++) {
+            switch (v % 4) {
+                case TR808_GROUP_KICK:   voices.triggerKick();   break;
+                case TR808_GROUP_SNARE:  voices.triggerSnare();  break;
+                case TR808_GROUP_CYMBAL: voices.triggerCymbal(); break;
+                default:                 voices.triggerHihat();  break;
+            }
+        }
+        
+        uint32_t start = ESP.getCycleCount();
+        for (uint16_t b = 0; b < MOZZI_BENCHMARK_BLOCKS; b++) {
+            voices.renderBlock(benchBlock, MOZZI_RENDER_BLOCK_SIZE, gainQ15);
+        }
+        cyclesPerSample[active] = (ESP.getCycleCount() - start) / samples;
+        
+        Serial.printf("보이스 %u개: %lu 사이클/샘플\n", active, (unsigned long)cyclesPerSample[active]);
     }
+    voices.stopAll();
     
-    lastSample = (int16_t)(mixedSample / 32768.0f * 2000.0f); // 샘플 스케일 조정
+    // 보이스당 비용 = (최대 보이스 - 무음) / 보이스 수
+    uint32_t baseCycles = cyclesPerSample[0];
+    uint32_t perVoice = (cyclesPerSample[TR808_MAX_VOICES] - baseCycles) / TR808_MAX_VOICES;
+    if (perVoice == 0) perVoice = 1;
     
-    return lastSample;
+    // 비교 대상 레이트 (빌드 레이트와 무관하게 고정)
+    const uint32_t rates[2] = { 32768, 64000 };
+    uint32_t cpuHz = ESP.getCpuFreqMHz() * 1000000UL;
+    for (int i = 0; i < 2; i++) {
+        uint32_t budget = cpuHz / rates[i];
+        uint32_t fit = budget > baseCycles ? (budget - baseCycles) / perVoice : 0;
+        Serial.printf("%lu Hz: 샘플당 %lu 사이클, 최대 보이스 약 %lu개\n",
+                      (unsigned long)rates[i], (unsigned long)budget, (unsigned long)fit);
+    }
 }
 
 // =============================================================================
@@ -558,6 +603,9 @@ int16_t TR808DrumMachineMozzi::updateAudio() {
 // =============================================================================
 
 void TR808DrumMachineMozzi::updatePerformanceMetrics() {
+    // 평균 블록 부하 (%)
+    performance.cpuUsage = voices.getLoadMeter().getAverage() / 10.0f;
+    
     // 메모리 사용량 업데이트
     performance.memoryUsage = ESP.getFreeHeap();
     
@@ -568,41 +616,43 @@ void TR808DrumMachineMozzi::updatePerformanceMetrics() {
 }
 
 void TR808DrumMachineMozzi::processDrumSource(uint8_t source, float velocity) {
-    if (source >= TR808_NUM_SOURCES || drumSources[source] == nullptr) {
+    if (source >= TR808_NUM_SOURCES || velocity <= 0.0f) {
         return;
     }
     
-    // 실제 드럼 소스 처리 (간단한 구현)
-    TR808Oscillator* osc = (TR808Oscillator*)drumSources[source];
-    
-    // 주파수별 드럼 처리
+    // 18개 드럼 소스를 보이스 풀의 4개 그룹으로 매핑
     switch (source) {
-        case TR808_KICK:
-            osc->setFrequency(KICK_FREQUENCY);
-            osc->setAmplitude(velocity * KICK_PUNCH_GAIN);
+        case TR808_SNARE:
+        case TR808_RIMSHOT:
+        case TR808_CLAW:
+        case TR808_ClAP:
+            voices.triggerSnare(velocity);
             break;
             
-        case TR808_SNARE:
-            osc->setFrequency(SNARE_FREQUENCY);
-            osc->setAmplitude(velocity);
+        case TR808_CYMBAL:
+        case TR808_COWBELL:
+        case TR808_CRASH:
+            voices.triggerCymbal(velocity);
             break;
             
         case TR808_HIHAT_CLOSED:
+        case TR808_MARACAS:
+        case TR808_SHAKER:
+            voices.triggerHihat(false, velocity);
+            break;
+            
         case TR808_HIHAT_OPEN:
-            osc->setFrequency(HIHAT_FREQUENCY);
-            osc->setAmplitude(velocity * 0.6f);
+            voices.triggerHihat(true, velocity);
             break;
             
         default:
-            osc->setFrequency(100.0f + source * 10.0f);
-            osc->setAmplitude(velocity);
+            // 킥, 톰, 콩가 (사인 기반)
+            voices.triggerKick(velocity);
             break;
     }
     
     TR808_DEBUG_PRINT(F("드럼 소스 처리: "));
     TR808_DEBUG_PRINT(source);
-    TR808_DEBUG_PRINT(F(", 주파수: "));
-    TR808_DEBUG_PRINT(osc->frequency());
     TR808_DEBUG_PRINT(F(", 볼륨: "));
     TR808_DEBUG_PRINTLN(velocity);
 }
@@ -655,14 +705,6 @@ void TR808DrumMachineMozzi::loadDefaultPatterns() {
     TR808_DEBUG_PRINTLN(F("기본 패턴 로드 완료"));
 }
 
-// =============================================================================
-// 추가 getter 함수들 (헤더에서 선언되지 않은 함수들)
-// =============================================================================
-
-float TR808DrumMachineMozzi::getFrequency() const {
-    return 100.0f; // 기본 주파수
-}
-
 // =============================================================================
 // Arduino 호환성 함수들
 // =============================================================================
@@ -671,7 +713,7 @@ float TR808DrumMachineMozzi::getFrequency() const {
 void audioWrite(int16_t output) {
     // PWM 출력 (GPIO 18) - 8-bit 변환
     uint8_t pwmValue = constrain((output + 32768) >> 8, 0, 255);
-    analogWrite(AUDIO_OUTPUT_CHANNEL, pwmValue);
+    analogWrite(AUDIO_OUTPUT_PIN, pwmValue);
     
     // I2S 출력 (필요시 활성화)
     #ifdef USE_I2S_OUTPUT
@@ -689,4 +731,3 @@ void audioWrite(int16_t output) {
     }
     #endif
 }
-}
\ No newline at end of file
@@ -0,0 +1,135 @@
+/*
+ * TR-808 시작 메모리 아레나
+ *
+ * 엔진 상태(블록 버퍼, 보이스 풀, 패턴 저장, 트레이스 링 등)를 정적 저장소 하나에서 잘라 쓰는 선형 할당기
+ * - 할당은 setup()에서 예산 표 순서대로 한 번만, seal() 이후 할당은 실패 (오디오 경로 힙 사용 금지)
+ * - 해제 없음: 수명이 프로그램 전체인 상태만 둠
+ * - 예산 표(TR808ArenaBudget 배열)는 constexpr: 합계(정렬 패딩 포함)를 static_assert로 검사해
+ *   환경별 상한(TR808_ARENA_LIMIT_BYTES, platformio.ini -D)을 넘으면 빌드 실패
+ * - 소비자 이름/오프셋/크기를 기록해 런타임 보고 ('memory' 명령)
+ *
+ * 작성일: 2025-10-30
+ * 호환성: ESP32C3 Arduino / 호스트 (extras/host)
+ */
+
+#ifndef TR808_ARENA_H
+#define TR808_ARENA_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+// ============================================
+// 아레나 설정
+// ============================================
+
+#define TR808_ARENA_MAX_CONSUMERS   16      // 보고용 소비자 기록 수
+#define TR808_ARENA_DEFAULT_ALIGN   4       // 워드 정렬 (RV32)
+#define TR808_ARENA_STORAGE_ALIGN   16      // 저장소 시작 정렬 (DMA 디스크립터 버퍼 포함)
+
+#ifndef TR808_ARENA_LIMIT_BYTES
+#define TR808_ARENA_LIMIT_BYTES     16384   // 환경별 상한 (platformio.ini에서 -DTR808_ARENA_LIMIT_BYTES로 변경)
+#endif
+
+// ============================================
+// 컴파일 타임 예산 표
+// ============================================
+
+struct TR808ArenaBudget {
+    const char* name;
+    uint32_t bytes;                     // 0이면 이 빌드에서 사용 안 함 (건너뜀)
+    uint16_t align;                     // 2의 거듭제곱
+};
+
+constexpr uint32_t tr808ArenaAlignUp(uint32_t offset, uint32_t align) {
+    return (offset + align - 1) & ~(align - 1);
+}
+
+// 표 순서대로 배치했을 때의 전체 크기 (정렬 패딩 포함, C++11 constexpr라 재귀)
+constexpr uint32_t tr808ArenaTotal(const TR808ArenaBudget* table, uint32_t count, uint32_t offset = 0) {
+    return count == 0 ? offset
+         : tr808ArenaTotal(table + 1, count - 1,
+                           table->bytes == 0 ? offset : tr808ArenaAlignUp(offset, table->align) + table->bytes);
+}
+
+struct TR808ArenaConsumer {
+    const char* name;
+    uint32_t offset;
+    uint32_t bytes;
+};
+
+// ============================================
+// 아레나
+// ============================================
+
+/**
+ * 정적 저장소 위의 선형 할당기 (setup() 전용, 단일 스레드)
+ * 저장소는 호출자가 정적 배열로 제공: alignas(TR808_ARENA_STORAGE_ALIGN) static uint8_t[tr808ArenaTotal(...)]
+ */
+class TR808Arena {
+private:
+    uint8_t* base;
+    uint32_t capacity;
+    uint32_t used;
+    bool sealed;
+    uint16_t failures;                  // 공간 부족 / 봉인 후 요청 수
+    uint8_t consumerCount;
+    TR808ArenaConsumer consumers[TR808_ARENA_MAX_CONSUMERS];
+
+public:
+    TR808Arena() : base(nullptr), capacity(0), used(0), sealed(false), failures(0), consumerCount(0) {}
+
+    void begin(void* storage, uint32_t bytes) {
+        base = (uint8_t*)storage;
+        capacity = bytes;
+        used = 0;
+        sealed = false;
+        failures = 0;
+        consumerCount = 0;
+    }
+
+    /**
+     * 정렬된 영역 하나 할당 (0으로 초기화)
+     * 반환: 실패(공간 부족, 봉인됨) 또는 bytes == 0이면 nullptr
+     */
+    void* allocate(const char* name, uint32_t bytes, uint16_t align = TR808_ARENA_DEFAULT_ALIGN) {
+        if (bytes == 0) return nullptr;
+        uint32_t offset = tr808ArenaAlignUp(used, align);
+        if (sealed || base == nullptr || offset + bytes > capacity) {
+            failures++;
+            return nullptr;
+        }
+        used = offset + bytes;
+        if (consumerCount < TR808_ARENA_MAX_CONSUMERS) {
+            consumers[consumerCount].name = name;
+            consumers[consumerCount].offset = offset;
+            consumers[consumerCount].bytes = bytes;
+            consumerCount++;
+        }
+        memset(base + offset, 0, bytes);
+        return base + offset;
+    }
+
+    // 예산 표 항목 하나 할당 (표 순서대로 호출하면 오프셋이 tr808ArenaTotal 계산과 일치)
+    void* allocate(const TR808ArenaBudget& entry) {
+        return allocate(entry.name, entry.bytes, entry.align);
+    }
+
+    template <typename T>
+    T* allocateArray(const char* name, uint32_t count) {
+        return (T*)allocate(name, (uint32_t)(sizeof(T) * count),
+                            alignof(T) > TR808_ARENA_DEFAULT_ALIGN ? alignof(T) : TR808_ARENA_DEFAULT_ALIGN);
+    }
+
+    // setup() 끝에서 호출: 이후 할당은 모두 실패로 집계
+    void seal() { sealed = true; }
+    bool isSealed() const { return sealed; }
+
+    uint32_t getUsed() const { return used; }
+    uint32_t getCapacity() const { return capacity; }
+    uint16_t getFailures() const { return failures; }
+    uint8_t getConsumerCount() const { return consumerCount; }
+    const TR808ArenaConsumer& getConsumer(uint8_t index) const { return consumers[index]; }
+};
+
+#endif // TR808_ARENA_H
@@ -0,0 +1,160 @@
+#include "tr808_command_parser.h"
+
+// ================ 해시 ================
+
+uint32_t tr808HashToken(const char* s, size_t length) {
+    uint32_t hash = (uint32_t)TR808_FNV_OFFSET;
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash ^ (uint8_t)s[i]) * (uint32_t)TR808_FNV_PRIME;
+    }
+    return hash;
+}
+
+bool tr808TokenIs(const char* s, size_t length, const char* name) {
+    for (size_t i = 0; i < length; i++) {
+        if (name[i] != s[i]) return false;  // name이 먼저 끝나면 '\0' != s[i]
+    }
+    return name[length] == '\0';
+}
+
+// ================ 숫자 파싱 ================
+
+bool tr808ParseInt(const char* s, int32_t* out) {
+    bool negative = false;
+    if (*s == '+' || *s == '-') {
+        negative = (*s == '-');
+        s++;
+    }
+    if (*s == '\0') return false;
+
+    int64_t value = 0;
+    while (*s != '\0') {
+        if (*s < '0' || *s > '9') return false;
+        value = value * 10 + (*s - '0');
+        if (value > 2147483648LL) return false; // 오버플로
+        s++;
+    }
+
+    if (negative) value = -value;
+    if (value > 2147483647LL) return false;
+    *out = (int32_t)value;
+    return true;
+}
+
+bool tr808ParseFloat(const char* s, float* out) {
+    bool negative = false;
+    if (*s == '+' || *s == '-') {
+        negative = (*s == '-');
+        s++;
+    }
+
+    // 정수부/소수부를 하나의 가수로 누적 (유효 9자리까지)
+    uint32_t mantissa = 0;
+    int8_t digits = 0;
+    int16_t exponent = 0;
+    bool anyDigit = false;
+
+    while (*s >= '0' && *s <= '9') {
+        if (digits < 9) {
+            mantissa = mantissa * 10 + (uint32_t)(*s - '0');
+            if (mantissa != 0) digits++;
+        } else {
+            exponent++;
+        }
+        anyDigit = true;
+        s++;
+    }
+
+    if (*s == '.') {
+        s++;
+        while (*s >= '0' && *s <= '9') {
+            if (digits < 9) {
+                mantissa = mantissa * 10 + (uint32_t)(*s - '0');
+                if (mantissa != 0) digits++;
+                exponent--;
+            }
+            anyDigit = true;
+            s++;
+        }
+    }
+
+    if (!anyDigit) return false;
+
+    if (*s == 'e' || *s == 'E') {
+        s++;
+        int32_t explicitExponent;
+        if (!tr808ParseInt(s, &explicitExponent) ||
+            explicitExponent < -45 || explicitExponent > 38) {
+            return false;
+        }
+        exponent += (int16_t)explicitExponent;
+    } else if (*s != '\0') {
+        return false;
+    }
+
+    // 10의 거듭제곱 적용 (제곱 분해로 곱셈 횟수 최소화)
+    float value = (float)mantissa;
+    float scale = 1.0f;
+    float power = 10.0f;
+    int16_t e = exponent < 0 ? -exponent : exponent;
+    while (e > 0) {
+        if (e & 1) scale *= power;
+        power *= power;
+        e >>= 1;
+    }
+    value = exponent < 0 ? value / scale : value * scale;
+
+    *out = negative ? -value : value;
+    return true;
+}
+
+// ================ TR808CommandTokens 구현 ================
+
+uint8_t TR808CommandTokens::parse(char* line) {
+    count = 0;
+    char* p = line;
+
+    while (*p != '\0') {
+        // 구분자 건너뛰기
+        while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') {
+            *p++ = '\0';
+        }
+        if (*p == '\0') break;
+
+        if (count == TR808_CMD_MAX_TOKENS) {
+            break; // 초과 토큰 무시
+        }
+
+        char* start = p;
+        while (*p != '\0' && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n') {
+            if (*p >= 'A' && *p <= 'Z') *p = (char)(*p + ('a' - 'A'));
+            p++;
+        }
+
+        size_t tokenLength = (size_t)(p - start);
+        tokens[count] = start;
+        lengths[count] = tokenLength > 255 ? 255 : (uint8_t)tokenLength;
+        count++;
+    }
+    return count;
+}
+
+uint32_t TR808CommandTokens::commandHash() const {
+    return count > 0 ? tr808HashToken(tokens[0], lengths[0]) : 0;
+}
+
+bool TR808CommandTokens::getFloat(uint8_t index, float* out) const {
+    return index < count && tr808ParseFloat(tokens[index], out);
+}
+
+bool TR808CommandTokens::getInt(uint8_t index, int32_t* out) const {
+    return index < count && tr808ParseInt(tokens[index], out);
+}
+
+bool TR808CommandTokens::getFloatOr(uint8_t index, float defaultValue, float* out) const {
+    if (index >= count) {
+        *out = defaultValue;
+        return true;
+    }
+    return tr808ParseFloat(tokens[index], out);
+}
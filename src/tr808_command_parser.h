@@ -0,0 +1,122 @@
+/*
+ * TR-808 텍스트 명령 파서 (힙 할당 없음)
+ *
+ * String/substring/toFloat 기반 명령 처리는 명령마다 힙 할당을 반복해
+ * 오디오 실행 중 힙 단편화와 지연 스파이크를 유발하므로,
+ * 고정 char 버퍼 위에서 동작하는 토크나이저와 숫자 파서를 제공
+ * - 토큰은 입력 버퍼를 제자리에서 분할 (복사/할당 없음)
+ * - 명령 조회는 컴파일 타임 FNV-1a 해시에 대한 switch 분기
+ *   (알려진 명령끼리의 해시 충돌은 case 라벨 중복으로 컴파일 오류)
+ * - 알 수 없는 토큰도 어떤 명령과 해시가 같을 수 있으므로,
+ *   case 진입 후 matches()로 문자열을 비교해 다르면 default 경로로
+ * - 정수/실수 파싱은 strtod/atof 없이 직접 처리
+ *
+ * 사용 예:
+ *   TR808CommandTokens tokens;
+ *   tokens.parse(line);
+ *   switch (tokens.commandHash()) {
+ *       case TR808_CMD("kick"): case TR808_CMD("k"):
+ *           if (!tokens.matches(0, "kick", "k")) break;  // 해시만 같은 토큰 거부
+ *           ...
+ *   }
+ *
+ * 작성일: 2025-10-30
+ * 호환성: ESP32C3 Arduino / 호스트 (C++11)
+ */
+
+#ifndef TR808_COMMAND_PARSER_H
+#define TR808_COMMAND_PARSER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define TR808_CMD_MAX_TOKENS    6       // 명령 + 인자 최대 토큰 수
+
+// ============================================
+// 컴파일 타임 해시 (FNV-1a 32bit)
+// ============================================
+
+#define TR808_FNV_OFFSET  2166136261UL
+#define TR808_FNV_PRIME   16777619UL
+
+// C++11 constexpr 제약 때문에 단일 return 재귀 형태로 작성
+constexpr uint32_t tr808HashStep(const char* s, uint32_t hash) {
+    return *s == '\0' ? hash
+                      : tr808HashStep(s + 1, (uint32_t)((hash ^ (uint8_t)*s) * TR808_FNV_PRIME));
+}
+
+constexpr uint32_t tr808Hash(const char* s) {
+    return tr808HashStep(s, (uint32_t)TR808_FNV_OFFSET);
+}
+
+// switch case 라벨용 매크로
+#define TR808_CMD(name) tr808Hash(name)
+
+// 런타임 해시 (길이 지정, 토큰용)
+uint32_t tr808HashToken(const char* s, size_t length);
+
+// 토큰(길이 지정)이 이름과 정확히 같은지 (해시 일치 후 확인)
+bool tr808TokenIs(const char* s, size_t length, const char* name);
+
+// ============================================
+// 숫자 파싱 (힙/로케일 무관)
+// ============================================
+
+/**
+ * 10진 정수 파싱 (부호 허용, 전체 토큰이 숫자여야 성공)
+ */
+bool tr808ParseInt(const char* s, int32_t* out);
+
+/**
+ * 실수 파싱: [+-]digits[.digits][e[+-]digits]
+ * 드럼 파라미터 범위에서 float 정밀도로 충분
+ */
+bool tr808ParseFloat(const char* s, float* out);
+
+// ============================================
+// 토크나이저
+// ============================================
+
+/**
+ * 명령 줄 토크나이저
+ * 입력 버퍼를 제자리에서 소문자 변환 및 공백 분할
+ */
+class TR808CommandTokens {
+private:
+    char* tokens[TR808_CMD_MAX_TOKENS];
+    uint8_t lengths[TR808_CMD_MAX_TOKENS];
+    uint8_t count;
+
+public:
+    TR808CommandTokens() : count(0) {}
+
+    // 버퍼를 수정함 (구분자 위치에 '\0' 기록)
+    uint8_t parse(char* line);
+
+    uint8_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    const char* get(uint8_t index) const { return index < count ? tokens[index] : ""; }
+    uint8_t length(uint8_t index) const { return index < count ? lengths[index] : 0; }
+
+    // 첫 토큰(명령) 해시 - 빈 줄이면 0
+    uint32_t commandHash() const;
+
+    // index 토큰이 이름(별칭 중 하나)과 정확히 같은지 - 해시 case 진입 후 충돌 배제용
+    bool matches(uint8_t index, const char* name) const {
+        return index < count && tr808TokenIs(tokens[index], lengths[index], name);
+    }
+    template <typename... Names>
+    bool matches(uint8_t index, const char* name, Names... aliases) const {
+        return matches(index, name) || matches(index, aliases...);
+    }
+
+    // 인자 파싱 (없거나 형식 오류면 false)
+    bool getFloat(uint8_t index, float* out) const;
+    bool getInt(uint8_t index, int32_t* out) const;
+
+    // 선택 인자: 없으면 기본값, 형식 오류면 false
+    bool getFloatOr(uint8_t index, float defaultValue, float* out) const;
+};
+
+#endif // TR808_COMMAND_PARSER_H
@@ -0,0 +1,113 @@
+/*
+ * TR-808 DMA 블록 링 (핑퐁 출력 버퍼 관리)
+ *
+ * 샘플마다 타이머 ISR을 띄우는 대신 DMA가 블록 단위로 출력하고,
+ * 블록 하나가 끝날 때(2블록 링이면 링 절반 완료) 렌더 태스크를 깨워 다음 블록을 채우는 구조의 장부
+ * - DMA 쪽: 블록 완료(EOF)마다 onBlockComplete() 1회 (ISR 또는 드라이버 이벤트)
+ *   소비자가 직접 블록 내용을 고르는 경우(PWM 샘플 ISR) 재생 시작 시 isSubmitted()로 제출 여부 확인
+ * - 렌더 쪽: freeBlocks()로 채울 블록 수 확인 -> writeIndex()에 렌더 -> commit()
+ * - DMA가 재생 중인 블록은 항상 DMA 소유: 빈 블록 수는 최대 블록 수 - 1
+ * - 언더런: 재생을 시작한 블록이 아직 제출되지 않았거나(늦은 렌더) 늦게 제출된 경우 블록 단위로 집계,
+ *   렌더 위치는 재생 중인 블록 다음으로 재동기화 (늦은 블록은 버림)
+ * - 버퍼 자체는 소유하지 않음: 장치 드라이버(extras/dma_output_esp32c3.cpp, extras/audio_output_esp32c3.cpp)와
+ *   호스트 DMA 모델(extras/host/dma_model.cpp)이 같은 장부를 공유
+ *
+ * 작성일: 2025-10-30
+ * 호환성: ESP32C3 Arduino / 호스트 (extras/host)
+ */
+
+#ifndef TR808_DMA_RING_H
+#define TR808_DMA_RING_H
+
+#include <stdint.h>
+
+// ============================================
+// DMA 링 설정
+// ============================================
+
+#define TR808_DMA_MAX_BLOCKS    8       // 링 블록 수 상한 (2 = 핑퐁)
+
+// ============================================
+// DMA 블록 링
+// ============================================
+
+/**
+ * 블록 번호 장부 (단일 DMA 소비자, 단일 렌더 생산자)
+ * 블록 번호는 0부터 증가하는 전체 순번, 슬롯 = 번호 % 블록 수
+ */
+class TR808DmaRing {
+private:
+    uint8_t blocks;
+    volatile uint32_t completed;        // DMA가 재생을 끝낸 블록 수 = 지금 재생 중인 블록 번호
+    uint32_t submitted;                 // 제출(또는 건너뜀)한 블록 수 = 다음에 채울 블록 번호
+    uint32_t underruns;                 // 제출 없이(또는 늦게) 재생된 블록 수
+    uint32_t lateCommits;               // 그중 렌더가 재생 시작 뒤에 끝난 블록 수
+
+    // 재생 중인 블록이 제출되지 않았으면 그 블록까지 버리고 다음 블록부터 채움
+    inline void resync() {
+        uint32_t playing = completed;
+        if ((int32_t)(submitted - playing) <= 0) {
+            underruns += playing - submitted + 1;
+            __atomic_store_n(&submitted, playing + 1, __ATOMIC_RELEASE);
+        }
+    }
+
+public:
+    TR808DmaRing() : blocks(2), completed(0), submitted(0), underruns(0), lateCommits(0) {}
+
+    /**
+     * DMA 시작 전 초기화
+     * prefilled: 시작 시 이미 채워 둔 블록 수 (무음 포함, 보통 blockCount)
+     */
+    void begin(uint8_t blockCount, uint8_t prefilled) {
+        if (blockCount < 2) blockCount = 2;
+        if (blockCount > TR808_DMA_MAX_BLOCKS) blockCount = TR808_DMA_MAX_BLOCKS;
+        if (prefilled > blockCount) prefilled = blockCount;
+        if (prefilled == 0) prefilled = 1;  // 재생 시작 블록은 DMA 소유
+        blocks = blockCount;
+        completed = 0;
+        submitted = prefilled;
+        underruns = 0;
+        lateCommits = 0;
+    }
+
+    // DMA 블록 완료 (ISR/드라이버 이벤트 컨텍스트, 단일 호출자)
+    inline void onBlockComplete() { completed = completed + 1; }
+
+    // 지금 채울 수 있는 블록 수 (재동기화 포함)
+    inline uint8_t freeBlocks() {
+        resync();
+        return (uint8_t)(blocks - (submitted - completed));
+    }
+
+    inline uint32_t nextBlock() const { return submitted; }
+    inline uint8_t writeIndex() const { return (uint8_t)(submitted % blocks); }
+
+    /**
+     * 렌더한 블록 제출
+     * 반환: 제때 제출했으면 true, 렌더 도중 DMA가 이미 그 블록 재생을 시작했으면 false (언더런)
+     */
+    inline bool commit() {
+        bool onTime = (int32_t)(submitted - completed) > 0;
+        if (!onTime) {
+            underruns++;
+            lateCommits++;
+        }
+        // 블록 내용 기록 후 공개 (소비자 ISR이 isSubmitted()로 읽음)
+        __atomic_store_n(&submitted, submitted + 1, __ATOMIC_RELEASE);
+        return onTime;
+    }
+
+    // 소비자 쪽: block 번호가 제출됐는지 (재생 시작 시 확인, 아니면 무음 재생)
+    inline bool isSubmitted(uint32_t block) const {
+        return (int32_t)(__atomic_load_n(&submitted, __ATOMIC_ACQUIRE) - block) > 0;
+    }
+
+    uint8_t getBlocks() const { return blocks; }
+    uint32_t getCompleted() const { return completed; }
+    uint32_t getSubmitted() const { return submitted; }
+    uint32_t getUnderruns() const { return underruns; }
+    uint32_t getLateCommits() const { return lateCommits; }
+};
+
+#endif // TR808_DMA_RING_H
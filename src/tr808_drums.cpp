@@ -1,17 +1,33 @@
 #include "tr808_drums.h"
 
+// 빌드 레이트로 시작 (정적 초기화 순서와 무관하도록 집합 초기화)
+TR808RuntimeRate tr808Rate = {
+    TR808AudioRate::rate, TR808AudioRate::samplePeriod, TR808AudioRate::radiansPerHz,
+    TR808_CONTROL_INTERVAL, 1.0f / TR808_CONTROL_INTERVAL,
+    (uint32_t)((uint64_t)TR808_CONTROL_INTERVAL * 1000000UL / TR808AudioRate::rate)
+};
+
+// C++11에는 constinit이 없으므로 보이스 기본 상태가 상수 식인지 여기서 확인
+// (생성자에 런타임 계산이 들어가면 빌드 실패: 전역 엔진이 부팅 시 생성자를 실행하게 됨)
+template <typename Voice>
+constexpr bool tr808ConstantDefault(Voice) { return true; }
+
+static_assert(tr808ConstantDefault(TR808Kick()) && tr808ConstantDefault(TR808Snare()) &&
+              tr808ConstantDefault(TR808Cymbal()) && tr808ConstantDefault(TR808HiHat()) &&
+              tr808ConstantDefault(TR808Tom()) && tr808ConstantDefault(TR808Conga()) &&
+              tr808ConstantDefault(TR808Rimshot()) && tr808ConstantDefault(TR808Maracas()) &&
+              tr808ConstantDefault(TR808Clap()) && tr808ConstantDefault(TR808Cowbell()),
+              "보이스 기본 상태가 컴파일 타임 상수가 아님");
+
 // ================ TR808Oscillator 구현 ================
 
-TR808Oscillator::TR808Oscillator() {
-    frequency = 440.0f;
-    phase = 0.0f;
-    phaseIncrement = 0.0f;
-    amplitude = 1.0f;
+TR808_HOT void TR808Oscillator::setFrequency(float freq) {
+    frequency = freq;
+    phaseIncrement = frequency * tr808Rate.radiansPerHz;
 }
 
-void TR808Oscillator::setFrequency(float freq) {
-    frequency = freq;
-    phaseIncrement = TWO_PI * frequency / MAX_SAMPLE_RATE;
+void TR808Oscillator::updateRate() {
+    setFrequency(frequency);
 }
 
 void TR808Oscillator::setAmplitude(float amp) {
@@ -22,38 +38,72 @@ void TR808Oscillator::resetPhase() {
     phase = 0.0f;
 }
 
-void TR808Oscillator::updatePhase() {
+TR808_HOT void TR808Oscillator::updatePhase() {
     phase += phaseIncrement;
     if (phase >= TWO_PI) {
         phase -= TWO_PI;
     }
 }
 
-float TR808Oscillator::generateSine() {
+TR808_HOT float TR808Oscillator::generateSine() {
+    TR808_PROFILE_STAGE(TR808_STAGE_OSCILLATOR);
     updatePhase();
     return amplitude * sinf(phase);
 }
 
-float TR808Oscillator::generateSquare() {
+TR808_HOT float TR808Oscillator::generateSquare() {
+    TR808_PROFILE_STAGE(TR808_STAGE_OSCILLATOR);
     updatePhase();
     float value = (phase < PI) ? amplitude : -amplitude;
     return value;
 }
 
-float TR808Oscillator::generateSaw() {
+/**
+ * PolyBLEP 구형파
+ * 엣지 앞뒤 1샘플 구간만 2차 다항식 잔차로 보정 (나머지 샘플은 naive와 같은 비교 1~2회)
+ * - 0에서 상승, PI에서 하강: 반주기 단위로 접어 엣지 거리 t를 구함
+ * - 보정 구간의 나눗셈은 엣지 근처 샘플(2 x 증분 / PI 비율)에서만 발생
+ * - 증분이 PI/2 미만(레이트/4 미만 주파수)이라고 가정: 금속성 뱅크 최고 800Hz
+ */
+TR808_HOT float TR808Oscillator::generateSquareBlep() {
+    TR808_PROFILE_STAGE(TR808_STAGE_OSCILLATOR);
+    updatePhase();
+    float value = amplitude;
+    float t = phase;
+    if (t >= PI) {
+        value = -value;
+        t -= PI;
+    }
+    if (t < phaseIncrement) {
+        // 엣지 직후: 0 -> 1 구간을 x(2 - x)로
+        float x = t / phaseIncrement;
+        return value * x * (2.0f - x);
+    }
+    if (t > PI - phaseIncrement) {
+        // 다음 엣지 직전: -1 -> 0 구간을 -x(x + 2)로
+        float x = (t - PI) / phaseIncrement;
+        return -value * x * (x + 2.0f);
+    }
+    return value;
+}
+
+TR808_HOT float TR808Oscillator::generateSaw() {
+    TR808_PROFILE_STAGE(TR808_STAGE_OSCILLATOR);
     updatePhase();
     float normalizedPhase = phase / TWO_PI;
     return amplitude * (2.0f * normalizedPhase - 1.0f);
 }
 
-float TR808Oscillator::generateWhiteNoise() {
+TR808_HOT float TR808Oscillator::generateWhiteNoise() {
+    TR808_PROFILE_STAGE(TR808_STAGE_OSCILLATOR);
     // ESP32C3 최적화된 랜덤 노이즈 생성
     static uint32_t seed = 0x12345678;
     seed = (seed * 1664525 + 1013904223) & 0xFFFFFFFF;
     return amplitude * ((seed & 0xFFFF) / 32768.0f - 1.0f);
 }
 
-float TR808Oscillator::generatePinkNoise() {
+TR808_HOT float TR808Oscillator::generatePinkNoise() {
+    TR808_PROFILE_STAGE(TR808_STAGE_OSCILLATOR);
     // 간단한 1차 필터를 통한 핑크 노이즈
     static float lastOutput = 0.0f;
     float white = generateWhiteNoise();
@@ -63,18 +113,6 @@ float TR808Oscillator::generatePinkNoise() {
 
 // ================ TR808Envelope 구현 ================
 
-TR808Envelope::TR808Envelope() {
-    attackTime = 1.0f;
-    decayTime = 100.0f;
-    releaseTime = 100.0f;
-    sustainLevel = 0.7f;
-    currentLevel = 0.0f;
-    isActive = false;
-    startTime = 0;
-    attackEndTime = 0;
-    decayEndTime = 0;
-}
-
 void TR808Envelope::setAttack(float timeMs) {
     attackTime = timeMs;
 }
@@ -96,6 +134,10 @@ void TR808Envelope::trigger() {
     startTime = micros();
     attackEndTime = startTime + (uint32_t)(attackTime * 1000);
     decayEndTime = attackEndTime + (uint32_t)(decayTime * 1000);
+    
+    // 다음 샘플에서 램프 재시작 (0에서 어택 시작)
+    rampValue = 0.0f;
+    rampCounter = 0;
 }
 
 void TR808Envelope::release() {
@@ -103,10 +145,12 @@ void TR808Envelope::release() {
 }
 
 float TR808Envelope::getValue() {
+    return getValueAt(micros());
+}
+
+TR808_HOT float TR808Envelope::getValueAt(uint32_t currentTime) {
     if (!isActive) return 0.0f;
     
-    uint32_t currentTime = micros();
-    
     if (currentTime < attackEndTime) {
         // 어택 단계
         float progress = (float)(currentTime - startTime) / (attackTime * 1000.0f);
@@ -125,47 +169,51 @@ float TR808Envelope::getValue() {
     return currentLevel;
 }
 
+TR808_HOT void TR808Envelope::updateRamp() {
+    // 이번 구간 끝(N 샘플 후)의 값을 목표로 삼아 램프 지연을 없앰
+    float target = getValueAt(micros() + tr808Rate.controlPeriodUs);
+    rampStep = (target - rampValue) * tr808Rate.controlStep;
+    rampCounter = tr808Rate.controlInterval;
+}
+
 bool TR808Envelope::isNoteActive() {
     return isActive && currentLevel > 0.001f;
 }
 
 // ================ TR808Filter 구현 ================
 
-TR808Filter::TR808Filter() {
-    cutoffFreq = 1000.0f;
-    resonance = 1.0f;
-    alpha = 0.0f;
-    beta = 0.0f;
-    gamma = 0.0f;
-    delta = 0.0f;
-    x1 = x2 = y1 = y2 = 0.0f;
-}
-
 void TR808Filter::setCutoff(float freq) {
     cutoffFreq = freq;
     // 간단한 1차 필터 계산
-    float omega = TWO_PI * cutoffFreq / MAX_SAMPLE_RATE;
+    float omega = cutoffFreq * tr808Rate.radiansPerHz;
     alpha = omega / (omega + 1.0f);
 }
 
+void TR808Filter::updateRate() {
+    setCutoff(cutoffFreq);
+}
+
 void TR808Filter::setResonance(float q) {
     resonance = q;
 }
 
-float TR808Filter::processLowPass(float input) {
+TR808_HOT float TR808Filter::processLowPass(float input) {
+    TR808_PROFILE_STAGE(TR808_STAGE_FILTER);
     float output = alpha * input + (1.0f - alpha) * y1;
     y1 = output;
     return output;
 }
 
-float TR808Filter::processHighPass(float input) {
+TR808_HOT float TR808Filter::processHighPass(float input) {
+    TR808_PROFILE_STAGE(TR808_STAGE_FILTER);
     float output = alpha * (input - x1 + y1);
     x1 = input;
     y1 = output;
     return output;
 }
 
-float TR808Filter::processBandPass(float input) {
+TR808_HOT float TR808Filter::processBandPass(float input) {
+    TR808_PROFILE_STAGE(TR808_STAGE_FILTER);
     // 2차 밴드패스 구현
     float output = alpha * (input - gamma * y1 - delta * y2);
     y2 = y1;
@@ -179,11 +227,6 @@ void TR808Filter::reset() {
 
 // ================ TR808Processor 구현 ================
 
-TR808Processor::TR808Processor() {
-    masterGain = 1.0f;
-    saturatorAmount = 0.0f;
-}
-
 void TR808Processor::setGain(float gain) {
     masterGain = gain;
 }
@@ -192,12 +235,12 @@ void TR808Processor::setSaturation(float amount) {
     saturatorAmount = amount;
 }
 
-float TR808Processor::process(float input) {
+TR808_HOT float TR808Processor::process(float input) {
     float processed = saturate(input);
     return processed * masterGain;
 }
 
-float TR808Processor::saturate(float input) {
+TR808_HOT float TR808Processor::saturate(float input) {
     if (saturatorAmount <= 0.0f) return input;
     
     // 간단한 소프트 클리핑
@@ -208,20 +251,20 @@ float TR808Processor::saturate(float input) {
 
 // ================ TR808BridgedTOscillator 구현 ================
 
-TR808BridgedTOscillator::TR808BridgedTOscillator() {
-    resonantFreq = 60.0f;
-    damping = 0.1f;
-    phase = 0.0f;
-    amplitude = 1.0f;
-    decayRate = 0.1f;
-}
-
 void TR808BridgedTOscillator::setFrequency(float freq) {
     resonantFreq = freq;
 }
 
 void TR808BridgedTOscillator::setDecay(float decayMs) {
-    decayRate = 1000.0f / decayMs / MAX_SAMPLE_RATE;
+    this->decayMs = decayMs;
+    decayRate = 1000.0f / decayMs * tr808Rate.samplePeriod;
+}
+
+void TR808BridgedTOscillator::updateRate() {
+    // 공진 주파수는 generate()에서 매 샘플 변환하므로 감쇠율만 재계산
+    if (decayMs > 0.0f) {
+        setDecay(decayMs);
+    }
 }
 
 void TR808BridgedTOscillator::trigger() {
@@ -229,13 +272,14 @@ void TR808BridgedTOscillator::trigger() {
     phase = 0.0f;
 }
 
-float TR808BridgedTOscillator::generate() {
+TR808_HOT float TR808BridgedTOscillator::generate() {
+    TR808_PROFILE_STAGE(TR808_STAGE_OSCILLATOR);
     // 브리지드 T 발진기 시뮬레이션
     // 실제 TR-808의 브리지드 T 회로는 매우 복잡하므로 근사치로 구현
     float frequency = resonantFreq * (1.0f - 0.1f * amplitude);
     float sample = amplitude * sinf(phase);
     
-    phase += TWO_PI * frequency / MAX_SAMPLE_RATE;
+    phase += frequency * tr808Rate.radiansPerHz;
     if (phase >= TWO_PI) {
         phase -= TWO_PI;
     }
@@ -253,13 +297,6 @@ void TR808BridgedTOscillator::reset() {
 
 // ================ TR808InharmonicOscillator 구현 ================
 
-TR808InharmonicOscillator::TR808InharmonicOscillator() {
-    freq1 = 1667.0f; // ~G#6+6¢
-    freq2 = 455.0f;  // ~A#4-42¢
-    phase1 = phase2 = 0.0f;
-    mixRatio = 0.5f;
-}
-
 void TR808InharmonicOscillator::setFrequencies(float f1, float f2) {
     freq1 = f1;
     freq2 = f2;
@@ -269,12 +306,13 @@ void TR808InharmonicOscillator::setMixRatio(float ratio) {
     mixRatio = ratio;
 }
 
-float TR808InharmonicOscillator::generate() {
+TR808_HOT float TR808InharmonicOscillator::generate() {
+    TR808_PROFILE_STAGE(TR808_STAGE_OSCILLATOR);
     float sample1 = sinf(phase1);
     float sample2 = sinf(phase2);
     
-    phase1 += TWO_PI * freq1 / MAX_SAMPLE_RATE;
-    phase2 += TWO_PI * freq2 / MAX_SAMPLE_RATE;
+    phase1 += freq1 * tr808Rate.radiansPerHz;
+    phase2 += freq2 * tr808Rate.radiansPerHz;
     
     if (phase1 >= TWO_PI) phase1 -= TWO_PI;
     if (phase2 >= TWO_PI) phase2 -= TWO_PI;
@@ -288,23 +326,6 @@ void TR808InharmonicOscillator::reset() {
 
 // ================ TR808Kick 구현 ================
 
-TR808Kick::TR808Kick() {
-    subFrequency = 50.0f;
-    isPlaying = false;
-    
-    oscillator.setFrequency(60.0f);
-    amplitudeEnvelope.setAttack(1.0f);
-    amplitudeEnvelope.setDecay(500.0f);
-    amplitudeEnvelope.setSustain(0.0f);
-    
-    pitchEnvelope.setAttack(0.5f);
-    pitchEnvelope.setDecay(30.0f);
-    pitchEnvelope.setSustain(0.0f);
-    
-    toneFilter.setCutoff(200.0f);
-    processor.setGain(0.8f);
-}
-
 void TR808Kick::trigger(float velocity) {
     oscillator.trigger();
     amplitudeEnvelope.trigger();
@@ -315,23 +336,22 @@ void TR808Kick::trigger(float velocity) {
     oscillator.setFrequency(60.0f + 20.0f * velocity);
 }
 
-float TR808Kick::process() {
+TR808_HOT float TR808Kick::process() {
     if (!isPlaying) return 0.0f;
     
-    float pitchMod = pitchEnvelope.getValue();
+    // 피치/진폭 엔벨롭은 컨트롤 레이트로 계산되어 램프로 들어옴
+    float pitchMod = pitchEnvelope.nextSample();
     float freq = 60.0f * (1.0f - 0.5f * pitchMod);
     oscillator.setFrequency(freq);
     
     float tonal = oscillator.generate();
-    float envelope = amplitudeEnvelope.getValue();
+    float envelope = amplitudeEnvelope.nextSample();
     
     float output = tonal * envelope;
     output = toneFilter.processLowPass(output);
     output = processor.process(output);
     
     // 서브 바디 보강
-    static TR808Oscillator subOsc;
-    subOsc.setFrequency(subFrequency);
     float sub = subOsc.generateSine() * envelope * 0.3f;
     output += sub;
     
@@ -358,34 +378,14 @@ bool TR808Kick::isActive() {
     return isPlaying;
 }
 
-// ================ TR808Snare 구현 ================
-
-TR808Snare::TR808Snare() {
-    isPlaying = false;
-    
-    // 두 개의 브리지드 T 발진기 설정
-    osc1.setFrequency(200.0f);
-    osc2.setFrequency(180.0f);
-    
-    // 노이즈 설정
-    noiseOsc.setAmplitude(0.7f);
-    
-    // 엔벨롭 설정
-    tonalEnvelope.setAttack(0.1f);
-    tonalEnvelope.setDecay(50.0f);
-    tonalEnvelope.setSustain(0.0f);
-    
-    noiseEnvelope.setAttack(0.1f);
-    noiseEnvelope.setDecay(25.0f); // "Snappy"
-    noiseEnvelope.setSustain(0.0f);
-    
-    // 필터 설정
-    noiseHPF.setCutoff(1000.0f);
-    noiseHPF.setResonance(1.0f);
-    
-    processor.setGain(0.6f);
+void TR808Kick::updateRate() {
+    oscillator.updateRate();
+    subOsc.updateRate();
+    toneFilter.updateRate();
 }
 
+// ================ TR808Snare 구현 ================
+
 void TR808Snare::trigger(float velocity) {
     osc1.trigger();
     osc2.trigger();
@@ -394,21 +394,23 @@ void TR808Snare::trigger(float velocity) {
     isPlaying = true;
 }
 
-float TR808Snare::process() {
+TR808_HOT float TR808Snare::process() {
     if (!isPlaying) return 0.0f;
     
     float tonal1 = osc1.generate();
     float tonal2 = osc2.generate();
-    float tonal = (tonal1 + tonal2) * 0.5f * tonalEnvelope.getValue();
+    float tonalLevel = tonalEnvelope.nextSample();
+    float noiseLevel = noiseEnvelope.nextSample();
+    float tonal = (tonal1 + tonal2) * 0.5f * tonalLevel;
     
     float noise = noiseOsc.generateWhiteNoise();
     noise = noiseHPF.processHighPass(noise);
-    noise *= noiseEnvelope.getValue();
+    noise *= noiseLevel;
     
     float output = tonal + noise;
     output = processor.process(output);
     
-    if (tonalEnvelope.getValue() <= 0.001f && noiseEnvelope.getValue() <= 0.001f) {
+    if (tonalLevel <= 0.001f && noiseLevel <= 0.001f) {
         isPlaying = false;
     }
     
@@ -432,42 +434,27 @@ bool TR808Snare::isActive() {
     return isPlaying;
 }
 
-// ================ TR808Cymbal 구현 ================
-
-TR808Cymbal::TR808Cymbal() {
-    // 6개 오실레이터 초기화
-    for (int i = 0; i < 6; i++) {
-        oscillators[i].setFrequency(oscFreqs[i]);
-        oscillators[i].setAmplitude(0.3f);
-    }
-    
-    // 듀얼 밴드패스 필터
-    bpf1.setCutoff(7100.0f); // ~7.1 kHz
-    bpf2.setCutoff(3440.0f); // ~3.44 kHz
-    
-    // 엔벨롭
-    envelope.setAttack(1.0f);
-    envelope.setDecay(800.0f);
-    envelope.setSustain(0.0f);
-    
-    // 하이패스
-    hpf.setCutoff(2000.0f);
-    
-    processor.setGain(0.5f);
+void TR808Snare::updateRate() {
+    osc1.updateRate();
+    osc2.updateRate();
+    noiseOsc.updateRate();
+    noiseHPF.updateRate();
 }
 
+// ================ TR808Cymbal 구현 ================
+
 void TR808Cymbal::trigger(float velocity) {
     envelope.trigger();
 }
 
-float TR808Cymbal::process() {
-    float envelope = this->envelope.getValue();
+TR808_HOT float TR808Cymbal::process() {
+    float envelope = this->envelope.nextSample();
     if (envelope <= 0.001f) return 0.0f;
     
     // 6개 오실레이터 믹싱
     float mixed = 0.0f;
     for (int i = 0; i < 6; i++) {
-        mixed += oscillators[i].generateSquare();
+        mixed += oscillators[i].generateSquareBlep();
     }
     mixed /= 6.0f;
     
@@ -502,47 +489,29 @@ bool TR808Cymbal::isActive() {
     return envelope.getValue() > 0.001f;
 }
 
-// ================ TR808HiHat 구현 ================
-
-TR808HiHat::TR808HiHat(bool open) {
-    isOpen = open;
-    
-    // 6개 오실레이터 초기화 (심벌과 동일)
+void TR808Cymbal::updateRate() {
     for (int i = 0; i < 6; i++) {
-        oscillators[i].setFrequency(oscFreqs[i]);
-        oscillators[i].setAmplitude(0.2f);
+        oscillators[i].updateRate();
     }
-    
-    // 밴드패스 필터
-    bpf.setCutoff(8000.0f);
-    
-    // 엔벨롭
-    if (open) {
-        envelope.setDecay(200.0f);
-    } else {
-        envelope.setDecay(50.0f); // 클로즈드
-    }
-    envelope.setAttack(0.5f);
-    envelope.setSustain(0.0f);
-    
-    // 하이패스
-    hpf.setCutoff(3000.0f);
-    
-    processor.setGain(0.4f);
+    bpf1.updateRate();
+    bpf2.updateRate();
+    hpf.updateRate();
 }
 
+// ================ TR808HiHat 구현 ================
+
 void TR808HiHat::trigger(float velocity) {
     envelope.trigger();
 }
 
-float TR808HiHat::process() {
-    float envelope = this->envelope.getValue();
+TR808_HOT float TR808HiHat::process() {
+    float envelope = this->envelope.nextSample();
     if (envelope <= 0.001f) return 0.0f;
     
     // 6개 오실레이터 믹싱
     float mixed = 0.0f;
     for (int i = 0; i < 6; i++) {
-        mixed += oscillators[i].generateSquare();
+        mixed += oscillators[i].generateSquareBlep();
     }
     mixed /= 6.0f;
     
@@ -575,31 +544,16 @@ bool TR808HiHat::isActive() {
     return envelope.getValue() > 0.001f;
 }
 
-// ================ TR808Tom 구현 ================
-
-TR808Tom::TR808Tom() {
-    isPlaying = false;
-    pitchBendRate = 0.95f;
-    
-    oscillator.setFrequency(165.0f); // High Tom
-    
-    // 톤 엔벨롭
-    tonalEnvelope.setAttack(0.5f);
-    tonalEnvelope.setDecay(100.0f);
-    tonalEnvelope.setSustain(0.0f);
-    
-    // 핑크 노이즈 엔벨롭 (가짜 잔향)
-    noiseEnvelope.setAttack(1.0f);
-    noiseEnvelope.setDecay(200.0f);
-    noiseEnvelope.setSustain(0.0f);
-    
-    // 핑크 노이즈 설정
-    pinkNoiseOsc.setAmplitude(0.1f);
-    noiseLPF.setCutoff(500.0f);
-    
-    processor.setGain(0.7f);
+void TR808HiHat::updateRate() {
+    for (int i = 0; i < 6; i++) {
+        oscillators[i].updateRate();
+    }
+    bpf.updateRate();
+    hpf.updateRate();
 }
 
+// ================ TR808Tom 구현 ================
+
 void TR808Tom::trigger(float velocity) {
     oscillator.trigger();
     tonalEnvelope.trigger();
@@ -607,7 +561,7 @@ void TR808Tom::trigger(float velocity) {
     isPlaying = true;
 }
 
-float TR808Tom::process() {
+TR808_HOT float TR808Tom::process() {
     if (!isPlaying) return 0.0f;
     
     // 피치 벤드 효과 (하향)
@@ -615,10 +569,11 @@ float TR808Tom::process() {
     currentFreq *= pitchBendRate;
     oscillator.setFrequency(currentFreq);
     
-    float tonal = oscillator.generate() * tonalEnvelope.getValue();
+    float tonalLevel = tonalEnvelope.nextSample();
+    float tonal = oscillator.generate() * tonalLevel;
     float noise = pinkNoiseOsc.generatePinkNoise();
     noise = noiseLPF.processLowPass(noise);
-    noise *= noiseEnvelope.getValue() * 0.3f;
+    noise *= noiseEnvelope.nextSample() * 0.3f;
     
     float output = tonal + noise;
     output = processor.process(output);
@@ -626,7 +581,7 @@ float TR808Tom::process() {
     // 빈도 복구
     currentFreq = 165.0f;
     
-    if (tonalEnvelope.getValue() <= 0.001f) {
+    if (tonalLevel <= 0.001f) {
         isPlaying = false;
     }
     
@@ -649,27 +604,14 @@ bool TR808Tom::isActive() {
     return isPlaying;
 }
 
-// ================ TR808Conga 구현 ================
-
-TR808Conga::TR808Conga() {
-    isPlaying = false;
-    
-    oscillator.setFrequency(370.0f); // High Conga
-    
-    tonalEnvelope.setAttack(0.5f);
-    tonalEnvelope.setDecay(80.0f);
-    tonalEnvelope.setSustain(0.0f);
-    
-    noiseEnvelope.setAttack(1.0f);
-    noiseEnvelope.setDecay(180.0f);
-    noiseEnvelope.setSustain(0.0f);
-    
-    pinkNoiseOsc.setAmplitude(0.1f);
-    noiseLPF.setCutoff(600.0f);
-    
-    processor.setGain(0.7f);
+void TR808Tom::updateRate() {
+    oscillator.updateRate();
+    pinkNoiseOsc.updateRate();
+    noiseLPF.updateRate();
 }
 
+// ================ TR808Conga 구현 ================
+
 void TR808Conga::trigger(float velocity) {
     oscillator.trigger();
     tonalEnvelope.trigger();
@@ -677,18 +619,19 @@ void TR808Conga::trigger(float velocity) {
     isPlaying = true;
 }
 
-float TR808Conga::process() {
+TR808_HOT float TR808Conga::process() {
     if (!isPlaying) return 0.0f;
     
-    float tonal = oscillator.generate() * tonalEnvelope.getValue();
+    float tonalLevel = tonalEnvelope.nextSample();
+    float tonal = oscillator.generate() * tonalLevel;
     float noise = pinkNoiseOsc.generatePinkNoise();
     noise = noiseLPF.processLowPass(noise);
-    noise *= noiseEnvelope.getValue() * 0.3f;
+    noise *= noiseEnvelope.nextSample() * 0.3f;
     
     float output = tonal + noise;
     output = processor.process(output);
     
-    if (tonalEnvelope.getValue() <= 0.001f) {
+    if (tonalLevel <= 0.001f) {
         isPlaying = false;
     }
     
@@ -711,30 +654,21 @@ bool TR808Conga::isActive() {
     return isPlaying;
 }
 
-// ================ TR808Rimshot 구현 ================
-
-TR808Rimshot::TR808Rimshot() {
-    noiseGateActive = false;
-    lastInput = 0.0f;
-    
-    // 림샷 전용 주파수 설정
-    oscillator.setFrequencies(1667.0f, 455.0f);
-    
-    envelope.setAttack(1.0f);
-    envelope.setDecay(10.0f); // 극단적 스냅
-    envelope.setSustain(0.0f);
-    
-    hpf.setCutoff(800.0f);
-    processor.setGain(0.8f);
+void TR808Conga::updateRate() {
+    oscillator.updateRate();
+    pinkNoiseOsc.updateRate();
+    noiseLPF.updateRate();
 }
 
+// ================ TR808Rimshot 구현 ================
+
 void TR808Rimshot::trigger(float velocity) {
     envelope.trigger();
     oscillator.reset();
 }
 
-float TR808Rimshot::process() {
-    float envelope = this->envelope.getValue();
+TR808_HOT float TR808Rimshot::process() {
+    float envelope = this->envelope.nextSample();
     if (envelope <= 0.001f) return 0.0f;
     
     float tonal = oscillator.generate();
@@ -761,36 +695,29 @@ bool TR808Rimshot::isActive() {
     return envelope.getValue() > 0.001f;
 }
 
-// ================ TR808Maracas 구현 ================
-
-TR808Maracas::TR808Maracas() {
-    isPlaying = false;
-    
-    noiseOsc.setAmplitude(0.5f);
-    
-    envelope.setAttack(0.5f);
-    envelope.setDecay(30.0f); // AR 엔벨롭
-    envelope.setSustain(0.0f);
-    
-    hpf.setCutoff(1500.0f);
-    processor.setGain(0.3f);
+void TR808Rimshot::updateRate() {
+    // 비정수배 오실레이터는 매 샘플 변환하므로 필터만 재계산
+    hpf.updateRate();
 }
 
+// ================ TR808Maracas 구현 ================
+
 void TR808Maracas::trigger(float velocity) {
     envelope.trigger();
     isPlaying = true;
 }
 
-float TR808Maracas::process() {
+TR808_HOT float TR808Maracas::process() {
     if (!isPlaying) return 0.0f;
     
     float noise = noiseOsc.generateWhiteNoise();
     noise = hpf.processHighPass(noise);
-    noise *= envelope.getValue();
+    float level = envelope.nextSample();
+    noise *= level;
     
     float output = processor.process(noise);
     
-    if (envelope.getValue() <= 0.001f) {
+    if (level <= 0.001f) {
         isPlaying = false;
     }
     
@@ -805,29 +732,13 @@ bool TR808Maracas::isActive() {
     return isPlaying;
 }
 
-// ================ TR808Clap 구현 ================
-
-TR808Clap::TR808Clap() {
-    hitCount = 0;
-    lastHitTime = 0;
-    
-    noiseOsc.setAmplitude(0.8f);
-    
-    bpf.setCutoff(1000.0f); // ~1 kHz
-    
-    // 톱니파 엔벨롭 (3개 타격)
-    sawEnvelope.setAttack(1.0f);
-    sawEnvelope.setDecay(10.0f);
-    sawEnvelope.setSustain(0.0f);
-    
-    // 리버브 엔벨롭
-    reverbEnvelope.setAttack(5.0f);
-    reverbEnvelope.setDecay(100.0f);
-    reverbEnvelope.setSustain(0.0f);
-    
-    processor.setGain(0.6f);
+void TR808Maracas::updateRate() {
+    noiseOsc.updateRate();
+    hpf.updateRate();
 }
 
+// ================ TR808Clap 구현 ================
+
 void TR808Clap::trigger(float velocity) {
     // 3개 타격 생성
     for (int i = 0; i < 3; i++) {
@@ -837,12 +748,12 @@ void TR808Clap::trigger(float velocity) {
     reverbEnvelope.trigger();
 }
 
-float TR808Clap::process() {
+TR808_HOT float TR808Clap::process() {
     float noise = noiseOsc.generateWhiteNoise();
     noise = bpf.processBandPass(noise);
     
-    float saw = sawEnvelope.getValue();
-    float reverb = reverbEnvelope.getValue();
+    float saw = sawEnvelope.nextSample();
+    float reverb = reverbEnvelope.nextSample();
     
     float output = noise * (saw + reverb * 0.5f);
     output = processor.process(output);
@@ -858,32 +769,23 @@ bool TR808Clap::isActive() {
     return (sawEnvelope.getValue() > 0.001f || reverbEnvelope.getValue() > 0.001f);
 }
 
-// ================ TR808Cowbell 구현 ================
-
-TR808Cowbell::TR808Cowbell() {
-    osc1.setFrequency(cowbellFreqs[0]); // 800 Hz
-    osc2.setFrequency(cowbellFreqs[1]); // 540 Hz
-    
-    bpf.setCutoff(2000.0f);
-    hpf.setCutoff(500.0f);
-    
-    envelope.setAttack(0.5f);
-    envelope.setDecay(80.0f);
-    envelope.setSustain(0.0f);
-    
-    processor.setGain(0.5f);
+void TR808Clap::updateRate() {
+    noiseOsc.updateRate();
+    bpf.updateRate();
 }
 
+// ================ TR808Cowbell 구현 ================
+
 void TR808Cowbell::trigger(float velocity) {
     envelope.trigger();
 }
 
-float TR808Cowbell::process() {
-    float envelope = this->envelope.getValue();
+TR808_HOT float TR808Cowbell::process() {
+    float envelope = this->envelope.nextSample();
     if (envelope <= 0.001f) return 0.0f;
     
-    float osc1_out = osc1.generateSquare();
-    float osc2_out = osc2.generateSquare();
+    float osc1_out = osc1.generateSquareBlep();
+    float osc2_out = osc2.generateSquareBlep();
     float mixed = 0.6f * osc1_out + 0.4f * osc2_out;
     
     mixed = bpf.processBandPass(mixed);
@@ -902,10 +804,51 @@ bool TR808Cowbell::isActive() {
     return envelope.getValue() > 0.001f;
 }
 
+void TR808Cowbell::updateRate() {
+    osc1.updateRate();
+    osc2.updateRate();
+    bpf.updateRate();
+    hpf.updateRate();
+}
+
 // ================ TR808DrumMachine 구현 ================
 
-TR808DrumMachine::TR808DrumMachine() {
-    masterVolume = 0.8f;
+bool TR808DrumMachine::setControlInterval(uint8_t interval) {
+    if (interval < 1) return false;
+    // 진행 중인 램프는 현재 구간을 마친 뒤 새 간격으로 전환
+    tr808Rate.setControlInterval(interval);
+    return true;
+}
+
+bool TR808DrumMachine::setSampleRate(uint32_t rate) {
+    if (rate < TR808_SAMPLE_RATE_MIN || rate > TR808_SAMPLE_RATE_MAX) {
+        return false;
+    }
+    // 렌더 루프가 다음 블록 시작에서 적용 (블록 중간 계수 변경 방지)
+    pendingSampleRate = (rate == tr808Rate.rate) ? 0 : rate;
+    return true;
+}
+
+bool TR808DrumMachine::applyPendingSampleRate() {
+    uint32_t rate = pendingSampleRate;
+    if (rate == 0) return false;
+    pendingSampleRate = 0;
+
+    tr808Rate.set(rate);
+
+    // 캐시된 증분/필터/감쇠 계수를 모두 새 레이트로 재계산
+    // (엔벨로프는 micros() 기반이라 레이트 무관)
+    kick.updateRate();
+    snare.updateRate();
+    cymbal.updateRate();
+    hiHat.updateRate();
+    tom.updateRate();
+    conga.updateRate();
+    rimshot.updateRate();
+    maracas.updateRate();
+    clap.updateRate();
+    cowbell.updateRate();
+    return true;
 }
 
 void TR808DrumMachine::triggerKick(float velocity) {
@@ -949,7 +892,9 @@ void TR808DrumMachine::triggerCowbell(float velocity) {
     cowbell.trigger(velocity);
 }
 
-float TR808DrumMachine::process() {
+TR808_HOT float TR808DrumMachine::process() {
+    // 보이스 내부의 오실레이터/필터/엔벨롭을 뺀 나머지가 믹스로 집계됨
+    TR808_PROFILE_STAGE(TR808_STAGE_MIX);
     float output = 0.0f;
     
     output += kick.process();
@@ -4,12 +4,70 @@
 #include <stdint.h>
 #include <math.h>
 #include <Arduino.h>
+#include "tr808_sample_rate.h"
+#include "tr808_perf_monitor.h"
+#include "tr808_placement.h"
 
-// ESP32C3 최적화를 위한 상수 정의
-#define MAX_SAMPLE_RATE 32768  // ESP32C3 권장 오디오 레이트
+// ESP32C3 최적화를 위한 상수 정의 (레이트는 tr808_sample_rate.h)
+// Arduino.h의 double 상수 대신 float 사용 (C3는 배정밀도 FPU 없음)
+#undef PI
+#undef TWO_PI
 #define PI 3.14159265358979323846f
 #define TWO_PI 6.28318530717958647692f
-#define SAMPLE_TIME_US (1000000 / MAX_SAMPLE_RATE)
+#define SAMPLE_TIME_US (1000000 / TR808_SAMPLE_RATE)
+
+// 컨트롤 레이트: 엔벨롭/피치 변조를 N 샘플마다 계산하고 그 사이는 선형 램프
+// (1이면 매 샘플 계산, -DTR808_CONTROL_INTERVAL=... 또는 setControlInterval()로 변경)
+#ifndef TR808_CONTROL_INTERVAL
+#define TR808_CONTROL_INTERVAL 16
+#endif
+#define TR808_CONTROL_INTERVAL_MAX 255
+
+static_assert(TR808_CONTROL_INTERVAL >= 1 && TR808_CONTROL_INTERVAL <= TR808_CONTROL_INTERVAL_MAX,
+              "TR808_CONTROL_INTERVAL 범위 오류");
+
+/**
+ * 런타임 샘플 레이트 계수
+ * 빌드 레이트(TR808AudioRate)로 초기화되고, TR808DrumMachine::applyPendingSampleRate()가
+ * 블록 경계에서만 갱신 (렌더 중간에 바뀌지 않음)
+ */
+struct TR808RuntimeRate {
+    uint32_t rate;
+    float samplePeriod;     // 1 / rate
+    float radiansPerHz;     // 2pi / rate
+    uint8_t controlInterval;    // 컨트롤 틱당 샘플 수
+    float controlStep;          // 1 / controlInterval (램프 기울기용)
+    uint32_t controlPeriodUs;   // 컨트롤 틱 길이 (엔벨롭 목표 시각)
+
+    void set(uint32_t sampleRate) {
+        rate = sampleRate;
+        samplePeriod = 1.0f / sampleRate;
+        radiansPerHz = TWO_PI / sampleRate;
+        controlPeriodUs = (uint32_t)((uint64_t)controlInterval * 1000000UL / sampleRate);
+    }
+
+    void setControlInterval(uint8_t interval) {
+        controlInterval = interval;
+        controlStep = 1.0f / interval;
+        controlPeriodUs = (uint32_t)((uint64_t)interval * 1000000UL / rate);
+    }
+};
+
+extern TR808RuntimeRate tr808Rate;
+
+// 빌드 레이트 기준 기본 계수: 보이스 기본 상태를 constexpr 생성자로 만들어
+// 전역 엔진이 정적 초기화 코드 없이 .data에 놓임 (부팅 시 계수 계산 없음)
+// 런타임 레이트 전환 시에는 updateRate()가 tr808Rate로 다시 계산 (같은 식)
+constexpr float tr808PhaseIncrement(float freq) {
+    return freq * TR808AudioRate::radiansPerHz;
+}
+
+constexpr float tr808OnePoleAlpha(float freq) {
+    return freq * TR808AudioRate::radiansPerHz / (freq * TR808AudioRate::radiansPerHz + 1.0f);
+}
+
+// TR-808 금속성 오실레이터 뱅크 (심벌/하이햇, 카우벨은 앞 2개)
+constexpr float TR808_METAL_FREQS[6] = {800.0f, 540.0f, 522.7f, 369.6f, 304.4f, 205.3f};
 
 /**
  * 기본 Oscillator 클래스 - 사인파, 사각파, 톱니파 생성
@@ -22,8 +80,10 @@ private:
     float amplitude;
     
 public:
-    TR808Oscillator();
+    constexpr TR808Oscillator(float freq = 440.0f, float amp = 1.0f)
+        : frequency(freq), phase(0.0f), phaseIncrement(tr808PhaseIncrement(freq)), amplitude(amp) {}
     void setFrequency(float freq);
+    void updateRate();  // 레이트 변경 시 증분 재계산
     void setAmplitude(float amp);
     void resetPhase();
     void updatePhase();
@@ -35,7 +95,8 @@ public:
     
     // 다양한 파형 생성
     float generateSine();
-    float generateSquare();
+    float generateSquare();     // naive (엣지마다 에일리어싱, 비교 기준)
+    float generateSquareBlep(); // PolyBLEP 대역 제한 (금속성 보이스)
     float generateSaw();
     float generatePinkNoise(); // 필터링된 핑크 노이즈
     float generateWhiteNoise();
@@ -56,8 +117,19 @@ private:
     uint32_t attackEndTime;
     uint32_t decayEndTime;
     
+    // 컨트롤 레이트 램프
+    float rampValue;
+    float rampStep;
+    uint8_t rampCounter;
+    
+    void updateRamp();
+    
 public:
-    TR808Envelope();
+    constexpr TR808Envelope(float attackMs = 1.0f, float decayMs = 100.0f, float sustain = 0.7f,
+                            float releaseMs = 100.0f)
+        : attackTime(attackMs), decayTime(decayMs), releaseTime(releaseMs), sustainLevel(sustain),
+          currentLevel(0.0f), isActive(false), startTime(0), attackEndTime(0), decayEndTime(0),
+          rampValue(0.0f), rampStep(0.0f), rampCounter(0) {}
     void setAttack(float timeMs);
     void setDecay(float timeMs);
     void setRelease(float timeMs);
@@ -65,7 +137,19 @@ public:
     void trigger();
     void release();
     float getValue();
+    float getValueAt(uint32_t timeUs);
     bool isNoteActive();
+    
+    // 오디오 레이트 출력: 컨트롤 틱마다 다음 틱 시점의 값을 계산해 선형 보간
+    // (micros()와 나눗셈은 N 샘플에 한 번)
+    // 스텝 후 값을 반환: 트리거 직후 첫 샘플이 0이면 보이스가 바로 종료 판정됨
+    inline float nextSample() {
+        TR808_PROFILE_STAGE(TR808_STAGE_ENVELOPE);
+        if (rampCounter == 0) updateRamp();
+        rampCounter--;
+        rampValue += rampStep;
+        return rampValue;
+    }
 };
 
 /**
@@ -85,8 +169,11 @@ private:
     float y1, y2; // 출력 지연
     
 public:
-    TR808Filter();
+    constexpr TR808Filter(float cutoff = 1000.0f, float q = 1.0f)
+        : cutoffFreq(cutoff), resonance(q), alpha(tr808OnePoleAlpha(cutoff)),
+          beta(0.0f), gamma(0.0f), delta(0.0f), x1(0.0f), x2(0.0f), y1(0.0f), y2(0.0f) {}
     void setCutoff(float freq);
+    void updateRate();  // 레이트 변경 시 계수 재계산
     void setResonance(float q);
     float process(float input);
     void reset();
@@ -106,7 +193,8 @@ private:
     float saturatorAmount;
     
 public:
-    TR808Processor();
+    constexpr TR808Processor(float gain = 1.0f, float saturation = 0.0f)
+        : masterGain(gain), saturatorAmount(saturation) {}
     void setGain(float gain);
     void setSaturation(float amount);
     float process(float input);
@@ -123,14 +211,18 @@ private:
     float phase;
     float amplitude;
     float decayRate;
+    float decayMs;      // 0이면 setDecay() 미호출 (기본 decayRate 유지)
     
     // 브리지드 T 파라미터
     float r1, r2, c1, c2; // 저항/커패시터 값 (임시 계산)
     
 public:
-    TR808BridgedTOscillator();
+    constexpr TR808BridgedTOscillator(float freq = 60.0f)
+        : resonantFreq(freq), damping(0.1f), phase(0.0f), amplitude(1.0f), decayRate(0.1f), decayMs(0.0f),
+          r1(0.0f), r2(0.0f), c1(0.0f), c2(0.0f) {}
     void setFrequency(float freq);
     void setDecay(float decayMs);
+    void updateRate();
     void trigger();
     float generate();
     void reset();
@@ -147,7 +239,8 @@ private:
     float mixRatio;
     
 public:
-    TR808InharmonicOscillator();
+    constexpr TR808InharmonicOscillator(float f1 = 1667.0f, float f2 = 455.0f)
+        : freq1(f1), freq2(f2), phase1(0.0f), phase2(0.0f), mixRatio(0.5f) {}
     void setFrequencies(float f1, float f2);
     void setMixRatio(float ratio);
     float generate();
@@ -164,17 +257,21 @@ private:
     TR808Envelope pitchEnvelope;
     TR808Filter toneFilter;
     TR808Processor processor;
+    TR808Oscillator subOsc;
     float subFrequency;
     bool isPlaying;
     
 public:
-    TR808Kick();
+    constexpr TR808Kick()
+        : oscillator(60.0f), amplitudeEnvelope(1.0f, 500.0f, 0.0f), pitchEnvelope(0.5f, 30.0f, 0.0f),
+          toneFilter(200.0f), processor(0.8f), subOsc(50.0f), subFrequency(50.0f), isPlaying(false) {}
     void trigger(float velocity = 1.0f);
     float process();
     void setDecay(float decayMs);
     void setTone(float tone); // 0-1
     void setLevel(float level);
     bool isActive();
+    void updateRate();
 };
 
 /**
@@ -191,13 +288,18 @@ private:
     bool isPlaying;
     
 public:
-    TR808Snare();
+    // 두 개의 브리지드 T 발진기, 노이즈 엔벨롭 = "Snappy"
+    constexpr TR808Snare()
+        : osc1(200.0f), osc2(180.0f), noiseOsc(440.0f, 0.7f),
+          tonalEnvelope(0.1f, 50.0f, 0.0f), noiseEnvelope(0.1f, 25.0f, 0.0f),
+          noiseHPF(1000.0f, 1.0f), processor(0.6f), isPlaying(false) {}
     void trigger(float velocity = 1.0f);
     float process();
     void setTone(float tone);
     void setSnappy(float snappy);
     void setLevel(float level);
     bool isActive();
+    void updateRate();
 };
 
 /**
@@ -211,17 +313,20 @@ private:
     TR808Filter hpf;
     TR808Processor processor;
     
-    // 오실레이터 주파수 (TR-808 원본 설정)
-    const float oscFreqs[6] = {800.0f, 540.0f, 522.7f, 369.6f, 304.4f, 205.3f};
-    
 public:
-    TR808Cymbal();
+    // 6개 오실레이터 (TR-808 원본 주파수), 듀얼 밴드패스 ~7.1 kHz / ~3.44 kHz
+    constexpr TR808Cymbal()
+        : oscillators{TR808Oscillator(TR808_METAL_FREQS[0], 0.3f), TR808Oscillator(TR808_METAL_FREQS[1], 0.3f),
+                      TR808Oscillator(TR808_METAL_FREQS[2], 0.3f), TR808Oscillator(TR808_METAL_FREQS[3], 0.3f),
+                      TR808Oscillator(TR808_METAL_FREQS[4], 0.3f), TR808Oscillator(TR808_METAL_FREQS[5], 0.3f)},
+          bpf1(7100.0f), bpf2(3440.0f), envelope(1.0f, 800.0f, 0.0f), hpf(2000.0f), processor(0.5f) {}
     void trigger(float velocity = 1.0f);
     float process();
     void setDecay(float decayMs);
     void setTone(float tone);
     void setLevel(float level);
     bool isActive();
+    void updateRate();
 };
 
 /**
@@ -237,13 +342,20 @@ private:
     bool isOpen; // 클로즈드/오픈 모드
     
 public:
-    TR808HiHat(bool open = false);
+    // 오실레이터는 심벌과 동일한 금속성 뱅크, 디케이는 오픈 200ms / 클로즈드 50ms
+    constexpr TR808HiHat(bool open = false)
+        : oscillators{TR808Oscillator(TR808_METAL_FREQS[0], 0.2f), TR808Oscillator(TR808_METAL_FREQS[1], 0.2f),
+                      TR808Oscillator(TR808_METAL_FREQS[2], 0.2f), TR808Oscillator(TR808_METAL_FREQS[3], 0.2f),
+                      TR808Oscillator(TR808_METAL_FREQS[4], 0.2f), TR808Oscillator(TR808_METAL_FREQS[5], 0.2f)},
+          bpf(8000.0f), envelope(0.5f, open ? 200.0f : 50.0f, 0.0f), hpf(3000.0f), processor(0.4f),
+          isOpen(open) {}
     void trigger(float velocity = 1.0f);
     float process();
     void setOpen(bool open);
     void setDecay(float decayMs);
     void setLevel(float level);
     bool isActive();
+    void updateRate();
 };
 
 /**
@@ -261,13 +373,18 @@ private:
     bool isPlaying;
     
 public:
-    TR808Tom();
+    // High Tom, 핑크 노이즈 엔벨롭 = 가짜 잔향
+    constexpr TR808Tom()
+        : oscillator(165.0f), pinkNoiseOsc(440.0f, 0.1f),
+          tonalEnvelope(0.5f, 100.0f, 0.0f), noiseEnvelope(1.0f, 200.0f, 0.0f),
+          noiseLPF(500.0f), processor(0.7f), pitchBendRate(0.95f), isPlaying(false) {}
     void trigger(float velocity = 1.0f);
     float process();
     void setTuning(float freq);
     void setDecay(float decayMs);
     void setLevel(float level);
     bool isActive();
+    void updateRate();
 };
 
 /**
@@ -284,13 +401,18 @@ private:
     bool isPlaying;
     
 public:
-    TR808Conga();
+    // High Conga
+    constexpr TR808Conga()
+        : oscillator(370.0f), pinkNoiseOsc(440.0f, 0.1f),
+          tonalEnvelope(0.5f, 80.0f, 0.0f), noiseEnvelope(1.0f, 180.0f, 0.0f),
+          noiseLPF(600.0f), processor(0.7f), isPlaying(false) {}
     void trigger(float velocity = 1.0f);
     float process();
     void setTuning(float freq);
     void setDecay(float decayMs);
     void setLevel(float level);
     bool isActive();
+    void updateRate();
 };
 
 /**
@@ -306,11 +428,15 @@ private:
     float lastInput;
     
 public:
-    TR808Rimshot();
+    // 림샷 전용 비조화 주파수, 10ms 극단적 스냅
+    constexpr TR808Rimshot()
+        : oscillator(1667.0f, 455.0f), envelope(1.0f, 10.0f, 0.0f), hpf(800.0f), processor(0.8f),
+          noiseGateActive(false), lastInput(0.0f) {}
     void trigger(float velocity = 1.0f);
     float process();
     void setLevel(float level);
     bool isActive();
+    void updateRate();
 };
 
 /**
@@ -325,11 +451,15 @@ private:
     bool isPlaying;
     
 public:
-    TR808Maracas();
+    // AR 엔벨롭
+    constexpr TR808Maracas()
+        : noiseOsc(440.0f, 0.5f), envelope(0.5f, 30.0f, 0.0f), hpf(1500.0f), processor(0.3f),
+          isPlaying(false) {}
     void trigger(float velocity = 1.0f);
     float process();
     void setLevel(float level);
     bool isActive();
+    void updateRate();
 };
 
 /**
@@ -346,11 +476,15 @@ private:
     uint32_t lastHitTime;
     
 public:
-    TR808Clap();
+    // ~1 kHz 밴드패스, 톱니파 엔벨롭 (3개 타격) + 리버브 엔벨롭
+    constexpr TR808Clap()
+        : noiseOsc(440.0f, 0.8f), bpf(1000.0f), sawEnvelope(1.0f, 10.0f, 0.0f),
+          reverbEnvelope(5.0f, 100.0f, 0.0f), processor(0.6f), hitCount(0), lastHitTime(0) {}
     void trigger(float velocity = 1.0f);
     float process();
     void setLevel(float level);
     bool isActive();
+    void updateRate();
 };
 
 /**
@@ -364,15 +498,16 @@ private:
     TR808Envelope envelope;
     TR808Processor processor;
     
-    // 카우벨 전용 주파수
-    const float cowbellFreqs[2] = {800.0f, 540.0f};
-    
 public:
-    TR808Cowbell();
+    // 카우벨 주파수 800 / 540 Hz (금속성 뱅크 앞 2개)
+    constexpr TR808Cowbell()
+        : osc1(TR808_METAL_FREQS[0]), osc2(TR808_METAL_FREQS[1]), bpf(2000.0f), hpf(500.0f),
+          envelope(0.5f, 80.0f, 0.0f), processor(0.5f) {}
     void trigger(float velocity = 1.0f);
     float process();
     void setLevel(float level);
     bool isActive();
+    void updateRate();
 };
 
 /**
@@ -392,9 +527,10 @@ private:
     TR808Cowbell cowbell;
     
     float masterVolume;
+    volatile uint32_t pendingSampleRate;    // 0 = 변경 없음
     
 public:
-    TR808DrumMachine();
+    constexpr TR808DrumMachine() : masterVolume(0.8f), pendingSampleRate(0) {}
     
     // 트리거 함수들
     void triggerKick(float velocity = 1.0f);
@@ -427,6 +563,16 @@ public:
     void setTomDecay(float decayMs);
     void setCongaTuning(float freq);
     void setCongaDecay(float decayMs);
+    
+    // 컨트롤 레이트 간격 (1 - TR808_CONTROL_INTERVAL_MAX 샘플)
+    bool setControlInterval(uint8_t interval);
+    uint8_t getControlInterval() const { return tr808Rate.controlInterval; }
+    
+    // 런타임 샘플 레이트 (블록 경계에서 적용)
+    bool setSampleRate(uint32_t rate);
+    bool hasPendingSampleRate() const { return pendingSampleRate != 0; }
+    bool applyPendingSampleRate();
+    uint32_t getSampleRate() const { return tr808Rate.rate; }
 };
 
 #endif // TR808_DRUMS_H
\ No newline at end of file
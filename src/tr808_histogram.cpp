@@ -0,0 +1,91 @@
+#include <string.h>
+#include "tr808_histogram.h"
+
+// ================ TR808HistogramSnapshot 구현 ================
+
+void TR808HistogramSnapshot::clear() {
+    memset(counts, 0, sizeof(counts));
+    total = 0;
+    minValue = 0xFFFFFFFF;
+    maxValue = 0;
+    sum = 0;
+}
+
+void TR808HistogramSnapshot::merge(const TR808HistogramSnapshot& other) {
+    for (uint16_t i = 0; i < TR808_HIST_BUCKETS; i++) {
+        counts[i] += other.counts[i];
+    }
+    total += other.total;
+    sum += other.sum;
+    if (other.minValue < minValue) minValue = other.minValue;
+    if (other.maxValue > maxValue) maxValue = other.maxValue;
+}
+
+uint32_t TR808HistogramSnapshot::percentile(uint16_t perTenThousand) const {
+    if (total == 0) return 0;
+
+    // 최근접 순위: ceil(total * p / 10000)번째 값
+    uint64_t rank = ((uint64_t)total * perTenThousand + 9999) / 10000;
+    if (rank == 0) rank = 1;
+
+    uint64_t seen = 0;
+    for (uint16_t i = 0; i < TR808_HIST_BUCKETS; i++) {
+        seen += counts[i];
+        if (seen >= rank) {
+            uint32_t upper = tr808HistBucketUpper(i);
+            return upper < maxValue ? upper : maxValue;
+        }
+    }
+    return maxValue;
+}
+
+uint32_t TR808HistogramSnapshot::exceedance(uint32_t threshold) const {
+    if (total == 0) return 0;
+
+    // threshold가 속한 버킷 다음부터 합산 (버킷 안에서는 구분 불가: 보수적으로 포함 안 함)
+    uint64_t over = 0;
+    for (uint16_t i = tr808HistBucket(threshold) + 1; i < TR808_HIST_BUCKETS; i++) {
+        over += counts[i];
+    }
+    return (uint32_t)((over * 10000) / total);
+}
+
+// ================ TR808Histogram 구현 ================
+
+TR808Histogram::TR808Histogram() : active(0) {
+    clearBank(0);
+    clearBank(1);
+}
+
+void TR808Histogram::clearBank(uint8_t bank) {
+    memset(counts[bank], 0, sizeof(counts[bank]));
+    total[bank] = 0;
+    minValue[bank] = 0xFFFFFFFF;
+    maxValue[bank] = 0;
+    sum[bank] = 0;
+}
+
+void TR808Histogram::snapshot(TR808HistogramSnapshot* out, bool resetOnRead) {
+    uint8_t bank = active;
+    if (resetOnRead) {
+        // 다음 기록부터 비어 있는 반대 뱅크로
+        __atomic_store_n(&active, (uint8_t)(bank ^ 1), __ATOMIC_RELEASE);
+    }
+
+    memcpy(out->counts, counts[bank], sizeof(out->counts));
+    out->total = total[bank];
+    out->minValue = minValue[bank];
+    out->maxValue = maxValue[bank];
+    out->sum = sum[bank];
+
+    if (resetOnRead) {
+        clearBank(bank);
+    }
+}
+
+void TR808Histogram::reset() {
+    // 비활성 뱅크는 항상 비어 있음: 전환 후 이전 뱅크만 비우면 됨
+    uint8_t bank = active;
+    __atomic_store_n(&active, (uint8_t)(bank ^ 1), __ATOMIC_RELEASE);
+    clearBank(bank);
+}
@@ -0,0 +1,124 @@
+/*
+ * TR-808 로그-선형 지연 히스토그램 (HDR 방식)
+ *
+ * 평균/최대 대신 꼬리 분포(p99.9)를 보기 위한 고정 메모리 히스토그램
+ * - 2의 거듭제곱 구간마다 TR808_HIST_SUB_BUCKETS개의 선형 버킷 (상대 오차 ≤ 1/16)
+ * - 기록: 상수 시간 (msb 위치 + 시프트 + 카운터 증가), 할당/락 없음
+ * - 스냅샷: 병합 가능 (세션 누적 = 구간 스냅샷 합), 백분위는 버킷 상한으로 보수적 추정
+ * - 읽고 초기화: 뱅크 2개를 교대로 사용, 읽는 쪽이 뱅크를 바꾼 뒤 이전 뱅크를 복사/비움
+ *   (단일 코어 전제: 기록자(ISR/오디오 루프)가 읽는 쪽보다 우선순위가 높아 기록 도중 전환 없음)
+ *
+ * 작성일: 2025-10-30
+ * 호환성: ESP32C3 Arduino / 호스트 (extras/host)
+ */
+
+#ifndef TR808_HISTOGRAM_H
+#define TR808_HISTOGRAM_H
+
+#include <stdint.h>
+
+// ============================================
+// 히스토그램 설정
+// ============================================
+
+#define TR808_HIST_SUB_BITS     4       // 2의 거듭제곱 구간당 선형 버킷 비트 (16개)
+#define TR808_HIST_MAX_BITS     24      // 기록 범위 0 ~ 2^24-1 (160MHz에서 약 105ms), 초과는 마지막 버킷
+
+#define TR808_HIST_SUB_BUCKETS  (1UL << TR808_HIST_SUB_BITS)
+#define TR808_HIST_BUCKETS      ((TR808_HIST_MAX_BITS - TR808_HIST_SUB_BITS + 1) * TR808_HIST_SUB_BUCKETS)
+#define TR808_HIST_MAX_VALUE    ((1UL << TR808_HIST_MAX_BITS) - 1)
+
+static_assert(TR808_HIST_MAX_BITS > TR808_HIST_SUB_BITS && TR808_HIST_MAX_BITS <= 31,
+              "TR808_HIST_MAX_BITS 범위 오류");
+
+// 백분위 지정 (만분율: 5000 = p50, 9900 = p99, 9990 = p99.9)
+#define TR808_P50       5000
+#define TR808_P99       9900
+#define TR808_P999      9990
+
+// 값 -> 버킷 인덱스 (상수 시간)
+inline uint16_t tr808HistBucket(uint32_t value) {
+    if (value > TR808_HIST_MAX_VALUE) value = TR808_HIST_MAX_VALUE;
+    if (value < TR808_HIST_SUB_BUCKETS) return (uint16_t)value;
+    uint32_t msb = 31 - __builtin_clz(value);
+    uint32_t shift = msb - TR808_HIST_SUB_BITS;
+    return (uint16_t)(((shift + 1) << TR808_HIST_SUB_BITS) +
+                      ((value >> shift) - TR808_HIST_SUB_BUCKETS));
+}
+
+// 버킷이 나타내는 최대값 (백분위는 이 값으로 보고: 꼬리를 낮게 보지 않음)
+inline uint32_t tr808HistBucketUpper(uint16_t bucket) {
+    if (bucket < TR808_HIST_SUB_BUCKETS) return bucket;
+    uint32_t shift = (bucket >> TR808_HIST_SUB_BITS) - 1;
+    uint32_t base = TR808_HIST_SUB_BUCKETS + (bucket & (TR808_HIST_SUB_BUCKETS - 1));
+    return ((base + 1) << shift) - 1;
+}
+
+// ============================================
+// 스냅샷
+// ============================================
+
+/**
+ * 히스토그램 사본 (읽는 쪽 전용)
+ * merge()로 구간 스냅샷을 세션 누적에 더하거나 여러 측정점을 합침
+ */
+struct TR808HistogramSnapshot {
+    uint32_t counts[TR808_HIST_BUCKETS];
+    uint32_t total;
+    uint32_t minValue;
+    uint32_t maxValue;
+    uint64_t sum;
+
+    void clear();
+    void merge(const TR808HistogramSnapshot& other);
+
+    // 만분율 백분위 (버킷 상한, 최대값 이하로 제한), 비어 있으면 0
+    uint32_t percentile(uint16_t perTenThousand) const;
+    uint32_t mean() const { return total > 0 ? (uint32_t)(sum / total) : 0; }
+
+    // threshold 초과 비율 (만분율): 마감 초과 위험
+    uint32_t exceedance(uint32_t threshold) const;
+};
+
+// ============================================
+// 히스토그램
+// ============================================
+
+/**
+ * 단일 기록자 로그-선형 히스토그램
+ * record()는 ISR/오디오 컨텍스트, snapshot()은 모니터 태스크에서 호출
+ */
+class TR808Histogram {
+private:
+    uint32_t counts[2][TR808_HIST_BUCKETS];
+    uint32_t total[2];
+    uint32_t minValue[2];
+    uint32_t maxValue[2];
+    uint64_t sum[2];
+    volatile uint8_t active;            // 기록 뱅크
+
+    void clearBank(uint8_t bank);
+
+public:
+    TR808Histogram();
+
+    inline void record(uint32_t value) {
+        uint8_t bank = active;
+        counts[bank][tr808HistBucket(value)]++;
+        total[bank]++;
+        sum[bank] += value;
+        if (value < minValue[bank]) minValue[bank] = value;
+        if (value > maxValue[bank]) maxValue[bank] = value;
+    }
+
+    /**
+     * 현재 뱅크 사본
+     * resetOnRead: 기록 뱅크를 바꾸고 이전 뱅크를 복사 후 비움 (구간 측정)
+     * 아니면 진행 중인 뱅크를 그대로 복사 (기록 중 값은 1~2개 어긋날 수 있음)
+     */
+    void snapshot(TR808HistogramSnapshot* out, bool resetOnRead);
+
+    void reset();
+};
+
+#endif // TR808_HISTOGRAM_H
@@ -0,0 +1,187 @@
+#include <new>
+#include "tr808_hybrid.h"
+#include "tr808_trace.h"
+
+void* TR808HybridMixer::profileScratch = nullptr;
+
+// ================ TR808HybridMixer 구현 ================
+
+TR808HybridMixer::TR808HybridMixer(TR808DrumMachine& engine)
+    : native(engine), mozziRouted(0), mozziActive(false)
+    , controlCountdown(TR808_HYBRID_CONTROL_SAMPLES)
+    , mozziGain(0.8f * TR808_HYBRID_MOZZI_SCALE) {
+    for (uint8_t voice = 0; voice < TR808_VOICE_COUNT; voice++) {
+        backends[voice] = TR808_BACKEND_NATIVE;
+    }
+}
+
+void TR808HybridMixer::begin() {
+    mozzi.begin();
+    // 풀 기본 8비트 크러셔는 네이티브 보이스와 섞이면 음질 차이가 두드러지므로 해제
+    mozzi.setBitCrushDepth(16);
+    controlCountdown = TR808_HYBRID_CONTROL_SAMPLES;
+
+    // 기본 구성: 킥/스네어는 네이티브 (피치 스윕/톤이 본체), 금속성 잡음 계열인
+    // 심벌/하이햇은 Mozzi (float 금속성 뱅크보다 싸고 차이가 잘 들리지 않음)
+    // -> 'engine <드럼> native|mozzi'로 드럼별 변경
+    mozzi.setMixLevel(TR808_GROUP_CYMBAL, TR808_HYBRID_MOZZI_CYMBAL_LEVEL);
+    mozzi.setMixLevel(TR808_GROUP_HIHAT, TR808_HYBRID_MOZZI_HIHAT_LEVEL);
+    setAllBackends(TR808_BACKEND_NATIVE);
+    setBackend(TR808_VOICE_CYMBAL, TR808_BACKEND_MOZZI);
+    setBackend(TR808_VOICE_HIHAT_CLOSED, TR808_BACKEND_MOZZI);
+}
+
+bool TR808HybridMixer::setBackend(uint8_t voice, TR808Backend backend) {
+    if (voice >= TR808_VOICE_COUNT) return false;
+    if (backend == TR808_BACKEND_MOZZI) {
+        if (!tr808HasMozziVoice(voice)) return false;
+        // Mozzi Oscil 증분은 빌드 레이트 기준: 네이티브 레이트가 다르면 피치가 틀어짐
+        if (native.getSampleRate() != MOZZI_TR808_AUDIO_RATE || native.hasPendingSampleRate()) {
+            return false;
+        }
+    }
+
+    // 오픈/클로즈드 하이햇은 같은 보이스를 공유 (초크) -> 함께 전환
+    uint8_t first = voice;
+    uint8_t last = voice;
+    if (voice == TR808_VOICE_HIHAT_CLOSED || voice == TR808_VOICE_HIHAT_OPEN) {
+        first = TR808_VOICE_HIHAT_CLOSED;
+        last = TR808_VOICE_HIHAT_OPEN;
+    }
+
+    for (uint8_t v = first; v <= last; v++) {
+        if (backends[v] == backend) continue;
+        backends[v] = backend;
+        if (backend == TR808_BACKEND_MOZZI) {
+            mozziRouted++;
+        } else {
+            mozziRouted--;
+        }
+    }
+
+    // Mozzi 라우팅이 모두 빠지면 남은 꼬리를 끊고 Mozzi 렌더를 생략
+    if (mozziRouted == 0) {
+        mozzi.stopAll();
+        mozziActive = false;
+    }
+    return true;
+}
+
+TR808Backend TR808HybridMixer::getBackend(uint8_t voice) const {
+    if (voice >= TR808_VOICE_COUNT) return TR808_BACKEND_NATIVE;
+    return (TR808Backend)backends[voice];
+}
+
+void TR808HybridMixer::setAllBackends(TR808Backend backend) {
+    for (uint8_t voice = 0; voice < TR808_VOICE_COUNT; voice++) {
+        if (tr808HasMozziVoice(voice)) {
+            setBackend(voice, backend);
+        }
+    }
+}
+
+void TR808HybridMixer::trigger(uint8_t voice, float velocity) {
+    if (voice >= TR808_VOICE_COUNT) return;
+    if (backends[voice] == TR808_BACKEND_MOZZI) {
+        triggerMozzi(voice, velocity);
+    } else {
+        triggerNative(voice, velocity);
+    }
+}
+
+void TR808HybridMixer::triggerNative(uint8_t voice, float velocity) {
+    switch (voice) {
+        case TR808_VOICE_KICK:         native.triggerKick(velocity); break;
+        case TR808_VOICE_SNARE:        native.triggerSnare(velocity); break;
+        case TR808_VOICE_CYMBAL:       native.triggerCymbal(velocity); break;
+        case TR808_VOICE_HIHAT_CLOSED: native.triggerHiHat(velocity, false); break;
+        case TR808_VOICE_HIHAT_OPEN:   native.triggerHiHat(velocity, true); break;
+        case TR808_VOICE_TOM:          native.triggerTom(velocity); break;
+        case TR808_VOICE_CONGA:        native.triggerConga(velocity); break;
+        case TR808_VOICE_RIMSHOT:      native.triggerRimshot(velocity); break;
+        case TR808_VOICE_MARACAS:      native.triggerMaracas(velocity); break;
+        case TR808_VOICE_CLAP:         native.triggerClap(velocity); break;
+        case TR808_VOICE_COWBELL:      native.triggerCowbell(velocity); break;
+    }
+}
+
+void TR808HybridMixer::triggerMozzi(uint8_t voice, float velocity) {
+    mozziActive = true;
+    switch (voice) {
+        case TR808_VOICE_KICK:         mozzi.triggerKick(velocity); break;
+        case TR808_VOICE_SNARE:        mozzi.triggerSnare(velocity); break;
+        case TR808_VOICE_CYMBAL:       mozzi.triggerCymbal(velocity); break;
+        case TR808_VOICE_HIHAT_CLOSED: mozzi.triggerHihat(false, velocity); break;
+        case TR808_VOICE_HIHAT_OPEN:   mozzi.triggerHihat(true, velocity); break;
+    }
+}
+
+TR808_HOT float TR808HybridMixer::process() {
+    // 네이티브 엔진: 마스터 볼륨/클리핑 포함
+    float output = native.process();
+
+    if (mozziActive) {
+        // Mozzi 컨트롤 틱 (엔벨롭 단계 진행), 모두 끝났으면 다음 트리거까지 렌더 생략
+        if (--controlCountdown == 0) {
+            TR808_PROFILE_STAGE(TR808_STAGE_CONTROL);
+            TR808_TRACE_EVENT(TR808_TRACE_CONTROL_BEGIN, 0);
+            mozzi.update();
+            TR808_TRACE_EVENT(TR808_TRACE_CONTROL_END, 0);
+            controlCountdown = TR808_HYBRID_CONTROL_SAMPLES;
+            mozziActive = mozzi.isAnyVoicePlaying();
+        }
+        output += mozzi.next() * mozziGain;
+
+        if (output > 1.0f) output = 1.0f;
+        if (output < -1.0f) output = -1.0f;
+    }
+
+    return output;
+}
+
+void TR808HybridMixer::setMasterVolume(float volume) {
+    native.setMasterVolume(volume);
+    mozziGain = volume * TR808_HYBRID_MOZZI_SCALE;
+}
+
+bool TR808HybridMixer::setSampleRate(uint32_t rate) {
+    // Mozzi 보이스가 라우팅되어 있으면 빌드 레이트 외 전환 불가
+    if (mozziRouted > 0 && rate != MOZZI_TR808_AUDIO_RATE) {
+        return false;
+    }
+    return native.setSampleRate(rate);
+}
+
+uint32_t TR808HybridMixer::profile(const uint8_t routing[TR808_VOICE_COUNT], uint32_t voiceMask,
+                                   uint16_t samples, TR808TickCounter counter) {
+    if (samples == 0 || profileScratch == nullptr) return 0;
+
+    // 새 인스턴스: 실행 중인 엔진의 보이스/엔벨롭 상태를 건드리지 않음 (작업 공간에 생성)
+    uint8_t* scratch = (uint8_t*)profileScratch;
+    TR808DrumMachine* engine = new (scratch) TR808DrumMachine();
+    TR808HybridMixer* mixer = new (scratch + TR808_HYBRID_PROFILE_ENGINE_BYTES) TR808HybridMixer(*engine);
+    mixer->begin();
+    for (uint8_t voice = 0; voice < TR808_VOICE_COUNT; voice++) {
+        if (tr808HasMozziVoice(voice)) {
+            mixer->setBackend(voice, (TR808Backend)routing[voice]);
+        }
+    }
+
+    for (uint8_t voice = 0; voice < TR808_VOICE_COUNT; voice++) {
+        if (voiceMask & TR808_VOICE_BIT(voice)) {
+            mixer->trigger(voice, 1.0f);
+        }
+    }
+
+    volatile float sink = 0.0f;
+    uint32_t start = counter();
+    for (uint16_t i = 0; i < samples; i++) {
+        sink += mixer->process();
+    }
+    uint32_t ticks = counter() - start;
+    (void)sink;
+
+    mixer->~TR808HybridMixer();
+    engine->~TR808DrumMachine();
+    return ticks / samples;
+}
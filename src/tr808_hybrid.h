@@ -0,0 +1,124 @@
+/*
+ * TR-808 하이브리드 엔진 (드럼별 네이티브/Mozzi 백엔드 선택)
+ *
+ * mozzi_integration_plan.h의 MOZZI_HYBRID 모드를 실제로 렌더하는 믹서
+ * 드럼마다 백엔드를 골라 두 엔진을 한 샘플 루프에서 합성
+ * - 네이티브(float, TR808DrumMachine): 기본 백엔드
+ * - Mozzi(고정소수점, TR808VoicePoolMozzi): 킥/스네어/심벌/하이햇을 드럼별로 선택
+ * - Mozzi 구현이 없는 보이스(톰, 콩가, 림샷 등)는 항상 네이티브
+ * - Mozzi update()는 믹서가 샘플 카운트로 CONTROL_RATE 주기마다 호출
+ * - Mozzi 보이스는 빌드 레이트(MOZZI_TR808_AUDIO_RATE) 고정: 레이트가 다르면 Mozzi 선택 거부
+ *
+ * 작성일: 2025-10-30
+ * 호환성: ESP32C3 Arduino + Mozzi / 호스트 (extras/host)
+ */
+
+#ifndef TR808_HYBRID_H
+#define TR808_HYBRID_H
+
+#include <stdint.h>
+#include "tr808_drums.h"
+#include "tr808_serial_protocol.h"
+#include "mozzi_tr808_drums.h"
+
+// ============================================
+// 하이브리드 설정
+// ============================================
+
+// Mozzi 컨트롤 틱 간격 (샘플)
+#define TR808_HYBRID_CONTROL_SAMPLES  (MOZZI_TR808_AUDIO_RATE / CONTROL_RATE)
+
+// Mozzi 출력(Q15)을 네이티브 스케일(-1.0 ~ 1.0)로 변환
+#define TR808_HYBRID_MOZZI_SCALE      (1.0f / 32768.0f)
+
+// 기본 구성에서 Mozzi로 보내는 심벌/하이햇의 그룹 레벨 (풀 기본 0.6/0.5 대신)
+// 네이티브 보이스와 출력 피크가 같도록 맞춤 (extras/host/hybrid_profile.cpp의 피크 열로 측정)
+#define TR808_HYBRID_MOZZI_CYMBAL_LEVEL  0.104f
+#define TR808_HYBRID_MOZZI_HIHAT_LEVEL   0.137f
+
+static_assert(TR808_HYBRID_CONTROL_SAMPLES > 0 && TR808_HYBRID_CONTROL_SAMPLES <= 65535,
+              "CONTROL_RATE는 오디오 레이트 이하여야 함");
+
+enum TR808Backend : uint8_t {
+    TR808_BACKEND_NATIVE = 0,
+    TR808_BACKEND_MOZZI
+};
+
+// 보이스 비트마스크 (프로파일 대상 지정)
+#define TR808_VOICE_BIT(voice)  (1UL << (voice))
+
+// Mozzi 보이스 풀에 대응 그룹이 있는 보이스 (오픈/클로즈드 하이햇은 한 그룹)
+constexpr bool tr808HasMozziVoice(uint8_t voice) {
+    return voice == TR808_VOICE_KICK || voice == TR808_VOICE_SNARE ||
+           voice == TR808_VOICE_CYMBAL || voice == TR808_VOICE_HIHAT_CLOSED ||
+           voice == TR808_VOICE_HIHAT_OPEN;
+}
+
+// 프로파일 측정용 틱 카운터 (기기: CPU 사이클, 호스트: ns)
+typedef uint32_t (*TR808TickCounter)();
+
+// ============================================
+// 하이브리드 믹서
+// ============================================
+
+/**
+ * 드럼별 백엔드 라우팅 + 단일 믹서
+ * 기본 구성: 킥/스네어 네이티브, 심벌/하이햇 Mozzi (레벨은 네이티브에 맞춤), setBackend()로 드럼별 변경
+ * 벨로시티는 두 백엔드 모두 전달 (Mozzi는 보이스 슬롯별 Q15 게인)
+ */
+class TR808HybridMixer {
+private:
+    TR808DrumMachine& native;
+    TR808VoicePoolMozzi mozzi;
+    uint8_t backends[TR808_VOICE_COUNT];    // TR808Backend
+    uint8_t mozziRouted;                    // Mozzi로 라우팅된 보이스 수
+    bool mozziActive;                       // 재생 중인 Mozzi 보이스 있음 (컨트롤 틱마다 갱신)
+    uint16_t controlCountdown;              // 다음 Mozzi update()까지 남은 샘플
+    float mozziGain;                        // Q15 -> float 변환 * 마스터 볼륨
+
+    void triggerNative(uint8_t voice, float velocity);
+    void triggerMozzi(uint8_t voice, float velocity);
+
+    static void* profileScratch;            // profile() 인스턴스 자리 (TR808_HYBRID_PROFILE_SCRATCH_BYTES)
+
+public:
+    explicit TR808HybridMixer(TR808DrumMachine& engine);
+
+    void begin();
+
+    // 백엔드 선택: Mozzi 구현이 없거나 레이트가 맞지 않으면 false
+    bool setBackend(uint8_t voice, TR808Backend backend);
+    TR808Backend getBackend(uint8_t voice) const;
+    void setAllBackends(TR808Backend backend);
+    uint8_t getMozziVoiceCount() const { return mozziRouted; }
+
+    // 라우팅된 백엔드로 트리거
+    void trigger(uint8_t voice, float velocity = 1.0f);
+
+    // 한 샘플 렌더 (-1.0 ~ 1.0): 네이티브 + Mozzi 합산 후 클리핑
+    float process();
+
+    // 설정 (두 엔진에 모두 적용)
+    void setMasterVolume(float volume);
+    bool setSampleRate(uint32_t rate);
+
+    TR808VoicePoolMozzi& getMozzi() { return mozzi; }
+
+    /**
+     * 렌더 비용 측정 (틱/샘플)
+     * 새 엔진 인스턴스에 voiceMask 보이스를 트리거한 뒤 samples 샘플을 렌더
+     * 실행 중인 엔진 상태(재생 중인 보이스)에 영향 없음
+     * 인스턴스는 setProfileScratch()로 받은 자리에 생성 (힙 사용 없음), 자리가 없으면 0
+     */
+    static uint32_t profile(const uint8_t routing[TR808_VOICE_COUNT], uint32_t voiceMask,
+                            uint16_t samples, TR808TickCounter counter);
+
+    // 시작 아레나에서 TR808_HYBRID_PROFILE_SCRATCH_BYTES (16바이트 정렬)를 받아 연결
+    static void setProfileScratch(void* storage) { profileScratch = storage; }
+};
+
+// profile() 작업 공간: 엔진 + 믹서 인스턴스 (각각 16바이트 정렬)
+#define TR808_HYBRID_PROFILE_ENGINE_BYTES   ((sizeof(TR808DrumMachine) + 15) & ~(size_t)15)
+#define TR808_HYBRID_PROFILE_SCRATCH_BYTES  (TR808_HYBRID_PROFILE_ENGINE_BYTES + sizeof(TR808HybridMixer))
+
+#endif // TR808_HYBRID_H
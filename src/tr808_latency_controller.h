@@ -0,0 +1,217 @@
+/*
+ * TR-808 적응형 출력 지연 컨트롤러
+ *
+ * 출력 블록 크기(= 지연)를 2의 거듭제곱 단위로 키우고 줄이는 폐루프 제어
+ * - 최소 크기에서 시작: 버틸 수 있는 가장 낮은 지연을 찾아감 (라이브 연주)
+ * - 키움: 마감 초과(언더런) 즉시, 또는 창 안 최악 서비스 시간이 마감의 90% 초과 시
+ * - 줄임: 여러 창 연속으로 언더런 없고 최악 서비스 시간이 마감의 40% 미만일 때만
+ *   (40%면 블록이 절반이 되어 서비스 시간이 전혀 줄지 않아도 새 마감의 80%)
+ * - 적용은 안전 지점에서만: 무음 블록(재설정 잡음이 들리지 않음)
+ *   키움은 이미 끊김이 나는 중이므로 무음을 오래 못 만나면 강제 적용
+ * - 키운 뒤 일정 시간은 줄이지 않음 (진동 방지), 최소=최대로 두면 고정 지연 (설치물)
+ * - 시간 단위는 출력 샘플 수: 장치 렌더 태스크와 호스트 모델(extras/host/dma_model.cpp)이 공유
+ *
+ * 작성일: 2025-10-30
+ * 호환성: ESP32C3 Arduino / 호스트 (extras/host)
+ */
+
+#ifndef TR808_LATENCY_CONTROLLER_H
+#define TR808_LATENCY_CONTROLLER_H
+
+#include <stdint.h>
+
+// ============================================
+// 컨트롤러 설정
+// ============================================
+
+#define TR808_LATENCY_WINDOW_MS         500     // 통계 창
+#define TR808_LATENCY_SHRINK_WINDOWS    20      // 줄이기 전 연속 안정 창 수 (10초)
+#define TR808_LATENCY_HOLD_MS           30000   // 키운 뒤 줄이기 금지 시간
+#define TR808_LATENCY_FORCE_MS          100     // 키움 요청 후 무음을 못 만나면 강제 적용
+#define TR808_LATENCY_GROW_PERCENT      90      // 최악 서비스 / 마감 > 90% -> 키움
+#define TR808_LATENCY_SHRINK_PERCENT    40      // 최악 서비스 / 마감 < 40% -> 줄임 후보
+
+enum TR808LatencyReason : uint8_t {
+    TR808_LATENCY_NONE = 0,
+    TR808_LATENCY_GROW_MISS,            // 언더런
+    TR808_LATENCY_GROW_HEADROOM,        // 마감 근접
+    TR808_LATENCY_SHRINK_STABLE,        // 여유 충분
+    TR808_LATENCY_MANUAL                // resizeAudioBuffer() 요청
+};
+
+// ============================================
+// 지연 컨트롤러
+// ============================================
+
+/**
+ * 블록마다 onBlock() 1회 (렌더 태스크), 적용 시점이면 true -> 출력 재설정 후 applyResize()
+ * 단일 스레드 사용 (렌더 태스크 전용)
+ */
+class TR808LatencyController {
+private:
+    uint32_t sampleRate;
+    uint8_t blockCount;
+    uint16_t minSamples;
+    uint16_t maxSamples;
+    uint16_t blockSamples;              // 현재 블록 크기
+    uint16_t pendingSamples;            // 적용 대기 중인 크기 (0 = 없음)
+    TR808LatencyReason pendingReason;
+    uint32_t deadlineUs;                // 현재 크기의 렌더 마감
+
+    uint32_t now;                       // 누적 출력 샘플 (시간축)
+    uint32_t windowStart;
+    uint32_t windowMaxServiceUs;
+    uint16_t windowMisses;
+    uint8_t stableWindows;
+    uint32_t holdUntil;
+    uint32_t pendingSince;
+
+    uint32_t grows;
+    uint32_t shrinks;
+    uint32_t misses;
+
+    inline uint32_t msToSamples(uint32_t ms) const { return (uint32_t)((uint64_t)ms * sampleRate / 1000); }
+
+    void updateDeadline() {
+        // 블록 수 - 1개 블록 주기 (재생 중인 블록은 DMA 소유)
+        deadlineUs = (uint32_t)((uint64_t)blockSamples * (blockCount - 1) * 1000000ULL / sampleRate);
+    }
+
+    void request(uint16_t samples, TR808LatencyReason reason) {
+        if (samples < minSamples) samples = minSamples;
+        if (samples > maxSamples) samples = maxSamples;
+        if (samples == blockSamples) {
+            pendingSamples = 0;
+            return;
+        }
+        // 키움 요청이 줄임 요청보다 우선
+        if (pendingSamples != 0 && pendingSamples > samples && reason != TR808_LATENCY_MANUAL) return;
+        if (pendingSamples == 0 || (samples > blockSamples) != (pendingSamples > blockSamples)) {
+            pendingSince = now;
+        }
+        pendingSamples = samples;
+        pendingReason = reason;
+    }
+
+    void resetWindow() {
+        windowStart = now;
+        windowMaxServiceUs = 0;
+        windowMisses = 0;
+    }
+
+public:
+    TR808LatencyController()
+        : sampleRate(64000), blockCount(2), minSamples(128), maxSamples(128), blockSamples(128),
+          pendingSamples(0), pendingReason(TR808_LATENCY_NONE), deadlineUs(0),
+          now(0), windowStart(0), windowMaxServiceUs(0), windowMisses(0), stableWindows(0),
+          holdUntil(0), pendingSince(0), grows(0), shrinks(0), misses(0) {}
+
+    /**
+     * 초기화: 최소 크기에서 시작
+     * minBlock/maxBlock: 2의 거듭제곱 (같으면 고정 지연)
+     */
+    void begin(uint32_t rate, uint8_t blocks, uint16_t minBlock, uint16_t maxBlock) {
+        sampleRate = rate;
+        blockCount = blocks < 2 ? 2 : blocks;
+        minSamples = minBlock;
+        maxSamples = maxBlock < minBlock ? minBlock : maxBlock;
+        blockSamples = minSamples;
+        pendingSamples = 0;
+        pendingReason = TR808_LATENCY_NONE;
+        now = 0;
+        stableWindows = 0;
+        holdUntil = 0;
+        grows = shrinks = misses = 0;
+        updateDeadline();
+        resetWindow();
+    }
+
+    // 범위 변경 (라이브: 낮은 최소, 설치물: 최소=최대), 현재 크기가 밖이면 다음 안전 지점에 맞춤
+    void setLimits(uint16_t minBlock, uint16_t maxBlock) {
+        minSamples = minBlock;
+        maxSamples = maxBlock < minBlock ? minBlock : maxBlock;
+        if (blockSamples < minSamples) request(minSamples, TR808_LATENCY_MANUAL);
+        if (blockSamples > maxSamples) request(maxSamples, TR808_LATENCY_MANUAL);
+    }
+
+    // 수동 요청 (2의 거듭제곱으로 올림, 안전 지점에서 적용)
+    void requestSize(uint16_t samples) {
+        uint16_t size = minSamples;
+        while (size < samples && size < maxSamples) size <<= 1;
+        request(size, TR808_LATENCY_MANUAL);
+        holdUntil = now + msToSamples(TR808_LATENCY_HOLD_MS);
+    }
+
+    // 마감 초과 (블록이 늦게 제출됨)
+    void onMiss() {
+        misses++;
+        windowMisses++;
+        stableWindows = 0;
+        if (blockSamples < maxSamples) {
+            request(blockSamples << 1, TR808_LATENCY_GROW_MISS);
+        }
+        holdUntil = now + msToSamples(TR808_LATENCY_HOLD_MS);
+    }
+
+    /**
+     * 블록 하나 처리 후 호출
+     * serviceUs: 깨어남 -> 제출 시간, silent: 이 블록이 무음인지 (안전 지점)
+     * 반환: 지금 getPendingSamples()로 재설정해야 하면 true
+     */
+    bool onBlock(uint32_t serviceUs, bool silent) {
+        now += blockSamples;
+        if (serviceUs > windowMaxServiceUs) windowMaxServiceUs = serviceUs;
+
+        if (now - windowStart >= msToSamples(TR808_LATENCY_WINDOW_MS)) {
+            if (windowMisses == 0 && blockSamples < maxSamples &&
+                (uint64_t)windowMaxServiceUs * 100 > (uint64_t)deadlineUs * TR808_LATENCY_GROW_PERCENT) {
+                request(blockSamples << 1, TR808_LATENCY_GROW_HEADROOM);
+                stableWindows = 0;
+                holdUntil = now + msToSamples(TR808_LATENCY_HOLD_MS);
+            } else if (windowMisses == 0 &&
+                       (uint64_t)windowMaxServiceUs * 100 < (uint64_t)deadlineUs * TR808_LATENCY_SHRINK_PERCENT) {
+                if (stableWindows < 255) stableWindows++;
+                if (stableWindows >= TR808_LATENCY_SHRINK_WINDOWS && blockSamples > minSamples &&
+                    (int32_t)(now - holdUntil) >= 0) {
+                    request(blockSamples >> 1, TR808_LATENCY_SHRINK_STABLE);
+                    stableWindows = 0;
+                }
+            } else {
+                stableWindows = 0;
+            }
+            resetWindow();
+        }
+
+        if (pendingSamples == 0) return false;
+        if (silent) return true;
+        // 키움은 무음을 오래 기다리지 않음 (이미 끊김 발생 중)
+        return pendingSamples > blockSamples &&
+               now - pendingSince >= msToSamples(TR808_LATENCY_FORCE_MS);
+    }
+
+    // 출력 재설정 완료 후 호출
+    void applyResize() {
+        if (pendingSamples == 0) return;
+        if (pendingSamples > blockSamples) grows++; else shrinks++;
+        blockSamples = pendingSamples;
+        pendingSamples = 0;
+        pendingReason = TR808_LATENCY_NONE;
+        stableWindows = 0;
+        updateDeadline();
+        resetWindow();
+    }
+
+    uint16_t getBlockSamples() const { return blockSamples; }
+    uint32_t getLatencySamples() const { return (uint32_t)blockSamples * blockCount; }
+    uint32_t getDeadlineUs() const { return deadlineUs; }
+    uint32_t getBlockPeriodUs() const { return deadlineUs / (blockCount - 1); }
+    uint16_t getPendingSamples() const { return pendingSamples; }
+    TR808LatencyReason getPendingReason() const { return pendingReason; }
+    uint16_t getMinSamples() const { return minSamples; }
+    uint16_t getMaxSamples() const { return maxSamples; }
+    uint32_t getGrows() const { return grows; }
+    uint32_t getShrinks() const { return shrinks; }
+    uint32_t getMisses() const { return misses; }
+};
+
+#endif // TR808_LATENCY_CONTROLLER_H
@@ -0,0 +1,150 @@
+#include <stdio.h>
+#include "tr808_log.h"
+
+TR808LogSink tr808Log;
+
+// TR808LogFormatId 순서와 일치
+static const char* const LOG_FORMATS[TR808_LOG_FORMAT_COUNT] = {
+    "⚠️ I2S 버퍼 경고: %ld/%ld",
+    "❌ I2S 레이트 변경 실패, 복구: %ld Hz",
+    "❌ I2S 레이트 변경(%ld Hz)과 복구(%ld Hz) 모두 실패, 출력 중단 ('reset'으로 재시작)",
+
+    "Initializing ESP32C3 DMA audio output...",
+    "ERROR: Failed to install I2S DMA output",
+    "DMA output ready: %ld blocks x %ld samples (%ld us/block)",
+    "Starting DMA output...",
+    "Stopping DMA output...",
+    "WARNING: DMA underrun (total %ld blocks, wrote %ld bytes)",
+    "ERROR: Failed to start audio render task",
+
+    "PWM output ready: %ld Hz carrier, %ld-bit, noise shaping order %ld",
+    "ERROR: Failed to allocate PWM sample timer",
+    "WARNING: PWM underrun (total %ld blocks)",
+
+    "Output block grown: %ld -> %ld samples (latency %ld samples)",
+    "Output block shrunk: %ld -> %ld samples (latency %ld samples)",
+    "ERROR: Failed to resize output block to %ld samples",
+
+    "Performance Summary - CPU: %ld%%, Heap: %ld bytes",
+    "WARNING: High CPU usage: %ld%%",
+    "WARNING: Low memory: %ld bytes",
+    "WARNING: High p99.9 block service time: %ld μs (target: %ld μs)",
+    "WARNING: Multiple buffer overflows: %ld",
+    "Performance degradation detected - consider optimization",
+};
+
+// ================ TR808LogSink 구현 ================
+
+TR808LogSink::TR808LogSink()
+    : head(0), tail(0), dropped(0), reportedDropped(0), written(0) {
+#if defined(ARDUINO_ARCH_ESP32)
+    drainTask = nullptr;
+#endif
+    for (uint32_t i = 0; i < TR808_LOG_RECORDS; i++) {
+        records[i].sequence = i;
+    }
+}
+
+bool TR808LogSink::log(uint16_t format, int32_t arg0, int32_t arg1, int32_t arg2) {
+    // 슬롯 시퀀스 == 위치면 비어 있음: 위치를 CAS로 예약 (경합 시 재시도)
+    uint32_t pos = __atomic_load_n(&head, __ATOMIC_RELAXED);
+    TR808LogRecord* slot;
+    while (true) {
+        slot = &records[pos & (TR808_LOG_RECORDS - 1)];
+        int32_t diff = (int32_t)(__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) - pos);
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&head, &pos, pos + 1, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // 소비자가 밀림: 기다리지 않고 버림
+            __atomic_fetch_add(&dropped, 1, __ATOMIC_RELAXED);
+            return false;
+        } else {
+            pos = __atomic_load_n(&head, __ATOMIC_RELAXED);
+        }
+    }
+
+    slot->timeMs = millis();
+    slot->format = format;
+    slot->args[0] = arg0;
+    slot->args[1] = arg1;
+    slot->args[2] = arg2;
+    __atomic_store_n(&slot->sequence, pos + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+uint16_t TR808LogSink::drain(TR808LogOutput output, uint16_t maxRecords) {
+    char line[TR808_LOG_LINE_SIZE];
+    uint16_t lines = 0;
+
+    uint32_t lost = __atomic_load_n(&dropped, __ATOMIC_RELAXED);
+    if (lost != reportedDropped) {
+        snprintf(line, sizeof(line), "⚠️ 로그 %lu개 유실 (링 가득 참)",
+                 (unsigned long)(lost - reportedDropped));
+        output(line);
+        reportedDropped = lost;
+        lines++;
+    }
+
+    while (lines < maxRecords) {
+        TR808LogRecord& slot = records[tail & (TR808_LOG_RECORDS - 1)];
+        if (__atomic_load_n(&slot.sequence, __ATOMIC_ACQUIRE) != tail + 1) {
+            break; // 비었거나 기록 중
+        }
+
+        // 포맷팅 전에 복사하고 슬롯 반환 (기록자가 오래 막히지 않게)
+        uint32_t timeMs = slot.timeMs;
+        uint16_t format = slot.format;
+        long arg0 = slot.args[0], arg1 = slot.args[1], arg2 = slot.args[2];
+        __atomic_store_n(&slot.sequence, tail + TR808_LOG_RECORDS, __ATOMIC_RELEASE);
+        tail++;
+
+        int prefix = snprintf(line, sizeof(line), "[%lu.%03lu] ",
+                              (unsigned long)(timeMs / 1000), (unsigned long)(timeMs % 1000));
+        if (format < TR808_LOG_FORMAT_COUNT) {
+            snprintf(line + prefix, sizeof(line) - prefix, LOG_FORMATS[format], arg0, arg1, arg2);
+        } else {
+            snprintf(line + prefix, sizeof(line) - prefix, "log #%u (%ld, %ld, %ld)",
+                     format, arg0, arg1, arg2);
+        }
+        output(line);
+        written++;
+        lines++;
+    }
+    return lines;
+}
+
+uint32_t TR808LogSink::getPending() const {
+    return __atomic_load_n(&head, __ATOMIC_RELAXED) - tail;
+}
+
+#if defined(ARDUINO_ARCH_ESP32)
+
+static void printLogLine(const char* line) {
+    Serial.println(line);
+}
+
+static void logDrainTask(void* parameters) {
+    TR808LogSink* sink = (TR808LogSink*)parameters;
+    TickType_t lastWake = xTaskGetTickCount();
+    while (true) {
+        vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(TR808_LOG_DRAIN_MS));
+        sink->drain(printLogLine, TR808_LOG_DRAIN_MAX);
+    }
+}
+
+bool TR808LogSink::startTask(uint8_t priority, uint32_t stackSize) {
+    if (drainTask != nullptr) return true;
+
+    TaskHandle_t handle = nullptr;
+    if (xTaskCreate(logDrainTask, "tr808_log", stackSize, this,
+                    priority, &handle) != pdPASS) {
+        return false;
+    }
+    drainTask = handle;
+    return true;
+}
+
+#endif
@@ -0,0 +1,131 @@
+/*
+ * TR-808 비동기 로그 싱크
+ *
+ * 실시간 경로(오디오 루프, 렌더 태스크, DMA 출력 설정)에서 Serial.println/String 포맷팅을 없애기 위한 로그
+ * - 기록: 고정 크기 바이너리 레코드 {시각, 포맷 ID, 정수 인자 3개}를 링에 복사만 함
+ * - 출력: 저우선순위 태스크가 포맷 표로 문자열을 만들어 UART로 전송
+ * - 링: 다중 기록자/단일 소비자, 슬롯별 시퀀스 번호 (락 없음, ISR에서도 호출 가능)
+ * - 링이 차면 기록자는 기다리지 않고 버림 + 유실 카운터 증가 (로그가 오버런을 늘리지 않음)
+ *   유실은 소비자가 다음 출력 때 한 줄로 보고
+ *
+ * 작성일: 2025-10-30
+ * 호환성: ESP32C3 Arduino / 호스트 (extras/host)
+ */
+
+#ifndef TR808_LOG_H
+#define TR808_LOG_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <Arduino.h>
+
+// ============================================
+// 로그 설정
+// ============================================
+
+#define TR808_LOG_RECORDS       64      // 링 크기 (2의 거듭제곱, 24바이트/레코드)
+#define TR808_LOG_ARGS          3       // 레코드당 정수 인자 수
+#define TR808_LOG_LINE_SIZE     128     // 출력 한 줄 최대 길이
+#define TR808_LOG_DRAIN_MS      20      // 출력 태스크 주기
+#define TR808_LOG_DRAIN_MAX     8       // 주기당 최대 출력 줄 수 (UART 점유 제한)
+
+static_assert((TR808_LOG_RECORDS & (TR808_LOG_RECORDS - 1)) == 0,
+              "TR808_LOG_RECORDS는 2의 거듭제곱이어야 함");
+
+// ============================================
+// 포맷 ID (tr808_log.cpp의 포맷 표와 순서 일치)
+// 인자는 int32_t, 포맷은 %ld만 사용
+// ============================================
+
+enum TR808LogFormatId : uint16_t {
+    // 오디오 루프 (TR808_ESP32C3.ino)
+    TR808_LOG_I2S_SHORT_WRITE = 0,      // 기록 바이트 수, 블록 크기 (샘플)
+    TR808_LOG_RATE_RESTORED,            // 복구된 레이트
+    TR808_LOG_RATE_RESTORE_FAILED,      // 요청 레이트, 복구 레이트
+
+    // DMA 블록 출력 (extras/dma_output_esp32c3.cpp)
+    TR808_LOG_DMA_INIT,
+    TR808_LOG_DMA_INIT_FAILED,
+    TR808_LOG_DMA_READY,                // 블록 수, 블록 샘플 수, 블록 주기 μs
+    TR808_LOG_DMA_START,
+    TR808_LOG_DMA_STOP,
+    TR808_LOG_DMA_UNDERRUN,             // 누적 언더런 블록, 기록 바이트
+    TR808_LOG_DMA_TASK_FAILED,
+
+    // PWM 블록 출력 (extras/audio_output_esp32c3.cpp)
+    TR808_LOG_PWM_READY,                // 캐리어 Hz, 분해능 비트, 셰이핑 차수
+    TR808_LOG_PWM_TIMER_FAILED,
+    TR808_LOG_PWM_UNDERRUN,             // 누적 언더런 블록
+
+    // 적응형 지연 (extras/buffer_manager_esp32c3.cpp)
+    TR808_LOG_LATENCY_GROW,             // 이전 블록, 새 블록, 새 지연 샘플
+    TR808_LOG_LATENCY_SHRINK,           // 이전 블록, 새 블록, 새 지연 샘플
+    TR808_LOG_LATENCY_RESIZE_FAILED,    // 요청 블록 크기
+
+    // 성능 모니터 (extras/performance_monitor_esp32c3.cpp)
+    TR808_LOG_PERF_SUMMARY,             // CPU %, 여유 힙
+    TR808_LOG_WARN_CPU,                 // CPU %
+    TR808_LOG_WARN_HEAP,                // 여유 힙
+    TR808_LOG_WARN_SERVICE_TAIL,        // 블록 서비스 p99.9 μs, 목표 μs
+    TR808_LOG_WARN_OVERFLOW,            // 오버플로우 횟수
+    TR808_LOG_WARN_DEGRADED,
+
+    TR808_LOG_FORMAT_COUNT
+};
+
+struct TR808LogRecord {
+    volatile uint32_t sequence;         // 슬롯 상태 (기록 완료 = 위치 + 1)
+    uint32_t timeMs;
+    uint16_t format;                    // TR808LogFormatId
+    uint16_t reserved;
+    int32_t args[TR808_LOG_ARGS];
+};
+
+static_assert(sizeof(TR808LogRecord) == 24, "로그 레코드는 24바이트");
+
+// 포맷된 한 줄 출력 (개행 미포함)
+typedef void (*TR808LogOutput)(const char* line);
+
+// ============================================
+// 로그 싱크
+// ============================================
+
+/**
+ * 고정 레코드 로그 링
+ * log()는 어느 컨텍스트에서나 호출 가능, drain()은 출력 태스크(단일 소비자)에서만 호출
+ */
+class TR808LogSink {
+private:
+    TR808LogRecord records[TR808_LOG_RECORDS];
+    volatile uint32_t head;             // 기록자 예약 위치
+    uint32_t tail;                      // 소비자 위치
+    volatile uint32_t dropped;          // 링이 차서 버린 레코드 (누적)
+    uint32_t reportedDropped;           // 소비자가 이미 보고한 유실 수
+    uint32_t written;                   // 출력한 레코드 (누적)
+
+#if defined(ARDUINO_ARCH_ESP32)
+    void* drainTask;
+#endif
+
+public:
+    TR808LogSink();
+
+    // 레코드 복사만 수행, 링이 차면 false (유실 카운터 증가)
+    bool log(uint16_t format, int32_t arg0 = 0, int32_t arg1 = 0, int32_t arg2 = 0);
+
+    // 최대 maxRecords개를 포맷해 출력, 출력한 줄 수 반환 (유실 보고 줄 포함)
+    uint16_t drain(TR808LogOutput output, uint16_t maxRecords);
+
+    uint32_t getDropped() const { return dropped; }
+    uint32_t getWritten() const { return written; }
+    uint32_t getPending() const;
+
+#if defined(ARDUINO_ARCH_ESP32)
+    // Serial로 출력하는 저우선순위 태스크 (이미 실행 중이면 true)
+    bool startTask(uint8_t priority = 0, uint32_t stackSize = 3072);
+#endif
+};
+
+extern TR808LogSink tr808Log;
+
+#endif // TR808_LOG_H
@@ -0,0 +1,128 @@
+#include "tr808_midi.h"
+#include <string.h>
+
+// ================ 노트 -> 보이스 테이블 ================
+
+#define TR808_NOTE_ROW(n) \
+    tr808NoteToVoice(n + 0),  tr808NoteToVoice(n + 1),  tr808NoteToVoice(n + 2),  tr808NoteToVoice(n + 3),  \
+    tr808NoteToVoice(n + 4),  tr808NoteToVoice(n + 5),  tr808NoteToVoice(n + 6),  tr808NoteToVoice(n + 7),  \
+    tr808NoteToVoice(n + 8),  tr808NoteToVoice(n + 9),  tr808NoteToVoice(n + 10), tr808NoteToVoice(n + 11), \
+    tr808NoteToVoice(n + 12), tr808NoteToVoice(n + 13), tr808NoteToVoice(n + 14), tr808NoteToVoice(n + 15)
+
+constexpr uint8_t TR808_NOTE_TO_VOICE[128] = {
+    TR808_NOTE_ROW(0),  TR808_NOTE_ROW(16), TR808_NOTE_ROW(32), TR808_NOTE_ROW(48),
+    TR808_NOTE_ROW(64), TR808_NOTE_ROW(80), TR808_NOTE_ROW(96), TR808_NOTE_ROW(112)
+};
+
+static_assert(TR808_NOTE_TO_VOICE[MIDI_KICK_NOTE] == TR808_VOICE_KICK, "킥 노트 매핑 오류");
+static_assert(TR808_NOTE_TO_VOICE[MIDI_SNARE_NOTE] == TR808_VOICE_SNARE, "스네어 노트 매핑 오류");
+static_assert(TR808_NOTE_TO_VOICE[MIDI_COWBELL_NOTE] == TR808_VOICE_COWBELL, "카우벨 노트 매핑 오류");
+static_assert(TR808_NOTE_TO_VOICE[0] == TR808_MIDI_NO_VOICE, "매핑되지 않은 노트는 무시");
+static_assert((TR808_EVENT_QUEUE_SIZE & (TR808_EVENT_QUEUE_SIZE - 1)) == 0,
+              "이벤트 큐 크기는 2의 거듭제곱이어야 함");
+
+// ================ TR808MidiParser 구현 ================
+
+TR808MidiParser::TR808MidiParser() {
+    memset(&stats, 0, sizeof(stats));
+    reset();
+}
+
+void TR808MidiParser::reset() {
+    runningStatus = 0;
+    dataCount = 0;
+    expected = 0;
+    inSysex = false;
+}
+
+uint8_t TR808MidiParser::dataLength(uint8_t status) {
+    switch (status & 0xF0) {
+        case 0xC0:  // Program Change
+        case 0xD0:  // Channel Pressure
+            return 1;
+        case 0xF0:
+            switch (status) {
+                case 0xF1:  // MTC Quarter Frame
+                case 0xF3:  // Song Select
+                    return 1;
+                case 0xF2:  // Song Position Pointer
+                    return 2;
+                default:    // 0xF6 Tune Request 등
+                    return 0;
+            }
+        default:
+            return 2;
+    }
+}
+
+bool TR808MidiParser::feed(uint8_t byte, uint32_t timestamp, TR808MidiMessage* out) {
+    // 리얼타임 바이트: 어떤 메시지 중간에도 끼어들 수 있으며 상태에 영향 없음
+    if (byte >= MIDI_STATUS_REALTIME) {
+        out->status = byte;
+        out->data1 = 0;
+        out->data2 = 0;
+        out->timestamp = timestamp;
+        stats.realtime++;
+        return true;
+    }
+
+    if (byte & 0x80) {
+        // 상태 바이트
+        inSysex = false;
+        dataCount = 0;
+
+        if (byte == MIDI_STATUS_SYSEX_START) {
+            inSysex = true;
+            runningStatus = 0;
+            return false;
+        }
+        if (byte == MIDI_STATUS_SYSEX_END || byte == 0xF4 || byte == 0xF5) {
+            runningStatus = 0;
+            return false;
+        }
+
+        expected = dataLength(byte);
+        if (byte >= 0xF0) {
+            // 시스템 공통 메시지는 러닝 스테이터스 해제
+            runningStatus = 0;
+            if (expected == 0) {
+                out->status = byte;
+                out->data1 = 0;
+                out->data2 = 0;
+                out->timestamp = timestamp;
+                stats.messages++;
+                return true;
+            }
+        }
+        runningStatus = byte;
+        return false;
+    }
+
+    // 데이터 바이트
+    if (inSysex) {
+        stats.sysexBytes++;
+        return false;
+    }
+    if (runningStatus == 0) {
+        stats.strayData++;
+        return false;
+    }
+
+    data[dataCount++] = byte;
+    if (dataCount < expected) {
+        return false;
+    }
+
+    out->status = runningStatus;
+    out->data1 = data[0];
+    out->data2 = expected > 1 ? data[1] : 0;
+    out->timestamp = timestamp;
+    dataCount = 0;
+    stats.messages++;
+
+    // 시스템 공통 메시지는 러닝 스테이터스 대상이 아님
+    if (runningStatus >= 0xF0) {
+        runningStatus = 0;
+    }
+    return true;
+}
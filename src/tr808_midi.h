@@ -0,0 +1,259 @@
+/*
+ * TR-808 저지연 MIDI 입력
+ *
+ * update() 폴링 방식의 MIDI 처리는 루프 주기만큼 지연/지터가 생기므로,
+ * UART 수신 시점에 바이트 단위로 파싱하고 오디오 샘플 시간으로
+ * 타임스탬프를 찍어 오디오 이벤트 큐에 넣는 경로를 제공
+ * - 러닝 스테이터스, 리얼타임 바이트(메시지 중간 삽입 허용), SysEx 건너뛰기
+ * - 이벤트는 "수신 샘플 시각 + 고정 지연"에 샘플 단위로 재생 (지터 제거)
+ * - 노트 -> 보이스 변환은 컴파일 타임 생성 128 엔트리 테이블
+ *
+ * 작성일: 2025-10-30
+ * 호환성: ESP32C3 Arduino
+ */
+
+#ifndef TR808_MIDI_H
+#define TR808_MIDI_H
+
+#include <stdint.h>
+#include "arduino_tr808_config.h"
+#include "tr808_serial_protocol.h"
+
+// ============================================
+// MIDI 설정
+// ============================================
+
+#define TR808_MIDI_NO_VOICE        0xFF   // 매핑되지 않은 노트
+#define TR808_EVENT_QUEUE_SIZE     64     // 오디오 이벤트 큐 크기 (2의 거듭제곱)
+
+// MIDI 상태 바이트
+#define MIDI_STATUS_NOTE_OFF       0x80
+#define MIDI_STATUS_NOTE_ON        0x90
+#define MIDI_STATUS_CONTROL_CHANGE 0xB0
+#define MIDI_STATUS_SYSEX_START    0xF0
+#define MIDI_STATUS_SYSEX_END      0xF7
+#define MIDI_STATUS_REALTIME       0xF8   // 0xF8 이상은 리얼타임 메시지
+
+// ============================================
+// 노트 -> 보이스 변환 (컴파일 타임)
+// ============================================
+
+// arduino_tr808_config.h의 MIDI_*_NOTE 설정 + GM 드럼맵 보조 노트
+constexpr uint8_t tr808NoteToVoice(uint8_t note) {
+    return note == MIDI_KICK_NOTE         ? TR808_VOICE_KICK :
+           note == 35                     ? TR808_VOICE_KICK :          // Acoustic Bass Drum
+           note == MIDI_SNARE_NOTE        ? TR808_VOICE_SNARE :
+           note == 40                     ? TR808_VOICE_SNARE :         // Electric Snare
+           note == MIDI_CYMBAL_NOTE       ? TR808_VOICE_CYMBAL :
+           note == 51 || note == 57       ? TR808_VOICE_CYMBAL :        // Ride / Crash 2
+           note == MIDI_HIHAT_CLOSED_NOTE ? TR808_VOICE_HIHAT_CLOSED :
+           note == 44                     ? TR808_VOICE_HIHAT_CLOSED :  // Pedal Hi-Hat
+           note == MIDI_HIHAT_OPEN_NOTE   ? TR808_VOICE_HIHAT_OPEN :
+           note == MIDI_TOM_LOW_NOTE      ? TR808_VOICE_TOM :
+           note == MIDI_TOM_MID_NOTE      ? TR808_VOICE_TOM :
+           note == MIDI_TOM_HIGH_NOTE     ? TR808_VOICE_TOM :
+           note == 41 || note == 48 || note == 50 ? TR808_VOICE_TOM :   // 나머지 GM 톰
+           note == MIDI_CONGA_LOW_NOTE    ? TR808_VOICE_CONGA :
+           note == MIDI_CONGA_HIGH_NOTE   ? TR808_VOICE_CONGA :
+           note == 64                     ? TR808_VOICE_CONGA :         // Low Conga (GM)
+           note == MIDI_RIMSHOT_NOTE      ? TR808_VOICE_RIMSHOT :
+           note == MIDI_MARACAS_NOTE      ? TR808_VOICE_MARACAS :
+           note == 70                     ? TR808_VOICE_MARACAS :       // Maracas (GM)
+           note == MIDI_CLAP_NOTE         ? TR808_VOICE_CLAP :
+           note == MIDI_COWBELL_NOTE      ? TR808_VOICE_COWBELL :
+           TR808_MIDI_NO_VOICE;
+}
+
+// 런타임 조회용 테이블 (분기 없는 단일 로드)
+extern const uint8_t TR808_NOTE_TO_VOICE[128];
+
+// ============================================
+// 오디오 이벤트 큐
+// ============================================
+
+enum TR808EventType : uint8_t {
+    TR808_EVENT_TRIGGER = 0,    // value = 벨로시티 (0-127)
+    TR808_EVENT_VOLUME,         // value = 마스터 볼륨 (0-127)
+    TR808_EVENT_CLOCK,          // MIDI 클럭 틱 (0xF8)
+    TR808_EVENT_START,          // 0xFA
+    TR808_EVENT_CONTINUE,       // 0xFB
+    TR808_EVENT_STOP,           // 0xFC
+    TR808_EVENT_SONG_POSITION   // voice = LSB, value = MSB (16분음표 단위)
+};
+
+struct TR808AudioEvent {
+    uint32_t sampleTime;        // 재생할 오디오 샘플 시각
+    uint8_t type;               // TR808EventType
+    uint8_t voice;              // TR808Voice
+    uint8_t value;
+};
+
+/**
+ * 단일 생산자/단일 소비자 락프리 큐
+ * 생산자: UART 수신 콜백, 소비자: 오디오 렌더 루프
+ */
+class TR808EventQueue {
+private:
+    TR808AudioEvent events[TR808_EVENT_QUEUE_SIZE];
+    volatile uint32_t head;     // 생산자만 기록
+    volatile uint32_t tail;     // 소비자만 기록
+    volatile uint32_t dropped;
+
+public:
+    TR808EventQueue() : head(0), tail(0), dropped(0) {}
+
+    bool push(const TR808AudioEvent& event) {
+        uint32_t h = head;
+        if (h - __atomic_load_n(&tail, __ATOMIC_ACQUIRE) >= TR808_EVENT_QUEUE_SIZE) {
+            dropped++;
+            return false;
+        }
+        events[h & (TR808_EVENT_QUEUE_SIZE - 1)] = event;
+        __atomic_store_n(&head, h + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+
+    // 재생 시각이 도래한 이벤트만 꺼냄
+    bool popDue(uint32_t now, TR808AudioEvent* out) {
+        uint32_t t = tail;
+        if (t == __atomic_load_n(&head, __ATOMIC_ACQUIRE)) return false;
+
+        const TR808AudioEvent& event = events[t & (TR808_EVENT_QUEUE_SIZE - 1)];
+        if ((int32_t)(event.sampleTime - now) > 0) return false;
+
+        *out = event;
+        __atomic_store_n(&tail, t + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+
+    uint32_t getDropped() const { return dropped; }
+};
+
+// ============================================
+// 오디오 샘플 시계
+// ============================================
+
+/**
+ * 오디오 샘플 단위 현재 시각
+ * 렌더 루프가 블록 시작마다 기준점을 기록하고, 인터럽트/콜백에서는
+ * CPU 사이클 카운터 경과량으로 블록 내부 위치를 보간 (나눗셈 없음)
+ *
+ * 기준점(샘플, 사이클, 비율)은 32비트 하나에 담을 수 없으므로 두 슬롯에 번갈아 쓰고
+ * 시퀀스 번호로 게시 (래치형 seqlock)
+ * - 기록 중인 슬롯은 읽는 쪽이 보는 슬롯과 다르므로, 콜백이 렌더 루프를
+ *   선점해도 절반만 갱신된 기준점을 읽지 않고 기다리지도 않음
+ * - 읽는 동안 게시가 일어나면 (다음 기록이 읽던 슬롯을 덮을 수 있으므로) 다시 읽음
+ */
+class TR808SampleClock {
+private:
+    struct Anchor {
+        uint32_t sample;
+        uint32_t cycles;
+        uint32_t samplesPerCycleQ32;    // sampleRate / cpuHz (Q0.32)
+    };
+
+    Anchor anchors[2];
+    uint32_t sequence;                  // 게시 횟수, 현재 슬롯 = sequence & 1
+
+    // 단일 기록자 (렌더 루프 / 레이트 전환): 비활성 슬롯에 쓰고 게시
+    void publish(uint32_t sample, uint32_t cycles, uint32_t samplesPerCycleQ32) {
+        uint32_t next = __atomic_load_n(&sequence, __ATOMIC_RELAXED) + 1;
+        Anchor& anchor = anchors[next & 1];
+        anchor.sample = sample;
+        anchor.cycles = cycles;
+        anchor.samplesPerCycleQ32 = samplesPerCycleQ32;
+        __atomic_store_n(&sequence, next, __ATOMIC_RELEASE);
+    }
+
+    Anchor current() const {
+        Anchor anchor;
+        uint32_t seq = __atomic_load_n(&sequence, __ATOMIC_ACQUIRE);
+        for (;;) {
+            const Anchor& slot = anchors[seq & 1];
+            anchor.sample = __atomic_load_n(&slot.sample, __ATOMIC_RELAXED);
+            anchor.cycles = __atomic_load_n(&slot.cycles, __ATOMIC_RELAXED);
+            anchor.samplesPerCycleQ32 = __atomic_load_n(&slot.samplesPerCycleQ32, __ATOMIC_RELAXED);
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            uint32_t check = __atomic_load_n(&sequence, __ATOMIC_RELAXED);
+            if (check == seq) return anchor;
+            seq = check;
+        }
+    }
+
+public:
+    TR808SampleClock() : sequence(0) {
+        anchors[0].sample = anchors[1].sample = 0;
+        anchors[0].cycles = anchors[1].cycles = 0;
+        anchors[0].samplesPerCycleQ32 = anchors[1].samplesPerCycleQ32 = 0;
+    }
+
+    // 기준점 샘플/사이클은 유지하고 비율만 교체 (레이트 전환)
+    void begin(uint32_t sampleRate, uint32_t cpuHz) {
+        Anchor anchor = current();
+        publish(anchor.sample, anchor.cycles, (uint32_t)(((uint64_t)sampleRate << 32) / cpuHz));
+    }
+
+    // 렌더 루프: 블록 첫 샘플 렌더 직전에 호출
+    void beginBlock(uint32_t samplePosition, uint32_t cycles) {
+        publish(samplePosition, cycles, anchors[sequence & 1].samplesPerCycleQ32);
+    }
+
+    uint32_t now(uint32_t cycles) const {
+        Anchor anchor = current();
+        uint32_t elapsed = cycles - anchor.cycles;
+        return anchor.sample + (uint32_t)(((uint64_t)elapsed * anchor.samplesPerCycleQ32) >> 32);
+    }
+
+    // 샘플 시각 sample까지 남은 CPU 사이클 (이미 지났으면 0, 타이머 예약용)
+    uint32_t cyclesUntil(uint32_t sample, uint32_t cycles) const {
+        Anchor anchor = current();
+        uint32_t elapsed = cycles - anchor.cycles;
+        uint32_t position = anchor.sample + (uint32_t)(((uint64_t)elapsed * anchor.samplesPerCycleQ32) >> 32);
+        int32_t ahead = (int32_t)(sample - position);
+        if (ahead <= 0 || anchor.samplesPerCycleQ32 == 0) return 0;
+        return (uint32_t)(((uint64_t)ahead << 32) / anchor.samplesPerCycleQ32);
+    }
+};
+
+// ============================================
+// 바이트 단위 MIDI 파서
+// ============================================
+
+struct TR808MidiMessage {
+    uint8_t status;             // 채널 메시지는 채널 포함
+    uint8_t data1;
+    uint8_t data2;
+    uint32_t timestamp;         // 오디오 샘플 시각
+};
+
+class TR808MidiParser {
+public:
+    struct Stats {
+        uint32_t messages;
+        uint32_t realtime;
+        uint32_t sysexBytes;    // 건너뛴 SysEx 바이트
+        uint32_t strayData;     // 상태 없는 데이터 바이트
+    };
+
+private:
+    uint8_t runningStatus;
+    uint8_t data[2];
+    uint8_t dataCount;
+    uint8_t expected;           // 현재 상태의 데이터 바이트 수
+    bool inSysex;
+    Stats stats;
+
+    static uint8_t dataLength(uint8_t status);
+
+public:
+    TR808MidiParser();
+
+    void reset();
+
+    // 바이트 공급: 메시지가 완성되면 true (리얼타임 바이트는 즉시 완성)
+    bool feed(uint8_t byte, uint32_t timestamp, TR808MidiMessage* out);
+
+    const Stats& getStats() const { return stats; }
+};
+
+#endif // TR808_MIDI_H
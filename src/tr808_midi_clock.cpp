@@ -0,0 +1,221 @@
+#include "tr808_midi_clock.h"
+
+// ================ TR808MidiClock 구현 ================
+
+TR808MidiClock::TR808MidiClock() {
+    begin(32768);
+}
+
+uint32_t TR808MidiClock::periodFromTempo(uint32_t rate, float bpm) {
+    if (bpm < TR808_CLOCK_MIN_BPM) bpm = TR808_CLOCK_MIN_BPM;
+    if (bpm > TR808_CLOCK_MAX_BPM) bpm = TR808_CLOCK_MAX_BPM;
+    // 틱당 샘플 수 = rate * 60 / (bpm * 24), Q16
+    return (uint32_t)((rate * 60.0f / (bpm * TR808_CLOCK_PPQN)) * 65536.0f);
+}
+
+void TR808MidiClock::begin(uint32_t rate, float bpm) {
+    sampleRate = rate;
+    source = TR808_CLOCK_INTERNAL;
+    nominalPeriodQ16 = periodFromTempo(rate, bpm);
+    periodQ16 = nominalPeriodQ16;
+    nextTick = 0;
+    nextTickFrac = 0;
+    lastTick = 0;
+    running = false;
+    tickPosition = 0;
+    locked = false;
+    haveReference = false;
+    referencePending = false;
+    lastExternal = 0;
+    resetCounters();
+}
+
+void TR808MidiClock::setSampleRate(uint32_t rate, uint32_t now) {
+    if (rate == sampleRate || rate == 0) return;
+
+    // 주기는 레이트에 비례: 같은 템포를 새 샘플 단위로 환산
+    nominalPeriodQ16 = (uint32_t)((uint64_t)nominalPeriodQ16 * rate / sampleRate);
+    periodQ16 = (uint32_t)((uint64_t)periodQ16 * rate / sampleRate);
+
+    // 다음 틱까지 남은 시간도 같은 비율로 환산 (스텝 위상 유지)
+    if ((int32_t)(nextTick - now) > 0) {
+        uint64_t remainingQ16 = ((uint64_t)(nextTick - now) << 16) + nextTickFrac;
+        remainingQ16 = remainingQ16 * rate / sampleRate;
+        nextTick = now + (uint32_t)(remainingQ16 >> 16);
+        nextTickFrac = (uint32_t)(remainingQ16 & 0xFFFF);
+    }
+
+    sampleRate = rate;
+
+    // 슬레이브: 이전 레이트로 잰 수신 간격은 무효
+    if (source == TR808_CLOCK_EXTERNAL) {
+        locked = false;
+        haveReference = false;
+        resetCounters();
+    }
+}
+
+void TR808MidiClock::resetCounters() {
+    receivedTicks = 0;
+    generatedTicks = 0;
+}
+
+void TR808MidiClock::setSource(TR808ClockSource clockSource) {
+    source = clockSource;
+    locked = false;
+    haveReference = false;
+    referencePending = false;
+    periodQ16 = nominalPeriodQ16;
+    resetCounters();
+}
+
+void TR808MidiClock::setTempo(float bpm) {
+    nominalPeriodQ16 = periodFromTempo(sampleRate, bpm);
+    if (source == TR808_CLOCK_INTERNAL) {
+        periodQ16 = nominalPeriodQ16;
+    }
+}
+
+float TR808MidiClock::getTempo() const {
+    return sampleRate * 60.0f * 65536.0f / ((float)periodQ16 * TR808_CLOCK_PPQN);
+}
+
+void TR808MidiClock::start(uint32_t now) {
+    running = true;
+    tickPosition = 0;
+    resetCounters();
+    if (source == TR808_CLOCK_INTERNAL) {
+        // 첫 틱(스텝 0)을 즉시 발생
+        nextTick = now;
+        nextTickFrac = 0;
+    }
+}
+
+void TR808MidiClock::stop() {
+    running = false;
+}
+
+void TR808MidiClock::resume(uint32_t now) {
+    running = true;
+    resetCounters();
+    if (source == TR808_CLOCK_INTERNAL && (int32_t)(now - nextTick) > 0) {
+        nextTick = now;
+        nextTickFrac = 0;
+    }
+}
+
+void TR808MidiClock::setSongPosition(uint16_t sixteenths) {
+    tickPosition = (uint32_t)sixteenths * TR808_CLOCK_TICKS_PER_STEP;
+}
+
+void TR808MidiClock::advanceSchedule() {
+    nextTickFrac += periodQ16 & 0xFFFF;
+    nextTick += (periodQ16 >> 16) + (nextTickFrac >> 16);
+    nextTickFrac &= 0xFFFF;
+}
+
+void TR808MidiClock::onExternalTick(uint32_t timestamp) {
+    if (source != TR808_CLOCK_EXTERNAL) return;
+
+    if (!haveReference) {
+        // 주기를 모르는 첫 틱도 바로 생성 (생략하면 모든 스텝이 한 틱 늦음)
+        haveReference = true;
+        referencePending = true;
+        lastExternal = timestamp;
+        return;
+    }
+
+    uint32_t interval = timestamp - lastExternal;
+    lastExternal = timestamp;
+
+    if (!locked) {
+        // 첫 간격으로 주기 초기화 후 이 틱부터 생성
+        uint32_t minPeriod = periodFromTempo(sampleRate, TR808_CLOCK_MAX_BPM) >> 16;
+        uint32_t maxPeriod = periodFromTempo(sampleRate, TR808_CLOCK_MIN_BPM) >> 16;
+        if (interval < minPeriod || interval > maxPeriod) return;
+
+        periodQ16 = interval << 16;
+        nextTick = timestamp;
+        nextTickFrac = 0;
+        receivedTicks = 1;
+        generatedTicks = 0;
+        locked = true;
+        return;
+    }
+
+    receivedTicks++;
+
+    // 이 틱의 예정 시각: 이미 생성했으면 마지막 생성 시각, 아니면 다음 예정 시각
+    uint32_t scheduled = (generatedTicks >= receivedTicks) ? lastTick : nextTick;
+    int32_t error = (int32_t)(timestamp - scheduled);
+
+    // 두 주기 이상 어긋나면 (템포 급변/누락) 재동기화
+    int32_t period = (int32_t)(periodQ16 >> 16);
+    if (error > 2 * period || error < -2 * period || error > 32767 || error < -32767) {
+        locked = false;
+        return;
+    }
+
+    // PI 제어: 주기(I)와 위상(P) 보정
+    int32_t errorQ16 = error * 65536;
+    int64_t newPeriod = (int64_t)periodQ16 + (errorQ16 >> TR808_CLOCK_PLL_KI_SHIFT);
+    uint32_t minPeriodQ16 = periodFromTempo(sampleRate, TR808_CLOCK_MAX_BPM);
+    uint32_t maxPeriodQ16 = periodFromTempo(sampleRate, TR808_CLOCK_MIN_BPM);
+    if (newPeriod < minPeriodQ16) newPeriod = minPeriodQ16;
+    if (newPeriod > maxPeriodQ16) newPeriod = maxPeriodQ16;
+    periodQ16 = (uint32_t)newPeriod;
+
+    int64_t phase = (int64_t)nextTickFrac + (errorQ16 >> TR808_CLOCK_PLL_KP_SHIFT);
+    nextTick += (int32_t)(phase >> 16);
+    nextTickFrac = (uint32_t)(phase & 0xFFFF);
+}
+
+TR808_HOT uint8_t TR808MidiClock::process(uint32_t now) {
+    if (source == TR808_CLOCK_EXTERNAL) {
+        if (!locked) {
+            if (!referencePending) return 0;
+            referencePending = false;
+            return emitTick(now);
+        }
+
+        // 외부 클럭 중단 감지
+        if (now - lastExternal > (periodQ16 >> 16) * TR808_CLOCK_LOST_PERIODS) {
+            locked = false;
+            haveReference = false;
+            return 0;
+        }
+
+        if (receivedTicks > generatedTicks + 1) {
+            // 뒤처짐: 즉시 따라잡기
+            nextTick = now;
+            nextTickFrac = 0;
+        } else if (generatedTicks > receivedTicks) {
+            // 수신보다 한 틱 이상 앞서 예측하지 않음 (마스터 정지 시 폭주 방지)
+            return 0;
+        }
+    } else if ((int32_t)(now - nextTick) > (int32_t)(periodQ16 >> 16)) {
+        // 마스터: 오래 멈춰 있던 스케줄은 현재 시각으로 재설정
+        nextTick = now;
+        nextTickFrac = 0;
+    }
+
+    if ((int32_t)(now - nextTick) < 0) return 0;
+
+    uint32_t at = nextTick;
+    advanceSchedule();
+    generatedTicks++;
+    return emitTick(at);
+}
+
+TR808_HOT uint8_t TR808MidiClock::emitTick(uint32_t at) {
+    lastTick = at;
+
+    uint8_t flags = TR808_CLOCK_TICK;
+    if (running) {
+        if (tickPosition % TR808_CLOCK_TICKS_PER_STEP == 0) {
+            flags |= TR808_CLOCK_STEP;
+        }
+        tickPosition++;
+    }
+    return flags;
+}
@@ -0,0 +1,178 @@
+/*
+ * TR-808 MIDI 클럭 (마스터/슬레이브)
+ *
+ * millis() 기반 스텝 타이밍은 루프 주기에 따라 누적 오차가 생기므로,
+ * 오디오 샘플 시각 위에서 24 PPQN 틱을 생성하는 스텝 클럭을 제공
+ * - 마스터: 소수점 BPM, Q16 분수 누적으로 장시간 드리프트 없음
+ * - 슬레이브: 수신 0xF8 시각으로 PI 제어 PLL을 갱신하고,
+ *   필터링된 위상/주기로 틱을 생성 (수신 지터가 스텝에 전달되지 않음)
+ * - Start/Stop/Continue, Song Position Pointer 처리
+ * - 마스터 클럭 출력: 바이트를 샘플 시각과 함께 큐에 넣고 출력 타임라인에 맞춰 전송
+ *
+ * 작성일: 2025-10-30
+ * 호환성: ESP32C3 Arduino / 호스트
+ */
+
+#ifndef TR808_MIDI_CLOCK_H
+#define TR808_MIDI_CLOCK_H
+
+#include <stdint.h>
+#include "tr808_placement.h"
+
+// ============================================
+// 클럭 설정
+// ============================================
+
+#define TR808_CLOCK_PPQN            24      // MIDI 클럭 해상도
+#define TR808_CLOCK_TICKS_PER_STEP  6       // 16분음표 = 6틱
+#define TR808_CLOCK_MIN_BPM         20.0f
+#define TR808_CLOCK_MAX_BPM         300.0f
+#define TR808_CLOCK_PLL_KP_SHIFT    3       // 위상 보정 게인 1/8
+#define TR808_CLOCK_PLL_KI_SHIFT    6       // 주기 보정 게인 1/64
+#define TR808_CLOCK_LOST_PERIODS    4       // 이 주기 수만큼 틱이 없으면 언락
+
+// MIDI 리얼타임/시스템 메시지
+#define MIDI_CLOCK                  0xF8
+#define MIDI_START                  0xFA
+#define MIDI_CONTINUE               0xFB
+#define MIDI_STOP                   0xFC
+#define MIDI_SONG_POSITION          0xF2
+
+enum TR808ClockSource {
+    TR808_CLOCK_INTERNAL = 0,   // 마스터: 내부 템포로 틱 생성 (클럭 출력 가능)
+    TR808_CLOCK_EXTERNAL        // 슬레이브: 외부 0xF8에 위상 고정
+};
+
+// process() 반환 플래그
+#define TR808_CLOCK_TICK    0x01    // 이 샘플에서 틱 발생
+#define TR808_CLOCK_STEP    0x02    // 재생 중 16분음표 경계
+
+class TR808MidiClock {
+private:
+    TR808ClockSource source;
+    uint32_t sampleRate;
+
+    // 틱 주기 (샘플, Q16)
+    uint32_t periodQ16;
+    uint32_t nominalPeriodQ16;      // 마스터 템포
+
+    // 다음 틱 시각 (정수 샘플 + Q16 분수)
+    uint32_t nextTick;
+    uint32_t nextTickFrac;
+    uint32_t lastTick;              // 마지막으로 생성한 틱 시각
+
+    // 재생 상태
+    bool running;
+    uint32_t tickPosition;          // 송 포지션 (틱), 다음 틱이 가질 위치
+
+    // 슬레이브 PLL 상태
+    bool locked;
+    bool haveReference;
+    bool referencePending;          // 기준 틱(첫 수신)을 아직 생성하지 않음
+    uint32_t lastExternal;          // 마지막 수신 틱 시각
+    uint32_t receivedTicks;         // 기준점 이후 수신 틱 수
+    uint32_t generatedTicks;        // 기준점 이후 생성 틱 수
+
+    static uint32_t periodFromTempo(uint32_t sampleRate, float bpm);
+    void advanceSchedule();
+    uint8_t emitTick(uint32_t at);
+    void resetCounters();
+
+public:
+    TR808MidiClock();
+
+    void begin(uint32_t rate, float bpm = 120.0f);
+    // 샘플 레이트 변경 (템포/다음 틱까지 남은 시간 유지, 슬레이브는 재동기화)
+    void setSampleRate(uint32_t rate, uint32_t now);
+    uint32_t getSampleRate() const { return sampleRate; }
+    void setSource(TR808ClockSource clockSource);
+    TR808ClockSource getSource() const { return source; }
+
+    // 마스터 템포 (소수점 BPM)
+    void setTempo(float bpm);
+    // 현재 템포 (슬레이브는 PLL 추정값)
+    float getTempo() const;
+    bool isLocked() const { return source == TR808_CLOCK_INTERNAL || locked; }
+
+    // 트랜스포트 (마스터 조작 또는 수신 메시지)
+    void start(uint32_t now);
+    void stop();
+    void resume(uint32_t now);
+    void setSongPosition(uint16_t sixteenths);
+    bool isRunning() const { return running; }
+
+    // 외부 클럭 수신 (샘플 시각)
+    void onExternalTick(uint32_t timestamp);
+
+    // 렌더 루프에서 샘플마다 호출: TR808_CLOCK_* 플래그 반환
+    uint8_t process(uint32_t now);
+
+    // 마지막 STEP 플래그의 스텝 번호 (16분음표 단위 송 포지션)
+    uint32_t getStep() const { return (tickPosition - 1) / TR808_CLOCK_TICKS_PER_STEP; }
+};
+
+// ============================================
+// 클럭 바이트 출력 큐
+// ============================================
+
+#define TR808_CLOCK_OUT_QUEUE_SIZE  16      // 2의 거듭제곱 (출력 지연 동안 쌓이는 바이트 수보다 크게)
+
+/**
+ * 샘플 시각이 붙은 클럭/트랜스포트 바이트 (단일 생산자/단일 소비자 락프리)
+ * 생산자: 렌더 루프 (틱을 렌더한 샘플 시각), 소비자: 전송 타이머 콜백
+ * 렌더는 블록 단위로 몰아서 하므로 렌더 시점에 보내면 출력보다 DMA 지연만큼 앞서고
+ * 블록 안 위치만큼 흔들림 -> 소비자가 출력 타임라인(렌더 시각 - 출력 지연)에 맞춰 꺼냄
+ */
+class TR808ClockOutputQueue {
+private:
+    struct Entry {
+        uint32_t sampleTime;
+        uint8_t status;
+    };
+
+    Entry entries[TR808_CLOCK_OUT_QUEUE_SIZE];
+    volatile uint32_t head;     // 생산자만 기록
+    volatile uint32_t tail;     // 소비자만 기록
+    volatile uint32_t dropped;
+
+public:
+    TR808ClockOutputQueue() : head(0), tail(0), dropped(0) {}
+
+    bool push(uint32_t sampleTime, uint8_t status) {
+        uint32_t h = head;
+        if (h - __atomic_load_n(&tail, __ATOMIC_ACQUIRE) >= TR808_CLOCK_OUT_QUEUE_SIZE) {
+            dropped++;
+            return false;
+        }
+        Entry& entry = entries[h & (TR808_CLOCK_OUT_QUEUE_SIZE - 1)];
+        entry.sampleTime = sampleTime;
+        entry.status = status;
+        __atomic_store_n(&head, h + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+
+    // 가장 이른 바이트의 샘플 시각 (타이머 예약용)
+    bool peek(uint32_t* sampleTime) const {
+        uint32_t t = __atomic_load_n(&tail, __ATOMIC_RELAXED);
+        if (t == __atomic_load_n(&head, __ATOMIC_ACQUIRE)) return false;
+        *sampleTime = entries[t & (TR808_CLOCK_OUT_QUEUE_SIZE - 1)].sampleTime;
+        return true;
+    }
+
+    // 출력 타임라인의 현재 샘플(now)에 도달한 바이트만 꺼냄
+    bool popDue(uint32_t now, uint8_t* status) {
+        uint32_t t = tail;
+        if (t == __atomic_load_n(&head, __ATOMIC_ACQUIRE)) return false;
+
+        const Entry& entry = entries[t & (TR808_CLOCK_OUT_QUEUE_SIZE - 1)];
+        if ((int32_t)(entry.sampleTime - now) > 0) return false;
+
+        *status = entry.status;
+        __atomic_store_n(&tail, t + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+
+    uint32_t getDropped() const { return dropped; }
+};
+
+#endif // TR808_MIDI_CLOCK_H
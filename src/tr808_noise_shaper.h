@@ -0,0 +1,94 @@
+/*
+ * TR-808 PWM 재양자화 (오차 피드백 노이즈 셰이핑)
+ *
+ * 16비트 샘플을 8비트 PWM 듀티로 줄일 때 버려지는 하위 비트 오차를 다음 샘플에 되먹여
+ * 양자화 잡음 스펙트럼을 고역(PWM RC 필터가 깎는 대역)으로 밀어냄
+ * - 0차: 반올림만 (기존 CONVERT_TO_PWM_VALUE는 절삭이라 DC 오프셋 + 신호 상관 왜곡)
+ * - 1차: Y = X + (1 - z^-1)E       (저역 잡음 감소, fs/6 이하에서 이득)
+ * - 2차: Y = X + (1 - z^-1)^2 E    (저역 잡음 추가 감소, 고역 잡음 증가)
+ * - 정수 연산만 사용 (RV32IMC, FPU 없음), 블록 단위로 렌더 태스크에서 호출
+ * - 클리핑 구간에서 오차가 누적되지 않게 되먹임 오차를 제한
+ *
+ * 비교: extras/host/pwm_noise_shaping.cpp (차수별 대역 내 SNR)
+ *
+ * 작성일: 2025-10-30
+ * 호환성: ESP32C3 Arduino / 호스트 (extras/host)
+ */
+
+#ifndef TR808_NOISE_SHAPER_H
+#define TR808_NOISE_SHAPER_H
+
+#include <stdint.h>
+
+// ============================================
+// 재양자화 설정
+// ============================================
+
+#define TR808_SHAPER_OUTPUT_BITS    8           // PWM 듀티 분해능
+#define TR808_SHAPER_STEP           (1 << (16 - TR808_SHAPER_OUTPUT_BITS))  // 출력 1 LSB = 입력 256
+#define TR808_SHAPER_MAX_LEVEL      ((1 << TR808_SHAPER_OUTPUT_BITS) - 1)
+#define TR808_SHAPER_ERROR_LIMIT    (TR808_SHAPER_STEP * 2)  // 되먹임 오차 상한 (클리핑 시 발산 방지)
+
+// ============================================
+// 노이즈 셰이퍼
+// ============================================
+
+/**
+ * 16비트 부호 있는 샘플 -> 8비트 부호 없는 듀티 (중앙값 128)
+ * 상태는 직전 오차 2개뿐: 블록 경계를 넘어 이어지므로 출력 스트림당 인스턴스 하나
+ */
+class TR808NoiseShaper {
+private:
+    uint8_t order;
+    int32_t error1;                     // e[n-1]
+    int32_t error2;                     // e[n-2]
+
+public:
+    TR808NoiseShaper() : order(2), error1(0), error2(0) {}
+
+    // 차수 설정 (0..2) 및 오차 상태 초기화
+    void begin(uint8_t shapingOrder) {
+        order = shapingOrder > 2 ? 2 : shapingOrder;
+        reset();
+    }
+
+    void reset() {
+        error1 = 0;
+        error2 = 0;
+    }
+
+    uint8_t getOrder() const { return order; }
+
+    /**
+     * 샘플 하나 재양자화
+     * u = x - h*e (h: 1차 [1], 2차 [2, -1]), y = Q(u), e = y - u
+     */
+    inline uint8_t process(int16_t sample) {
+        int32_t target = (int32_t)sample + 32768;
+        if (order == 1) {
+            target -= error1;
+        } else if (order == 2) {
+            target -= 2 * error1 - error2;
+        }
+
+        int32_t level = (target + TR808_SHAPER_STEP / 2) >> (16 - TR808_SHAPER_OUTPUT_BITS);
+        if (level < 0) level = 0;
+        if (level > TR808_SHAPER_MAX_LEVEL) level = TR808_SHAPER_MAX_LEVEL;
+
+        int32_t error = level * TR808_SHAPER_STEP - target;
+        if (error > TR808_SHAPER_ERROR_LIMIT) error = TR808_SHAPER_ERROR_LIMIT;
+        if (error < -TR808_SHAPER_ERROR_LIMIT) error = -TR808_SHAPER_ERROR_LIMIT;
+        error2 = error1;
+        error1 = error;
+        return (uint8_t)level;
+    }
+
+    // 블록 재양자화 (렌더 태스크에서 블록 제출 직전)
+    void processBlock(const int16_t* input, uint8_t* output, uint16_t count) {
+        for (uint16_t i = 0; i < count; i++) {
+            output[i] = process(input[i]);
+        }
+    }
+};
+
+#endif // TR808_NOISE_SHAPER_H
@@ -0,0 +1,699 @@
+#include "tr808_pattern_store.h"
+#include <string.h>
+#include <stdlib.h>
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+static portMUX_TYPE storeMux = portMUX_INITIALIZER_UNLOCKED;
+#define STORE_LOCK()   portENTER_CRITICAL(&storeMux)
+#define STORE_UNLOCK() portEXIT_CRITICAL(&storeMux)
+#define STORE_YIELD()  vTaskDelay(1)
+#else
+#define STORE_LOCK()
+#define STORE_UNLOCK()
+#define STORE_YIELD()
+#endif
+
+#define ERASED_WORD 0xFFFFFFFFUL
+
+// ================ CRC32 구현 ================
+
+uint32_t tr808Crc32(const void* data, size_t length, uint32_t crc) {
+    // 니블 단위 테이블 (64바이트) - 플래시/RAM 사용 최소화
+    static const uint32_t table[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC,
+        0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+        0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+    };
+
+    const uint8_t* bytes = (const uint8_t*)data;
+    crc = ~crc;
+    for (size_t i = 0; i < length; i++) {
+        crc = table[(crc ^ bytes[i]) & 0x0F] ^ (crc >> 4);
+        crc = table[(crc ^ (bytes[i] >> 4)) & 0x0F] ^ (crc >> 4);
+    }
+    return ~crc;
+}
+
+static uint32_t sectorHeaderCrc(const TR808SectorHeader& header) {
+    return tr808Crc32(&header, offsetof(TR808SectorHeader, crc));
+}
+
+static uint32_t recordCrc(const TR808RecordHeader& header, const void* payload) {
+    uint32_t crc = tr808Crc32(&header, offsetof(TR808RecordHeader, crc));
+    return tr808Crc32(payload, header.length, crc);
+}
+
+// ================ TR808PartitionBackend 구현 ================
+
+#if defined(ARDUINO_ARCH_ESP32)
+
+TR808PartitionBackend::TR808PartitionBackend(const char* partitionLabel) {
+    label = partitionLabel;
+    partition = nullptr;
+    mapped = nullptr;
+    mapHandle = 0;
+}
+
+TR808PartitionBackend::~TR808PartitionBackend() {
+    if (mapped != nullptr) {
+        esp_partition_munmap(mapHandle);
+    }
+}
+
+bool TR808PartitionBackend::begin() {
+    // 전용 파티션만 사용 (다른 데이터 파티션을 대신 쓰면 그 파일 시스템을 덮어씀)
+    partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                         ESP_PARTITION_SUBTYPE_ANY, label);
+    if (partition == nullptr) {
+        return false;
+    }
+
+    // 읽기 경로는 캐시를 통한 메모리 매핑 사용
+    if (esp_partition_mmap(partition, 0, partition->size, ESP_PARTITION_MMAP_DATA,
+                           &mapped, &mapHandle) != ESP_OK) {
+        mapped = nullptr;
+    }
+    return true;
+}
+
+bool TR808PartitionBackend::read(uint32_t offset, void* data, size_t length) {
+    return esp_partition_read(partition, offset, data, length) == ESP_OK;
+}
+
+bool TR808PartitionBackend::write(uint32_t offset, const void* data, size_t length) {
+    return esp_partition_write(partition, offset, data, length) == ESP_OK;
+}
+
+bool TR808PartitionBackend::eraseSector(uint32_t sector) {
+    return esp_partition_erase_range(partition, sector * TR808_STORE_SECTOR_SIZE,
+                                     TR808_STORE_SECTOR_SIZE) == ESP_OK;
+}
+
+uint32_t TR808PartitionBackend::sectorCount() const {
+    return partition ? partition->size / TR808_STORE_SECTOR_SIZE : 0;
+}
+
+#endif
+
+// ================ TR808FileBackend 구현 ================
+
+#ifndef ARDUINO
+
+TR808FileBackend::TR808FileBackend(const char* filePath, uint32_t sectorCount) {
+    path = filePath;
+    sectors = sectorCount;
+    image = nullptr;
+    file = nullptr;
+}
+
+TR808FileBackend::~TR808FileBackend() {
+    if (file != nullptr) fclose(file);
+    free(image);
+}
+
+bool TR808FileBackend::begin() {
+    // 재마운트: 이전 이미지/파일을 닫고 파일에서 다시 로드
+    if (file != nullptr) fclose(file);
+    free(image);
+    file = nullptr;
+
+    size_t size = (size_t)sectors * TR808_STORE_SECTOR_SIZE;
+    image = (uint8_t*)malloc(size);
+    if (image == nullptr) return false;
+    memset(image, 0xFF, size);
+
+    file = fopen(path, "r+b");
+    if (file != nullptr) {
+        // 기존 이미지 로드 (짧으면 나머지는 소거 상태)
+        size_t loaded = fread(image, 1, size, file);
+        (void)loaded;
+    } else {
+        file = fopen(path, "w+b");
+        if (file == nullptr) return false;
+    }
+
+    fseek(file, 0, SEEK_SET);
+    fwrite(image, 1, size, file);
+    fflush(file);
+    return true;
+}
+
+bool TR808FileBackend::read(uint32_t offset, void* data, size_t length) {
+    if (offset + length > (size_t)sectors * TR808_STORE_SECTOR_SIZE) return false;
+    memcpy(data, image + offset, length);
+    return true;
+}
+
+bool TR808FileBackend::write(uint32_t offset, const void* data, size_t length) {
+    if (offset + length > (size_t)sectors * TR808_STORE_SECTOR_SIZE) return false;
+
+    // NOR 플래시 의미론 재현: 쓰기는 1 -> 0 만 가능
+    const uint8_t* bytes = (const uint8_t*)data;
+    for (size_t i = 0; i < length; i++) {
+        image[offset + i] &= bytes[i];
+    }
+
+    fseek(file, offset, SEEK_SET);
+    fwrite(image + offset, 1, length, file);
+    fflush(file);
+    return true;
+}
+
+bool TR808FileBackend::eraseSector(uint32_t sector) {
+    if (sector >= sectors) return false;
+    uint32_t offset = sector * TR808_STORE_SECTOR_SIZE;
+    memset(image + offset, 0xFF, TR808_STORE_SECTOR_SIZE);
+
+    fseek(file, offset, SEEK_SET);
+    fwrite(image + offset, 1, TR808_STORE_SECTOR_SIZE, file);
+    fflush(file);
+    return true;
+}
+
+#endif
+
+// ================ TR808PatternStore 구현 ================
+
+TR808PatternStore::TR808PatternStore(TR808StorageBackend* storage) {
+    backend = storage;
+    memset(index, 0, sizeof(index));
+    for (int i = 0; i < TR808_STORE_PENDING_SLOTS; i++) {
+        pending[i].state = PENDING_FREE;
+    }
+    headSector = 0;
+    headOffset = 0;
+    headSequence = 0;
+    tailSector = 0;
+    nextVersion = 1;
+    indexSequence = 0;
+    mounted = false;
+    collecting = false;
+    eraseAllowed = true;
+    memset(&stats, 0, sizeof(stats));
+#if defined(ARDUINO_ARCH_ESP32)
+    writerTask = nullptr;
+#endif
+}
+
+void TR808PatternStore::beginIndexUpdate() {
+    indexSequence = indexSequence + 1;
+    __sync_synchronize();
+}
+
+void TR808PatternStore::endIndexUpdate() {
+    __sync_synchronize();
+    indexSequence = indexSequence + 1;
+}
+
+uint32_t TR808PatternStore::alignedSize(uint16_t length) {
+    return sizeof(TR808RecordHeader) + ((length + 3u) & ~3u);
+}
+
+bool TR808PatternStore::begin() {
+    mounted = false;
+    if (backend == nullptr || !backend->begin()) return false;
+
+    uint32_t sectors = backend->sectorCount();
+    if (sectors < 3) return false; // head + 여유 섹터 + GC 대상 최소 필요
+
+    // 섹터 헤더 검사: 가장 오래된/최신 섹터 탐색
+    bool found = false;
+    uint32_t minSequence = 0, maxSequence = 0;
+    for (uint32_t s = 0; s < sectors; s++) {
+        TR808SectorHeader header;
+        if (!backend->read(s * TR808_STORE_SECTOR_SIZE, &header, sizeof(header))) return false;
+        if (header.magic != TR808_STORE_SECTOR_MAGIC || header.crc != sectorHeaderCrc(header)) {
+            continue;
+        }
+        if (header.eraseCount > stats.maxEraseCount) stats.maxEraseCount = header.eraseCount;
+        if (!found || header.sequence < minSequence) {
+            minSequence = header.sequence;
+            tailSector = s;
+        }
+        if (!found || header.sequence > maxSequence) {
+            maxSequence = header.sequence;
+            headSector = s;
+        }
+        found = true;
+    }
+
+    if (!found) {
+        return format();
+    }
+
+    // tail -> head 순서로 스캔 (링 구조), 최신 버전 우선
+    memset(index, 0, sizeof(index));
+    nextVersion = 1;
+    headSequence = maxSequence;
+    uint32_t s = tailSector;
+    while (true) {
+        scanSector(s);
+        if (s == headSector) break;
+        s = (s + 1) % sectors;
+    }
+
+    mounted = true;
+
+    // 이전 GC가 중단된 경우 여유 섹터 확보
+    if ((headSector + 1) % sectors == tailSector) {
+        collectTail();
+    }
+    return true;
+}
+
+bool TR808PatternStore::format() {
+    // 마운트가 인식하는 섹터(유효한 헤더)만 소거: 헤더 없는 섹터는 스캔에서 무시되고
+    // head가 도달할 때 formatSector()가 소거하므로, 첫 부팅은 섹터 0 소거 1회로 끝남
+    uint32_t sectors = backend->sectorCount();
+    beginIndexUpdate();
+    for (uint32_t s = 1; s < sectors; s++) {
+        TR808SectorHeader header;
+        if (!backend->read(s * TR808_STORE_SECTOR_SIZE, &header, sizeof(header))) continue;
+        if (header.magic == TR808_STORE_SECTOR_MAGIC && header.crc == sectorHeaderCrc(header) &&
+            backend->eraseSector(s)) {
+            stats.sectorsErased++;
+        }
+    }
+
+    memset(index, 0, sizeof(index));
+    endIndexUpdate();
+    nextVersion = 1;
+    headSequence = 0;
+    tailSector = 0;
+    headSector = 0;
+    if (!formatSector(0, ++headSequence)) return false;
+    headOffset = sizeof(TR808SectorHeader);
+
+    mounted = true;
+    return true;
+}
+
+bool TR808PatternStore::formatSector(uint32_t sector, uint32_t sequence) {
+    uint32_t base = sector * TR808_STORE_SECTOR_SIZE;
+
+    // 이전 소거 횟수 유지 (웨어 레벨링 통계)
+    TR808SectorHeader header;
+    if (!backend->read(base, &header, sizeof(header))) return false;
+    bool erased = isFreeSector(sector, header);
+    uint32_t eraseCount;
+    if (header.magic == TR808_STORE_SECTOR_MAGIC && header.crc == sectorHeaderCrc(header)) {
+        eraseCount = header.eraseCount + 1;
+    } else if (erased) {
+        // collectTail()이 미리 소거한 섹터: 다시 소거하지 않고 헤더만 기록
+        eraseCount = header.eraseCount == ERASED_WORD ? 1 : header.eraseCount;
+    } else {
+        eraseCount = 1;
+    }
+
+    if (!erased) {
+        if (!canErase()) return false;
+        if (!backend->eraseSector(sector)) return false;
+        stats.sectorsErased++;
+    }
+
+    header.magic = TR808_STORE_SECTOR_MAGIC;
+    header.sequence = sequence;
+    header.eraseCount = eraseCount;
+    header.crc = sectorHeaderCrc(header);
+    if (header.eraseCount > stats.maxEraseCount) stats.maxEraseCount = header.eraseCount;
+
+    return backend->write(base, &header, sizeof(header));
+}
+
+bool TR808PatternStore::scanSector(uint32_t sector) {
+    uint32_t base = sector * TR808_STORE_SECTOR_SIZE;
+    uint32_t offset = sizeof(TR808SectorHeader);
+
+    while (offset + sizeof(TR808RecordHeader) <= TR808_STORE_SECTOR_SIZE) {
+        TR808RecordHeader header;
+        if (!backend->read(base + offset, &header, sizeof(header))) return false;
+
+        if (header.magic == ERASED_WORD) {
+            break; // 기록되지 않은 영역
+        }
+
+        if (header.magic != TR808_STORE_RECORD_MAGIC || header.length > TR808_STORE_MAX_RECORD ||
+            offset + alignedSize(header.length) > TR808_STORE_SECTOR_SIZE) {
+            // 길이를 신뢰할 수 없으므로 섹터 나머지는 사용하지 않음
+            stats.crcErrors++;
+            offset = TR808_STORE_SECTOR_SIZE;
+            break;
+        }
+
+        backend->read(base + offset + sizeof(header), scratch, header.length);
+        if (header.crc == recordCrc(header, scratch) &&
+            header.type < TR808_RECORD_TYPE_COUNT && header.slot < TR808_STORE_MAX_SLOTS) {
+            IndexEntry& entry = index[header.type][header.slot];
+            if (entry.offset == 0 || header.version >= entry.version) {
+                entry.offset = base + offset;
+                entry.version = header.version;
+                entry.length = header.length;
+            }
+            if (header.version >= nextVersion) {
+                nextVersion = header.version + 1;
+            }
+        } else {
+            stats.crcErrors++;
+        }
+
+        offset += alignedSize(header.length);
+    }
+
+    if (sector == headSector) {
+        headOffset = offset;
+    }
+    return true;
+}
+
+bool TR808PatternStore::appendRecord(uint8_t type, uint8_t slot, const void* data, uint16_t length) {
+    uint32_t size = alignedSize(length);
+    if (size > TR808_STORE_SECTOR_SIZE - sizeof(TR808SectorHeader)) return false;
+
+    // 여유 섹터가 없으면 (advanceHead 직후 GC 실패) 새 레코드보다 GC를 먼저 재시도:
+    // 새 head의 남은 공간은 tail의 유효 레코드를 옮길 자리이므로 새 레코드로 채우지 않음
+    uint32_t sectors = backend->sectorCount();
+    if (!collecting && (headSector + 1) % sectors == tailSector && !collectTail()) return false;
+
+    // 새 head 섹터는 GC가 옮겨 온 레코드로 다시 찰 수 있으므로 전진 후 남은 공간을 다시 확인
+    // (섹터 경계를 넘는 레코드는 마운트 시 손상으로 버려짐)
+    for (uint32_t attempt = 0; headOffset + size > TR808_STORE_SECTOR_SIZE; attempt++) {
+        if (collecting || attempt >= sectors || !advanceHead()) return false;
+    }
+
+    TR808RecordHeader header;
+    header.magic = TR808_STORE_RECORD_MAGIC;
+    header.type = type;
+    header.slot = slot;
+    header.length = length;
+    header.version = nextVersion++;
+    header.crc = recordCrc(header, data);
+
+    // 페이로드를 먼저 기록하고 헤더를 마지막에 기록 (전원 차단 시 헤더 없는 레코드는 무시됨)
+    uint32_t offset = headSector * TR808_STORE_SECTOR_SIZE + headOffset;
+    if (!backend->write(offset + sizeof(header), data, length)) return false;
+    if (!backend->write(offset, &header, sizeof(header))) return false;
+
+    IndexEntry& entry = index[type][slot];
+    beginIndexUpdate();
+    entry.offset = offset;
+    entry.version = header.version;
+    entry.length = length;
+    endIndexUpdate();
+
+    headOffset += size;
+    stats.recordsWritten++;
+    return true;
+}
+
+bool TR808PatternStore::advanceHead() {
+    uint32_t sectors = backend->sectorCount();
+    uint32_t next = (headSector + 1) % sectors;
+    if (next == tailSector) return false;
+
+    if (!formatSector(next, ++headSequence)) return false;
+    headSector = next;
+    headOffset = sizeof(TR808SectorHeader);
+
+    // 항상 한 섹터는 비워 두어 GC 공간 확보
+    if ((headSector + 1) % sectors == tailSector) {
+        return collectTail();
+    }
+    return true;
+}
+
+bool TR808PatternStore::collectTail() {
+    uint32_t sectors = backend->sectorCount();
+    uint32_t victim = tailSector;
+    uint32_t base = victim * TR808_STORE_SECTOR_SIZE;
+    uint32_t offset = sizeof(TR808SectorHeader);
+
+    // 소거할 수 없으면 복사도 하지 않음 (head 공간 낭비 방지)
+    if (!canErase()) return false;
+
+    TR808SectorHeader victimHeader;
+    uint32_t eraseCount = 0;
+    if (backend->read(base, &victimHeader, sizeof(victimHeader)) &&
+        victimHeader.magic == TR808_STORE_SECTOR_MAGIC && victimHeader.crc == sectorHeaderCrc(victimHeader)) {
+        eraseCount = victimHeader.eraseCount;
+    }
+
+    collecting = true;
+    stats.gcRuns++;
+
+    // 가장 오래된 섹터에서 아직 유효한(최신) 레코드만 head로 복사
+    while (offset + sizeof(TR808RecordHeader) <= TR808_STORE_SECTOR_SIZE) {
+        TR808RecordHeader header;
+        backend->read(base + offset, &header, sizeof(header));
+        if (header.magic != TR808_STORE_RECORD_MAGIC || header.length > TR808_STORE_MAX_RECORD) {
+            break;
+        }
+
+        if (header.type < TR808_RECORD_TYPE_COUNT && header.slot < TR808_STORE_MAX_SLOTS &&
+            index[header.type][header.slot].offset == base + offset) {
+            backend->read(base + offset + sizeof(header), scratch, header.length);
+            if (!appendRecord(header.type, header.slot, scratch, header.length)) {
+                collecting = false;
+                return false; // 다음 appendRecord()가 새 레코드보다 먼저 재시도
+            }
+        }
+
+        offset += alignedSize(header.length);
+    }
+
+    collecting = false;
+
+    // 소거 중에는 옛 위치를 읽던 read()가 재시도하도록 시퀀스를 홀수로 유지
+    beginIndexUpdate();
+    bool erased = backend->eraseSector(victim);
+    endIndexUpdate();
+    if (!erased) return false;
+    stats.sectorsErased++;
+    tailSector = (victim + 1) % sectors;
+
+    // 여유 섹터 표시: 소거 횟수만 기록 (마운트는 무시, head 전진 시 재소거 없이 사용)
+    // 기록 실패/전원 차단 시에는 빈 섹터로 남아 소거 횟수 통계만 잃음
+    TR808SectorHeader marker;
+    memset(&marker, 0xFF, sizeof(marker));
+    marker.eraseCount = eraseCount + 1;
+    backend->write(base, &marker, sizeof(marker));
+    return true;
+}
+
+bool TR808PatternStore::isFreeSector(uint32_t sector, const TR808SectorHeader& header) {
+    if (header.magic != ERASED_WORD || header.sequence != ERASED_WORD || header.crc != ERASED_WORD) {
+        return false;
+    }
+    // 헤더 뒤 전체가 소거 상태인지 확인 (중단된 소거/기록이 남긴 섹터는 다시 소거)
+    uint32_t base = sector * TR808_STORE_SECTOR_SIZE;
+    const uint8_t* mapped = backend->mappedBase();
+    for (uint32_t offset = sizeof(TR808SectorHeader); offset < TR808_STORE_SECTOR_SIZE; offset += sizeof(header)) {
+        uint32_t words[sizeof(header) / sizeof(uint32_t)];
+        if (mapped != nullptr) {
+            memcpy(words, mapped + base + offset, sizeof(words));
+        } else if (!backend->read(base + offset, words, sizeof(words))) {
+            return false;
+        }
+        for (uint8_t i = 0; i < sizeof(words) / sizeof(words[0]); i++) {
+            if (words[i] != ERASED_WORD) return false;
+        }
+    }
+    return true;
+}
+
+bool TR808PatternStore::canErase() {
+    if (eraseAllowed) return true;
+    stats.erasesDeferred++;
+    return false;
+}
+
+void TR808PatternStore::setEraseAllowed(bool allowed) {
+    bool opened = allowed && !eraseAllowed;
+    eraseAllowed = allowed;
+#if defined(ARDUINO_ARCH_ESP32)
+    // 소거를 기다리던 쓰기가 있으면 재시도 주기를 기다리지 않고 처리
+    if (opened && writerTask != nullptr && hasPendingWrites()) {
+        xTaskNotifyGive((TaskHandle_t)writerTask);
+    }
+#else
+    (void)opened;
+#endif
+}
+
+bool TR808PatternStore::queueWrite(TR808RecordType type, uint8_t slot, const void* data, size_t length) {
+    if (type >= TR808_RECORD_TYPE_COUNT || slot >= TR808_STORE_MAX_SLOTS ||
+        length > TR808_STORE_MAX_RECORD) {
+        return false;
+    }
+
+    // 슬롯 확보 (같은 키가 대기 중이면 덮어써서 쓰기 횟수 절감)
+    int target = -1;
+    STORE_LOCK();
+    for (int i = 0; i < TR808_STORE_PENDING_SLOTS; i++) {
+        if (pending[i].state == PENDING_READY && pending[i].type == type && pending[i].slot == slot) {
+            target = i;
+            stats.recordsCoalesced++;
+            break;
+        }
+    }
+    if (target < 0) {
+        for (int i = 0; i < TR808_STORE_PENDING_SLOTS; i++) {
+            if (pending[i].state == PENDING_FREE) {
+                target = i;
+                break;
+            }
+        }
+    }
+    if (target >= 0) {
+        pending[target].state = PENDING_FILLING;
+    } else {
+        stats.queueFull++;
+    }
+    STORE_UNLOCK();
+
+    if (target < 0) return false;
+
+    PendingWrite& entry = pending[target];
+    entry.type = type;
+    entry.slot = slot;
+    entry.length = (uint16_t)length;
+    memcpy(entry.data, data, length);
+    entry.state = PENDING_READY;
+
+#if defined(ARDUINO_ARCH_ESP32)
+    if (writerTask != nullptr) {
+        xTaskNotifyGive((TaskHandle_t)writerTask);
+    }
+#endif
+    return true;
+}
+
+uint8_t TR808PatternStore::flushPending() {
+    if (!mounted) return 0;
+
+    uint8_t written = 0;
+    for (int i = 0; i < TR808_STORE_PENDING_SLOTS; i++) {
+        bool claimed = false;
+        STORE_LOCK();
+        if (pending[i].state == PENDING_READY) {
+            pending[i].state = PENDING_WRITING;
+            claimed = true;
+        }
+        STORE_UNLOCK();
+
+        if (!claimed) continue;
+
+        if (appendRecord(pending[i].type, pending[i].slot, pending[i].data, pending[i].length)) {
+            written++;
+            pending[i].state = PENDING_FREE;
+            continue;
+        }
+
+        // 실패: 대기열에 남겨 다음 flush에서 재시도
+        // 같은 키의 더 새 데이터가 기록 중에 들어왔으면 이 항목은 버림 (순서 역전 방지)
+        stats.writeFailures++;
+        STORE_LOCK();
+        bool superseded = false;
+        for (int j = 0; j < TR808_STORE_PENDING_SLOTS; j++) {
+            if (j != i && pending[j].state != PENDING_FREE &&
+                pending[j].type == pending[i].type && pending[j].slot == pending[i].slot) {
+                superseded = true;
+                break;
+            }
+        }
+        pending[i].state = superseded ? PENDING_FREE : PENDING_READY;
+        STORE_UNLOCK();
+    }
+    return written;
+}
+
+bool TR808PatternStore::hasPendingWrites() const {
+    for (int i = 0; i < TR808_STORE_PENDING_SLOTS; i++) {
+        if (pending[i].state != PENDING_FREE) return true;
+    }
+    return false;
+}
+
+bool TR808PatternStore::writeNow(TR808RecordType type, uint8_t slot, const void* data, size_t length) {
+    if (!mounted || type >= TR808_RECORD_TYPE_COUNT || slot >= TR808_STORE_MAX_SLOTS ||
+        length > TR808_STORE_MAX_RECORD) {
+        return false;
+    }
+    return appendRecord(type, slot, data, (uint16_t)length);
+}
+
+size_t TR808PatternStore::read(TR808RecordType type, uint8_t slot, void* out, size_t maxLength) {
+    for (uint8_t attempt = 0; attempt < TR808_STORE_READ_RETRIES; attempt++) {
+        uint32_t sequence = indexSequence;
+        if (sequence & 1) {
+            STORE_YIELD();  // 쓰기 태스크가 인덱스 수정/섹터 소거 중
+            continue;
+        }
+        __sync_synchronize();
+
+        if (!exists(type, slot)) return 0;
+        IndexEntry entry = index[type][slot];
+        size_t length = entry.length < maxLength ? entry.length : maxLength;
+
+        const uint8_t* base = backend->mappedBase();
+        if (base != nullptr) {
+            memcpy(out, base + entry.offset + sizeof(TR808RecordHeader), length);
+        } else if (!backend->read(entry.offset + sizeof(TR808RecordHeader), out, length)) {
+            return 0;
+        }
+
+        __sync_synchronize();
+        if (indexSequence == sequence) return length;
+    }
+    return 0;
+}
+
+const void* TR808PatternStore::map(TR808RecordType type, uint8_t slot, size_t* length) const {
+    if (!exists(type, slot)) return nullptr;
+
+    const uint8_t* base = backend->mappedBase();
+    if (base == nullptr) return nullptr;
+
+    const IndexEntry& entry = index[type][slot];
+    if (length != nullptr) *length = entry.length;
+    return base + entry.offset + sizeof(TR808RecordHeader);
+}
+
+bool TR808PatternStore::exists(TR808RecordType type, uint8_t slot) const {
+    if (type >= TR808_RECORD_TYPE_COUNT || slot >= TR808_STORE_MAX_SLOTS) return false;
+    return index[type][slot].offset != 0;
+}
+
+uint32_t TR808PatternStore::getVersion(TR808RecordType type, uint8_t slot) const {
+    return exists(type, slot) ? index[type][slot].version : 0;
+}
+
+#if defined(ARDUINO_ARCH_ESP32)
+
+static void patternStoreWriterTask(void* parameters) {
+    TR808PatternStore* store = (TR808PatternStore*)parameters;
+    while (true) {
+        // queueWrite 알림 대기 (오디오 루프와 분리된 저우선순위 실행)
+        // 실패해 남은 쓰기가 있으면 알림이 없어도 주기적으로 재시도
+        TickType_t wait = store->hasPendingWrites() ? pdMS_TO_TICKS(TR808_STORE_RETRY_MS) : portMAX_DELAY;
+        ulTaskNotifyTake(pdTRUE, wait);
+        store->flushPending();
+    }
+}
+
+bool TR808PatternStore::startWriterTask(uint8_t priority, uint32_t stackSize) {
+    if (writerTask != nullptr) return true;
+
+    TaskHandle_t handle = nullptr;
+    if (xTaskCreate(patternStoreWriterTask, "tr808_store", stackSize, this,
+                    priority, &handle) != pdPASS) {
+        return false;
+    }
+    writerTask = handle;
+    return true;
+}
+
+#endif
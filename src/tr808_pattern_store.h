@@ -0,0 +1,259 @@
+/*
+ * TR-808 패턴/킷 저장소 (로그 구조 플래시 저장)
+ *
+ * EEPROM.put 방식의 전체 블록 재기록 대신, 플래시 파티션에
+ * CRC와 버전이 붙은 레코드를 순차적으로 덧붙이는 로그 구조 저장소
+ * - 섹터 단위 링 구조로 소거 횟수를 고르게 분산 (웨어 레벨링)
+ * - 쓰기는 대기열에 복사만 하고 저우선순위 태스크에서 실제 기록
+ *   단일 코어 C3에서는 플래시 소거/기록 중 캐시가 꺼지고 스케줄러가 멈추므로
+ *   태스크를 분리해도 그동안 오디오 루프는 렌더하지 못함: 기록(페이지 프로그램)은
+ *   짧지만 섹터 소거(4KB, 수십 ms)는 DMA 여유보다 길어 언더런 발생
+ *   -> 소거는 호출자가 허용한 안전 지점(트랜스포트 정지 + 무음)에서만 수행
+ * - 읽기는 메모리 매핑된 파티션에서 포인터로 직접 접근
+ * - 호스트(Linux)에서는 파일 기반 백엔드로 동일 로직 테스트 가능
+ *
+ * 작성일: 2025-10-30
+ * 호환성: ESP32C3 (esp_partition) / 호스트 (stdio)
+ */
+
+#ifndef TR808_PATTERN_STORE_H
+#define TR808_PATTERN_STORE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#endif
+
+// ============================================
+// 저장소 설정
+// ============================================
+
+#define TR808_STORE_SECTOR_SIZE      4096    // 플래시 소거 단위
+#define TR808_STORE_MAX_SLOTS        32      // 레코드 타입별 최대 슬롯 수
+#define TR808_STORE_MAX_RECORD       1024    // 레코드 최대 페이로드 (바이트)
+#define TR808_STORE_PENDING_SLOTS    4       // 지연 쓰기 대기열 크기
+#define TR808_STORE_RETRY_MS         1000    // 실패한 지연 쓰기 재시도 간격
+#define TR808_STORE_READ_RETRIES     8       // 인덱스 갱신과 겹친 읽기 재시도 횟수
+#define TR808_STORE_PARTITION_LABEL  "tr808" // 전용 데이터 파티션 라벨 (partitions_tr808*.csv)
+
+#define TR808_STORE_SECTOR_MAGIC     0x38303853UL  // "S808"
+#define TR808_STORE_RECORD_MAGIC     0x38303852UL  // "R808"
+#define TR808_STORE_FORMAT_VERSION   1
+
+// 레코드 타입
+enum TR808RecordType {
+    TR808_RECORD_PATTERN = 0,   // 시퀀서 패턴
+    TR808_RECORD_KIT = 1,       // 드럼 킷 파라미터
+    TR808_RECORD_TYPE_COUNT = 2
+};
+
+// 섹터 헤더 (각 섹터의 첫 16바이트)
+struct TR808SectorHeader {
+    uint32_t magic;         // TR808_STORE_SECTOR_MAGIC
+    uint32_t sequence;      // 섹터 사용 순서 (클수록 최신)
+    uint32_t eraseCount;    // 누적 소거 횟수
+    uint32_t crc;           // 위 필드의 CRC32
+};
+
+// 레코드 헤더 (페이로드 앞 16바이트, 페이로드는 4바이트 정렬)
+struct TR808RecordHeader {
+    uint32_t magic;         // TR808_STORE_RECORD_MAGIC
+    uint8_t type;           // TR808RecordType
+    uint8_t slot;           // 슬롯 번호
+    uint16_t length;        // 페이로드 길이
+    uint32_t version;       // 전역 증가 버전 (클수록 최신)
+    uint32_t crc;           // 헤더(crc 제외) + 페이로드 CRC32
+};
+
+/**
+ * CRC32 (IEEE 802.3, 니블 테이블)
+ */
+uint32_t tr808Crc32(const void* data, size_t length, uint32_t crc = 0);
+
+/**
+ * 플래시 저장 매체 추상화
+ * NOR 플래시 의미론: 소거 시 0xFF, 쓰기는 소거된 영역에만
+ */
+class TR808StorageBackend {
+public:
+    virtual ~TR808StorageBackend() {}
+    virtual bool begin() = 0;
+    virtual bool read(uint32_t offset, void* data, size_t length) = 0;
+    virtual bool write(uint32_t offset, const void* data, size_t length) = 0;
+    virtual bool eraseSector(uint32_t sector) = 0;
+    virtual uint32_t sectorCount() const = 0;
+    // 메모리 매핑 주소 (지원하지 않으면 nullptr)
+    virtual const uint8_t* mappedBase() const { return nullptr; }
+};
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include <esp_partition.h>
+
+/**
+ * ESP32 플래시 파티션 백엔드 (esp_partition + mmap)
+ */
+class TR808PartitionBackend : public TR808StorageBackend {
+private:
+    const char* label;
+    const esp_partition_t* partition;
+    const void* mapped;
+    esp_partition_mmap_handle_t mapHandle;
+
+public:
+    TR808PartitionBackend(const char* partitionLabel = TR808_STORE_PARTITION_LABEL);
+    ~TR808PartitionBackend();
+    bool begin() override;
+    bool read(uint32_t offset, void* data, size_t length) override;
+    bool write(uint32_t offset, const void* data, size_t length) override;
+    bool eraseSector(uint32_t sector) override;
+    uint32_t sectorCount() const override;
+    const uint8_t* mappedBase() const override { return (const uint8_t*)mapped; }
+};
+#endif
+
+#ifndef ARDUINO
+#include <stdio.h>
+
+/**
+ * 호스트 파일 백엔드 (테스트/일괄 처리용)
+ * 파일 전체를 메모리 이미지로 유지하여 mmap 읽기 경로도 동일하게 동작
+ */
+class TR808FileBackend : public TR808StorageBackend {
+private:
+    const char* path;
+    uint32_t sectors;
+    uint8_t* image;
+    FILE* file;
+
+public:
+    TR808FileBackend(const char* filePath, uint32_t sectorCount);
+    ~TR808FileBackend();
+    bool begin() override;
+    bool read(uint32_t offset, void* data, size_t length) override;
+    bool write(uint32_t offset, const void* data, size_t length) override;
+    bool eraseSector(uint32_t sector) override;
+    uint32_t sectorCount() const override { return sectors; }
+    const uint8_t* mappedBase() const override { return image; }
+};
+#endif
+
+/**
+ * 로그 구조 패턴/킷 저장소
+ */
+class TR808PatternStore {
+public:
+    // 저장소 통계
+    struct Stats {
+        uint32_t recordsWritten;    // 기록된 레코드 수
+        uint32_t recordsCoalesced;  // 대기열에서 병합된 쓰기 수
+        uint32_t sectorsErased;     // 소거된 섹터 수
+        uint32_t gcRuns;            // 가비지 컬렉션 실행 횟수
+        uint32_t crcErrors;         // 마운트 중 발견된 손상 레코드
+        uint32_t queueFull;         // 대기열 가득참으로 거절된 쓰기
+        uint32_t writeFailures;     // 기록 실패 (대기열에 남겨 재시도)
+        uint32_t maxEraseCount;     // 섹터 최대 소거 횟수
+        uint32_t erasesDeferred;    // 안전 지점이 아니어서 미룬 소거 (head 전진/GC, 재시도마다 증가)
+    };
+
+private:
+    struct IndexEntry {
+        uint32_t offset;    // 레코드 헤더 위치 (0 = 없음)
+        uint32_t version;
+        uint16_t length;
+    };
+
+    enum PendingState : uint8_t {
+        PENDING_FREE = 0,
+        PENDING_FILLING,
+        PENDING_READY,
+        PENDING_WRITING
+    };
+
+    struct PendingWrite {
+        volatile PendingState state;
+        uint8_t type;
+        uint8_t slot;
+        uint16_t length;
+        uint8_t data[TR808_STORE_MAX_RECORD];
+    };
+
+    TR808StorageBackend* backend;
+    IndexEntry index[TR808_RECORD_TYPE_COUNT][TR808_STORE_MAX_SLOTS];
+    PendingWrite pending[TR808_STORE_PENDING_SLOTS];
+
+    uint32_t headSector;        // 현재 쓰기 섹터
+    uint32_t headOffset;        // 섹터 내 다음 쓰기 위치
+    uint32_t headSequence;
+    uint32_t tailSector;        // 가장 오래된 섹터
+    uint32_t nextVersion;
+    // 인덱스/섹터 갱신 시퀀스 (홀수 = 쓰기 태스크가 인덱스 수정 또는 섹터 소거 중)
+    // read()는 복사 전후 값이 같고 짝수일 때만 결과를 사용
+    volatile uint32_t indexSequence;
+    bool mounted;
+    bool collecting;            // 가비지 컬렉션 중 (head 전진 금지)
+    volatile bool eraseAllowed; // 쓰기 태스크의 섹터 소거 허용 (오디오 루프가 안전 지점마다 갱신)
+    Stats stats;
+    uint8_t scratch[TR808_STORE_MAX_RECORD];  // 스캔/GC 복사용 버퍼
+
+#if defined(ARDUINO_ARCH_ESP32)
+    void* writerTask;
+#endif
+
+    bool formatSector(uint32_t sector, uint32_t sequence);
+    bool scanSector(uint32_t sector);
+    bool appendRecord(uint8_t type, uint8_t slot, const void* data, uint16_t length);
+    bool advanceHead();
+    bool collectTail();
+    bool canErase();
+    bool isFreeSector(uint32_t sector, const TR808SectorHeader& header);
+    void beginIndexUpdate();
+    void endIndexUpdate();
+    static uint32_t alignedSize(uint16_t length);
+
+public:
+    TR808PatternStore(TR808StorageBackend* storage);
+
+    // 마운트 (섹터 스캔 후 인덱스 재구성, 저장소 섹터가 없으면 포맷)
+    bool begin();
+    // 저장소 섹터(유효한 섹터 헤더)와 섹터 0만 소거: 나머지는 head가 도달할 때 소거
+    bool format();
+
+    /**
+     * 쓰기 태스크의 섹터 소거 허용 여부 (기본 허용)
+     * 금지 중에는 현재 head 섹터에 들어가는 기록만 수행하고, head 전진/GC가 필요한
+     * 쓰기는 대기열에 남겨 허용될 때 처리 (허용으로 바뀌면 쓰기 태스크를 깨움)
+     * 확인 직후 소거가 시작되므로 허용 -> 금지 전환과 겹친 소거 1회는 막지 못함
+     */
+    void setEraseAllowed(bool allowed);
+    bool isEraseAllowed() const { return eraseAllowed; }
+
+    // 지연 쓰기: 대기열에 복사만 하고 즉시 반환 (오디오 루프에서 호출 가능)
+    bool queueWrite(TR808RecordType type, uint8_t slot, const void* data, size_t length);
+    // 대기열 처리 (저우선순위 태스크 또는 유휴 루프에서 호출)
+    uint8_t flushPending();
+    bool hasPendingWrites() const;
+
+    // 동기 쓰기 (테스트/초기화 전용, 오디오 경로에서 사용 금지)
+    bool writeNow(TR808RecordType type, uint8_t slot, const void* data, size_t length);
+
+    // 읽기 (쓰기 태스크의 GC와 겹치면 재시도, 끝내 겹치면 0)
+    size_t read(TR808RecordType type, uint8_t slot, void* out, size_t maxLength);
+    // 매핑 포인터는 이후 GC가 섹터를 소거하면 무효:
+    // 사용 전후 getIndexSequence()가 같고 짝수인지 호출자가 확인
+    const void* map(TR808RecordType type, uint8_t slot, size_t* length = nullptr) const;
+    uint32_t getIndexSequence() const { return indexSequence; }
+    bool exists(TR808RecordType type, uint8_t slot) const;
+    uint32_t getVersion(TR808RecordType type, uint8_t slot) const;
+
+#if defined(ARDUINO_ARCH_ESP32)
+    // 저우선순위 쓰기 태스크 시작 (queueWrite 시 깨어남)
+    bool startWriterTask(uint8_t priority = 1, uint32_t stackSize = 3072);
+#endif
+
+    const Stats& getStats() const { return stats; }
+    bool isMounted() const { return mounted; }
+};
+
+#endif // TR808_PATTERN_STORE_H
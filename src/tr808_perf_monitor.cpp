@@ -0,0 +1,319 @@
+#include <string.h>
+#include "tr808_perf_monitor.h"
+
+PerformanceMonitor tr808Perf;
+
+static const char* const STAGE_NAMES[TR808_STAGE_COUNT] = {
+    "oscillator", "filter", "envelope", "mix", "output", "control"
+};
+
+// ================ PerformanceMonitor 구현 ================
+
+PerformanceMonitor::PerformanceMonitor()
+    : blockStart(0), sampleStart(0), controlStart(0), controlNested(0), nestedCycles(0)
+    , head(0), tail(0), dropped(0), underruns(0), activeVoices(0), maxVoices(0)
+    , voiceResetRequested(false), windowCount(0), windowPos(0), resetRequested(false), reportSequence(0)
+    , sampleRate(32768), cpuHz(160000000UL), timerOverhead(0)
+    , lastUpdateTime(0), sampleCount(0), controlCount(0) {
+#if defined(ARDUINO_ARCH_ESP32)
+    collectorTask = nullptr;
+#endif
+    clearFrame();
+    memset(reports, 0, sizeof(reports));
+}
+
+void PerformanceMonitor::begin(uint32_t rate, uint32_t cpuFrequency) {
+    sampleRate = rate;
+    cpuHz = cpuFrequency;
+
+    // 카운터 연속 읽기 최소값 = 스테이지 1회 계측 비용 (배타 시간에서 차감)
+    uint32_t best = 0xFFFFFFFF;
+    for (int i = 0; i < 16; i++) {
+        uint32_t t0 = tr808CycleCount();
+        uint32_t t1 = tr808CycleCount();
+        if (t1 - t0 < best) best = t1 - t0;
+    }
+    timerOverhead = best;
+
+    // 이전 레이트로 잰 창은 수집기에서 비움
+    reset();
+}
+
+void PerformanceMonitor::clearFrame() {
+    for (uint8_t stage = 0; stage < TR808_STAGE_COUNT; stage++) {
+        frame.cycles[stage] = 0;
+    }
+    frame.total = 0;
+    frame.samples = 0;
+}
+
+void PerformanceMonitor::publishFrame() {
+    uint32_t h = head;
+    if (h - __atomic_load_n(&tail, __ATOMIC_ACQUIRE) >= TR808_PERF_RING_SIZE) {
+        // 수집기가 밀림: 오디오 쪽은 기다리지 않고 버림
+        dropped = dropped + 1;
+    } else {
+        ring[h & (TR808_PERF_RING_SIZE - 1)] = frame;
+        __atomic_store_n(&head, h + 1, __ATOMIC_RELEASE);
+    }
+    clearFrame();
+}
+
+void PerformanceMonitor::endBlock(uint16_t samples) {
+    frame.total += tr808CycleCount() - blockStart;
+    frame.samples += samples;
+    sampleCount += samples;
+    publishFrame();
+}
+
+void PerformanceMonitor::endAudioSample() {
+    frame.total += tr808CycleCount() - sampleStart;
+    frame.samples++;
+    sampleCount++;
+    if (frame.samples >= TR808_PERF_FRAME_SAMPLES) {
+        publishFrame();
+    }
+}
+
+void PerformanceMonitor::startControlUpdate() {
+    controlNested = enterStage();
+    controlStart = tr808CycleCount();
+}
+
+void PerformanceMonitor::endControlUpdate() {
+    uint32_t elapsed = tr808CycleCount() - controlStart;
+    exitStage(TR808_STAGE_CONTROL, elapsed, controlNested);
+    // Mozzi updateControl은 샘플 타이밍 밖에서 돌므로 전체에도 더함
+    frame.total += elapsed;
+    controlCount++;
+}
+
+void PerformanceMonitor::updateVoiceCount(uint32_t count) {
+    activeVoices = count;
+    if (voiceResetRequested) {
+        voiceResetRequested = false;
+        maxVoices = count;
+    } else if (count > maxVoices) {
+        maxVoices = count;
+    }
+}
+
+void PerformanceMonitor::computeStats(uint32_t* values, uint32_t count, TR808StageStats* out) {
+    if (count == 0) {
+        out->p50 = out->p90 = out->p99 = out->max = 0;
+        return;
+    }
+
+    // 삽입 정렬 (창 크기 TR808_PERF_WINDOW, 수집 태스크에서만 실행)
+    for (uint32_t i = 1; i < count; i++) {
+        uint32_t value = values[i];
+        uint32_t j = i;
+        while (j > 0 && values[j - 1] > value) {
+            values[j] = values[j - 1];
+            j--;
+        }
+        values[j] = value;
+    }
+
+    // 최근접 순위 백분위
+    out->p50 = values[(count * 50 + 99) / 100 - 1];
+    out->p90 = values[(count * 90 + 99) / 100 - 1];
+    out->p99 = values[(count * 99 + 99) / 100 - 1];
+    out->max = values[count - 1];
+}
+
+void PerformanceMonitor::calculateMetrics() {
+    if (resetRequested) {
+        resetRequested = false;
+        windowCount = 0;
+        windowPos = 0;
+    }
+
+    // 링 비우기 (수집기만 tail 기록)
+    uint32_t t = tail;
+    uint32_t h = __atomic_load_n(&head, __ATOMIC_ACQUIRE);
+    while (t != h) {
+        window[windowPos] = ring[t & (TR808_PERF_RING_SIZE - 1)];
+        windowPos = (windowPos + 1) % TR808_PERF_WINDOW;
+        if (windowCount < TR808_PERF_WINDOW) windowCount++;
+        t++;
+    }
+    __atomic_store_n(&tail, t, __ATOMIC_RELEASE);
+
+    uint32_t next = __atomic_load_n(&reportSequence, __ATOMIC_RELAXED) + 1;
+    TR808PerfReport& report = reports[next & 1];
+    uint32_t values[TR808_PERF_WINDOW];
+
+    uint64_t totalCycles = 0;
+    uint64_t totalSamples = 0;
+    for (uint32_t i = 0; i < windowCount; i++) {
+        totalCycles += window[i].total;
+        totalSamples += window[i].samples;
+        values[i] = window[i].samples > 0 ? window[i].total / window[i].samples : 0;
+    }
+    computeStats(values, windowCount, &report.total);
+    report.total.share = 100.0f;
+
+    uint64_t stageCycles[TR808_STAGE_COUNT];
+    for (uint8_t stage = 0; stage < TR808_STAGE_COUNT; stage++) {
+        stageCycles[stage] = 0;
+        for (uint32_t i = 0; i < windowCount; i++) {
+            stageCycles[stage] += window[i].cycles[stage];
+            values[i] = window[i].samples > 0 ? window[i].cycles[stage] / window[i].samples : 0;
+        }
+        computeStats(values, windowCount, &report.stages[stage]);
+        report.stages[stage].share = totalCycles > 0 ? 100.0f * stageCycles[stage] / totalCycles : 0.0f;
+    }
+
+    report.blocks = windowCount;
+    report.dropped = dropped;
+
+    // 샘플당 평균 사이클 -> CPU 사용률 / μs
+    MozziPerformanceMetrics& metrics = report.metrics;
+    float perSample = totalSamples > 0 ? 1.0f / totalSamples : 0.0f;
+    float loadScale = (float)sampleRate * 100.0f / cpuHz;
+    float cyclesPerUs = cpuHz / 1000000.0f;
+    metrics.audioCpuUsage = (totalCycles - stageCycles[TR808_STAGE_CONTROL]) * perSample * loadScale;
+    metrics.controlCpuUsage = stageCycles[TR808_STAGE_CONTROL] * perSample * loadScale;
+    metrics.bufferUnderruns = underruns;
+    metrics.activeVoices = activeVoices;
+    metrics.maxVoices = maxVoices;
+    metrics.envelopeLatency = stageCycles[TR808_STAGE_ENVELOPE] * perSample / cyclesPerUs;
+    metrics.filterLatency = stageCycles[TR808_STAGE_FILTER] * perSample / cyclesPerUs;
+    metrics.memoryUsage = sizeof(*this);
+
+    // 완성된 보고서 게시
+    __atomic_store_n(&reportSequence, next, __ATOMIC_RELEASE);
+    lastUpdateTime = millis();
+}
+
+TR808PerfReport PerformanceMonitor::getReport() const {
+    TR808PerfReport report;
+    uint32_t seq = __atomic_load_n(&reportSequence, __ATOMIC_ACQUIRE);
+    for (;;) {
+        memcpy(&report, &reports[seq & 1], sizeof(report));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        uint32_t check = __atomic_load_n(&reportSequence, __ATOMIC_RELAXED);
+        if (check == seq) return report;
+        seq = check;
+    }
+}
+
+MozziPerformanceMetrics PerformanceMonitor::getMetrics() {
+    return getReport().metrics;
+}
+
+const char* PerformanceMonitor::stageName(uint8_t stage) {
+    return stage < TR808_STAGE_COUNT ? STAGE_NAMES[stage] : "?";
+}
+
+// ================ TR808LoadMeter 구현 ================
+
+TR808LoadMeter::TR808LoadMeter()
+    : budgetPerSample(1), cyclesPerUs(1), start(0), pendingCycles(0), pendingSamples(0)
+    , averageQ(0), holdBlocks(0), load(0), peak(0), average(0), maxLoad(0)
+    , sampleCycles(0), maxSampleCycles(0), overruns(0), resetRequested(false) {
+}
+
+void TR808LoadMeter::begin(uint32_t sampleRate, uint32_t cpuHz) {
+    budgetPerSample = sampleRate > 0 ? cpuHz / sampleRate : 1;
+    if (budgetPerSample == 0) budgetPerSample = 1;
+    cyclesPerUs = cpuHz >= 1000000UL ? cpuHz / 1000000UL : 1;
+    pendingCycles = 0;
+    pendingSamples = 0;
+    resetRequested = true;
+}
+
+void TR808LoadMeter::flush() {
+    if (pendingSamples == 0) return;
+    addBlock(pendingCycles, pendingSamples);
+    pendingCycles = 0;
+    pendingSamples = 0;
+}
+
+void TR808LoadMeter::addBlock(uint32_t cycles, uint32_t samples) {
+    if (samples == 0) return;
+
+    if (resetRequested) {
+        resetRequested = false;
+        maxLoad = 0;
+        maxSampleCycles = 0;
+        overruns = 0;
+        peak = 0;
+        averageQ = 0;
+        holdBlocks = 0;
+    }
+
+    // 퍼밀 부하 (곱셈만 64비트, 나눗셈 1회)
+    uint64_t deadline = (uint64_t)budgetPerSample * samples;
+    uint32_t permille = (uint32_t)(((uint64_t)cycles * 1000) / deadline);
+    uint16_t current = permille > 0xFFFF ? 0xFFFF : (uint16_t)permille;
+    load = current;
+    sampleCycles = cycles / samples;
+
+    if (current > 1000) overruns = overruns + 1;
+    if (current > maxLoad) maxLoad = current;
+    if (sampleCycles > maxSampleCycles) maxSampleCycles = sampleCycles;
+
+    // 피크 유지 후 감쇠
+    if (current >= peak) {
+        peak = current;
+        holdBlocks = TR808_LOAD_HOLD_BLOCKS;
+    } else if (holdBlocks > 0) {
+        holdBlocks--;
+    } else {
+        uint16_t drop = (peak - current) >> TR808_LOAD_PEAK_SHIFT;
+        peak = peak - (drop > 0 ? drop : 1);
+    }
+
+    // 지수 감쇠 평균 (정수)
+    averageQ += current - (averageQ >> TR808_LOAD_AVG_SHIFT);
+    average = (uint16_t)(averageQ >> TR808_LOAD_AVG_SHIFT);
+}
+
+#if defined(ARDUINO_ARCH_ESP32)
+
+void PerformanceMonitor::printReport() {
+    TR808PerfReport report = getReport();
+
+    Serial.printf("📊 스테이지별 사이클/샘플 (최근 %lu 블록)\n", (unsigned long)report.blocks);
+#ifndef TR808_STAGE_PROFILING
+    Serial.println("  (스테이지 계측 비활성: -DTR808_STAGE_PROFILING 빌드에서 활성)");
+#endif
+    Serial.println("  스테이지        p50     p90     p99    최대    비율");
+    for (uint8_t stage = 0; stage < TR808_STAGE_COUNT; stage++) {
+        const TR808StageStats& s = report.stages[stage];
+        Serial.printf("  %-10s %7lu %7lu %7lu %7lu  %5.1f%%\n", STAGE_NAMES[stage],
+                      (unsigned long)s.p50, (unsigned long)s.p90, (unsigned long)s.p99,
+                      (unsigned long)s.max, s.share);
+    }
+    Serial.printf("  %-10s %7lu %7lu %7lu %7lu\n", "total",
+                  (unsigned long)report.total.p50, (unsigned long)report.total.p90,
+                  (unsigned long)report.total.p99, (unsigned long)report.total.max);
+    Serial.printf("  오디오 CPU %.1f%%, 컨트롤 CPU %.1f%%, 언더런 %lu, 버린 프레임 %lu\n",
+                  report.metrics.audioCpuUsage, report.metrics.controlCpuUsage,
+                  (unsigned long)report.metrics.bufferUnderruns, (unsigned long)report.dropped);
+}
+
+static void performanceCollectorTask(void* parameters) {
+    PerformanceMonitor* monitor = (PerformanceMonitor*)parameters;
+    TickType_t lastWake = xTaskGetTickCount();
+    while (true) {
+        vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(TR808_PERF_COLLECT_MS));
+        monitor->calculateMetrics();
+    }
+}
+
+bool PerformanceMonitor::startCollectorTask(uint8_t priority, uint32_t stackSize) {
+    if (collectorTask != nullptr) return true;
+
+    TaskHandle_t handle = nullptr;
+    if (xTaskCreate(performanceCollectorTask, "tr808_perf", stackSize, this,
+                    priority, &handle) != pdPASS) {
+        return false;
+    }
+    collectorTask = handle;
+    return true;
+}
+
+#endif
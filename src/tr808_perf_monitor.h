@@ -0,0 +1,310 @@
+/*
+ * TR-808 스테이지별 성능 모니터
+ *
+ * mozzi_integration_plan.h에 선언만 있던 PerformanceMonitor/MozziPerformanceMetrics 구현
+ * 샘플당 사이클이 어느 처리 단계에 쓰이는지 CPU 사이클 카운터로 귀속
+ * - 스테이지: 오실레이터, 필터, 엔벨롭, 믹스, 출력, 컨트롤
+ * - 오디오 컨텍스트(단일 기록자)는 블록 누산기에만 더하고, 블록 끝에 SPSC 링으로 발행 (락 없음)
+ * - 저우선순위 태스크가 링을 비워 최근 블록 창에서 p50/p90/p99/최대를 계산
+ * - 중첩 스테이지는 배타 시간으로 집계 (안쪽 스테이지 시간은 바깥에서 제외)
+ * - 스테이지 계측은 -DTR808_STAGE_PROFILING 빌드에서만 활성 (기본 빌드 비용 0)
+ *
+ * 작성일: 2025-10-30
+ * 호환성: ESP32C3 Arduino / 호스트 (extras/host)
+ */
+
+#ifndef TR808_PERF_MONITOR_H
+#define TR808_PERF_MONITOR_H
+
+#include <stdint.h>
+#include <Arduino.h>
+
+// ============================================
+// 모니터 설정
+// ============================================
+
+#define TR808_PERF_RING_SIZE        64      // 발행 대기 블록 프레임 (2의 거듭제곱)
+#define TR808_PERF_WINDOW           128     // 백분위 계산 창 (블록 수)
+#define TR808_PERF_FRAME_SAMPLES    256     // 샘플 단위 계측 시 프레임 길이
+#define TR808_PERF_COLLECT_MS       200     // 수집 태스크 주기
+
+#define TR808_LOAD_HOLD_BLOCKS      64      // 부하 피크 유지 블록 수 (이후 감쇠)
+#define TR808_LOAD_PEAK_SHIFT       3       // 피크 감쇠: 블록마다 차이의 1/8
+#define TR808_LOAD_AVG_SHIFT        4       // 평균 감쇠: 블록마다 차이의 1/16
+
+static_assert((TR808_PERF_RING_SIZE & (TR808_PERF_RING_SIZE - 1)) == 0,
+              "TR808_PERF_RING_SIZE는 2의 거듭제곱이어야 함");
+
+enum TR808PerfStage : uint8_t {
+    TR808_STAGE_OSCILLATOR = 0,
+    TR808_STAGE_FILTER,
+    TR808_STAGE_ENVELOPE,
+    TR808_STAGE_MIX,            // 보이스 합산/게인/클리핑 등 보이스 내부 나머지
+    TR808_STAGE_OUTPUT,         // 정수 변환/버퍼 기록 (I2S DMA 대기는 제외)
+    TR808_STAGE_CONTROL,        // 컨트롤 레이트 업데이트 (Mozzi updateControl)
+    TR808_STAGE_COUNT
+};
+
+// 사이클 카운터 (호스트: ns)
+inline uint32_t tr808CycleCount() {
+#ifdef TR808_HOST_BUILD
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+#else
+    return ESP.getCycleCount();
+#endif
+}
+
+// 사이클 카운터 주파수 (호스트: 1GHz = ns)
+inline uint32_t tr808CycleHz() {
+#ifdef TR808_HOST_BUILD
+    return 1000000000UL;
+#else
+    return ESP.getCpuFreqMHz() * 1000000UL;
+#endif
+}
+
+// ============================================
+// 집계 결과
+// ============================================
+
+/**
+ * Mozzi 전용 성능 메트릭
+ */
+struct MozziPerformanceMetrics {
+    float audioCpuUsage;      // 오디오 처리 CPU 사용률
+    float controlCpuUsage;    // 컨트롤 처리 CPU 사용률
+    uint32_t bufferUnderruns; // 버퍼 언더런 발생 횟수
+    uint32_t activeVoices;    // 활성 음성 수
+    uint32_t maxVoices;       // 최대 동시 음성 수
+    float envelopeLatency;    // 엔벨롭 지연 시간 (μs)
+    float filterLatency;      // 필터 지연 시간 (μs)
+    uint32_t memoryUsage;     // 메모리 사용량 (바이트)
+};
+
+// 스테이지별 샘플당 사이클 분포 (최근 창 기준)
+struct TR808StageStats {
+    uint32_t p50;
+    uint32_t p90;
+    uint32_t p99;
+    uint32_t max;
+    float share;                // 전체 사이클 중 비율 (%)
+};
+
+struct TR808PerfReport {
+    TR808StageStats stages[TR808_STAGE_COUNT];
+    TR808StageStats total;      // 블록 전체 (이벤트/클럭 등 미귀속 시간 포함)
+    uint32_t blocks;            // 창에 포함된 블록 수
+    uint32_t dropped;           // 링이 가득 차 버린 프레임 수
+    MozziPerformanceMetrics metrics;
+};
+
+// 오디오 컨텍스트에서 발행하는 블록 단위 누산 프레임
+struct TR808PerfFrame {
+    uint32_t cycles[TR808_STAGE_COUNT];
+    uint32_t total;
+    uint32_t samples;
+};
+
+// ============================================
+// 성능 모니터
+// ============================================
+
+/**
+ * 성능 모니터링 관리자
+ * 오디오 측 함수는 오디오 루프 하나에서만 호출 (락/원자 RMW 없음)
+ * calculateMetrics()는 수집 태스크 하나에서 호출, getReport()/printReport()는 어디서나
+ */
+class PerformanceMonitor {
+private:
+    // ---- 오디오 컨텍스트 전용 ----
+    TR808PerfFrame frame;               // 진행 중인 블록 누산기
+    uint32_t blockStart;
+    uint32_t sampleStart;
+    uint32_t controlStart;
+    uint32_t controlNested;
+    uint32_t nestedCycles;              // 현재 스테이지 안에서 끝난 하위 스테이지 시간
+
+    // ---- 오디오 -> 수집 SPSC 링 ----
+    TR808PerfFrame ring[TR808_PERF_RING_SIZE];
+    volatile uint32_t head;             // 오디오만 기록
+    volatile uint32_t tail;             // 수집기만 기록
+    volatile uint32_t dropped;
+    volatile uint32_t underruns;
+    volatile uint32_t activeVoices;
+    volatile uint32_t maxVoices;        // 오디오만 기록 (초기화도 오디오 쪽에서 적용)
+    volatile bool voiceResetRequested;  // 다음 updateVoiceCount()에서 최대값을 현재 값으로
+
+    // ---- 수집 컨텍스트 전용 ----
+    TR808PerfFrame window[TR808_PERF_WINDOW];
+    uint32_t windowCount;
+    uint32_t windowPos;
+    volatile bool resetRequested;
+
+    // 발행 보고서 (래치형 seqlock: 비활성 슬롯에 쓰고 reportSequence로 게시)
+    // 읽는 도중 게시가 두 번 일어나면 읽던 슬롯이 덮이므로 getReport()가 시퀀스로 확인
+    TR808PerfReport reports[2];
+    uint32_t reportSequence;            // 게시 횟수, 현재 슬롯 = reportSequence & 1
+
+    uint32_t sampleRate;
+    uint32_t cpuHz;
+    uint32_t timerOverhead;             // 스테이지 계측 1회 비용 (보정용)
+    uint32_t lastUpdateTime;
+    uint32_t sampleCount;
+    uint32_t controlCount;
+
+#if defined(ARDUINO_ARCH_ESP32)
+    void* collectorTask;
+#endif
+
+    void publishFrame();
+    void clearFrame();
+    static void computeStats(uint32_t* values, uint32_t count, TR808StageStats* out);
+
+public:
+    PerformanceMonitor();
+
+    void begin(uint32_t rate, uint32_t cpuHz);
+
+    // ---- 오디오 컨텍스트 ----
+    // 블록 렌더러: 블록 앞뒤로 호출
+    void beginBlock() { blockStart = tr808CycleCount(); }
+    void endBlock(uint16_t samples);
+
+    // 샘플 단위 렌더러 (Mozzi updateAudio): TR808_PERF_FRAME_SAMPLES마다 프레임 발행
+    void startAudioSample() { sampleStart = tr808CycleCount(); }
+    void endAudioSample();
+    void startControlUpdate();
+    void endControlUpdate();
+
+    // 스테이지 진입/종료 (TR808StageTimer 경유): 배타 시간 집계
+    inline uint32_t enterStage() {
+        uint32_t saved = nestedCycles;
+        nestedCycles = 0;
+        return saved;
+    }
+    inline void exitStage(uint8_t stage, uint32_t elapsed, uint32_t savedNested) {
+        uint32_t own = elapsed - nestedCycles;
+        frame.cycles[stage] += own > timerOverhead ? own - timerOverhead : 0;
+        nestedCycles = savedNested + elapsed;
+    }
+
+    void updateBufferUnderrun() { underruns = underruns + 1; }
+    void updateVoiceCount(uint32_t count);
+
+    // ---- 수집 컨텍스트 ----
+    // 링을 비우고 창의 백분위/메트릭을 계산해 보고서 발행
+    void calculateMetrics();
+    MozziPerformanceMetrics getMetrics();
+    TR808PerfReport getReport() const;
+    void printReport();
+    void reset() {
+        resetRequested = true;
+        voiceResetRequested = true;
+    }
+
+#if defined(ARDUINO_ARCH_ESP32)
+    // 오디오 루프보다 낮은 우선순위로 주기 수집 (loopTask 우선순위 1)
+    bool startCollectorTask(uint8_t priority = 0, uint32_t stackSize = 3072);
+#endif
+
+    static const char* stageName(uint8_t stage);
+};
+
+// 전체 엔진 공용 모니터
+extern PerformanceMonitor tr808Perf;
+
+// ============================================
+// 블록 부하 미터
+// ============================================
+
+/**
+ * 블록 마감 대비 CPU 부하 미터 (단위: 퍼밀, 1000 = 마감 시간 전부 사용)
+ * 블록 렌더 사이클 / (샘플 수 * 샘플당 사이클 예산)
+ * - 피크: TR808_LOAD_HOLD_BLOCKS 동안 유지 후 현재 값으로 감쇠
+ * - 평균: 지수 감쇠 평균
+ * 기록은 오디오 컨텍스트 하나, 조회는 어디서나 (16비트 값 단일 읽기)
+ */
+class TR808LoadMeter {
+private:
+    uint32_t budgetPerSample;           // 샘플당 사이클 예산 (cpuHz / 레이트)
+    uint32_t cyclesPerUs;
+    uint32_t start;
+    uint32_t pendingCycles;             // 샘플 단위 계측 누산
+    uint32_t pendingSamples;
+    uint32_t averageQ;                  // 평균 << TR808_LOAD_AVG_SHIFT
+    uint16_t holdBlocks;
+    volatile uint16_t load;
+    volatile uint16_t peak;
+    volatile uint16_t average;
+    volatile uint16_t maxLoad;
+    volatile uint32_t sampleCycles;     // 마지막 블록의 샘플당 사이클
+    volatile uint32_t maxSampleCycles;
+    volatile uint32_t overruns;         // 마감 초과 블록 수
+    volatile bool resetRequested;
+
+public:
+    TR808LoadMeter();
+
+    void begin(uint32_t sampleRate, uint32_t cpuHz);
+
+    // 블록 렌더러: 렌더 앞뒤로 호출 (출력 대기 시간 제외)
+    inline void startBlock() { start = tr808CycleCount(); }
+    inline void endBlock(uint16_t samples) { addBlock(tr808CycleCount() - start, samples); }
+
+    // 샘플 단위 렌더러: 샘플마다 누산, flush()에서 한 블록으로 반영
+    inline void startSample() { start = tr808CycleCount(); }
+    inline void endSample() {
+        pendingCycles += tr808CycleCount() - start;
+        pendingSamples++;
+    }
+    void flush();
+
+    void addBlock(uint32_t cycles, uint32_t samples);
+
+    // 퍼밀 단위 조회
+    uint16_t getLoad() const { return load; }
+    uint16_t getPeak() const { return peak; }
+    uint16_t getAverage() const { return average; }
+    uint16_t getMax() const { return maxLoad; }
+    uint32_t getOverruns() const { return overruns; }
+    uint32_t getSampleCycles() const { return sampleCycles; }
+    uint32_t getSampleTimeUs() const { return sampleCycles / cyclesPerUs; }
+    uint32_t getMaxSampleTimeUs() const { return maxSampleCycles / cyclesPerUs; }
+
+    // 최대/오버런 초기화 (다음 블록에서 오디오 컨텍스트가 적용)
+    void reset() { resetRequested = true; }
+};
+
+// ============================================
+// 스테이지 계측
+// ============================================
+
+/**
+ * 스코프 기반 스테이지 타이머
+ * 생성 시 시작, 소멸 시 tr808Perf에 배타 시간 누산
+ */
+class TR808StageTimer {
+private:
+    uint32_t start;
+    uint32_t savedNested;
+    uint8_t stage;
+
+public:
+    explicit TR808StageTimer(uint8_t stageId)
+        : savedNested(tr808Perf.enterStage()), stage(stageId) {
+        start = tr808CycleCount();
+    }
+    ~TR808StageTimer() {
+        tr808Perf.exitStage(stage, tr808CycleCount() - start, savedNested);
+    }
+};
+
+#ifdef TR808_STAGE_PROFILING
+    #define TR808_PROFILE_STAGE(stage) TR808StageTimer _tr808StageTimer(stage)
+#else
+    #define TR808_PROFILE_STAGE(stage)
+#endif
+
+#endif // TR808_PERF_MONITOR_H
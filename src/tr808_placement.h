@@ -0,0 +1,39 @@
+/*
+ * TR-808 렌더 경로 메모리 배치 정책
+ *
+ * 렌더 진입점(processAudio, audioHook)에서 도달하는 함수/테이블을 IRAM/DRAM에 둠
+ * - 목적은 캐시 미스 제거: 플래시 코드/테이블은 명령어·데이터 공용 캐시(C3 16KB) 뒤에 있어
+ *   다른 태스크나 긴 렌더가 캐시를 밀어낸 뒤에는 미스마다 플래시 읽기를 기다림 (블록 WCET 증가)
+ * - 플래시 지우기/쓰기 정지는 막지 못함: 단일 코어라 그동안 스케줄러가 멈춰 배치와 무관하게
+ *   렌더 태스크도 실행되지 않음 (저장소는 안전 지점에서만 지움, tr808_pattern_store.h)
+ * - newlib sinf/tanhf 등 미리 빌드된 라이브러리는 플래시에 남음 (배치 보고서에서 따로 집계)
+ * - TR808_HOT: 블록/샘플마다 호출되는 함수 (클래스 밖 정의에 지정)
+ * - TR808_HOT_DATA: 렌더 중 읽는 const 테이블 (정의에 지정, 기본은 플래시 .rodata)
+ * - 설정 경로(트리거, 파라미터, 초기화)는 플래시에 둠 (IRAM은 DRAM과 같은 SRAM을 나눠 씀)
+ * - -DTR808_PLACE_HOT_PATH=0이면 모두 빈 매크로 (배치 전 비교 빌드: platformio.ini env:flashpath)
+ * - 도달 가능 목록과 실제 섹션 확인: extras/tools/placement_report.py (env:placement)
+ * - ESP-IDF 컴포넌트 빌드는 extras/linker/tr808_placement.lf로 같은 정책을 객체 단위로 적용
+ *
+ * 작성일: 2025-10-30
+ * 호환성: ESP32C3 Arduino / 호스트 (빈 매크로)
+ */
+
+#ifndef TR808_PLACEMENT_H
+#define TR808_PLACEMENT_H
+
+#ifndef TR808_PLACE_HOT_PATH
+#define TR808_PLACE_HOT_PATH 1
+#endif
+
+#if TR808_PLACE_HOT_PATH && defined(ARDUINO_ARCH_ESP32) && !defined(TR808_HOST_BUILD)
+#include <esp_attr.h>
+#define TR808_PLACE_ACTIVE  1
+#define TR808_HOT           IRAM_ATTR
+#define TR808_HOT_DATA      DRAM_ATTR
+#else
+#define TR808_PLACE_ACTIVE  0
+#define TR808_HOT
+#define TR808_HOT_DATA
+#endif
+
+#endif // TR808_PLACEMENT_H
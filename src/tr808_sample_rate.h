@@ -0,0 +1,58 @@
+/*
+ * TR-808 샘플 레이트 정책 (단일 컴파일 타임 레이트)
+ *
+ * tr808_drums.h(32768), platformio.ini(44100/32000), Mozzi 보이스(64000)가
+ * 서로 다른 레이트를 가정하면 오실레이터 증분과 필터 계수가 틀어지므로,
+ * 모든 엔진이 계수를 유도하는 하나의 레이트를 정의
+ * - 빌드 플래그 -DSAMPLE_RATE=... 가 있으면 그 값, 없으면 32768
+ * - TR808RatePolicy<Rate>: 레이트 의존 상수를 constexpr로 제공 (컴파일러가 폴딩)
+ * - 출력 드라이버 설정과의 일치는 각 설정 헤더에서 static_assert로 검증
+ *
+ * 작성일: 2025-10-30
+ * 호환성: ESP32C3 Arduino / Mozzi / 호스트
+ */
+
+#ifndef TR808_SAMPLE_RATE_H
+#define TR808_SAMPLE_RATE_H
+
+#include <stdint.h>
+
+// ============================================
+// 레이트 선택
+// ============================================
+
+#ifndef TR808_SAMPLE_RATE
+    #ifdef SAMPLE_RATE
+        #define TR808_SAMPLE_RATE SAMPLE_RATE
+    #else
+        #define TR808_SAMPLE_RATE 32768     // 32.768kHz (ESP32C3 권장)
+    #endif
+#endif
+
+#define TR808_SAMPLE_RATE_MIN   8000
+#define TR808_SAMPLE_RATE_MAX   64000
+
+static_assert(TR808_SAMPLE_RATE >= TR808_SAMPLE_RATE_MIN && TR808_SAMPLE_RATE <= TR808_SAMPLE_RATE_MAX,
+              "TR808_SAMPLE_RATE 범위 오류");
+
+// ============================================
+// 레이트 의존 상수
+// ============================================
+
+/**
+ * 샘플 레이트에서 유도되는 계수 모음
+ * 엔진은 "/ rate" 대신 이 상수를 곱해 런타임 나눗셈을 없앰
+ */
+template <uint32_t Rate>
+struct TR808RatePolicy {
+    static constexpr uint32_t rate = Rate;
+    static constexpr float samplePeriod = 1.0f / Rate;                     // 초
+    static constexpr float radiansPerHz = 6.28318530717958647692f / Rate;  // 2pi / rate
+    static constexpr uint32_t samplePeriodUs = 1000000UL / Rate;
+    static constexpr uint64_t phasePerHzQ16 = ((uint64_t)1 << 48) / Rate;  // 32비트 위상, Hz Q16 입력
+};
+
+// 전체 엔진 공용 레이트
+typedef TR808RatePolicy<TR808_SAMPLE_RATE> TR808AudioRate;
+
+#endif // TR808_SAMPLE_RATE_H
@@ -0,0 +1,139 @@
+#include "tr808_serial_protocol.h"
+#include <string.h>
+
+// ================ CRC16 구현 ================
+
+uint16_t tr808Crc16(const uint8_t* data, size_t length, uint16_t crc) {
+    for (size_t i = 0; i < length; i++) {
+        // 테이블 없는 바이트 단위 CRC16-CCITT (프레임이 짧아 충분히 빠름)
+        uint16_t x = (uint16_t)(((crc >> 8) ^ data[i]) & 0xFF);
+        x ^= x >> 4;
+        crc = (uint16_t)((crc << 8) ^ (x << 12) ^ (x << 5) ^ x);
+    }
+    return crc;
+}
+
+// ================ TR808FrameDecoder 구현 ================
+
+TR808FrameDecoder::TR808FrameDecoder() {
+    memset(&stats, 0, sizeof(stats));
+    memset(&frame, 0, sizeof(frame));
+    reset();
+}
+
+void TR808FrameDecoder::reset() {
+    length = 0;
+    code = 0;
+    remaining = 0;
+    inFrame = false;
+    discarding = false;
+}
+
+bool TR808FrameDecoder::feed(uint8_t byte) {
+    if (byte == TR808_FRAME_DELIMITER) {
+        // 구분자: 데이터가 있었으면 프레임 종료 (텍스트 모드 복귀), 없으면 프레임 시작
+        if (!inFrame || (code == 0 && !discarding)) {
+            inFrame = true;
+            return false;
+        }
+
+        bool complete = false;
+        if (!discarding) {
+            if (remaining != 0) {
+                stats.malformed++;
+            } else {
+                complete = finishFrame();
+            }
+        }
+        reset();
+        return complete;
+    }
+
+    if (!inFrame || discarding) {
+        return false;
+    }
+
+    if (remaining == 0) {
+        // 새 COBS 블록: 이전 블록이 0xFF가 아니면 0x00 복원
+        if (code != 0 && code != 0xFF) {
+            if (length >= TR808_FRAME_MAX_DECODED) {
+                stats.overruns++;
+                discarding = true;
+                return false;
+            }
+            buffer[length++] = 0x00;
+        }
+        code = byte;
+        remaining = byte - 1;
+        return false;
+    }
+
+    if (length >= TR808_FRAME_MAX_DECODED) {
+        stats.overruns++;
+        discarding = true;
+        return false;
+    }
+    buffer[length++] = byte;
+    remaining--;
+    return false;
+}
+
+bool TR808FrameDecoder::finishFrame() {
+    if (length < TR808_FRAME_OVERHEAD) {
+        stats.malformed++;
+        return false;
+    }
+
+    uint8_t bodyLength = length - 2;
+    uint16_t received = tr808ReadU16(&buffer[bodyLength]);
+    if (tr808Crc16(buffer, bodyLength) != received) {
+        stats.crcErrors++;
+        return false;
+    }
+
+    frame.command = buffer[0];
+    frame.sequence = buffer[1];
+    frame.length = bodyLength - 2;
+    memcpy(frame.payload, &buffer[2], frame.length);
+    stats.framesReceived++;
+    return true;
+}
+
+// ================ 프레임 인코딩 ================
+
+size_t tr808EncodeFrame(uint8_t command, uint8_t sequence,
+                        const uint8_t* payload, uint8_t length, uint8_t* out) {
+    if (length > TR808_FRAME_MAX_PAYLOAD) return 0;
+
+    uint8_t raw[TR808_FRAME_MAX_DECODED];
+    raw[0] = command;
+    raw[1] = sequence;
+    if (length > 0) memcpy(&raw[2], payload, length);
+    uint16_t crc = tr808Crc16(raw, length + 2);
+    raw[length + 2] = (uint8_t)(crc & 0xFF);
+    raw[length + 3] = (uint8_t)(crc >> 8);
+    size_t rawLength = length + TR808_FRAME_OVERHEAD;
+
+    // COBS 인코딩
+    size_t pos = 0;
+    out[pos++] = TR808_FRAME_DELIMITER;
+    size_t codeIndex = pos++;
+    uint8_t blockCode = 1;
+    for (size_t i = 0; i < rawLength; i++) {
+        if (raw[i] == 0) {
+            out[codeIndex] = blockCode;
+            codeIndex = pos++;
+            blockCode = 1;
+        } else {
+            out[pos++] = raw[i];
+            if (++blockCode == 0xFF) {
+                out[codeIndex] = blockCode;
+                codeIndex = pos++;
+                blockCode = 1;
+            }
+        }
+    }
+    out[codeIndex] = blockCode;
+    out[pos++] = TR808_FRAME_DELIMITER;
+    return pos;
+}
@@ -0,0 +1,142 @@
+/*
+ * TR-808 바이너리 시리얼 프로토콜 (COBS 프레이밍 + CRC16)
+ *
+ * Serial.readString() 기반 텍스트 명령은 스트림 타임아웃(기본 1초)만큼
+ * 블로킹되고 String 할당을 유발하므로, 제어 소프트웨어용으로
+ * 할당 없는 증분 바이너리 프레임 파서를 제공
+ * - 프레임: 0x00 | COBS( cmd, seq, payload..., crc16 ) | 0x00
+ * - UART RX 링버퍼에서 바이트 단위로 공급, 프레임 완성 즉시 처리
+ * - 텍스트 콘솔과 공존 (텍스트 명령에는 0x00 바이트가 없음)
+ * - 페이로드 필드 배치는 extras/user_interface.h의 SerialPacket과 동일
+ *
+ * 작성일: 2025-10-30
+ * 호환성: ESP32C3 Arduino / 호스트
+ */
+
+#ifndef TR808_SERIAL_PROTOCOL_H
+#define TR808_SERIAL_PROTOCOL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// ============================================
+// 프로토콜 설정
+// ============================================
+
+#define TR808_FRAME_MAX_PAYLOAD   32     // 페이로드 최대 길이
+#define TR808_FRAME_OVERHEAD      4      // cmd + seq + crc16
+#define TR808_FRAME_MAX_DECODED   (TR808_FRAME_MAX_PAYLOAD + TR808_FRAME_OVERHEAD)
+// COBS 인코딩 최대 길이: 254바이트마다 1바이트 + 선두 코드 + 구분자 2개
+#define TR808_FRAME_MAX_ENCODED   (TR808_FRAME_MAX_DECODED + TR808_FRAME_MAX_DECODED / 254 + 3)
+#define TR808_FRAME_DELIMITER     0x00
+#define TR808_FRAME_STEPS         16     // 일괄 스텝 설정 단위
+
+// 프레임 명령
+enum TR808FrameCommand {
+    TR808_FRAME_TRIGGER       = 0x01,  // {voice, velocity}
+    TR808_FRAME_TRIGGER_MASK  = 0x02,  // {mask_lo, mask_hi, velocity} 여러 보이스 동시 트리거
+    TR808_FRAME_SET_PARAM     = 0x10,  // {param, float32 LE} 범위 밖/NaN이면 NACK(BAD_VALUE)
+    TR808_FRAME_SET_STEPS     = 0x20,  // {voice, start, count, velocity[count]} 최대 16스텝 일괄
+    TR808_FRAME_TRANSPORT     = 0x30,  // {running, bpm_lo, bpm_hi}
+    TR808_FRAME_STATUS        = 0x40,  // {} -> 상태 응답
+    TR808_FRAME_ACK           = 0x80,  // 응답: {command}
+    TR808_FRAME_NACK          = 0xFF   // 응답: {command, error}
+};
+
+// 보이스 번호 (텍스트 콘솔 숫자키 순서와 동일, MIDI/시퀀서 공용)
+enum TR808Voice {
+    TR808_VOICE_KICK = 0,
+    TR808_VOICE_SNARE,
+    TR808_VOICE_CYMBAL,
+    TR808_VOICE_HIHAT_CLOSED,
+    TR808_VOICE_HIHAT_OPEN,
+    TR808_VOICE_TOM,
+    TR808_VOICE_CONGA,
+    TR808_VOICE_RIMSHOT,
+    TR808_VOICE_MARACAS,
+    TR808_VOICE_CLAP,
+    TR808_VOICE_COWBELL,
+    TR808_VOICE_COUNT
+};
+
+// NACK 오류 코드
+enum TR808FrameError {
+    TR808_FRAME_OK = 0,
+    TR808_FRAME_ERR_UNKNOWN_COMMAND,
+    TR808_FRAME_ERR_BAD_LENGTH,
+    TR808_FRAME_ERR_BAD_VALUE
+};
+
+// 디코딩된 프레임
+struct TR808Frame {
+    uint8_t command;
+    uint8_t sequence;       // 응답 매칭용 시퀀스 번호
+    uint8_t length;         // 페이로드 길이
+    uint8_t payload[TR808_FRAME_MAX_PAYLOAD];
+};
+
+/**
+ * CRC16-CCITT (poly 0x1021, init 0xFFFF)
+ */
+uint16_t tr808Crc16(const uint8_t* data, size_t length, uint16_t crc = 0xFFFF);
+
+/**
+ * 증분 COBS 프레임 디코더
+ * 바이트 단위로 feed() 하면 프레임 완성 시 true 반환
+ * 내부 상태는 고정 크기 버퍼만 사용 (힙 할당 없음)
+ */
+class TR808FrameDecoder {
+public:
+    struct Stats {
+        uint32_t framesReceived;
+        uint32_t crcErrors;
+        uint32_t overruns;      // 최대 길이 초과 프레임
+        uint32_t malformed;     // COBS 오류 / 최소 길이 미만
+    };
+
+private:
+    uint8_t buffer[TR808_FRAME_MAX_DECODED];
+    uint8_t length;
+    uint8_t code;           // 현재 COBS 블록 코드
+    uint8_t remaining;      // 현재 블록 남은 바이트
+    bool inFrame;
+    bool discarding;        // 오류 프레임 - 다음 구분자까지 무시
+    TR808Frame frame;
+    Stats stats;
+
+    bool finishFrame();
+
+public:
+    TR808FrameDecoder();
+
+    void reset();
+
+    // 바이트 공급: 완성된 유효 프레임이 있으면 true
+    bool feed(uint8_t byte);
+
+    // 프레임 수신 중 여부 (텍스트 콘솔과 분리용)
+    bool isReceiving() const { return inFrame; }
+
+    const TR808Frame& getFrame() const { return frame; }
+    const Stats& getStats() const { return stats; }
+};
+
+/**
+ * 프레임 인코딩 (구분자 포함)
+ * @return 인코딩된 바이트 수 (out은 TR808_FRAME_MAX_ENCODED 이상), 실패 시 0
+ */
+size_t tr808EncodeFrame(uint8_t command, uint8_t sequence,
+                        const uint8_t* payload, uint8_t length, uint8_t* out);
+
+// 리틀엔디언 필드 헬퍼
+inline uint16_t tr808ReadU16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+inline float tr808ReadFloat(const uint8_t* p) {
+    union { uint32_t u; float f; } value;
+    value.u = (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+    return value.f;
+}
+
+#endif // TR808_SERIAL_PROTOCOL_H
@@ -0,0 +1,74 @@
+#include <string.h>
+#include "tr808_trace.h"
+
+#ifdef TR808_TRACE
+
+TR808TraceRing tr808Trace;
+
+// ================ TR808TraceRing 구현 ================
+
+TR808TraceRing::TR808TraceRing() : records(nullptr), head(0), enabled(false), freezeOnUnderrun(false) {
+}
+
+void TR808TraceRing::begin(TR808TraceRecord* storage) {
+    records = storage;
+    head = 0;
+    enabled = records != nullptr;
+}
+
+void TR808TraceRing::recordUnderrun(uint16_t written) {
+    record(TR808_TRACE_UNDERRUN, written);
+    if (freezeOnUnderrun) {
+        enabled = false;
+        freezeOnUnderrun = false;
+    }
+}
+
+void TR808TraceRing::clear() {
+    bool wasEnabled = enabled;
+    enabled = false;
+    head = 0;
+    enabled = wasEnabled;
+}
+
+uint32_t TR808TraceRing::getCount() const {
+    uint32_t reserved = head;
+    return reserved < TR808_TRACE_RECORDS ? reserved : TR808_TRACE_RECORDS;
+}
+
+uint32_t TR808TraceRing::getLost() const {
+    uint32_t reserved = head;
+    return reserved > TR808_TRACE_RECORDS ? reserved - TR808_TRACE_RECORDS : 0;
+}
+
+size_t TR808TraceRing::dump(TR808TraceWriter write) {
+    bool wasEnabled = enabled;
+    enabled = false;
+
+    uint32_t reserved = head;
+    uint32_t count = getCount();
+
+    TR808TraceHeader header;
+    memcpy(header.magic, TR808_TRACE_MAGIC, sizeof(header.magic));
+    header.version = TR808_TRACE_VERSION;
+    header.recordSize = sizeof(TR808TraceRecord);
+    header.reserved = 0;
+    header.cycleHz = tr808CycleHz();
+    header.recordCount = count;
+    header.lost = getLost();
+    write((const uint8_t*)&header, sizeof(header));
+
+    // 가장 오래된 슬롯부터 링 끝까지, 이어서 처음부터 (최대 2회 출력)
+    uint32_t first = (reserved - count) & (TR808_TRACE_RECORDS - 1);
+    uint32_t tail = TR808_TRACE_RECORDS - first;
+    if (tail > count) tail = count;
+    write((const uint8_t*)&records[first], tail * sizeof(TR808TraceRecord));
+    if (count > tail) {
+        write((const uint8_t*)&records[0], (count - tail) * sizeof(TR808TraceRecord));
+    }
+
+    enabled = wasEnabled;
+    return sizeof(header) + count * sizeof(TR808TraceRecord);
+}
+
+#endif // TR808_TRACE
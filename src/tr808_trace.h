@@ -0,0 +1,180 @@
+/*
+ * TR-808 오디오 경로 트레이스 링 (플라이트 레코더)
+ *
+ * 렌더/ISR/시리얼 처리/시퀀서 스텝이 시간상 어떻게 겹치는지 실기기에서 보기 위한 이벤트 기록
+ * - 레코드: {사이클 타임스탬프, 이벤트 ID, 인자} 8바이트, 링이 차면 가장 오래된 것부터 덮어씀
+ * - 기록: 슬롯 예약(원자 증가) + 저장 2회, 락/할당/포맷팅 없음 (ISR에서도 호출 가능)
+ * - -DTR808_TRACE 빌드에서만 활성: 아니면 TR808_TRACE_EVENT()는 빈 매크로, 링 메모리도 없음
+ * - 레코드 저장소는 시작 아레나(src/tr808_arena.h)에서 받아 begin()으로 연결, 연결 전에는 기록 안 함
+ * - 덤프: 시리얼로 바이너리(헤더 + 레코드) 전송, 호스트에서 Chrome/Perfetto JSON으로 변환
+ *   (extras/host/trace_to_json.cpp)
+ *
+ * 작성일: 2025-10-30
+ * 호환성: ESP32C3 Arduino / 호스트 (extras/host)
+ */
+
+#ifndef TR808_TRACE_H
+#define TR808_TRACE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// ============================================
+// 트레이스 설정
+// ============================================
+
+#define TR808_TRACE_RECORDS     1024        // 링 크기 (2의 거듭제곱, 8바이트/레코드)
+#define TR808_TRACE_MAGIC       "T808TRC1"  // 덤프 시작 표식 (8바이트, 호스트가 텍스트 사이에서 탐색)
+#define TR808_TRACE_VERSION     1
+
+static_assert((TR808_TRACE_RECORDS & (TR808_TRACE_RECORDS - 1)) == 0,
+              "TR808_TRACE_RECORDS는 2의 거듭제곱이어야 함");
+
+// ============================================
+// 이벤트 정의
+// ============================================
+
+enum TR808TraceEventId : uint8_t {
+    TR808_TRACE_NONE = 0,
+    TR808_TRACE_RENDER_BEGIN,       // arg: 블록 샘플 수
+    TR808_TRACE_RENDER_END,
+    TR808_TRACE_I2S_BEGIN,
+    TR808_TRACE_I2S_END,            // arg: 기록된 바이트 수 (I2S.write의 bytesWritten)
+    TR808_TRACE_ISR_BEGIN,
+    TR808_TRACE_ISR_END,
+    TR808_TRACE_SERIAL_BEGIN,       // arg: 수신 대기 바이트 수
+    TR808_TRACE_SERIAL_END,
+    TR808_TRACE_CONTROL_BEGIN,
+    TR808_TRACE_CONTROL_END,
+    TR808_TRACE_STEP,               // arg: 스텝 번호
+    TR808_TRACE_TRIGGER,            // arg: 보이스 | (벨로시티 << 8)
+    TR808_TRACE_UNDERRUN,           // arg: 기록된 바이트 수
+    TR808_TRACE_RATE_CHANGE,        // arg: 새 레이트 / 100
+    TR808_TRACE_MARK,               // arg: 사용자 지정
+    TR808_TRACE_EVENT_COUNT
+};
+
+// 트랙 (Chrome 트레이스의 스레드 행)
+enum TR808TraceTrack : uint8_t {
+    TR808_TRACK_AUDIO = 1,
+    TR808_TRACK_ISR,
+    TR808_TRACK_SERIAL,
+    TR808_TRACK_CONTROL,
+    TR808_TRACK_SEQUENCER
+};
+
+struct TR808TraceEventInfo {
+    const char* name;
+    uint8_t track;
+    char phase;                     // 'B' 시작, 'E' 끝, 'i' 순간
+};
+
+// 이벤트 ID 순서와 일치 (호스트 변환기와 공유)
+static const TR808TraceEventInfo TR808_TRACE_EVENT_INFO[TR808_TRACE_EVENT_COUNT] = {
+    {"none",        TR808_TRACK_AUDIO,     'i'},
+    {"render",      TR808_TRACK_AUDIO,     'B'},
+    {"render",      TR808_TRACK_AUDIO,     'E'},
+    {"i2s_write",   TR808_TRACK_AUDIO,     'B'},
+    {"i2s_write",   TR808_TRACK_AUDIO,     'E'},
+    {"isr",         TR808_TRACK_ISR,       'B'},
+    {"isr",         TR808_TRACK_ISR,       'E'},
+    {"serial",      TR808_TRACK_SERIAL,    'B'},
+    {"serial",      TR808_TRACK_SERIAL,    'E'},
+    {"control",     TR808_TRACK_CONTROL,   'B'},
+    {"control",     TR808_TRACK_CONTROL,   'E'},
+    {"step",        TR808_TRACK_SEQUENCER, 'i'},
+    {"trigger",     TR808_TRACK_SEQUENCER, 'i'},
+    {"underrun",    TR808_TRACK_AUDIO,     'i'},
+    {"rate_change", TR808_TRACK_AUDIO,     'i'},
+    {"mark",        TR808_TRACK_SEQUENCER, 'i'},
+};
+
+// ============================================
+// 덤프 형식 (리틀 엔디언)
+// ============================================
+
+struct TR808TraceRecord {
+    uint32_t cycles;                // CPU 사이클 카운터 (32비트 랩)
+    uint8_t event;                  // TR808TraceEventId
+    uint8_t reserved;
+    uint16_t arg;
+};
+
+struct TR808TraceHeader {
+    char magic[8];                  // TR808_TRACE_MAGIC
+    uint8_t version;
+    uint8_t recordSize;             // sizeof(TR808TraceRecord)
+    uint16_t reserved;
+    uint32_t cycleHz;               // 타임스탬프 주파수
+    uint32_t recordCount;           // 뒤따르는 레코드 수 (오래된 순)
+    uint32_t lost;                  // 덮어써져 빠진 레코드 수
+};
+
+static_assert(sizeof(TR808TraceRecord) == 8, "트레이스 레코드는 8바이트");
+static_assert(sizeof(TR808TraceHeader) == 24, "트레이스 헤더는 24바이트");
+
+// 덤프 출력 함수 (시리얼 등)
+typedef void (*TR808TraceWriter)(const uint8_t* data, size_t length);
+
+#ifdef TR808_TRACE
+
+#include "tr808_perf_monitor.h"
+
+// ============================================
+// 트레이스 링
+// ============================================
+
+/**
+ * 다중 기록자 덮어쓰기 링
+ * 슬롯은 원자 증가로 예약 (ESP32C3는 A 확장이 없어 짧은 인터럽트 마스크로 구현됨)
+ * 덤프는 루프 컨텍스트에서 호출: 기록을 멈춘 뒤 복사하므로 ISR과 경합 없음
+ */
+class TR808TraceRing {
+private:
+    TR808TraceRecord* records;      // TR808_TRACE_RECORDS개 (아레나)
+    volatile uint32_t head;         // 지금까지 예약된 레코드 수
+    volatile bool enabled;
+    volatile bool freezeOnUnderrun; // 언더런 기록 후 자동 정지 (직전 이력 보존)
+
+public:
+    TR808TraceRing();
+
+    // 레코드 저장소 연결 후 기록 시작 (setup()에서 한 번)
+    void begin(TR808TraceRecord* storage);
+
+    inline void record(uint8_t event, uint16_t arg) {
+        if (!enabled) return;
+        uint32_t slot = __atomic_fetch_add(&head, 1, __ATOMIC_RELAXED);
+        TR808TraceRecord& r = records[slot & (TR808_TRACE_RECORDS - 1)];
+        r.cycles = tr808CycleCount();
+        r.event = event;
+        r.arg = arg;
+    }
+
+    // 언더런: 기록 후 무장 상태면 정지
+    void recordUnderrun(uint16_t written);
+
+    void setEnabled(bool on) { enabled = on && records != nullptr; }
+    bool isEnabled() const { return enabled; }
+    void armFreeze(bool arm) { freezeOnUnderrun = arm; }
+    bool isArmed() const { return freezeOnUnderrun; }
+    void clear();
+
+    uint32_t getCount() const;
+    uint32_t getLost() const;
+
+    // 헤더 + 레코드(오래된 순) 출력, 출력 중에는 기록 정지 후 이전 상태 복원
+    size_t dump(TR808TraceWriter write);
+};
+
+extern TR808TraceRing tr808Trace;
+
+#define TR808_TRACE_EVENT(event, arg)   tr808Trace.record((event), (uint16_t)(arg))
+
+#else
+
+#define TR808_TRACE_EVENT(event, arg)
+
+#endif // TR808_TRACE
+
+#endif // TR808_TRACE_H
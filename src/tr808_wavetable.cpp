@@ -0,0 +1,24 @@
+#include "tr808_wavetable.h"
+
+// ================ 16비트 사인 테이블 (컴파일 타임 생성) ================
+
+#define TR808_SINE_ROW4(n) \
+    tr808SineEntry(n + 0), tr808SineEntry(n + 1), tr808SineEntry(n + 2), tr808SineEntry(n + 3)
+#define TR808_SINE_ROW16(n) \
+    TR808_SINE_ROW4(n + 0), TR808_SINE_ROW4(n + 4), TR808_SINE_ROW4(n + 8), TR808_SINE_ROW4(n + 12)
+#define TR808_SINE_ROW64(n) \
+    TR808_SINE_ROW16(n + 0), TR808_SINE_ROW16(n + 16), TR808_SINE_ROW16(n + 32), TR808_SINE_ROW16(n + 48)
+#define TR808_SINE_ROW256(n) \
+    TR808_SINE_ROW64(n + 0), TR808_SINE_ROW64(n + 64), TR808_SINE_ROW64(n + 128), TR808_SINE_ROW64(n + 192)
+
+// 렌더 중 매 샘플 2회 읽음: 캐시 미스/플래시 쓰기 중 정지를 피하려고 DRAM에 둠 (2KB)
+TR808_HOT_DATA constexpr int16_t TR808_SINE_TABLE[TR808_SINE_TABLE_SIZE + 1] = {
+    TR808_SINE_ROW256(0), TR808_SINE_ROW256(256), TR808_SINE_ROW256(512), TR808_SINE_ROW256(768),
+    tr808SineEntry(TR808_SINE_TABLE_SIZE)
+};
+
+static_assert(TR808_SINE_TABLE_SIZE == 1024, "행 매크로는 1024 엔트리 기준");
+static_assert(TR808_SINE_TABLE[0] == 0, "사인 테이블 시작값 오류");
+static_assert(TR808_SINE_TABLE[TR808_SINE_TABLE_SIZE / 4] == TR808_SINE_AMPLITUDE, "사인 테이블 최대값 오류");
+static_assert(TR808_SINE_TABLE[TR808_SINE_TABLE_SIZE * 3 / 4] == -TR808_SINE_AMPLITUDE, "사인 테이블 최소값 오류");
+static_assert(TR808_SINE_TABLE[TR808_SINE_TABLE_SIZE] == TR808_SINE_TABLE[0], "보간 가드 엔트리 오류");
@@ -0,0 +1,95 @@
+/*
+ * TR-808 고해상도 사인 웨이브테이블 오실레이터
+ *
+ * sin2048_int8을 (phase >> 8) & 0xFF로 읽으면 2048개 중 256개만 쓰고
+ * 보간도 없어 8비트 양자화 + 계단 왜곡이 그대로 출력되므로,
+ * 킥/톰 같은 저음 사인 보이스용 16비트 테이블 오실레이터를 제공
+ * - 1024 + 1(가드) 엔트리 int16 테이블, 컴파일 타임 생성 (DRAM 상주, TR808_PLACE_HOT_PATH=0이면 플래시)
+ * - 32비트 위상 누산기: 상위 10비트 인덱스, 다음 16비트 보간 계수
+ * - 선형 보간: 샘플당 테이블 로드 2회 + 곱셈 1회, 나눗셈 없음
+ *
+ * 작성일: 2025-10-30
+ * 호환성: ESP32C3 Arduino / 호스트
+ */
+
+#ifndef TR808_WAVETABLE_H
+#define TR808_WAVETABLE_H
+
+#include <stdint.h>
+#include "tr808_placement.h"
+
+// ============================================
+// 테이블 설정
+// ============================================
+
+#define TR808_SINE_TABLE_BITS   10
+#define TR808_SINE_TABLE_SIZE   (1 << TR808_SINE_TABLE_BITS)
+#define TR808_SINE_AMPLITUDE    32767
+#define TR808_SINE_INDEX_SHIFT  (32 - TR808_SINE_TABLE_BITS)
+#define TR808_SINE_FRAC_SHIFT   (TR808_SINE_INDEX_SHIFT - 16)
+
+// ============================================
+// 컴파일 타임 사인 계산 (C++11 constexpr)
+// ============================================
+
+// 테일러 급수 x^21항까지: [-pi, pi]에서 오차 1e-10 미만
+constexpr double tr808SinSeries(double x2, double term, int k, double sum) {
+    return k > 21 ? sum : tr808SinSeries(x2, -term * x2 / ((k + 1) * (k + 2)), k + 2, sum + term);
+}
+
+constexpr double tr808ConstSin(double x) {
+    return tr808SinSeries(x * x, x, 1, 0.0);
+}
+
+constexpr int16_t tr808RoundSample(double v) {
+    return (int16_t)(v >= 0.0 ? v + 0.5 : v - 0.5);
+}
+
+// 테이블 i번째 값: 위상을 [-pi, pi]로 접어서 급수 수렴 보장
+constexpr int16_t tr808SineEntry(int i) {
+    return tr808RoundSample(TR808_SINE_AMPLITUDE *
+        tr808ConstSin(6.283185307179586 * (i > TR808_SINE_TABLE_SIZE / 2 ? i - TR808_SINE_TABLE_SIZE : i)
+                      / TR808_SINE_TABLE_SIZE));
+}
+
+// 보간용 가드 엔트리 포함 (table[SIZE] == table[0])
+extern const int16_t TR808_SINE_TABLE[TR808_SINE_TABLE_SIZE + 1];
+
+// ============================================
+// 사인 오실레이터
+// ============================================
+
+class TR808SineOscillator {
+private:
+    uint32_t phase;
+    uint32_t increment;
+
+public:
+    TR808SineOscillator() : phase(0), increment(0) {}
+
+    void reset() { phase = 0; }
+
+    void setIncrement(uint32_t phaseIncrement) { increment = phaseIncrement; }
+    uint32_t getIncrement() const { return increment; }
+
+    // 컨트롤 레이트용: Hz(Q16) * TR808RatePolicy::phasePerHzQ16 (나눗셈 없음)
+    void setFrequencyQ16(uint32_t frequencyQ16, uint64_t phasePerHzQ16) {
+        increment = (uint32_t)(((uint64_t)frequencyQ16 * phasePerHzQ16) >> 32);
+    }
+
+    // 설정용 (부동소수점 나눗셈 포함, 오디오 경로에서 호출 금지)
+    void setFrequency(float frequency, uint32_t sampleRate) {
+        increment = (uint32_t)((double)frequency * 4294967296.0 / sampleRate);
+    }
+
+    inline int16_t next() {
+        uint32_t index = phase >> TR808_SINE_INDEX_SHIFT;
+        int32_t frac = (int32_t)((phase >> TR808_SINE_FRAC_SHIFT) & 0xFFFF);
+        int32_t a = TR808_SINE_TABLE[index];
+        int32_t b = TR808_SINE_TABLE[index + 1];
+        phase += increment;
+        return (int16_t)(a + (((b - a) * frac) >> 16));
+    }
+};
+
+#endif // TR808_WAVETABLE_H